@@ -415,18 +415,51 @@ bool IEngineRowStream::nextGroup(ConstPointerArray & group)
 
 void IEngineRowStream::readAll(RtlLinkedDatasetBuilder &builder)
 {
-    for (;;)
+    const void * rows[defaultNextRowsBlockSize];
+    bool pendingEOG = false;
+    bool eos = false;
+    while (!eos)
     {
-        const void *nextrec = nextRow();
-        if (!nextrec)
+        unsigned numRows = nextRows(rows, defaultNextRowsBlockSize, eos);
+        for (unsigned i=0; i < numRows; i++)
         {
-            nextrec = nextRow();
-            if (!nextrec)
+            if (rows[i])
+            {
+                if (pendingEOG)
+                {
+                    builder.appendEOG();
+                    pendingEOG = false;
+                }
+                builder.appendOwn(rows[i]);
+            }
+            else
+                pendingEOG = true;
+        }
+    }
+}
+
+unsigned IEngineRowStream::nextRows(const void * * rows, unsigned maxRows, bool & eos)
+{
+    dbgassertex(maxRows >= 2);
+    unsigned numRows = 0;
+    eos = false;
+    // Always leave room for an end of group marker and the row that follows it
+    while (numRows + 1 < maxRows)
+    {
+        const void * next = nextRow();
+        if (!next)
+        {
+            next = nextRow();
+            if (!next)
+            {
+                eos = true;
                 break;
-            builder.appendEOG();
+            }
+            rows[numRows++] = nullptr;
         }
-        builder.appendOwn(nextrec);
+        rows[numRows++] = next;
     }
+    return numRows;
 }
 
 
@@ -834,6 +867,28 @@ public:
     }
 };
 
+class CPrefixSortAlgorithm : public CStableInplaceSortAlgorithm
+{
+public:
+    CPrefixSortAlgorithm(ICompare *_compare, ISortKeyPrefix *_prefix, bool _parallel, roxiemem::IRowManager &_rowManager, unsigned _activityId)
+        : CStableInplaceSortAlgorithm(_compare), prefix(_prefix), parallel(_parallel), rowManager(_rowManager), activityId(_activityId) {}
+
+    virtual void sortRows(void * * rows, size_t numRows, void * * temp)
+    {
+        if (prefix && prefixsortvec(rows, numRows, *compare, *prefix, rowManager, activityId, parallel ? 0 : 1))
+            return;
+        if (parallel)
+            parmsortvecstableinplace(rows, numRows, *compare, temp);
+        else
+            msortvecstableinplace(rows, numRows, *compare, temp);
+    }
+protected:
+    ISortKeyPrefix *prefix;
+    bool parallel;
+    roxiemem::IRowManager &rowManager;
+    unsigned activityId;
+};
+
 class CHeapSortAlgorithm : public CSortAlgorithm
 {
     unsigned curIndex;
@@ -1301,12 +1356,17 @@ extern ISortAlgorithm *createParallelMergeSortAlgorithm(ICompare *_compare)
     return new CParallelMergeSortAlgorithm(_compare);
 }
 
+extern ISortAlgorithm *createPrefixSortAlgorithm(ICompare *_compare, ISortKeyPrefix *_prefix, bool _parallel, roxiemem::IRowManager &_rowManager, unsigned _activityId)
+{
+    return new CPrefixSortAlgorithm(_compare, _prefix, _parallel, _rowManager, _activityId);
+}
+
 extern ISortAlgorithm *createSpillingQuickSortAlgorithm(ICompare *_compare, roxiemem::IRowManager &_rowManager, IOutputMetaData * _rowMeta, ICodeContext *_ctx, const char *_tempDirectory, unsigned _activityId, bool _stable)
 {
     return new CSpillingQuickSortAlgorithm(_compare, _rowManager, _rowMeta, _ctx, _tempDirectory, _activityId, _stable);
 }
 
-extern ISortAlgorithm *createSortAlgorithm(RoxieSortAlgorithm _algorithm, ICompare *_compare, roxiemem::IRowManager &_rowManager, IOutputMetaData * _rowMeta, ICodeContext *_ctx, const char *_tempDirectory, unsigned _activityId)
+extern ISortAlgorithm *createSortAlgorithm(RoxieSortAlgorithm _algorithm, ICompare *_compare, roxiemem::IRowManager &_rowManager, IOutputMetaData * _rowMeta, ICodeContext *_ctx, const char *_tempDirectory, unsigned _activityId, ISortKeyPrefix *_prefix)
 {
     switch (_algorithm)
     {
@@ -1339,6 +1399,10 @@ extern ISortAlgorithm *createSortAlgorithm(RoxieSortAlgorithm _algorithm, ICompa
         return createTbbQuickSortAlgorithm(_compare);
     case tbbStableQuickSortAlgorithm:
         return createTbbStableQuickSortAlgorithm(_compare);
+    case prefixSortAlgorithm:
+        return createPrefixSortAlgorithm(_compare, _prefix, false, _rowManager, _activityId);
+    case parallelPrefixSortAlgorithm:
+        return createPrefixSortAlgorithm(_compare, _prefix, true, _rowManager, _activityId);
     default:
         break;
     }
@@ -332,6 +332,8 @@ typedef enum {
     parallelStableQuickSortAlgorithm,   // stable version of parallelQuickSortAlgorithm
     parallelTaskQuickSortAlgorithm,      // task based parallel version of the internal quicksort implementation (for comparison)
     parallelTaskStableQuickSortAlgorithm,// task based stable version of parallelQuickSortAlgorithm
+    prefixSortAlgorithm,                // stable radix sort on the normalized key prefix, falling back to merge sort
+    parallelPrefixSortAlgorithm,        // parallel version of prefixSortAlgorithm
     unknownSortAlgorithm
 } RoxieSortAlgorithm;
 
@@ -356,8 +358,9 @@ extern THORHELPER_API ISortAlgorithm *createTbbQuickSortAlgorithm(ICompare *_com
 extern THORHELPER_API ISortAlgorithm *createTbbStableQuickSortAlgorithm(ICompare *_compare);
 extern THORHELPER_API ISortAlgorithm *createParallelTaskQuickSortAlgorithm(ICompare *_compare);
 extern THORHELPER_API ISortAlgorithm *createParallelTaskStableQuickSortAlgorithm(ICompare *_compare);
+extern THORHELPER_API ISortAlgorithm *createPrefixSortAlgorithm(ICompare *_compare, ISortKeyPrefix *_prefix, bool _parallel, roxiemem::IRowManager &_rowManager, unsigned _activityId);
 
-extern THORHELPER_API ISortAlgorithm *createSortAlgorithm(RoxieSortAlgorithm algorithm, ICompare *_compare, roxiemem::IRowManager &_rowManager, IOutputMetaData * _rowMeta, ICodeContext *_ctx, const char *_tempDirectory, unsigned _activityId);
+extern THORHELPER_API ISortAlgorithm *createSortAlgorithm(RoxieSortAlgorithm algorithm, ICompare *_compare, roxiemem::IRowManager &_rowManager, IOutputMetaData * _rowMeta, ICodeContext *_ctx, const char *_tempDirectory, unsigned _activityId, ISortKeyPrefix *_prefix = nullptr);
 
 //=========================================================================================
 
@@ -28,10 +28,21 @@
 
 struct SmartStepExtra;
 
+// A reasonable number of rows for a consumer to request in each call to nextRows()
+constexpr unsigned defaultNextRowsBlockSize = 64;
+
 interface THORHELPER_API IEngineRowStream : public IRowStream
 {
     virtual bool nextGroup(ConstPointerArray & group);      // note: default implementation can be overridden for efficiency...
     virtual void readAll(RtlLinkedDatasetBuilder &builder); // note: default implementation can be overridden for efficiency...
+
+    // Batched alternative to nextRow() - fills rows[] with up to maxRows entries (maxRows must be at least 2) and returns
+    // the number read.  A NULL entry marks the end of a group (one before the end of the stream may be omitted).
+    // eos is set once the end of the stream has been reached - any rows returned with it are the last, and the stream must
+    // not be read again until it is restarted.  0 is only returned with eos set.
+    // The rows returned must be freed.  The default implementation calls nextRow(), activities where the per-row overhead
+    // is significant can override it to process a whole block at once (and to pull a block from their own input).
+    virtual unsigned nextRows(const void * * rows, unsigned maxRows, bool & eos);
     virtual const void *nextRowGE(const void * seek, unsigned numFields, bool &wasCompleteMatch, const SmartStepExtra &stepExtra);
 
     // Reinitialize the stream - called when smart-stepping potentially jumps forward in one of the inputs feeding into
@@ -21,6 +21,8 @@
 #include "jlog.hpp"
 #include "errorlist.h"
 #include <exception>
+#include <functional>
+#include <vector>
 #include "jtask.hpp"
 
 #ifdef _USE_TBB
@@ -749,3 +751,640 @@ void parmsortvecstableinplace(void ** rows, size_t n, const ICompare & compare,
         throw makeStringExceptionV(ERRORID_UNKNOWN, "TBB exception: %s", e.what());
     }
 }
+
+//-------------------------------------------------------------------------------------------------------------------
+// Sort (key prefix, row) pairs with a most significant byte first radix sort, so the compare function is only called
+// for rows whose key prefixes match.  The prefixes are held as two big endian 64bit values, so comparing two entries
+// is a pair of integer comparisons rather than a virtual call that follows the row pointers.
+// Each radix pass preserves the existing order, and ranges are finished with stable sorts, so the sort is stable.
+
+struct PrefixSortEntry
+{
+    unsigned __int64 high;      // bytes 0..7 of the prefix
+    unsigned __int64 low;       // bytes 8..15 of the prefix
+    void * row;
+};
+
+static const size_t prefixRadixThreshold = 64;           // ranges smaller than this are sorted with an insertion sort
+static const size_t singleThreadedPrefixThreshold = 10000;
+
+class PrefixSorter
+{
+public:
+    PrefixSorter(const ICompare & _compare, const ISortKeyPrefix & _prefix)
+        : compare(_compare), prefix(_prefix), prefixSize(_prefix.getPrefixSize()), exact(_prefix.isExact())
+    {
+        assertex(prefixSize <= MAX_SORT_KEY_PREFIX);
+    }
+
+    void buildEntries(PrefixSortEntry * entries, void * * rows, size_t from, size_t to) const
+    {
+        byte key[MAX_SORT_KEY_PREFIX];
+        memset(key, 0, sizeof(key));
+        for (size_t i=from; i < to; i++)
+        {
+            prefix.buildPrefix(key, rows[i]);
+            PrefixSortEntry & cur = entries[i];
+            cur.high = readBigEndian(key);
+            cur.low = readBigEndian(key+8);
+            cur.row = rows[i];
+        }
+    }
+
+    //Returns the first byte (at or after depth) that is not the same in all the entries, and the counts for that byte.
+    unsigned countBuckets(const PrefixSortEntry * entries, size_t n, unsigned depth, size_t * counts) const
+    {
+        const PrefixSortEntry & first = entries[0];
+        unsigned __int64 diffHigh = 0;
+        unsigned __int64 diffLow = 0;
+        for (size_t i=1; i < n; i++)
+        {
+            diffHigh |= (entries[i].high ^ first.high);
+            diffLow |= (entries[i].low ^ first.low);
+        }
+
+        unsigned firstDiff;
+        if (diffHigh)
+            firstDiff = leadingZeroBytes(diffHigh);
+        else if (diffLow)
+            firstDiff = 8 + leadingZeroBytes(diffLow);
+        else
+            return prefixSize;
+
+        if (firstDiff > depth)
+            depth = firstDiff;
+        memset(counts, 0, 256 * sizeof(size_t));
+        for (size_t i=0; i < n; i++)
+            counts[keyByte(entries[i], depth)]++;
+        return depth;
+    }
+
+    void distribute(PrefixSortEntry * entries, PrefixSortEntry * temp, size_t n, unsigned depth, const size_t * counts, size_t * starts) const
+    {
+        size_t next[256];
+        size_t offset = 0;
+        for (unsigned i=0; i < 256; i++)
+        {
+            starts[i] = offset;
+            next[i] = offset;
+            offset += counts[i];
+        }
+        for (size_t i=0; i < n; i++)
+            temp[next[keyByte(entries[i], depth)]++] = entries[i];
+        memcpy(entries, temp, n * sizeof(PrefixSortEntry));
+    }
+
+    void sortRange(PrefixSortEntry * entries, PrefixSortEntry * temp, size_t n, unsigned depth) const
+    {
+        if (n <= prefixRadixThreshold)
+        {
+            insertionSort(entries, n);
+            return;
+        }
+
+        size_t counts[256];
+        depth = countBuckets(entries, n, depth, counts);
+        if (depth == prefixSize)
+        {
+            sortTied(entries, temp, n);
+            return;
+        }
+
+        size_t starts[256];
+        distribute(entries, temp, n, depth, counts, starts);
+        for (unsigned i=0; i < 256; i++)
+        {
+            if (counts[i] > 1)
+                sortRange(entries + starts[i], temp + starts[i], counts[i], depth+1);
+        }
+    }
+
+    void sortRangeParallel(PrefixSortEntry * entries, PrefixSortEntry * temp, size_t n) const
+    {
+        size_t counts[256];
+        unsigned depth = countBuckets(entries, n, 0, counts);
+        if (depth == prefixSize)
+        {
+            sortTied(entries, temp, n);
+            return;
+        }
+
+        size_t starts[256];
+        distribute(entries, temp, n, depth, counts, starts);
+        taskAsyncFor(256, queryTaskScheduler(), [this, entries, temp, &counts, &starts, depth](unsigned i)
+        {
+            if (counts[i] > 1)
+                sortRange(entries + starts[i], temp + starts[i], counts[i], depth+1);
+        });
+    }
+
+protected:
+    void insertionSort(PrefixSortEntry * entries, size_t n) const
+    {
+        for (size_t i=1; i < n; i++)
+        {
+            PrefixSortEntry next = entries[i];
+            size_t j = i;
+            for (; j > 0; j--)
+            {
+                if (compareEntries(entries[j-1], next) <= 0)
+                    break;
+                entries[j] = entries[j-1];
+            }
+            entries[j] = next;
+        }
+    }
+
+    //All the prefixes in the range match, so only the order of the rows needs to change
+    void sortTied(PrefixSortEntry * entries, PrefixSortEntry * temp, size_t n) const
+    {
+        if (exact)
+            return;
+
+        //The temporary entries have space for at least 2*n row pointers
+        void * * rows = (void * *)temp;
+        for (size_t i=0; i < n; i++)
+            rows[i] = entries[i].row;
+        msortvecstableinplace(rows, n, compare, rows + n);
+        for (size_t i=0; i < n; i++)
+            entries[i].row = rows[i];
+    }
+
+    static inline unsigned __int64 readBigEndian(const byte * key)
+    {
+        unsigned __int64 value = 0;
+        for (unsigned i=0; i < 8; i++)
+            value = (value << 8) | key[i];
+        return value;
+    }
+
+    //Deliberately undefined if value == 0
+    static inline unsigned leadingZeroBytes(unsigned __int64 value)
+    {
+        unsigned i = 0;
+        while (!(value >> 56))
+        {
+            value <<= 8;
+            i++;
+        }
+        return i;
+    }
+
+    static inline unsigned keyByte(const PrefixSortEntry & entry, unsigned depth)
+    {
+        if (depth < 8)
+            return (unsigned)(entry.high >> ((7 - depth) * 8)) & 0xff;
+        return (unsigned)(entry.low >> ((15 - depth) * 8)) & 0xff;
+    }
+
+    inline int compareEntries(const PrefixSortEntry & l, const PrefixSortEntry & r) const
+    {
+        if (l.high != r.high)
+            return (l.high < r.high) ? -1 : +1;
+        if (l.low != r.low)
+            return (l.low < r.low) ? -1 : +1;
+        if (exact)
+            return 0;
+        return compare.docompare(l.row, r.row);
+    }
+
+protected:
+    const ICompare & compare;
+    const ISortKeyPrefix & prefix;
+    unsigned prefixSize;
+    bool exact;
+};
+
+size_t getPrefixSortTempSize(size_t n)
+{
+    return n * 2 * sizeof(PrefixSortEntry);
+}
+
+void prefixsortvecinplace(void ** rows, size_t n, const ICompare & compare, const ISortKeyPrefix & prefix, void * tempBuffer, unsigned maxCores)
+{
+    if (n <= 1)
+        return;
+
+    PrefixSortEntry * entries = (PrefixSortEntry *)tempBuffer;
+    PrefixSortEntry * temp = entries + n;
+    PrefixSorter sorter(compare, prefix);
+    unsigned numCores = queryTaskScheduler().numProcessors();
+    if (maxCores && (maxCores < numCores))
+        numCores = maxCores;
+    if ((numCores > 1) && (n > singleThreadedPrefixThreshold))
+    {
+        const unsigned numBlocks = numCores * 4;
+        size_t blockSize = (n + numBlocks - 1) / numBlocks;
+        taskAsyncFor(numBlocks, queryTaskScheduler(), [&sorter, entries, rows, n, blockSize](unsigned i)
+        {
+            size_t from = i * blockSize;
+            size_t to = std::min(from + blockSize, n);
+            if (from < to)
+                sorter.buildEntries(entries, rows, from, to);
+        });
+        sorter.sortRangeParallel(entries, temp, n);
+    }
+    else
+    {
+        sorter.buildEntries(entries, rows, 0, n);
+        sorter.sortRange(entries, temp, n, 0);
+    }
+
+    for (size_t i=0; i < n; i++)
+        rows[i] = entries[i].row;
+}
+
+bool prefixsortvec(void ** rows, size_t n, const ICompare & compare, const ISortKeyPrefix & prefix, roxiemem::IRowManager & rowManager, unsigned activityId, unsigned maxCores)
+{
+    if (n <= 1)
+        return true;
+
+    // The entries are much larger than a row pointer, so they must count towards the memory limit
+    roxiemem::OwnedConstRoxieRow temp;
+    try
+    {
+        temp.setown(rowManager.allocate(getPrefixSortTempSize(n), activityId));
+    }
+    catch (IException * e)
+    {
+        unsigned code = e->errorCode();
+        if ((code != ROXIEMM_MEMORY_LIMIT_EXCEEDED) && (code != ROXIEMM_MEMORY_POOL_EXHAUSTED))
+            throw;
+        e->Release();
+        return false;
+    }
+    prefixsortvecinplace(rows, n, compare, prefix, (void *)temp.get(), maxCores);
+    return true;
+}
+
+#ifdef _USE_CPPUNIT
+#include "unittests.hpp"
+#include "eclrtl.hpp"
+#include "eclrtl_imp.hpp"
+
+namespace thorsorttests {
+
+//Rows are an unsigned integer followed by a variable length string, sorted by the value and/or the string
+struct TestSortRow
+{
+    unsigned __int64 value;
+    unsigned len;
+    char text[28];
+};
+
+enum TestSortKey { SortValue, SortValueText, SortText };
+
+class TestSortCompare : public ICompare
+{
+public:
+    TestSortCompare(TestSortKey _key, bool _descending) : key(_key), descending(_descending) {}
+
+    virtual int docompare(const void * _left, const void * _right) const override
+    {
+        const TestSortRow * left = (const TestSortRow *)_left;
+        const TestSortRow * right = (const TestSortRow *)_right;
+        int ret = 0;
+        if (key != SortText)
+            ret = (left->value < right->value) ? -1 : (left->value > right->value) ? +1 : 0;
+        if (!ret && (key != SortValue))
+        {
+            unsigned len = std::min(left->len, right->len);
+            ret = memcmp(left->text, right->text, len);
+            if (!ret)
+                ret = (left->len < right->len) ? -1 : (left->len > right->len) ? +1 : 0;
+        }
+        return descending ? -ret : ret;
+    }
+
+protected:
+    TestSortKey key;
+    bool descending;
+};
+
+class TestSortPrefix : public ISortKeyPrefix
+{
+public:
+    TestSortPrefix(TestSortKey _key, bool _descending) : key(_key), descending(_descending) {}
+
+    virtual size32_t getPrefixSize() const override { return (key != SortText) ? 8 : MAX_SORT_KEY_PREFIX; }
+    virtual bool isExact() const override { return key == SortValue; }
+    virtual void buildPrefix(byte * target, const void * _row) const override
+    {
+        const TestSortRow * row = (const TestSortRow *)_row;
+        if (key != SortText)
+        {
+            for (unsigned i=0; i < 8; i++)
+                target[i] = (byte)(row->value >> ((7 - i) * 8));
+        }
+        else
+        {
+            unsigned len = std::min(row->len, (unsigned)MAX_SORT_KEY_PREFIX);
+            memcpy(target, row->text, len);
+            memset(target + len, 0, MAX_SORT_KEY_PREFIX - len);
+        }
+        if (descending)
+        {
+            for (unsigned i=0; i < getPrefixSize(); i++)
+                target[i] = ~target[i];
+        }
+    }
+
+protected:
+    TestSortKey key;
+    bool descending;
+};
+
+static void createTestRows(std::vector<TestSortRow> & data, size_t numRows, unsigned valueRange, unsigned seed)
+{
+    static const char * const prefixes[] = { "", "SMITH", "JOHNSON", "WILLIAMSON-BROWN", "A" };
+    data.resize(numRows);
+    unsigned state = seed;
+    for (size_t i=0; i < numRows; i++)
+    {
+        state = state * 1103515245 + 12345;
+        TestSortRow & cur = data[i];
+        cur.value = valueRange ? (state >> 8) % valueRange : ((unsigned __int64)state << 32) ^ (state * 2654435761U);
+        const char * prefix = prefixes[(state >> 4) % 5];
+        unsigned prefixLen = strlen(prefix);
+        unsigned suffixLen = (state >> 12) % 8;
+        memcpy(cur.text, prefix, prefixLen);
+        for (unsigned j=0; j < suffixLen; j++)
+        {
+            state = state * 1103515245 + 12345;
+            cur.text[prefixLen + j] = 'A' + ((state >> 16) % 4);
+        }
+        cur.len = prefixLen + suffixLen;
+    }
+}
+
+//Rows sorted on string fields, with prefixes built in the same way as the code generator's buildSortKeyPrefixClass():
+//  SORT(ds, name, -id)  - a variable length string fills the whole prefix, which is not exact
+//  SORT(ds, -name, id)  - the same, with the prefix inverted
+//  SORT(ds, code, -id)  - a string10 followed by a descending integer4, which is exact
+struct GeneratedSortRow
+{
+    size32_t lenName;
+    char name[24];
+    char code[10];
+    int id;
+};
+
+enum GeneratedSortKey { SortName, SortNameDescending, SortCode };
+
+class GeneratedSortCompare : public ICompare
+{
+public:
+    GeneratedSortCompare(GeneratedSortKey _key) : key(_key) {}
+
+    virtual int docompare(const void * _left, const void * _right) const override
+    {
+        const GeneratedSortRow * left = (const GeneratedSortRow *)_left;
+        const GeneratedSortRow * right = (const GeneratedSortRow *)_right;
+        int ret;
+        if (key == SortCode)
+            ret = rtlCompareStrStr(sizeof(left->code), left->code, sizeof(right->code), right->code);
+        else
+            ret = rtlCompareStrStr(left->lenName, left->name, right->lenName, right->name);
+        if (key == SortNameDescending)
+            ret = -ret;
+        if (ret)
+            return ret;
+        if (left->id == right->id)
+            return 0;
+        bool idAscending = (key == SortNameDescending);
+        return ((left->id < right->id) == idAscending) ? -1 : +1;
+    }
+
+protected:
+    GeneratedSortKey key;
+};
+
+class GeneratedSortPrefix : public ISortKeyPrefix
+{
+public:
+    GeneratedSortPrefix(GeneratedSortKey _key) : key(_key) {}
+
+    virtual size32_t getPrefixSize() const override { return (key == SortCode) ? 14 : MAX_SORT_KEY_PREFIX; }
+    virtual bool isExact() const override { return key == SortCode; }
+    virtual void buildPrefix(byte * target, const void * _row) const override
+    {
+        const GeneratedSortRow * row = (const GeneratedSortRow *)_row;
+        if (key == SortCode)
+        {
+            rtlSortPrefixStr(target+0, 10, sizeof(row->code), row->code);
+            rtlSortPrefixInt(target+10, 4, row->id, 4);
+            rtlSortPrefixDescending(target+10, 4);
+        }
+        else
+        {
+            rtlSortPrefixStr(target+0, MAX_SORT_KEY_PREFIX, row->lenName, row->name);
+            if (key == SortNameDescending)
+                rtlSortPrefixDescending(target+0, MAX_SORT_KEY_PREFIX);
+        }
+    }
+
+protected:
+    GeneratedSortKey key;
+};
+
+static void createGeneratedSortRows(std::vector<GeneratedSortRow> & data, size_t numRows, unsigned seed)
+{
+    //Characters either side of the space padding, and a top bit set character, so that padding matters to the order
+    static const char alphabet[] = { ' ', ' ', '\t', '!', 'A', 'B', (char)0xE9 };
+    data.resize(numRows);
+    unsigned state = seed;
+    auto nextRandom = [&state]() { state = state * 1103515245 + 12345; return state >> 8; };
+    for (size_t i=0; i < numRows; i++)
+    {
+        GeneratedSortRow & cur = data[i];
+        cur.lenName = nextRandom() % (sizeof(cur.name) + 1);
+        for (unsigned j=0; j < cur.lenName; j++)
+            cur.name[j] = alphabet[nextRandom() % sizeof(alphabet)];
+        unsigned lenCode = nextRandom() % (sizeof(cur.code) + 1);
+        for (unsigned j=0; j < sizeof(cur.code); j++)
+            cur.code[j] = (j < lenCode) ? alphabet[nextRandom() % sizeof(alphabet)] : ' ';
+        cur.id = (int)(nextRandom() % 7) - 3;
+    }
+}
+
+class ThorSortTests : public CppUnit::TestFixture
+{
+    CPPUNIT_TEST_SUITE(ThorSortTests);
+        CPPUNIT_TEST(testSetup);
+        CPPUNIT_TEST(testPrefixSort);
+        CPPUNIT_TEST(testGeneratedPrefixSort);
+        CPPUNIT_TEST(testPrefixSortMemoryLimit);
+        CPPUNIT_TEST(testCleanup);
+    CPPUNIT_TEST_SUITE_END();
+
+    const IContextLogger &logctx;
+
+public:
+    ThorSortTests() : logctx(queryDummyContextLogger())
+    {
+    }
+
+protected:
+    void testSetup()
+    {
+        roxiemem::setTotalMemoryLimit(false, true, false, false, 64*HEAP_ALIGNMENT_SIZE, 0, NULL, NULL);
+    }
+
+    void testCleanup()
+    {
+        roxiemem::releaseRoxieHeap();
+    }
+
+    void checkPrefixSort(roxiemem::IRowManager & rowManager, size_t numRows, unsigned valueRange, TestSortKey key, bool descending, unsigned maxCores)
+    {
+        std::vector<TestSortRow> data;
+        createTestRows(data, numRows, valueRange, (unsigned)numRows + valueRange);
+        std::vector<void *> expected(numRows), actual(numRows), temp(numRows);
+        for (size_t i=0; i < numRows; i++)
+            expected[i] = actual[i] = &data[i];
+
+        TestSortCompare compare(key, descending);
+        TestSortPrefix prefix(key, descending);
+        msortvecstableinplace(expected.data(), numRows, compare, temp.data());
+        CPPUNIT_ASSERT(prefixsortvec(actual.data(), numRows, compare, prefix, rowManager, 0, maxCores));
+        //Both sorts are stable, so the results must be identical
+        for (size_t i=0; i < numRows; i++)
+            CPPUNIT_ASSERT_EQUAL(expected[i], actual[i]);
+    }
+
+    void testPrefixSort()
+    {
+        Owned<roxiemem::IRowManager> rowManager = roxiemem::createRowManager(0, NULL, logctx, NULL, false);
+        for (size_t numRows : { 0, 1, 2, 63, 64, 65, 1000, 50000 })
+        {
+            for (unsigned valueRange : { 0, 1, 3, 1000 })
+            {
+                for (unsigned maxCores : { 1, 0 })
+                {
+                    for (TestSortKey key : { SortValue, SortValueText, SortText })
+                    {
+                        checkPrefixSort(*rowManager, numRows, valueRange, key, false, maxCores);
+                        checkPrefixSort(*rowManager, numRows, valueRange, key, true, maxCores);
+                    }
+                }
+            }
+        }
+    }
+
+    void testGeneratedPrefixSort()
+    {
+        Owned<roxiemem::IRowManager> rowManager = roxiemem::createRowManager(0, NULL, logctx, NULL, false);
+        for (GeneratedSortKey key : { SortName, SortNameDescending, SortCode })
+        {
+            GeneratedSortCompare compare(key);
+            GeneratedSortPrefix prefix(key);
+            size32_t prefixSize = prefix.getPrefixSize();
+
+            //Whenever two prefixes differ, they must order the rows in the same way as the compare function
+            std::vector<GeneratedSortRow> data;
+            createGeneratedSortRows(data, 300, 1);
+            for (const GeneratedSortRow & left : data)
+            {
+                byte leftPrefix[MAX_SORT_KEY_PREFIX];
+                prefix.buildPrefix(leftPrefix, &left);
+                for (const GeneratedSortRow & right : data)
+                {
+                    byte rightPrefix[MAX_SORT_KEY_PREFIX];
+                    prefix.buildPrefix(rightPrefix, &right);
+                    int prefixOrder = memcmp(leftPrefix, rightPrefix, prefixSize);
+                    int rowOrder = compare.docompare(&left, &right);
+                    if (prefixOrder)
+                        CPPUNIT_ASSERT((prefixOrder < 0) == (rowOrder < 0));
+                    else if (prefix.isExact())
+                        CPPUNIT_ASSERT_EQUAL(0, rowOrder);
+                }
+            }
+
+            for (size_t numRows : { 100, 20000 })
+            {
+                createGeneratedSortRows(data, numRows, (unsigned)numRows);
+                std::vector<void *> expected(numRows), actual(numRows), temp(numRows);
+                for (size_t i=0; i < numRows; i++)
+                    expected[i] = actual[i] = &data[i];
+                msortvecstableinplace(expected.data(), numRows, compare, temp.data());
+                CPPUNIT_ASSERT(prefixsortvec(actual.data(), numRows, compare, prefix, *rowManager, 0, 0));
+                for (size_t i=0; i < numRows; i++)
+                    CPPUNIT_ASSERT_EQUAL(expected[i], actual[i]);
+            }
+        }
+    }
+
+    void testPrefixSortMemoryLimit()
+    {
+        //The prefix entries must be charged to the row manager, and the sort must leave the rows alone if they do not fit
+        Owned<roxiemem::IRowManager> rowManager = roxiemem::createRowManager(2*HEAP_ALIGNMENT_SIZE, NULL, logctx, NULL, false);
+        const size_t numRows = 50000;
+        std::vector<TestSortRow> data;
+        createTestRows(data, numRows, 0, 12345);
+        std::vector<void *> original(numRows), rows(numRows);
+        for (size_t i=0; i < numRows; i++)
+            original[i] = rows[i] = &data[i];
+
+        TestSortCompare compare(SortValue, false);
+        TestSortPrefix prefix(SortValue, false);
+        CPPUNIT_ASSERT(getPrefixSortTempSize(numRows) > 2*HEAP_ALIGNMENT_SIZE);
+        CPPUNIT_ASSERT(!prefixsortvec(rows.data(), numRows, compare, prefix, *rowManager, 0, 0));
+        CPPUNIT_ASSERT(original == rows);
+    }
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(ThorSortTests);
+CPPUNIT_TEST_SUITE_NAMED_REGISTRATION(ThorSortTests, "ThorSortTests");
+
+class ThorSortTiming : public CppUnit::TestFixture
+{
+    CPPUNIT_TEST_SUITE(ThorSortTiming);
+        CPPUNIT_TEST(testTiming);
+    CPPUNIT_TEST_SUITE_END();
+
+protected:
+    Owned<roxiemem::IRowManager> rowManager;
+
+    void timeSorts(const char * title, size_t numRows, unsigned valueRange, TestSortKey key)
+    {
+        std::vector<TestSortRow> data;
+        createTestRows(data, numRows, valueRange, 12345);
+        std::vector<void *> original(numRows), rows(numRows), temp(numRows);
+        for (size_t i=0; i < numRows; i++)
+            original[i] = &data[i];
+
+        TestSortCompare compare(key, false);
+        TestSortPrefix prefix(key, false);
+        auto runSort = [&](const char * name, const std::function<void()> & sortFunc)
+        {
+            rows = original;
+            CCycleTimer timer;
+            sortFunc();
+            DBGLOG("%s %s: %" I64F "ums", title, name, timer.elapsedMs());
+        };
+        runSort("qsortvec", [&]() { qsortvec(rows.data(), numRows, compare); });
+        runSort("msortvecstableinplace", [&]() { msortvecstableinplace(rows.data(), numRows, compare, temp.data()); });
+        runSort("prefixsortvec", [&]() { prefixsortvec(rows.data(), numRows, compare, prefix, *rowManager, 0, 1); });
+        runSort("parqsortvec", [&]() { parqsortvec(rows.data(), numRows, compare); });
+        runSort("parmsortvecstableinplace", [&]() { parmsortvecstableinplace(rows.data(), numRows, compare, temp.data()); });
+        runSort("prefixsortvec(parallel)", [&]() { prefixsortvec(rows.data(), numRows, compare, prefix, *rowManager, 0, 0); });
+    }
+
+    void testTiming()
+    {
+        const size_t numRows = 2000000;
+        roxiemem::setTotalMemoryLimit(false, true, false, false, 1024*HEAP_ALIGNMENT_SIZE, 0, NULL, NULL);
+        rowManager.setown(roxiemem::createRowManager(0, NULL, queryDummyContextLogger(), NULL, false));
+        timeSorts("Unique integer", numRows, 0, SortValue);
+        timeSorts("Integer 1000 values", numRows, 1000, SortValue);
+        timeSorts("Integer 1000 values, string", numRows, 1000, SortValueText);
+        timeSorts("String", numRows, 0, SortText);
+        rowManager.clear();
+        roxiemem::releaseRoxieHeap();
+    }
+};
+
+CPPUNIT_TEST_SUITE_NAMED_REGISTRATION(ThorSortTiming, "ThorSortTiming");
+
+} // namespace thorsorttests
+#endif
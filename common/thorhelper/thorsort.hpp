@@ -22,9 +22,17 @@
 
 #include "thorhelper.hpp"
 #include "jsort.hpp"
+#include "eclhelper.hpp"
+#include "roxiemem.hpp"
 
 extern THORHELPER_API void msortvecstableinplace(void ** rows, size_t n, const ICompare & compare, void ** temp);
 extern THORHELPER_API void parmsortvecstableinplace(void ** rows, size_t n, const ICompare & compare, void ** temp);
+// Stable sort that orders on the normalized key prefixes, and only calls compare for rows with matching prefixes.
+// The inplace variant uses a caller supplied temporary buffer of getPrefixSortTempSize(n) bytes, the other allocates
+// it from the row manager and returns false (with the rows unchanged) if that would exceed the memory limit.
+extern THORHELPER_API size_t getPrefixSortTempSize(size_t n);
+extern THORHELPER_API void prefixsortvecinplace(void ** rows, size_t n, const ICompare & compare, const ISortKeyPrefix & prefix, void * temp, unsigned maxCores=0);
+extern THORHELPER_API bool prefixsortvec(void ** rows, size_t n, const ICompare & compare, const ISortKeyPrefix & prefix, roxiemem::IRowManager & rowManager, unsigned activityId, unsigned maxCores=0);
 
 extern THORHELPER_API void tbbqsortvec(void **a, size_t n, const ICompare & compare);
 extern THORHELPER_API void tbbqsortstable(void ** rows, size_t n, const ICompare & compare, void ** temp);
@@ -18,6 +18,8 @@
 #include <queue>
 #include <list>
 #include <unordered_map>
+#include <functional>
+#include <vector>
 
 #include "platform.h"
 #include "jhash.hpp"
@@ -38,6 +40,7 @@
 
 #define DEBUG_DIR "debug"
 #define DEFAULT_KEEP_LASTN_STORES 10 // should match default in dali.xsd
+#define DEFAULT_LOCK_DOMAINS "Files,WorkUnits,Queues,JobQueues,Status,DFU,Environment,Locks,Groups" // should match default in dali.xsd
 #define MAXDELAYS 5
 static const char *deltaHeader = "<CRC>0000000000</CRC><SIZE>0000000000000000</SIZE>"; // fill in later
 static unsigned deltaHeaderCrcOff = 5;
@@ -77,6 +80,9 @@ static unsigned readWriteTimeout = 60000;
 #define DELTAINPROGRESS "delta.progress"
 #define DETACHINPROGRESS "detach.progress"
 #define TMPSAVENAME "dali_store_tmp.xml"
+#define TMPBINARYSAVENAME "dali_store_tmp.bin"
+#define XMLSTOREEXT ".xml"
+#define BINARYSTOREEXT ".bin"
 #define INIT_NODETABLE_SIZE 0x380000
 
 #define DEFAULT_LCIDLE_PERIOD (60*10)  // time has to be quiet for before blocking/saving (when using @lightweightCoalesce)
@@ -202,6 +208,327 @@ StringBuffer &getSdsCmdText(SdsCommand cmd, StringBuffer &ret)
     return ret;
 }
 
+// Times are recorded in 1/10ths of a ms. A histogram of the times is also kept, in power of 2 ms buckets.
+// Commits to different lock domains can record at the same time, so updates are serialized by crit.
+class TimingStats
+{
+public:
+    static constexpr unsigned numBuckets = 16; // <1ms, <2ms, <4ms ... <16384ms, >=16384ms
+
+    TimingStats() { reset(); }
+    void reset()
+    {
+        CriticalBlock b(crit);
+        count = 0;
+        totalTime = 0;
+        maxTime = 0;
+        minTime = (unsigned long)-1;
+        totalSize = 0;
+        for (unsigned b=0; b<numBuckets; b++)
+            buckets[b] = 0;
+    }
+    inline void record(unsigned long interval)
+    {
+        CriticalBlock b(crit);
+        count++;
+        totalTime += interval;
+        if(interval>maxTime) maxTime = interval;
+        if(interval<minTime) minTime = interval;
+        buckets[queryBucket(interval)]++;
+    }
+    inline void recordSize(unsigned long size)
+    {
+        CriticalBlock b(crit);
+        totalSize += size;
+    }
+    unsigned long queryCount() const { return count; }
+    unsigned long queryMeanTime() const { return count ? (unsigned long)(((double)totalTime*0.1)/count + 0.5) : 0; }
+    unsigned long queryMaxTime() const { return maxTime/10; }
+    unsigned long queryMinTime() const { return count ? minTime/10 : 0; }
+    unsigned long queryMeanSize() const { return count ? (unsigned long)(((double)totalSize)/count + 0.5) : 0; }
+    unsigned long queryBucketCount(unsigned bucket) const { return buckets[bucket]; }
+    StringBuffer &getInfo(StringBuffer &out) const
+    {
+        CriticalBlock block(crit);
+        out.appendf("count=%lu", count);
+        if (count)
+        {
+            out.appendf(", mean=%lums, min=%lums, max=%lums, histogram={", queryMeanTime(), queryMinTime(), queryMaxTime());
+            bool first = true;
+            for (unsigned b=0; b<numBuckets; b++)
+            {
+                if (!buckets[b])
+                    continue;
+                if (!first)
+                    out.append(", ");
+                first = false;
+                if (b < numBuckets-1)
+                    out.append('<').append(1U<<b);
+                else
+                    out.append(">=").append(1U<<(b-1));
+                out.appendf("ms:%lu", buckets[b]);
+            }
+            out.append('}');
+        }
+        return out;
+    }
+private:
+    static unsigned queryBucket(unsigned long interval)
+    {
+        unsigned long ms = interval/10;
+        unsigned bucket = 0;
+        while (ms && (bucket < numBuckets-1))
+        {
+            ms >>= 1;
+            bucket++;
+        }
+        return bucket;
+    }
+
+    unsigned long count;
+    unsigned long totalTime;
+    unsigned long maxTime;
+    unsigned long minTime;
+    unsigned long totalSize;
+    unsigned long buckets[numBuckets];
+    mutable CriticalSection crit;
+};
+
+class TimingBlock
+{
+public:
+    TimingBlock(TimingStats & _stats) : stats(_stats) { start = usTick(); }
+    ~TimingBlock() { stats.record((usTick()-start)/100); }
+protected:
+    TimingStats & stats;
+private:
+    unsigned start;
+};
+
+class TimingSizeBlock : public TimingBlock
+{
+public:
+    TimingSizeBlock(TimingStats & _stats) : TimingBlock(_stats), size(0) {}
+    ~TimingSizeBlock() { stats.recordSize(size); }
+    inline void recordSize(unsigned long _size) { size = _size; }
+private:
+    unsigned long size;
+};
+
+/////////////////
+
+/* The store is split into lock domains, one per configured top-level branch (see @lockDomains).
+ * Every operation holds the global lock for read, so that an operation on the store as a whole can still exclude
+ * everything else by taking it for write. An operation that is confined to one branch then only takes that
+ * branch's lock, so that commits to one branch (e.g. /WorkUnits) do not block readers or writers of another (e.g. /Files).
+ * An operation outside of any domain either takes the global lock for write, or for read along with a read lock on
+ * every domain.
+ *
+ * The domain is a property of the thread (see CSDSLockDomainScope), so that code which releases and re-acquires the
+ * data lock whilst it waits (e.g. CUnlockCallback), does so in the same domain.
+ */
+class CSDSLockDomain : public CInterface
+{
+public:
+    CSDSLockDomain(const char *_name) : name(_name) { }
+    const char *queryName() const { return name; }
+
+    StringAttr name;
+    ReadWriteLock lock;
+    CheckedCriticalSection connectCrit;
+    CriticalSection statsCrit;
+    TimingStats readWaitStats, writeWaitStats;
+};
+
+static thread_local CSDSLockDomain *threadLockDomain = nullptr;
+
+class CSDSLockDomainScope
+{
+    CSDSLockDomain *prev;
+public:
+    CSDSLockDomainScope(CSDSLockDomain *domain) : prev(threadLockDomain) { threadLockDomain = domain; }
+    ~CSDSLockDomainScope() { threadLockDomain = prev; }
+    void set(CSDSLockDomain *domain) { threadLockDomain = domain; }
+};
+
+class CSDSDataLock
+{
+    CSDSLockDomain global;
+    CIArrayOf<CSDSLockDomain> domains;
+
+    static unsigned remainingTime(unsigned start, unsigned timeout)
+    {
+        if (INFINITE == timeout)
+            return INFINITE;
+        unsigned elapsed = msTick()-start;
+        return (elapsed >= timeout) ? 0 : timeout-elapsed;
+    }
+public:
+    CSDSDataLock() : global("(global)") { }
+
+    void setDomains(const char *list) // only called before the store is in use
+    {
+        domains.kill();
+        StringArray names;
+        names.appendList(list, ",");
+        ForEachItemIn(n, names)
+        {
+            const char *name = names.item(n);
+            if (!isEmptyString(name) && !queryNamedDomain(name, strlen(name)))
+                domains.append(*new CSDSLockDomain(name));
+        }
+    }
+    CSDSLockDomain *queryNamedDomain(const char *name, size32_t len) const
+    {
+        ForEachItemIn(d, domains)
+        {
+            CSDSLockDomain &domain = domains.item(d);
+            if ((domain.name.length() == len) && (0 == memcmp(domain.queryName(), name, len)))
+                return &domain;
+        }
+        return nullptr;
+    }
+    // The domain that an operation on xpath (absolute, or relative to the root) is confined to, if any.
+    // Connections can delete or replace their root, so only qualify if they are below the top-level branch.
+    CSDSLockDomain *queryDomain(const char *xpath, bool allowBranchRoot) const
+    {
+        if (!xpath || !domains.ordinality())
+            return nullptr;
+        if ('/' == *xpath)
+            xpath++;
+        const char *tail = strchr(xpath, '/');
+        size32_t len = tail ? tail-xpath : strlen(xpath);
+        if (!len)
+            return nullptr;
+        if (!tail || !tail[1])
+        {
+            if (!allowBranchRoot)
+                return nullptr;
+        }
+        else if (strstr(tail, "/.")) // may refer to the branch itself, or escape it
+            return nullptr;
+        return queryNamedDomain(xpath, len);
+    }
+    CSDSLockDomain *queryCurrentDomain() const { return threadLockDomain; }
+    CheckedCriticalSection &queryConnectCrit() { return threadLockDomain ? threadLockDomain->connectCrit : global.connectCrit; }
+
+    bool lockRead(CSDSLockDomain *domain, unsigned timeout)
+    {
+        unsigned start = msTick();
+        if (!global.lock.lockRead(timeout))
+            return false;
+        if (domain)
+        {
+            if (domain->lock.lockRead(remainingTime(start, timeout)))
+                return true;
+        }
+        else
+        {
+            // could read any branch, so need all the domains. Always taken in the same order.
+            unsigned d = 0;
+            for (; d<domains.ordinality(); d++)
+            {
+                if (!domains.item(d).lock.lockRead(remainingTime(start, timeout)))
+                    break;
+            }
+            if (d == domains.ordinality())
+                return true;
+            while (d--)
+                domains.item(d).lock.unlock();
+        }
+        global.lock.unlock();
+        return false;
+    }
+    bool lockWrite(CSDSLockDomain *domain, unsigned timeout)
+    {
+        if (!domain)
+            return global.lock.lockWrite(timeout);
+        unsigned start = msTick();
+        if (!global.lock.lockRead(timeout))
+            return false;
+        if (domain->lock.lockWrite(remainingTime(start, timeout)))
+            return true;
+        global.lock.unlock();
+        return false;
+    }
+    void unlock(CSDSLockDomain *domain)
+    {
+        if (domain)
+            domain->lock.unlock();
+        else if (!global.lock.queryWriteLocked())
+        {
+            ForEachItemInRev(d, domains)
+                domains.item(d).lock.unlock();
+        }
+        global.lock.unlock();
+    }
+    bool queryWriteLocked(CSDSLockDomain *domain) { return domain ? domain->lock.queryWriteLocked() : global.lock.queryWriteLocked(); }
+    unsigned queryReadLockCount(CSDSLockDomain *domain) const { return domain ? domain->lock.queryReadLockCount() : global.lock.queryReadLockCount(); }
+    void noteWait(CSDSLockDomain *domain, bool write, unsigned long interval)
+    {
+        CSDSLockDomain &d = domain ? *domain : global;
+        CriticalBlock b(d.statsCrit);
+        if (write)
+            d.writeWaitStats.record(interval);
+        else
+            d.readWaitStats.record(interval);
+    }
+    StringBuffer &getWaitStats(StringBuffer &out)
+    {
+        auto getDomainStats = [&out](CSDSLockDomain &d)
+        {
+            CriticalBlock b(d.statsCrit);
+            out.appendf("%s read: ", d.queryName());
+            d.readWaitStats.getInfo(out).newline();
+            out.appendf("%s write: ", d.queryName());
+            d.writeWaitStats.getInfo(out).newline();
+        };
+        getDomainStats(global);
+        ForEachItemIn(d, domains)
+            getDomainStats(domains.item(d));
+        return out;
+    }
+    void resetWaitStats()
+    {
+        auto resetDomainStats = [](CSDSLockDomain &d)
+        {
+            CriticalBlock b(d.statsCrit);
+            d.readWaitStats.reset();
+            d.writeWaitStats.reset();
+        };
+        resetDomainStats(global);
+        ForEachItemIn(d, domains)
+            resetDomainStats(domains.item(d));
+    }
+
+// ReadWriteLock equivalents, in the domain of the calling thread
+    void lockRead() { lockRead(threadLockDomain, INFINITE); }
+    void lockWrite() { lockWrite(threadLockDomain, INFINITE); }
+    bool lockRead(unsigned timeout) { return lockRead(threadLockDomain, timeout); }
+    bool lockWrite(unsigned timeout) { return lockWrite(threadLockDomain, timeout); }
+    void unlock() { unlock(threadLockDomain); }
+    void unlockRead() { unlock(threadLockDomain); }
+    void unlockWrite() { unlock(threadLockDomain); }
+    bool queryWriteLocked() { return queryWriteLocked(threadLockDomain); }
+    unsigned queryReadLockCount() const { return queryReadLockCount(threadLockDomain); }
+    void checkedLockRead(unsigned timeout, const char *fname, unsigned lnum)
+    {
+        while (!lockRead(threadLockDomain, timeout))
+        {
+            PROGLOG("CSDSDataLock::checkedLockRead timeout %s(%d)", fname, lnum);
+            PrintStackReport();
+        }
+    }
+    void checkedLockWrite(unsigned timeout, const char *fname, unsigned lnum)
+    {
+        while (!lockWrite(threadLockDomain, timeout))
+        {
+            PROGLOG("CSDSDataLock::checkedLockWrite timeout %s(%d)", fname, lnum);
+            PrintStackReport();
+        }
+    }
+};
+
 #ifdef USECHECKEDCRITICALSECTIONS
 class LinkingCriticalBlock : public CheckedCriticalBlock, public CInterface
 {
@@ -210,34 +537,37 @@ public:
 };
 class CLCLockBlock : public CInterface
 {
-    ReadWriteLock &lock;
+    CSDSDataLock &lock;
+    CSDSLockDomain *domain;
     unsigned got, lnum;
 public:
-    CLCLockBlock(ReadWriteLock &_lock, bool readLock, unsigned timeout, const char *fname, unsigned _lnum) : lock(_lock), lnum(_lnum)
+    CLCLockBlock(CSDSDataLock &_lock, bool readLock, unsigned timeout, const char *fname, unsigned _lnum) : lock(_lock), domain(_lock.queryCurrentDomain()), lnum(_lnum)
     {
         got = msTick();
+        CCycleTimer waitTimer;
         for (;;)
         {
             if (readLock)
             {
-                if (lock.lockRead(timeout))
+                if (lock.lockRead(domain, timeout))
                     break;
             }
             else
             {
-                if (lock.lockWrite(timeout))
+                if (lock.lockWrite(domain, timeout))
                     break;
             }
             PROGLOG("CLCLockBlock(write=%d) timeout %s(%d), took %d ms",!readLock,fname,lnum,got-msTick());
             if (readWriteStackTracing)
                 PrintStackReport();
         }
+        lock.noteWait(domain, !readLock, waitTimer.elapsedNs()/100000);
         got = msTick();
     };
     ~CLCLockBlock()
     {
-        bool writeLocked = lock.queryWriteLocked();
-        lock.unlock();
+        bool writeLocked = lock.queryWriteLocked(domain);
+        lock.unlock(domain);
         unsigned e=msTick()-got;
         if (e>readWriteSlowTracing)
         {
@@ -259,18 +589,19 @@ public:
 };
 class CLCLockBlock : public CInterface
 {
-    ReadWriteLock &lock;
+    CSDSDataLock &lock;
+    CSDSLockDomain *domain;
 public:
-    CLCLockBlock(ReadWriteLock &_lock, bool readLock, unsigned timeout, const char *fname, unsigned lnum) : lock(_lock)
+    CLCLockBlock(CSDSDataLock &_lock, bool readLock, unsigned timeout, const char *fname, unsigned lnum) : lock(_lock), domain(_lock.queryCurrentDomain())
     {
         if (readLock)
-            lock.lockRead();
+            lock.lockRead(domain, INFINITE);
         else
-            lock.lockWrite();
+            lock.lockWrite(domain, INFINITE);
     };
     ~CLCLockBlock()
     {
-        lock.unlock();
+        lock.unlock(domain);
     }
     void changeToWrite(const char *msg);
 };
@@ -284,14 +615,14 @@ void CLCLockBlock::changeToWrite(const char *msg)
      */
 
     // Must be read locked when called.
-    dbgassertex(lock.queryReadLockCount() > 0);
+    dbgassertex(lock.queryReadLockCount(domain) > 0);
 
-    lock.unlock();
+    lock.unlock(domain);
 
     CCycleTimer timer;
     while (true)
     {
-        if (lock.lockWrite(readWriteTimeout))
+        if (lock.lockWrite(domain, readWriteTimeout))
             break;
         PROGLOG("changeToWrite timeout [%s], time taken so far %u ms", msg, timer.elapsedMs());
         if (readWriteStackTracing)
@@ -303,8 +634,8 @@ void CLCLockBlock::changeToWrite(const char *msg)
 #define CHECKEDDALIREADLOCKBLOCK(l, timeout)  Owned<CLCLockBlock> glue(block,__LINE__) = new CLCLockBlock(l, true, timeout, __FILE__, __LINE__)
 #define CHECKEDDALIWRITELOCKBLOCK(l, timeout)  Owned<CLCLockBlock> glue(block,__LINE__) = new CLCLockBlock(l, false, timeout, __FILE__, __LINE__)
 #else
-#define CHECKEDDALIREADLOCKBLOCK(l,timeout)   ReadLockBlock glue(block,__LINE__)(l)
-#define CHECKEDDALIWRITELOCKBLOCK(l,timeout)  WriteLockBlock glue(block,__LINE__)(l)
+#define CHECKEDDALIREADLOCKBLOCK(l,timeout)   CLCLockBlock glue(block,__LINE__)(l, true, timeout, __FILE__, __LINE__)
+#define CHECKEDDALIWRITELOCKBLOCK(l,timeout)  CLCLockBlock glue(block,__LINE__)(l, false, timeout, __FILE__, __LINE__)
 #endif
 
 #define OVERFLOWSIZE 50000
@@ -403,12 +734,12 @@ public:
 
 enum IncInfo { IINull=0x00, IncData=0x01, IncDetails=0x02, IncConnect=0x04, IncDisconnect=0x08, IncDisconnectDelete=0x24 };
 
-StringBuffer &constructStoreName(const char *storeBase, unsigned e, StringBuffer &res)
+StringBuffer &constructStoreName(const char *storeBase, unsigned e, StringBuffer &res, const char *ext=XMLSTOREEXT)
 {
     res.append(storeBase);
     if (e)
         res.append(e);
-    res.append(".xml");
+    res.append(ext);
     return res;
 }
 
@@ -422,55 +753,6 @@ static StringAttr remoteBackupLocation;
 
 /////////////////
 
-class TimingStats
-{
-public:
-    TimingStats() : count(0), totalTime(0), maxTime(0), minTime((unsigned long)-1), totalSize(0) {}
-    inline void record(unsigned long interval)
-    {
-        count++;
-        totalTime += interval;
-        if(interval>maxTime) maxTime = interval;
-        if(interval<minTime) minTime = interval;
-    }
-    inline void recordSize(unsigned long size)
-    {
-        totalSize += size;
-    }
-    unsigned long queryCount() const { return count; }
-    unsigned long queryMeanTime() const { return count ? (unsigned long)(((double)totalTime*0.1)/count + 0.5) : 0; }
-    unsigned long queryMaxTime() const { return maxTime/10; }
-    unsigned long queryMinTime() const { return count ? minTime/10 : 0; }
-    unsigned long queryMeanSize() const { return count ? (unsigned long)(((double)totalSize)/count + 0.5) : 0; }
-private:
-    unsigned long count;
-    unsigned long totalTime;
-    unsigned long maxTime;
-    unsigned long minTime;
-    unsigned long totalSize;
-};
-
-class TimingBlock
-{
-public:
-    TimingBlock(TimingStats & _stats) : stats(_stats) { start = msTick(); }
-    ~TimingBlock() { stats.record(msTick()-start); }
-protected:
-    TimingStats & stats;
-private:
-    unsigned long start;
-};
-
-class TimingSizeBlock : public TimingBlock
-{
-public:
-    TimingSizeBlock(TimingStats & _stats) : TimingBlock(_stats), size(0) {}
-    ~TimingSizeBlock() { stats.recordSize(size); }
-    inline void recordSize(unsigned long _size) { size = _size; }
-private:
-    unsigned long size;
-};
-
 class CSDSTransactionServer : public Thread, public CTransactionLogTracker
 {
 public:
@@ -2095,6 +2377,13 @@ public:
     unsigned queryCommitMeanTime() const { return server.queryCommitTimingStats().queryMeanTime(); }
     unsigned queryCommitMaxTime() const { return server.queryCommitTimingStats().queryMaxTime(); }
     unsigned queryCommitMeanSize() const { return server.queryCommitTimingStats().queryMeanSize(); }
+    CheckedCriticalSection &queryConnectCrit() { return dataRWLock.queryConnectCrit(); }
+    CSDSLockDomain *queryLockDomain(const char *xpath, bool allowBranchRoot) const { return dataRWLock.queryDomain(xpath, allowBranchRoot); }
+    CSDSLockDomain *queryConnectionLockDomain(ConnectionId connectionId, bool allowBranchRoot)
+    {
+        Owned<CServerConnection> connection = getConnection(connectionId);
+        return connection ? dataRWLock.queryDomain(connection->queryXPath(), allowBranchRoot) : nullptr;
+    }
     virtual void saveRequest();
     virtual IPropertyTree &queryProperties() const;
     virtual IPropertyTreeIterator *getElementsRaw(const char *xpath,INode *remotedali=NULL, unsigned timeout=MP_WAIT_FOREVER);
@@ -2110,15 +2399,14 @@ public:
     virtual bool fireException(IException *e);
 
 public: // data
-    mutable ReadWriteLock dataRWLock;
-    CheckedCriticalSection connectCrit;
+    mutable CSDSDataLock dataRWLock;
     CheckedCriticalSection connDestructCrit;
     CheckedCriticalSection cTableCrit;
     CheckedCriticalSection sTableCrit;
     CheckedCriticalSection lockCrit;
     CheckedCriticalSection treeRegCrit;
     Owned<Thread> unhandledThread;
-    unsigned writeTransactions;
+    std::atomic<unsigned> writeTransactions;
     bool ignoreExternals;
     StringAttr dataPath;
     StringAttr daliName;
@@ -2143,6 +2431,7 @@ private:
     CLockTable lockTable;
     CNotifyHandlerTable nodeNotifyHandlers;
     Owned<IThreadPool> scanNotifyPool, notifyPool;
+    CriticalSection notifyPoolCrit;
     CExternalHandlerTable externalHandlers;
     CSubscriberNotifierTable subscriberNotificationTable;
     Owned<CConnectionSubscriptionManager> connectionSubscriptionManager;
@@ -2473,6 +2762,7 @@ void CServerConnection::aborted(SessionId id)
     Owned<CLCLockBlock> lockBlock = new CLCLockBlock(((CCovenSDSManager &)manager).dataRWLock, false, readWriteTimeout, __FILE__, __LINE__);
     SDSManager->disconnect(connectionId, false);
 #else
+    CSDSLockDomainScope scope(nullptr); // can be called back inline, whilst the data lock of the caller's domain is released
     Owned<CLCLockBlock> lockBlock = new CLCLockBlock(((CCovenSDSManager &)manager).dataRWLock, true, readWriteTimeout, __FILE__, __LINE__);
     SDSManager->disconnect(connectionId, false, lockBlock);
 #endif
@@ -4288,6 +4578,7 @@ void CSDSTransactionServer::processMessage(CMessageBuffer &mb)
 
     TimingBlock xactTimingBlock(xactTimingStats);
     ICoven &coven = queryCoven();
+    CSDSLockDomainScope lockDomainScope(nullptr); // set below for requests confined to a single branch
 
     StringAttr xpath;
     ConnectionId connectionId;
@@ -4317,11 +4608,21 @@ void CSDSTransactionServer::processMessage(CMessageBuffer &mb)
                 mb.read(xpath);
                 if (queryTransactionLogging())
                     transactionLog.log("xpath='%s' mode=%d", xpath.get(), (unsigned)mode);
-                Owned<LinkingCriticalBlock> connectCritBlock = new LinkingCriticalBlock(manager.connectCrit, __FILE__, __LINE__);
-                if (RTM_CREATE == (mode & RTM_CREATE_MASK) || RTM_CREATE_QUERY == (mode & RTM_CREATE_MASK))
-                    lockBlock.setown(new CLCLockBlock(manager.dataRWLock, false, readWriteTimeout, __FILE__, __LINE__));
-                else
-                    lockBlock.setown(new CLCLockBlock(manager.dataRWLock, true, readWriteTimeout, __FILE__, __LINE__));
+                bool create = RTM_CREATE == (mode & RTM_CREATE_MASK) || RTM_CREATE_QUERY == (mode & RTM_CREATE_MASK);
+                CSDSLockDomain *domain = manager.queryLockDomain(xpath, !create);
+                Owned<LinkingCriticalBlock> connectCritBlock;
+                for (;;)
+                {
+                    lockDomainScope.set(domain);
+                    connectCritBlock.setown(new LinkingCriticalBlock(manager.queryConnectCrit(), __FILE__, __LINE__));
+                    lockBlock.setown(new CLCLockBlock(manager.dataRWLock, !create, readWriteTimeout, __FILE__, __LINE__));
+                    if (!domain || !create || manager.queryRoot()->hasProp(domain->queryName()))
+                        break;
+                    // the branch itself would have to be created, which is a change to the root
+                    lockBlock.clear();
+                    connectCritBlock.clear();
+                    domain = nullptr;
+                }
                 if (queryTransactionLogging())
                     transactionLog.markExtra();
                 connectionId = 0;
@@ -4365,6 +4666,22 @@ void CSDSTransactionServer::processMessage(CMessageBuffer &mb)
                 Owned<IMultipleConnector> mConnect = deserializeIMultipleConnector(mb);
                 mb.clear();
 
+                // can only use a lock domain if all the connections are within the same one
+                CSDSLockDomain *domain = nullptr;
+                for (unsigned c=0; c<mConnect->queryConnections(); c++)
+                {
+                    StringAttr xpath;
+                    unsigned mode;
+                    mConnect->getConnectionDetails(c, xpath, mode);
+                    CSDSLockDomain *connDomain = manager.queryLockDomain(xpath, false);
+                    if (0 == c)
+                        domain = connDomain;
+                    else if (connDomain != domain)
+                        domain = nullptr;
+                    if (!domain)
+                        break;
+                }
+                lockDomainScope.set(domain);
                 lockBlock.setown(new CLCLockBlock(manager.dataRWLock, true, readWriteTimeout, __FILE__, __LINE__));
 
                 try
@@ -4382,7 +4699,7 @@ void CSDSTransactionServer::processMessage(CMessageBuffer &mb)
                         connectionId = 0;
                         CServerRemoteTree *_tree;
                         Owned<CServerRemoteTree> tree;
-                        Owned<LinkingCriticalBlock> connectCritBlock = new LinkingCriticalBlock(manager.connectCrit, __FILE__, __LINE__);
+                        Owned<LinkingCriticalBlock> connectCritBlock = new LinkingCriticalBlock(manager.queryConnectCrit(), __FILE__, __LINE__);
                         manager.createConnection(id, mode, timeout, xpath, _tree, connectionId, true, connectCritBlock);
                         if (connectionId)
                             tree.setown(_tree);
@@ -4434,6 +4751,7 @@ void CSDSTransactionServer::processMessage(CMessageBuffer &mb)
                     transactionLog.log();
                 __int64 serverId;
                 mb.read(serverId);
+                lockDomainScope.set(manager.queryConnectionLockDomain(connectionId, true));
                 CHECKEDDALIREADLOCKBLOCK(manager.dataRWLock, readWriteTimeout);
                 CHECKEDCRITICALBLOCK(SDSManager->treeRegCrit, fakeCritTimeout);
                 Owned<CServerRemoteTree> tree = manager.getRegisteredTree(serverId);
@@ -4478,6 +4796,7 @@ void CSDSTransactionServer::processMessage(CMessageBuffer &mb)
                     transactionLog.log("%s",conn?conn->queryXPath():"???");
                 }
                 __int64 serverId;
+                lockDomainScope.set(manager.queryConnectionLockDomain(connectionId, true));
                 CHECKEDDALIREADLOCKBLOCK(manager.dataRWLock, readWriteTimeout);
                 CHECKEDCRITICALBLOCK(SDSManager->treeRegCrit, fakeCritTimeout);
                 CMessageBuffer replyMb;
@@ -4540,6 +4859,7 @@ void CSDSTransactionServer::processMessage(CMessageBuffer &mb)
                     CServerConnection *conn = manager.queryConnection(connectionId);
                     transactionLog.log("%s",conn?conn->queryXPath():"???");
                 }
+                lockDomainScope.set(manager.queryConnectionLockDomain(connectionId, true));
                 CHECKEDDALIREADLOCKBLOCK(manager.dataRWLock, readWriteTimeout);
                 CHECKEDCRITICALBLOCK(SDSManager->treeRegCrit, fakeCritTimeout);
 
@@ -4585,6 +4905,7 @@ void CSDSTransactionServer::processMessage(CMessageBuffer &mb)
                 Owned<CLCLockBlock> lockBlock;
                 {
                     CheckTime block1("DAMP_SDSCMD_DATA.1");
+                    lockDomainScope.set(manager.queryConnectionLockDomain(connectionId, false));
                     if (data || deleteRoot)
                         lockBlock.setown(new CLCLockBlock(manager.dataRWLock, false, readWriteTimeout, __FILE__, __LINE__));
                     else
@@ -4739,11 +5060,12 @@ void CSDSTransactionServer::processMessage(CMessageBuffer &mb)
             }
             case DAMP_SDSCMD_GETELEMENTSRAW:
             {
-                CHECKEDDALIREADLOCKBLOCK(manager.dataRWLock, readWriteTimeout);
                 StringAttr _xpath;
                 mb.read(_xpath);
                 if (queryTransactionLogging())
                     transactionLog.log("%s", xpath.get());
+                lockDomainScope.set(manager.queryLockDomain(_xpath, true));
+                CHECKEDDALIREADLOCKBLOCK(manager.dataRWLock, readWriteTimeout);
                 CMessageBuffer replyMb;
                 replyMb.init(mb.getSender(), mb.getTag(), mb.getReplyTag());
                 replyMb.append((int)DAMP_SDSREPLY_OK);
@@ -4769,6 +5091,7 @@ void CSDSTransactionServer::processMessage(CMessageBuffer &mb)
                 mb.read(xpath);
                 if (queryTransactionLogging())
                     transactionLog.log("xpath='%s'", xpath.get());
+                lockDomainScope.set(manager.queryLockDomain(xpath, true));
                 CHECKEDDALIREADLOCKBLOCK(manager.dataRWLock, readWriteTimeout);
                 mb.clear();
                 mb.append((int)DAMP_SDSREPLY_OK);
@@ -4972,10 +5295,10 @@ inline unsigned prevEditionN(unsigned e, unsigned i=1)
     return e-i;
 }
 
-void removeDaliFile(const char *path, const char *base, unsigned e)
+void removeDaliFile(const char *path, const char *base, unsigned e, const char *ext=XMLSTOREEXT)
 {
     StringBuffer filename(path);
-    constructStoreName(base, e, filename);
+    constructStoreName(base, e, filename, ext);
     OwnedIFile iFile = createIFile(filename.str());
     try
     {
@@ -5007,7 +5330,289 @@ void initializeInternals(IPropertyTree *root)
     root->addPropTree("Status/Servers",createPTree());
 }
 
-IPropertyTree *loadStore(const char *storeFilename, unsigned edition, IPTreeMaker *iMaker, unsigned crcValidation, bool logErrorsOnly=false, const bool *abort=NULL)
+/* Binary store format
+ *
+ * header   : magic, version
+ * chunks   : each chunk is a sequence of complete children of one top level branch, serialized as PTree::serialize does
+ * index    : root (self only), number of branches, then for each branch, the branch (self only), number of chunks and
+ *            the offset, size, crc and number of children of each chunk. Chunks are listed in child order.
+ * trailer  : offset, size and crc of the index, magic
+ *
+ * Chunks are independent, so they are written and read in parallel, and a chunk can be rewritten without reformatting
+ * the rest of the file. The crc of the index (which includes the chunk crcs) is used as the crc of the store.
+ */
+static constexpr char binaryStoreMagic[8] = { 'H', 'P', 'C', 'C', 'S', 'D', 'S', 'B' };
+static constexpr unsigned binaryStoreVersion = 1;
+static constexpr size32_t binaryStoreChunkSize = 0x1000000; // children are added to a chunk until it exceeds this size
+static constexpr unsigned binaryStoreChildrenPerTask = 0x400;
+static constexpr size32_t binaryStoreHeaderSize = sizeof(binaryStoreMagic) + sizeof(unsigned);
+static constexpr size32_t binaryStoreTrailerSize = sizeof(offset_t) + sizeof(size32_t) + sizeof(unsigned) + sizeof(binaryStoreMagic);
+
+typedef std::function<void(IPropertyTree &)> BinaryStoreNodeCallback;
+
+struct CBinaryStoreChunk
+{
+    offset_t offset = 0;
+    size32_t size = 0;
+    unsigned crc = 0;
+    unsigned count = 0;
+};
+
+static bool isBinaryStore(IFileIO &iFileIO)
+{
+    char magic[sizeof(binaryStoreMagic)];
+    if (iFileIO.read(0, sizeof(magic), magic) != sizeof(magic))
+        return false;
+    return 0 == memcmp(magic, binaryStoreMagic, sizeof(magic));
+}
+
+static void writeBinaryStoreData(IFileIO &iFileIO, offset_t pos, MemoryBuffer &mb)
+{
+    if (iFileIO.write(pos, mb.length(), mb.toByteArray()) != mb.length())
+        throw MakeSDSException(SDSExcpt_FileCreateFailure, "Failed to write binary store");
+}
+
+static void readBinaryStoreData(IFileIO &iFileIO, offset_t pos, size32_t size, MemoryBuffer &mb)
+{
+    if (iFileIO.read(pos, size, mb.clear().reserveTruncate(size)) != size)
+        throw MakeSDSException(SDSExcpt_CorruptStore, "Binary store truncated (reading %u bytes at %" I64F "u)", size, pos);
+}
+
+// Returns the crc of the index
+static unsigned saveBinaryStore(IPropertyTree &root, IFileIO &iFileIO)
+{
+    struct CSaveTask
+    {
+        unsigned branch = 0;
+        unsigned start = 0;
+        unsigned end = 0;
+        std::vector<CBinaryStoreChunk> chunks;
+    };
+    std::vector<IPropertyTree *> branches;
+    std::vector<std::vector<IPropertyTree *>> branchChildren;
+    std::vector<CSaveTask> tasks;
+    Owned<IPropertyTreeIterator> iter = root.getElements("*");
+    ForEach(*iter)
+    {
+        IPropertyTree &branch = iter->query();
+        unsigned b = branches.size();
+        branches.push_back(&branch);
+        branchChildren.emplace_back();
+        std::vector<IPropertyTree *> &children = branchChildren.back();
+        Owned<IPropertyTreeIterator> childIter = branch.getElements("*");
+        ForEach(*childIter)
+            children.push_back(&childIter->query());
+        for (unsigned start=0; start<children.size(); start += binaryStoreChildrenPerTask)
+        {
+            tasks.emplace_back();
+            CSaveTask &task = tasks.back();
+            task.branch = b;
+            task.start = start;
+            task.end = std::min((unsigned)children.size(), start+binaryStoreChildrenPerTask);
+        }
+    }
+
+    MemoryBuffer header;
+    header.append(sizeof(binaryStoreMagic), binaryStoreMagic).append(binaryStoreVersion);
+    writeBinaryStoreData(iFileIO, 0, header);
+
+    CriticalSection writeCrit;
+    offset_t writePos = header.length();
+    asyncFor(tasks.size(), getAffinityCpus(), true, [&](unsigned i)
+    {
+        CSaveTask &task = tasks[i];
+        std::vector<IPropertyTree *> &children = branchChildren[task.branch];
+        MemoryBuffer mb;
+        unsigned count = 0;
+        auto flushChunk = [&]()
+        {
+            CBinaryStoreChunk chunk;
+            chunk.size = mb.length();
+            chunk.crc = crc32((const char *)mb.toByteArray(), mb.length(), 0);
+            chunk.count = count;
+            {
+                CriticalBlock b(writeCrit);
+                chunk.offset = writePos;
+                writePos += chunk.size;
+            }
+            writeBinaryStoreData(iFileIO, chunk.offset, mb);
+            task.chunks.push_back(chunk);
+            mb.clear();
+            count = 0;
+        };
+        for (unsigned c=task.start; c<task.end; c++)
+        {
+            PTree *child = QUERYINTERFACE(children[c], PTree);
+            assertex(child);
+            child->serialize(mb);
+            ++count;
+            if (mb.length() >= binaryStoreChunkSize)
+                flushChunk();
+        }
+        if (count)
+            flushChunk();
+    });
+
+    MemoryBuffer index;
+    PTree *rootTree = QUERYINTERFACE(&root, PTree);
+    assertex(rootTree);
+    rootTree->serializeSelf(index);
+    index.append((unsigned)branches.size());
+    auto curTask = tasks.begin();
+    for (unsigned b=0; b<branches.size(); b++)
+    {
+        PTree *branch = QUERYINTERFACE(branches[b], PTree);
+        assertex(branch);
+        branch->serializeSelf(index);
+        auto firstTask = curTask;
+        unsigned numChunks = 0;
+        for (; curTask != tasks.end() && curTask->branch == b; ++curTask)
+            numChunks += curTask->chunks.size();
+        index.append(numChunks);
+        for (auto task = firstTask; task != curTask; ++task)
+        {
+            for (const CBinaryStoreChunk &chunk : task->chunks)
+                index.append(chunk.offset).append(chunk.size).append(chunk.crc).append(chunk.count);
+        }
+    }
+    unsigned indexCrc = crc32((const char *)index.toByteArray(), index.length(), 0);
+    writeBinaryStoreData(iFileIO, writePos, index);
+
+    MemoryBuffer trailer;
+    trailer.append(writePos).append(index.length()).append(indexCrc).append(sizeof(binaryStoreMagic), binaryStoreMagic);
+    writeBinaryStoreData(iFileIO, writePos+index.length(), trailer);
+    return indexCrc;
+}
+
+static IPropertyTree *readBinaryStoreNode(MemoryBuffer &mb, IPTreeNodeCreator &nodeCreator, const BinaryStoreNodeCallback &onLoad)
+{
+    Owned<IPropertyTree> tree = nodeCreator.create(nullptr);
+    PTree *node = QUERYINTERFACE(tree.get(), PTree);
+    assertex(node);
+    node->deserializeSelf(mb);
+    if (onLoad)
+        onLoad(*tree);
+    return tree.getClear();
+}
+
+// Children are added before their own children are read, so that attaching them is not recursive
+static void readBinaryStoreChildren(MemoryBuffer &mb, IPropertyTree &parent, IPTreeNodeCreator &nodeCreator, const BinaryStoreNodeCallback &onLoad)
+{
+    for (;;)
+    {
+        if ('\0' == *(const char *)mb.readDirect(0))
+        {
+            mb.skip(1);
+            break;
+        }
+        IPropertyTree *child = readBinaryStoreNode(mb, nodeCreator, onLoad);
+        parent.addPropTree(child->queryName(), child);
+        readBinaryStoreChildren(mb, *child, nodeCreator, onLoad);
+    }
+}
+
+// onLoad is called for each node once its own attributes and value have been read. It is called concurrently from
+// multiple threads.
+static IPropertyTree *loadBinaryStore(IFileIO &iFileIO, IPTreeNodeCreator &nodeCreator, const BinaryStoreNodeCallback &onLoad, unsigned &indexCrc, const bool *abort)
+{
+    offset_t fileSize = iFileIO.size();
+    if (fileSize < binaryStoreHeaderSize + binaryStoreTrailerSize)
+        throw MakeSDSException(SDSExcpt_CorruptStore, "Binary store truncated (size=%" I64F "u)", fileSize);
+    MemoryBuffer mb;
+    readBinaryStoreData(iFileIO, 0, binaryStoreHeaderSize, mb);
+    mb.skip(sizeof(binaryStoreMagic));
+    unsigned version;
+    mb.read(version);
+    if (version > binaryStoreVersion)
+        throw MakeSDSException(SDSExcpt_Unsupported, "Binary store version %u is newer than supported version %u", version, binaryStoreVersion);
+
+    readBinaryStoreData(iFileIO, fileSize-binaryStoreTrailerSize, binaryStoreTrailerSize, mb);
+    offset_t indexOffset;
+    size32_t indexSize;
+    mb.read(indexOffset).read(indexSize).read(indexCrc);
+    if (0 != memcmp(mb.readDirect(sizeof(binaryStoreMagic)), binaryStoreMagic, sizeof(binaryStoreMagic)) || (indexOffset + indexSize + binaryStoreTrailerSize != fileSize))
+        throw MakeSDSException(SDSExcpt_CorruptStore, "Binary store has an invalid trailer, the save was probably incomplete");
+    MemoryBuffer index;
+    readBinaryStoreData(iFileIO, indexOffset, indexSize, index);
+    if (crc32((const char *)index.toByteArray(), indexSize, 0) != indexCrc)
+        throw MakeSDSException(SDSExcpt_CorruptStore, "Binary store index crc mismatch");
+
+    struct CLoadBranch
+    {
+        Owned<IPropertyTree> tree;
+        unsigned firstChunk = 0;
+        unsigned numChunks = 0;
+    };
+    Owned<IPropertyTree> root = readBinaryStoreNode(index, nodeCreator, onLoad);
+    unsigned numBranches;
+    index.read(numBranches);
+    std::unique_ptr<CLoadBranch[]> branches(new CLoadBranch[numBranches]);
+    std::vector<CBinaryStoreChunk> chunks;
+    for (unsigned b=0; b<numBranches; b++)
+    {
+        CLoadBranch &branch = branches[b];
+        branch.tree.setown(readBinaryStoreNode(index, nodeCreator, onLoad));
+        branch.firstChunk = chunks.size();
+        index.read(branch.numChunks);
+        for (unsigned c=0; c<branch.numChunks; c++)
+        {
+            CBinaryStoreChunk chunk;
+            index.read(chunk.offset).read(chunk.size).read(chunk.crc).read(chunk.count);
+            chunks.push_back(chunk);
+        }
+    }
+
+    unsigned numChunks = chunks.size();
+    std::unique_ptr<IArrayOf<IPropertyTree>[]> chunkChildren(new IArrayOf<IPropertyTree>[numChunks]);
+    std::atomic<unsigned> chunksLoaded{0};
+    unsigned lastProgress = msTick();
+    CriticalSection progressCrit;
+    asyncFor(numChunks, getAffinityCpus(), true, [&](unsigned i)
+    {
+        if (abort && *abort)
+            return;
+        const CBinaryStoreChunk &chunk = chunks[i];
+        MemoryBuffer mb;
+        readBinaryStoreData(iFileIO, chunk.offset, chunk.size, mb);
+        if (crc32((const char *)mb.toByteArray(), chunk.size, 0) != chunk.crc)
+            throw MakeSDSException(SDSExcpt_CorruptStore, "Binary store chunk crc mismatch (chunk %u, offset %" I64F "u)", i, chunk.offset);
+        for (unsigned c=0; c<chunk.count; c++)
+        {
+            IPropertyTree *child = readBinaryStoreNode(mb, nodeCreator, onLoad);
+            chunkChildren[i].append(*child);
+            readBinaryStoreChildren(mb, *child, nodeCreator, onLoad);
+        }
+        unsigned loaded = ++chunksLoaded;
+        CriticalBlock b(progressCrit);
+        if (msTick()-lastProgress >= 60000)
+        {
+            PROGLOG("Load progress: %u of %u chunks", loaded, numChunks);
+            lastProgress = msTick();
+        }
+    });
+    if (abort && *abort)
+        throw MakeSDSException(SDSExcpt_LoadAborted, "Binary store load aborted");
+
+    for (unsigned b=0; b<numBranches; b++)
+    {
+        CLoadBranch &branch = branches[b];
+        IPropertyTree *tree = root->addPropTree(branch.tree->queryName(), branch.tree.getClear());
+        for (unsigned c=branch.firstChunk; c<branch.firstChunk+branch.numChunks; c++)
+        {
+            IArrayOf<IPropertyTree> &children = chunkChildren[c];
+            ForEachItemIn(n, children)
+            {
+                IPropertyTree &child = children.item(n);
+                tree->addPropTree(child.queryName(), LINK(&child));
+            }
+            children.kill();
+        }
+    }
+    return root.getClear();
+}
+
+// iMaker is used to load xml stores, nodeCreator and onLoad are used to load binary stores
+IPropertyTree *loadStore(const char *storeFilename, unsigned edition, IPTreeMaker *iMaker, IPTreeNodeCreator &nodeCreator, const BinaryStoreNodeCallback &onLoad, unsigned crcValidation, bool logErrorsOnly=false, const bool *abort=NULL)
 {
     CHECKEDCRITICALBLOCK(loadStoreCrit, fakeCritTimeout);
     CHECKEDCRITICALBLOCK(saveStoreCrit, fakeCritTimeout);
@@ -5019,14 +5624,25 @@ IPropertyTree *loadStore(const char *storeFilename, unsigned edition, IPTreeMake
         if (!iFileIOStore)
             throw MakeSDSException(SDSExcpt_OpenStoreFailed, "%s", storeFilename);
         offset_t fSize = iFileIOStore->size();
-        PROGLOG("Loading store %u (size=%.2f MB, storedCrc=%x)", edition, ((double)fSize) / 0x100000, crcValidation);
-        Owned<IFileIOStream> fstream = createIOStream(iFileIOStore);
-        OwnedIFileIOStream progressedIFileIOStream = createProgressIFileIOStream(fstream, fSize, "Load progress", 60);
-        Owned<ICrcIOStream> crcPipeStream = createCrcPipeStream(progressedIFileIOStream);
-        Owned<IIOStream> ios = createBufferedIOStream(crcPipeStream);
-        root.setown((CServerRemoteTree *) createPTree(*ios, ipt_none, ptr_ignoreWhiteSpace, iMaker));
-        ios.clear();
-        unsigned crc = crcPipeStream->queryCrc();
+        unsigned crc;
+        if (isBinaryStore(*iFileIOStore))
+        {
+            PROGLOG("Loading binary store %u (size=%.2f MB, storedCrc=%x)", edition, ((double)fSize) / 0x100000, crcValidation);
+            CCycleTimer timer;
+            root.setown(loadBinaryStore(*iFileIOStore, nodeCreator, onLoad, crc, abort));
+            PROGLOG("Binary store loaded in %u ms", timer.elapsedMs());
+        }
+        else
+        {
+            PROGLOG("Loading store %u (size=%.2f MB, storedCrc=%x)", edition, ((double)fSize) / 0x100000, crcValidation);
+            Owned<IFileIOStream> fstream = createIOStream(iFileIOStore);
+            OwnedIFileIOStream progressedIFileIOStream = createProgressIFileIOStream(fstream, fSize, "Load progress", 60);
+            Owned<ICrcIOStream> crcPipeStream = createCrcPipeStream(progressedIFileIOStream);
+            Owned<IIOStream> ios = createBufferedIOStream(crcPipeStream);
+            root.setown((CServerRemoteTree *) createPTree(*ios, ipt_none, ptr_ignoreWhiteSpace, iMaker));
+            ios.clear();
+            crc = crcPipeStream->queryCrc();
+        }
 
         if (crcValidation && crc != crcValidation)
             IWARNLOG("Error processing store %s - CRC ERROR (file size=%" I64F "d, validation crc=%x, calculated crc=%x)", storeFilename, iFileIOStore->size(), crcValidation, crc); // not fatal yet (maybe later)
@@ -5056,6 +5672,48 @@ IPropertyTree *loadStore(const char *storeFilename, unsigned edition, IPTreeMake
 }
 
 
+bool isBinaryStoreFile(const char *filename)
+{
+    OwnedIFile iFile = createIFile(filename);
+    OwnedIFileIO iFileIO = iFile->open(IFOread);
+    return iFileIO && isBinaryStore(*iFileIO);
+}
+
+IPropertyTree *loadStoreFile(const char *filename)
+{
+    OwnedIFile iFile = createIFile(filename);
+    OwnedIFileIO iFileIO = iFile->open(IFOread);
+    if (!iFileIO)
+        throw MakeSDSException(SDSExcpt_OpenStoreFailed, "%s", filename);
+    if (!isBinaryStore(*iFileIO))
+        return createPTree(*iFileIO, ipt_none, ptr_ignoreWhiteSpace);
+
+    class CNodeCreate : implements IPTreeNodeCreator, public CInterface
+    {
+    public:
+        IMPLEMENT_IINTERFACE;
+        virtual IPropertyTree *create(const char *tag) { return createPTree(tag); }
+    } nodeCreator;
+    unsigned crc;
+    return loadBinaryStore(*iFileIO, nodeCreator, nullptr, crc, nullptr);
+}
+
+void saveStoreFile(IPropertyTree *root, const char *filename, bool binary)
+{
+    if (!binary)
+    {
+        saveXML(filename, root);
+        return;
+    }
+    OwnedIFile iFile = createIFile(filename);
+    OwnedIFileIO iFileIO = iFile->open(IFOcreate);
+    if (!iFileIO)
+        throw MakeSDSException(SDSExcpt_FileCreateFailure, "%s", filename);
+    saveBinaryStore(*root, *iFileIO);
+    iFileIO->close();
+}
+
+
 // Not really coalescing, blocking transations and saving store (which will delete pending transactions).
 class CLightCoalesceThread : implements ICoalesce, public CInterface
 {
@@ -5242,9 +5900,9 @@ public:
         assertex(unlocked);
         unsigned got = msTick();
         if (lockedForWrite)
-            CHECKEDWRITELOCKENTER(SDSManager->dataRWLock, readWriteTimeout);
+            SDSManager->dataRWLock.checkedLockWrite(readWriteTimeout, __FILE__, __LINE__);
         else
-            CHECKEDREADLOCKENTER(SDSManager->dataRWLock, readWriteTimeout);
+            SDSManager->dataRWLock.checkedLockRead(readWriteTimeout, __FILE__, __LINE__);
         CHECKEDCRITENTER(SDSManager->lockCrit, fakeCritTimeout);
         unlocked = false;
         unsigned e=msTick()-got;
@@ -5488,6 +6146,13 @@ class CStoreHelper : implements IStoreHelper, public CInterface
         OwnedIFile detachIPIFile;
         StringBuffer activeDetachIPStr, inactiveDetachIPStr;
     };
+    const char *queryStoreExt(unsigned edition)
+    {
+        StringBuffer binaryName(location);
+        constructStoreName(storeName, edition, binaryName, BINARYSTOREEXT);
+        OwnedIFile iFile = createIFile(binaryName);
+        return iFile->exists() ? BINARYSTOREEXT : XMLSTOREEXT;
+    }
 public:
     IMPLEMENT_IINTERFACE;
 
@@ -5501,11 +6166,13 @@ public:
         {
             refreshStoreInfo();
             unsigned edition = storeInfo.edition;
-            Owned<IDirectoryIterator> di = createDirectoryIterator(location, "dali*.xml");
+            Owned<IDirectoryIterator> di = createDirectoryIterator(location, "dali*");
             ForEach (*di)
             {
                 StringBuffer fname;
                 di->getName(fname);
+                if (!endsWithIgnoreCase(fname, XMLSTOREEXT) && !endsWithIgnoreCase(fname, BINARYSTOREEXT))
+                    continue;
                 if ('_' != fname.charAt(7)) // Unhelpful naming convention to differentiate store files from externals!
                 {
                     if (0 == memicmp("inc", fname.str()+4, 3) || 0 == memicmp("sds", fname.str()+4, 3))
@@ -5721,30 +6388,41 @@ public:
 
         unsigned edition = storeInfo.edition;
         unsigned newEdition = currentEdition?edition:nextEditionN(edition);
+        bool binary;
+        if (0 != (SH_KeepStoreFormat & configFlags))
+            binary = streq(BINARYSTOREEXT, queryStoreExt(edition));
+        else
+            binary = 0 != (SH_BinaryStore & configFlags);
+        const char *ext = binary ? BINARYSTOREEXT : XMLSTOREEXT;
         bool done = false;
         try
         {
             unsigned crc = 0;
             StringBuffer tmpStoreName;
-            OwnedIFileIO iFileIOTmpStore = createUniqueFile(location, TMPSAVENAME, NULL, tmpStoreName);
+            OwnedIFileIO iFileIOTmpStore = createUniqueFile(location, binary ? TMPBINARYSAVENAME : TMPSAVENAME, NULL, tmpStoreName);
             OwnedIFile iFileTmpStore = createIFile(tmpStoreName);
             try
             {
-                OwnedIFileIOStream fstream = createIOStream(iFileIOTmpStore);
-                Owned<ICrcIOStream> crcPipeStream = createCrcPipeStream(fstream);
-                Owned<IIOStream> ios = createBufferedIOStream(crcPipeStream);
+                if (binary)
+                    crc = saveBinaryStore(*root, *iFileIOTmpStore);
+                else
+                {
+                    OwnedIFileIOStream fstream = createIOStream(iFileIOTmpStore);
+                    Owned<ICrcIOStream> crcPipeStream = createCrcPipeStream(fstream);
+                    Owned<IIOStream> ios = createBufferedIOStream(crcPipeStream);
 
 #ifdef _DEBUG
-                toXML(root, *ios);          // formatted (default)
+                    toXML(root, *ios);          // formatted (default)
 #else
-                toXML(root, *ios, 0, 0);
+                    toXML(root, *ios, 0, 0);
 #endif
-                ios->flush(); // ensure flushed outside of dtor (to ensure any exception thrown)
-                ios.clear();
-                fstream.clear();
-                crcPipeStream->flush(); // ensure flushed outside of dtor. NB: calls wrapped stream flush()
-                crc = crcPipeStream->queryCrc();
-                crcPipeStream.clear();
+                    ios->flush(); // ensure flushed outside of dtor (to ensure any exception thrown)
+                    ios.clear();
+                    fstream.clear();
+                    crcPipeStream->flush(); // ensure flushed outside of dtor. NB: calls wrapped stream flush()
+                    crc = crcPipeStream->queryCrc();
+                    crcPipeStream.clear();
+                }
                 iFileIOTmpStore->close(); // ensure flushed outside of dtor
                 iFileIOTmpStore.clear();
             }
@@ -5757,7 +6435,7 @@ public:
             }
 
             StringBuffer newStoreName;
-            constructStoreName(storeName, newEdition, newStoreName);
+            constructStoreName(storeName, newEdition, newStoreName, ext);
             StringBuffer newStoreNamePath(location);
             newStoreNamePath.append(newStoreName);
             refreshStoreInfo();
@@ -5772,6 +6450,8 @@ public:
                 OwnedIFile newStoreIFile = createIFile(newStoreNamePath.str());
                 newStoreIFile->remove();
                 iFileTmpStore->rename(newStoreName.str());
+                if (currentEdition) // replacing the current edition, possibly in a different format
+                    removeDaliFile(location, storeName, newEdition, binary ? XMLSTOREEXT : BINARYSTOREEXT);
             }
             catch (IException *e)
             {
@@ -5817,7 +6497,7 @@ public:
                 {
                     PROGLOG("Copying store to backup location");
                     StringBuffer rL(remoteBackupLocation);
-                    constructStoreName(storeName, newEdition, rL);
+                    constructStoreName(storeName, newEdition, rL, ext);
                     copyFile(rL.str(), newStoreNamePath.str());
 
                     clearStoreInfo("store", remoteBackupLocation, 0, NULL);
@@ -5848,17 +6528,18 @@ public:
         {
 #ifndef NODELETE
             unsigned toDeleteEdition = prevEditionN(edition, keepStores+(currentEdition?1:0));
+            const char *toDeleteExt = queryStoreExt(toDeleteEdition);
             StringBuffer filename(location);
-            constructStoreName(storeName, toDeleteEdition, filename);
+            constructStoreName(storeName, toDeleteEdition, filename, toDeleteExt);
             OwnedIFile iFile = createIFile(filename.str());
             if (iFile->exists())
                 PROGLOG("Deleting old store: %s", filename.str());
-            removeDaliFile(location, storeName, toDeleteEdition);
+            removeDaliFile(location, storeName, toDeleteEdition, toDeleteExt);
             removeDaliFile(location, DELTANAME, toDeleteEdition);
             removeDaliFile(location, DELTADETACHED, toDeleteEdition);
             if (remoteBackupLocation)
             {
-                removeDaliFile(remoteBackupLocation, storeName, toDeleteEdition);
+                removeDaliFile(remoteBackupLocation, storeName, toDeleteEdition, toDeleteExt);
                 removeDaliFile(remoteBackupLocation, DELTANAME, toDeleteEdition);
                 removeDaliFile(remoteBackupLocation, DELTADETACHED, toDeleteEdition);
             }
@@ -5873,7 +6554,7 @@ public:
     virtual StringBuffer &getCurrentStoreFilename(StringBuffer &res, unsigned *crc=NULL)
     {
         refreshStoreInfo();
-        constructStoreName(storeName, storeInfo.edition, res);
+        constructStoreName(storeName, storeInfo.edition, res, queryStoreExt(storeInfo.edition));
         if (crc)
             * crc = storeInfo.crc;
         return res;
@@ -5984,6 +6665,9 @@ CCovenSDSManager::CCovenSDSManager(ICoven &_coven, IPropertyTree &_config, const
     allNodes.ensure(initNodeTableSize?initNodeTableSize:INIT_NODETABLE_SIZE);
     externalSizeThreshold = config.getPropInt("@externalSizeThreshold", defaultExternalSizeThreshold);
     remoteBackupLocation.set(config.queryProp("@remoteBackupLocation"));
+    const char *lockDomains = config.hasProp("@lockDomains") ? config.queryProp("@lockDomains") : DEFAULT_LOCK_DOMAINS;
+    dataRWLock.setDomains(lockDomains);
+    PROGLOG("SDS lock domains: %s", isEmptyString(lockDomains) ? "<none>" : lockDomains);
     nextExternal = 1;
     if (0 == coven.getServerRank())
     {
@@ -6082,6 +6766,11 @@ CCovenSDSManager::CCovenSDSManager(ICoven &_coven, IPropertyTree &_config, const
 
     unsigned configFlags = config.getPropBool("@recoverFromIncErrors", true) ? SH_RecoverFromIncErrors : 0;
     configFlags |= config.getPropBool("@backupErrorFiles", true) ? SH_BackupErrorFiles : 0;
+    const char *storeFormat = config.queryProp("@storeFormat");
+    if (storeFormat && strieq(storeFormat, "binary"))
+        configFlags |= SH_BinaryStore;
+    else if (storeFormat && !strieq(storeFormat, "xml"))
+        OWARNLOG("Unknown storeFormat '%s', saving stores as xml", storeFormat);
     iStoreHelper = createStoreHelper(storeName, dataPath, remoteBackupLocation, configFlags, keepLastN, 100, &server.queryStopped());
     doTimeComparison = false;
     if (config.getPropBool("@lightweightCoalesce", true))
@@ -6243,7 +6932,18 @@ void CCovenSDSManager::loadStore(const char *storeName, const bool *abort)
         StringBuffer storeFilename(dataPath);
         iStoreHelper->getCurrentStoreFilename(storeFilename, &crc);
 
-        root = (CServerRemoteTree *)::loadStore(storeFilename.str(), iStoreHelper->queryCurrentEdition(), &treeMaker, crc, false, abort);
+        CriticalSection convertCrit;
+        auto noteBinaryNode = [&](IPropertyTree &tree)
+        {
+            CServerRemoteTree &node = (CServerRemoteTree &)tree;
+            node.setSubscribed(false); // saved state of a node that was subscribed to when the store was saved
+            if (node.testExternalCandidate())
+            {
+                CriticalBlock b(convertCrit);
+                treeMaker.convertQueue.append(node);
+            }
+        };
+        root = (CServerRemoteTree *)::loadStore(storeFilename.str(), iStoreHelper->queryCurrentEdition(), &treeMaker, nodeCreator, noteBinaryNode, crc, false, abort);
         if (!root)
         {
             StringBuffer s(storeName);
@@ -6801,6 +7501,7 @@ StringBuffer &getMConnectString(IMultipleConnector *mConnect, StringBuffer &s)
 // ISDSManager impl.
 IRemoteConnections *CCovenSDSManager::connect(IMultipleConnector *mConnect, SessionId id, unsigned timeout)
 {
+    CSDSLockDomainScope scope(nullptr); // in-process requests are not confined to a lock domain
     Owned<CLCLockBlock> lockBlock;
     lockBlock.setown(new CLCLockBlock(dataRWLock, true, readWriteTimeout, __FILE__, __LINE__));
 
@@ -6820,11 +7521,12 @@ IRemoteConnections *CCovenSDSManager::connect(IMultipleConnector *mConnect, Sess
 
 IRemoteConnection *CCovenSDSManager::connect(const char *xpath, SessionId id, unsigned mode, unsigned timeout)
 {
+    CSDSLockDomainScope scope(nullptr);
     Owned<CLCLockBlock> lockBlock;
     Owned<LinkingCriticalBlock> connectCritBlock;
     if (!RTM_MODE(mode, RTM_INTERNAL))
     {
-        connectCritBlock.setown(new LinkingCriticalBlock(connectCrit, __FILE__, __LINE__));
+        connectCritBlock.setown(new LinkingCriticalBlock(queryConnectCrit(), __FILE__, __LINE__));
         if (RTM_CREATE == (mode & RTM_CREATE_MASK) || RTM_CREATE_QUERY == (mode & RTM_CREATE_MASK))
             lockBlock.setown(new CLCLockBlock(dataRWLock, false, readWriteTimeout, __FILE__, __LINE__));
         else
@@ -6900,13 +7602,15 @@ bool CCovenSDSManager::removeNotifyHandler(const char *handlerKey)
 IPropertyTree *CCovenSDSManager::lockStoreRead() const
 {
     PROGLOG("lockStoreRead() called");
-    CHECKEDREADLOCKENTER(dataRWLock, readWriteTimeout);
+    CSDSLockDomainScope scope(nullptr);
+    dataRWLock.checkedLockRead(readWriteTimeout, __FILE__, __LINE__);
     return root;
 }
 
 void CCovenSDSManager::unlockStoreRead() const
 {
     PROGLOG("unlockStoreRead() called");
+    CSDSLockDomainScope scope(nullptr);
     dataRWLock.unlockRead();
 }
 
@@ -6960,6 +7664,23 @@ bool CCovenSDSManager::setSDSDebug(StringArray &params, StringBuffer &reply)
 
         PROGLOG("fakecrit, fakeCritTimeout timing set to %d", fakeCritTimeout);
     }
+    else if (0 == stricmp("lockStats", params.item(0)))
+    {
+        if ((params.ordinality()>1) && (0 == stricmp("reset", params.item(1))))
+        {
+            dataRWLock.resetWaitStats();
+            PROGLOG("datalock, wait stats reset");
+            return true;
+        }
+        reply.append("Data lock waits:").newline();
+        dataRWLock.getWaitStats(reply);
+        reply.append("Transactions: ");
+        server.queryXactTimingStats().getInfo(reply).newline();
+        reply.append("Connects: ");
+        server.queryConnectTimingStats().getInfo(reply).newline();
+        reply.append("Commits: ");
+        server.queryCommitTimingStats().getInfo(reply).appendf(", mean size=%lu", server.queryCommitTimingStats().queryMeanSize());
+    }
     else
     {
         reply.append("Unknown command");
@@ -6986,6 +7707,7 @@ void CCovenSDSManager::installNotifyHandler(const char *handlerKey, ISDSNotifyHa
 // ISDSConnectionManager impl.
 void CCovenSDSManager::commit(CRemoteConnection &connection, bool *disconnectDeleteRoot)
 {
+    CSDSLockDomainScope scope(nullptr);
     Owned<CLCLockBlock> lockBlock;
     if (!RTM_MODE(connection.queryMode(), RTM_INTERNAL))
         lockBlock.setown(new CLCLockBlock(dataRWLock, false, readWriteTimeout, __FILE__, __LINE__));
@@ -7035,6 +7757,7 @@ void CCovenSDSManager::commit(CRemoteConnection &connection, bool *disconnectDel
 
 CRemoteTreeBase *CCovenSDSManager::get(CRemoteConnection &connection, __int64 serverId)
 {
+    CSDSLockDomainScope scope(nullptr);
     Owned<CLCLockBlock> lockBlock;
     if (!RTM_MODE(connection.queryMode(), RTM_INTERNAL))
         lockBlock.setown(new CLCLockBlock(dataRWLock, true, readWriteTimeout, __FILE__, __LINE__));
@@ -7050,6 +7773,7 @@ CRemoteTreeBase *CCovenSDSManager::get(CRemoteConnection &connection, __int64 se
 
 void CCovenSDSManager::getChildren(CRemoteTreeBase &parent, CRemoteConnection &connection, unsigned levels)
 {
+    CSDSLockDomainScope scope(nullptr);
     Owned<CLCLockBlock> lockBlock;
     if (!RTM_MODE(connection.queryMode(), RTM_INTERNAL))
         lockBlock.setown(new CLCLockBlock(dataRWLock, true, readWriteTimeout, __FILE__, __LINE__));
@@ -7061,6 +7785,7 @@ void CCovenSDSManager::getChildren(CRemoteTreeBase &parent, CRemoteConnection &c
 
 void CCovenSDSManager::getChildrenFor(CRTArray &childLessList, CRemoteConnection &connection, unsigned levels)
 {
+    CSDSLockDomainScope scope(nullptr);
     Owned<CLCLockBlock> lockBlock;
     if (!RTM_MODE(connection.queryMode(), RTM_INTERNAL))
         lockBlock.setown(new CLCLockBlock(dataRWLock, true, readWriteTimeout, __FILE__, __LINE__));
@@ -7153,6 +7878,7 @@ void CCovenSDSManager::_getChildren(CRemoteTreeBase &parent, CServerRemoteTree &
 
 IPropertyTreeIterator *CCovenSDSManager::getElements(CRemoteConnection &connection, const char *xpath)
 {
+    CSDSLockDomainScope scope(nullptr);
     Owned<CLCLockBlock> lockBlock = new CLCLockBlock(dataRWLock, true, readWriteTimeout, __FILE__, __LINE__);
     CDisableFetchChangeBlock block(connection);
     Owned<CServerRemoteTree> serverConnRoot = (CServerRemoteTree *)getRegisteredTree(((CClientRemoteTree *)connection.queryRoot())->queryServerId());
@@ -7243,6 +7969,7 @@ void CCovenSDSManager::getExternalValueFromServerId(__int64 serverId, MemoryBuff
 IPropertyTreeIterator *CCovenSDSManager::getElementsRaw(const char *xpath,INode *remotedali, unsigned timeout)
 {
     assertex(!remotedali); // only client side
+    CSDSLockDomainScope scope(nullptr);
     CHECKEDDALIREADLOCKBLOCK(dataRWLock, readWriteTimeout);
     return root->getElements(xpath);
 }
@@ -7683,7 +8410,7 @@ void CCovenSDSManager::createConnection(SessionId sessionId, unsigned mode, unsi
     {
         struct LockUnblock
         {
-            LockUnblock(ReadWriteLock &_rWLock) : rWLock(_rWLock)
+            LockUnblock(CSDSDataLock &_rWLock) : rWLock(_rWLock)
             {
                 lockedForWrite = rWLock.queryWriteLocked();
                 if (lockedForWrite) rWLock.unlockWrite();
@@ -7691,7 +8418,7 @@ void CCovenSDSManager::createConnection(SessionId sessionId, unsigned mode, unsi
             }
             ~LockUnblock() { if (lockedForWrite) rWLock.lockWrite(); else rWLock.lockRead(); }
             bool lockedForWrite;
-            ReadWriteLock &rWLock;
+            CSDSDataLock &rWLock;
         };
         bool locked = false;
         class CConnectExistingLockCallback : implements IUnlockCallback
@@ -7780,7 +8507,7 @@ void CCovenSDSManager::createConnection(SessionId sessionId, unsigned mode, unsi
                                     }
                                     else
                                         remaining = 0; // a timeout of 0 means fail immediately if locked
-                                    CConnectExistingLockCallback connectLockCallback(xpath, connectionId, existing, &connectCrit);
+                                    CConnectExistingLockCallback connectLockCallback(xpath, connectionId, existing, &queryConnectCrit());
                                     lock(existing, xpath, connectionId, sessionId, mode, remaining, connectLockCallback);
                                 }
                                 if (!queryConnection(connectionId)) // aborted
@@ -7871,7 +8598,7 @@ void CCovenSDSManager::createConnection(SessionId sessionId, unsigned mode, unsi
         {
             if (!locked)
             {
-                CConnectExistingLockCallback connectLockCallback(xpath, connectionId, *(CServerRemoteTree *)_tree, connectCritBlock.get()?&connectCrit:NULL);
+                CConnectExistingLockCallback connectLockCallback(xpath, connectionId, *(CServerRemoteTree *)_tree, connectCritBlock.get()?&queryConnectCrit():NULL);
                 lock(*(CServerRemoteTree *)_tree, xpath, connectionId, sessionId, mode, timeout, connectLockCallback);
             }
         }
@@ -8364,11 +9091,14 @@ void CCovenSDSManager::handleNotify(CSubscriberContainerBase *_subscriber, Memor
             return new CNotifyHandler();
         }
     };
-    if (!notifyPool)
     {
-        CNotifyPoolFactory *factory = new CNotifyPoolFactory;
-        notifyPool.setown(createThreadPool("SDS Notification Pool", factory, this, SUBNTFY_POOL_SIZE));
-        factory->Release();
+        CriticalBlock b(notifyPoolCrit); // commits in different lock domains can notify concurrently
+        if (!notifyPool)
+        {
+            CNotifyPoolFactory *factory = new CNotifyPoolFactory;
+            notifyPool.setown(createThreadPool("SDS Notification Pool", factory, this, SUBNTFY_POOL_SIZE));
+            factory->Release();
+        }
     }
 
     CHECKEDCRITICALBLOCK(nfyTableCrit, fakeCritTimeout);
@@ -8696,11 +9426,14 @@ void CCovenSDSManager::startNotification(IPropertyTree &changeTree, CPTStack &st
             return new CScanNotifyHandler();
         }
     };
-    if (!scanNotifyPool)
     {
-        CScanNotifyPoolFactory *factory = new CScanNotifyPoolFactory;
-        scanNotifyPool.setown(createThreadPool("SDS Scan-Notification Pool", factory, this, SUBSCAN_POOL_SIZE));
-        factory->Release();
+        CriticalBlock b(notifyPoolCrit); // commits in different lock domains can start notifications concurrently
+        if (!scanNotifyPool)
+        {
+            CScanNotifyPoolFactory *factory = new CScanNotifyPoolFactory;
+            scanNotifyPool.setown(createThreadPool("SDS Scan-Notification Pool", factory, this, SUBSCAN_POOL_SIZE));
+            factory->Release();
+        }
     }
 
     Owned<CSubscriberNotifyScanner> scan = new CSubscriberNotifyScanner(changeTree, stack, changes);
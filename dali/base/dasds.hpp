@@ -210,7 +210,8 @@ enum SDSExceptionCodes
     SDSExcpt_InvalidSessionId,
     SDSExcpt_LockHeld,
     SDSExcpt_SubscriptionParseError,
-    SDSExcpt_SubscriptionNoMatch
+    SDSExcpt_SubscriptionNoMatch,
+    SDSExcpt_CorruptStore
 };
 
 interface da_decl ISDSException : extends IException { };
@@ -269,8 +270,15 @@ enum
     SH_RecoverFromIncErrors = 0x0002,
     SH_BackupErrorFiles     = 0x0004,
     SH_CheckNewDelta        = 0x0008,
+    SH_BinaryStore          = 0x0010, // save stores in the binary format
+    SH_KeepStoreFormat      = 0x0020, // save stores in the same format as the current store
 };
 extern da_decl IStoreHelper *createStoreHelper(const char *storeName, const char *location, const char *remoteBackupLocation, unsigned configFlags, unsigned keepStores=0, unsigned delay=5000, const bool *abort=NULL);
+// Stores are saved either as xml, or in a binary format that is chunked by branch, with a crc per chunk, so that it
+// can be loaded in parallel.  These functions load and save either format outside of a dali server, e.g. for tooling.
+extern da_decl bool isBinaryStoreFile(const char *filename);
+extern da_decl IPropertyTree *loadStoreFile(const char *filename);
+extern da_decl void saveStoreFile(IPropertyTree *root, const char *filename, bool binary);
 extern da_decl bool applyXmlDeltas(IPropertyTree &root, IIOStream &stream, bool stopOnError=false);
 extern da_decl bool traceAllTransactions(); // server only
 extern da_decl bool traceSlowTransactions(unsigned thresholdMs); // server only
@@ -422,6 +422,8 @@ public:
                 return out.append("Lock held");
             case SDSExcpt_SubscriptionParseError:
                 return out.append("Subscription parse error");
+            case SDSExcpt_CorruptStore:
+                return out.append("Store file is corrupt");
             default:
                 return out.append("INTERNAL ERROR");
         }
@@ -2146,13 +2146,13 @@ void coalesce()
 {
     const char *daliDataPath = NULL;
     const char *remoteBackupLocation = NULL;
-    Owned<IStoreHelper> iStoreHelper = createStoreHelper(NULL, daliDataPath, remoteBackupLocation, SH_External|SH_RecoverFromIncErrors);
+    Owned<IStoreHelper> iStoreHelper = createStoreHelper(NULL, daliDataPath, remoteBackupLocation, SH_External|SH_RecoverFromIncErrors|SH_KeepStoreFormat);
     unsigned baseEdition = iStoreHelper->queryCurrentEdition();
 
     StringBuffer storeFilename(daliDataPath);
     iStoreHelper->getCurrentStoreFilename(storeFilename);
     OUTLOG("Loading store: %s", storeFilename.str());
-    Owned<IPropertyTree> root = createPTreeFromXMLFile(storeFilename.str());
+    Owned<IPropertyTree> root = loadStoreFile(storeFilename.str());
     OUTLOG("Loaded: %s", storeFilename.str());
 
     if (baseEdition != iStoreHelper->queryCurrentEdition())
@@ -2472,6 +2472,16 @@ void xmlSize(const char *filename, double pc)
     }
 }
 
+void convertStore(const char *srcFilename, const char *dstFilename)
+{
+    bool binary = endsWithIgnoreCase(dstFilename, ".bin");
+    OUTLOG("Loading store: %s", srcFilename);
+    Owned<IPropertyTree> root = loadStoreFile(srcFilename);
+    OUTLOG("Saving %s store: %s", binary ? "binary" : "xml", dstFilename);
+    saveStoreFile(root, dstFilename, binary);
+    OUTLOG("Saved: %s", dstFilename);
+}
+
 void translateToXpath(const char *logicalfile, DfsXmlBranchKind tailType)
 {
     CDfsLogicalFileName lfn;
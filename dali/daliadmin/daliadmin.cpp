@@ -108,6 +108,7 @@ void usage(const char *exe)
   printf("  xmlsize <filename> [<percentage>] --  analyse size usage in xml file, display individual items above 'percentage' \n");
   printf("  migratefiles <src-group> <target-group> [<filemask>] [dryrun] [createmaps] [listonly] [verbose]\n");
   printf("  translatetoxpath logicalfile [File|SuperFile|Scope]\n");
+  printf("  convertstore <srcfile> <destfile> -- convert a store file between xml and binary (binary if <destfile> ends in .bin)\n");
   printf("  cleanglobalwuid [dryrun] [noreconstruct]\n");
   printf("\n");
   printf("Common options\n");
@@ -224,6 +225,11 @@ int main(int argc, const char* argv[])
                         branchType = DXB_File;
                     translateToXpath(params.item(1), branchType);
                 }
+                else if (strieq(cmd,"convertstore"))
+                {
+                    CHECKPARAMS(2,2);
+                    convertStore(params.item(1), params.item(2));
+                }
                 else if (strieq(cmd, "remotetest"))
                     remoteTest(params.item(1), false);
                 else
@@ -32,6 +32,7 @@
 #include "danqs.hpp"
 #include "dautils.hpp"
 #include "dasess.hpp"
+#include "dadiags.hpp"
 #include "mplog.hpp"
 #include "rmtclient.hpp"
 
@@ -3317,11 +3318,107 @@ void testlockprop(const char *lfn)
     printf("done\n");
 }
 
+static bool getSDSDebug(const char *cmd, const char *arg, StringBuffer &reply)
+{
+    MemoryBuffer mb;
+    mb.append("setsdsdebug");
+    mb.append((unsigned)(arg ? 2 : 1));
+    mb.append(cmd);
+    if (arg)
+        mb.append(arg);
+    getDaliDiagnosticValue(mb);
+    bool success;
+    StringAttr replyText;
+    mb.read(success);
+    mb.read(replyText);
+    reply.append(replyText);
+    return success;
+}
+
+/* Floods /WorkUnits with large commits whilst other threads read /Files, and reports how long the reads took and the
+ * dali's lock wait stats. Without lock domains the readers are blocked for the duration of each commit.
+ * params: [<writers> [<readers> [<commits per writer> [<nodes per commit>]]]]
+ */
+void TestBranchFlood(StringArray &params)
+{
+    unsigned writers = params.isItem(0) ? atoi(params.item(0)) : 4;
+    unsigned readers = params.isItem(1) ? atoi(params.item(1)) : 8;
+    unsigned commits = params.isItem(2) ? atoi(params.item(2)) : 50;
+    unsigned commitNodes = params.isItem(3) ? atoi(params.item(3)) : 20000;
+
+    StringBuffer reply;
+    if (!getSDSDebug("lockStats", "reset", reply))
+        PROGLOG("Dali does not support lockStats: %s", reply.str());
+
+    CriticalSection statsCrit;
+    unsigned readCount = 0, commitCount = 0;
+    unsigned __int64 readTotalNs = 0, commitTotalNs = 0;
+    unsigned __int64 readMaxNs = 0, commitMaxNs = 0;
+    std::atomic<unsigned> writersRunning{writers};
+
+    PROGLOG("BRANCHFLOOD: %u writers of /WorkUnits, %u readers of /Files, %u commits of %u nodes per writer", writers, readers, commits, commitNodes);
+    CCycleTimer totalTimer;
+    asyncFor(writers+readers, writers+readers, true, [&](unsigned i)
+    {
+        if (i < writers)
+        {
+            VStringBuffer xpath("/WorkUnits/datest_branchflood_%u", i);
+            Owned<IRemoteConnection> conn = querySDS().connect(xpath, myProcessSession(), RTM_CREATE|RTM_LOCK_WRITE|RTM_DELETE_ON_DISCONNECT, SDS_LOCK_TIMEOUT);
+            for (unsigned c=0; c<commits; c++)
+            {
+                IPropertyTree *root = conn->queryRoot();
+                root->removeProp("Data");
+                IPropertyTree *data = root->addPropTree("Data");
+                for (unsigned n=0; n<commitNodes; n++)
+                {
+                    IPropertyTree *item = data->addPropTree("Item");
+                    item->setPropInt("@n", n);
+                    item->setPropInt("@commit", c);
+                }
+                CCycleTimer timer;
+                conn->commit();
+                unsigned __int64 ns = timer.elapsedNs();
+                CriticalBlock b(statsCrit);
+                commitCount++;
+                commitTotalNs += ns;
+                if (ns > commitMaxNs)
+                    commitMaxNs = ns;
+            }
+            conn->close(true);
+            writersRunning--;
+        }
+        else
+        {
+            while (writersRunning)
+            {
+                CCycleTimer timer;
+                {
+                    Owned<IRemoteConnection> conn = querySDS().connect("/Files", myProcessSession(), 0, SDS_LOCK_TIMEOUT);
+                    if (conn)
+                        conn->queryRoot()->hasProp("Scope");
+                }
+                querySDS().queryCount("/Files/*");
+                unsigned __int64 ns = timer.elapsedNs();
+                CriticalBlock b(statsCrit);
+                readCount++;
+                readTotalNs += ns;
+                if (ns > readMaxNs)
+                    readMaxNs = ns;
+            }
+        }
+    });
+    PROGLOG("BRANCHFLOOD: finished in %u ms", totalTimer.elapsedMs());
+    PROGLOG("BRANCHFLOOD: commits=%u mean=%" I64F "u us max=%" I64F "u us", commitCount, commitCount ? commitTotalNs/commitCount/1000 : 0, commitMaxNs/1000);
+    PROGLOG("BRANCHFLOOD: reads=%u mean=%" I64F "u us max=%" I64F "u us", readCount, readCount ? readTotalNs/readCount/1000 : 0, readMaxNs/1000);
+    if (getSDSDebug("lockStats", nullptr, reply.clear()))
+        PROGLOG("BRANCHFLOOD: dali lock stats:\n%s", reply.str());
+}
+
 void usage(const char *error=NULL)
 {
     if (error) printf("%s\n", error);
     printf("usage: DATEST <server_ip:port>* [/test <name> [<test params...>] [/NITER <iterations>]\n");
-    printf("where name = RANDTEST | DFS | QTEST | QTEST2 | SESSION | LOCKS | SDS1 | SDS2 | XPATHS| STRESS | STRESS2 | SHUTDOWN | EXTERNAL | SUBLOCKS | SUBSCRIPTION | CONNECTIONSUBS | MULTIFILE | NODESUBS | DFUSTREAMREAD | DFUSTREAMWRITE | DFUSTREAMCOPY\n");
+    printf("where name = RANDTEST | DFS | QTEST | QTEST2 | SESSION | LOCKS | SDS1 | SDS2 | XPATHS| STRESS | STRESS2 | SHUTDOWN | EXTERNAL | SUBLOCKS | SUBSCRIPTION | CONNECTIONSUBS | MULTIFILE | NODESUBS | DFUSTREAMREAD | DFUSTREAMWRITE | DFUSTREAMCOPY | BRANCHFLOOD\n");
     printf("eg:  datest . /test QTEST put          -- one coven server running locally, running qtest with param \"put\"\n");
     printf("     datest eq0001016 eq0001017        -- two coven servers, use default test %s\n", DEFAULT_TEST);
 }
@@ -3530,6 +3627,8 @@ int main(int argc, char* argv[])
                 testDfuStreamWrite(testParams.ordinality() ? testParams.item(0) : nullptr);
             else if (TEST("DFUSTREAMCOPY"))
                 testDfuStreamCopy(testParams.ordinality() ? testParams.item(0) : nullptr);
+            else if (TEST("BRANCHFLOOD"))
+                TestBranchFlood(testParams);
 //          else if (TEST("DALILOG"))
 //              testDaliLog(testParams.ordinality()&&0!=atoi(testParams.item(0)));
             else
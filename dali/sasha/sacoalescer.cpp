@@ -50,7 +50,7 @@ void coalesceDatastore(IPropertyTree *coalesceProps, bool force)
 
         for (;;) {
             PROGLOG("COALESCER: dataPath=%s, backupPath=%s, minDeltaSize = %" I64F "dK", dataPath.str(), backupPath.str(), (unsigned __int64) minDeltaSize);
-            unsigned configFlags = SH_External|SH_CheckNewDelta;
+            unsigned configFlags = SH_External|SH_CheckNewDelta|SH_KeepStoreFormat;
             configFlags |= coalesceProps->getPropBool("@recoverFromIncErrors", false) ? SH_RecoverFromIncErrors : 0;
             configFlags |= coalesceProps->getPropBool("@backupErrorFiles", true) ? SH_BackupErrorFiles : 0;
             bool stopped;
@@ -90,7 +90,7 @@ void coalesceDatastore(IPropertyTree *coalesceProps, bool force)
             if (storeIFile->exists())
             {
                 PROGLOG("Loading store: %s, size=%" I64F "d", storeFilename.str(), storeIFile->size());
-                _root.setown(createPTreeFromXMLFile(storeFilename.str()));
+                _root.setown(loadStoreFile(storeFilename.str()));
                 PROGLOG("Loaded: %s", storeFilename.str());
             }
             else
@@ -385,6 +385,7 @@ protected:
     StringArray allowSignedPermissions;
     StringArray deniedPermissions;
     StringAttr optMetaLocation;
+    StringAttr optCompileCacheDir;
     StringBuffer neverSimplifyRegEx;
     StringAttr optDefaultGitPrefix;
     StringAttr optGitUser;
@@ -804,6 +805,12 @@ ICppCompiler * EclCC::createCompiler(const char * coreName, const char * sourceD
     ForEachItemIn(iLib, libraryPaths)
         compiler->addLibraryPath(libraryPaths.item(iLib));
 
+    if (optCompileCacheDir)
+    {
+        Owned<ICompiledObjectCache> objectCache = createCompiledObjectCache(optCompileCacheDir);
+        compiler->setObjectCache(objectCache);
+    }
+
     return compiler.getClear();
 }
 
@@ -2936,6 +2943,13 @@ int EclCC::parseCommandLineOptions(int argc, const char* argv[])
         else if (iter.matchFlag(optIncludeMeta, "-meta") || iter.matchFlag(optIncludeMeta, "--meta"))
         {
         }
+        else if (iter.matchOption(tempArg, "--compilecache"))
+        {
+            if (!tempArg.isEmpty())
+                optCompileCacheDir.set(tempArg);
+            else
+                optCompileCacheDir.clear();
+        }
         else if (iter.matchOption(tempArg, "--metacache"))
         {
             if (!tempArg.isEmpty())
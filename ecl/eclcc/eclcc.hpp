@@ -82,6 +82,7 @@ const char * const helpText[] = {
     "?   -checkDirty   Report any modified attributes using git status",
     "?   --cleanrepos  Unconditionally delete any cached repositories associated with dependencies",
     "?   --cleaninvalidrepos Delete any incomplete cached repositories associated with dependencies",
+    "!   --compilecache=x Directory used to cache compiled objects between workunits",
     "!   --component   Set the name of the component this is executing on behalf of",
 #ifdef _WIN32
     "!   -brk <n>      Trigger a break point in eclcc after nth allocation",
@@ -134,6 +134,9 @@ private:
 
 static bool useChildProcesses = false;      // Use k8s jobs for compile tasks
 static unsigned childProcessTimeLimit = 0;  // If using k8s jobs to compile, try a child process first but abort if it takes longer than this time (seconds)
+static StringAttr compileCacheDir;          // Directory used to cache compiled objects between workunits
+static offset_t compileCacheMaxSize = 0;
+static Owned<ICompiledObjectCache> compiledObjectCache;
 
 class AbortWaiter : public Thread
 {
@@ -244,6 +247,9 @@ class EclccCompileThread : implements IPooledThread, implements IErrorReporter,
     StringBuffer repoRootPath;
     unsigned defaultMaxCompileThreads = 1;
     bool saveTemps = false;
+    RelaxedAtomic<unsigned> numCacheHits{0};
+    RelaxedAtomic<unsigned> numCacheMisses{0};
+    RelaxedAtomic<unsigned __int64> cacheSavedNs{0};
 
     virtual void reportError(IException *e)
     {
@@ -446,10 +452,27 @@ class EclccCompileThread : implements IPooledThread, implements IErrorReporter,
         }
         else if (!alreadyFailed)
         {
+            StringBuffer cacheKey, source, object;
+            if (compiledObjectCache && extractCompileFilenames(line, source, object))
+            {
+                unsigned __int64 savedNs;
+                if (compiledObjectCache->restore(line, source, object, cacheKey, savedNs))
+                {
+                    DBGLOG("Using cached object for %s", source.str());
+                    numCacheHits++;
+                    cacheSavedNs.fetch_add(savedNs);
+                    return 0;
+                }
+                numCacheMisses++;
+            }
+
             DBGLOG("Executing %s", line);
+            CCycleTimer compileTimer;
             unsigned retcode = doRunCompileCommand(abortWaiter, output, line);
             if (retcode)
                 DBGLOG("Error: retcode=%u executing %s", retcode, line);
+            else if (cacheKey.length())
+                compiledObjectCache->add(cacheKey, object, compileTimer.elapsedNs());
             return retcode;
         }
         return 0;
@@ -478,6 +501,9 @@ class EclccCompileThread : implements IPooledThread, implements IErrorReporter,
         }
         unsigned lineIdx = 0;
         StringBuffer output;
+        numCacheHits = 0;
+        numCacheMisses = 0;
+        cacheSavedNs = 0;
         if (streq(lines.item(lineIdx), "#compile"))
         {
             lineIdx++;
@@ -686,6 +712,8 @@ class EclccCompileThread : implements IPooledThread, implements IErrorReporter,
             workunit->setStatistic(queryStatisticsComponentType(), queryStatisticsComponentName(), SSTcompilestage, "compile", StWhenStarted, NULL, getTimeStampNowValue(), 1, 0, StatsMergeAppend);
             eclccCmd.appendf(" -Sx %s.cc", wuid);
         }
+        else if (compileCacheDir)
+            eclccCmd.append(" --compilecache=").append(compileCacheDir);
         if (workunit->getResultLimit())
         {
             eclccCmd.appendf(" -fapplyInstantEclTransformations=1 -fapplyInstantEclTransformationsLimit=%u", workunit->getResultLimit());
@@ -721,6 +749,25 @@ class EclccCompileThread : implements IPooledThread, implements IErrorReporter,
                 retcode = doCompileCpp(abortWaiter, wuid, workunit->getDebugValueInt("maxCompileThreads", defaultMaxCompileThreads));
                 unsigned __int64 elapsed_compilecpp = cycle_to_nanosec(get_cycles_now() - startCompileCpp);
                 workunit->setStatistic(queryStatisticsComponentType(), queryStatisticsComponentName(), SSTcompilestage, "compile:compile c++", StTimeElapsed, NULL, elapsed_compilecpp, 1, 0, StatsMergeReplace);
+                if (numCacheHits || numCacheMisses)
+                {
+                    workunit->setStatistic(queryStatisticsComponentType(), queryStatisticsComponentName(), SSTcompilestage, "compile:compile c++", StNumCompileCacheHits, NULL, numCacheHits, 1, 0, StatsMergeReplace);
+                    workunit->setStatistic(queryStatisticsComponentType(), queryStatisticsComponentName(), SSTcompilestage, "compile:compile c++", StNumCompileCacheMisses, NULL, numCacheMisses, 1, 0, StatsMergeReplace);
+                    workunit->setStatistic(queryStatisticsComponentType(), queryStatisticsComponentName(), SSTcompilestage, "compile:compile c++", StTimeCompileCacheSaved, NULL, cacheSavedNs, 1, 0, StatsMergeReplace);
+                }
+            }
+            if (compiledObjectCache)
+            {
+                //Trim the cache after each compile - including those that compiled within eclcc
+                try
+                {
+                    compiledObjectCache->purge(compileCacheMaxSize);
+                }
+                catch (IException * e)
+                {
+                    EXCLOG(e, "Purging compiled object cache");
+                    e->Release();
+                }
             }
             if (compileCppSeparately)
             {
@@ -1410,6 +1457,13 @@ int main(int argc, const char *argv[])
 #endif
 #endif
 
+    compileCacheDir.set(globals->queryProp("@compileCacheDir"));
+    if (compileCacheDir)
+    {
+        compileCacheMaxSize = (offset_t)globals->getPropInt64("@compileCacheMaxSizeMB", 1024) * 0x100000;
+        compiledObjectCache.setown(createCompiledObjectCache(compileCacheDir));
+    }
+
     const char *daliServers = globals->queryProp("@daliServers");
     if (!daliServers)
     {
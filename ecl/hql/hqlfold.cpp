@@ -2418,6 +2418,10 @@ static bool hashElement(node_operator op, IHqlExpression * expr, unsigned __int6
 
 static IHqlExpression * foldHashXX(IHqlExpression * expr)
 {
+    //Internal hashes use a different (non-persistent) hash function, which is only evaluated at runtime
+    if (expr->hasAttribute(fastAtom))
+        return NULL;
+
     IHqlExpression * child = expr->queryChild(0);
     node_operator op = expr->getOperator();
 
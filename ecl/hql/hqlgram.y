@@ -11391,6 +11391,7 @@ xmlParseFlag
                             parser->normalizeExpression($3, type_string, false);
                             $$.setExpr(createExprAttribute(xmlAtom, $3.getExpr()));
                         }
+    | commonAttribute
     ;
 
 startGROUP
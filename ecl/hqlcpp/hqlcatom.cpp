@@ -421,6 +421,10 @@ IIdAtom * IIndirectMemberVisitor_visitRowId;
 IIdAtom * IIndirectMemberVisitor_visitRowsetId;
 IIdAtom * initProcessId;
 IIdAtom * intFormatId;
+IIdAtom * internalHash32DataId;
+IIdAtom * internalHash32Data4Id;
+IIdAtom * internalHash32Data8Id;
+IIdAtom * internalHash32VStrId;
 IIdAtom * isResultId;
 IIdAtom * keyUnicodeXId;
 IIdAtom * keyUnicodeStrengthXId;
@@ -1086,6 +1090,10 @@ MODULE_INIT(INIT_PRIORITY_HQLATOM-1)
     MAKEID(IIndirectMemberVisitor_visitRow);
     MAKEID(IIndirectMemberVisitor_visitRowset);
     intFormatId = createIdAtom("_intformat");
+    MAKEID(internalHash32Data);
+    MAKEID(internalHash32Data4);
+    MAKEID(internalHash32Data8);
+    MAKEID(internalHash32VStr);
     MAKEID(isResult);
     MAKEID(keyUnicodeX);
     MAKEID(keyUnicodeStrengthX);
@@ -419,6 +419,10 @@ extern IIdAtom * IIndirectMemberVisitor_visitRowId;
 extern IIdAtom * IIndirectMemberVisitor_visitRowsetId;
 extern IIdAtom * initProcessId;
 extern IIdAtom * intFormatId;
+extern IIdAtom * internalHash32DataId;
+extern IIdAtom * internalHash32Data4Id;
+extern IIdAtom * internalHash32Data8Id;
+extern IIdAtom * internalHash32VStrId;
 extern IIdAtom * isResultId;
 extern IIdAtom * keyUnicodeXId;
 extern IIdAtom * keyUnicodeStrengthXId;
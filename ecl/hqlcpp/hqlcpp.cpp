@@ -1896,6 +1896,7 @@ void HqlCppTranslator::cacheOptions()
         DebugOption(options.timeTransforms,"timeTransforms", false),
         DebugOption(options.reportDFSinfo,"reportDFSinfo", 0),
         DebugOption(options.useGlobalCompareClass,"useGlobalCompareClass", false),
+        DebugOption(options.generateSortKeyPrefix,"generateSortKeyPrefix", true),
         DebugOption(options.createValueSets,"createValueSets", true),
         DebugOption(options.implicitKeyedDiskFilter,"implicitKeyedDiskFilter", false),
         DebugOption(options.addDefaultBloom,"addDefaultBloom", true),
@@ -9266,8 +9267,8 @@ void HqlCppTranslator::doBuildReturnCompare(BuildCtx & ctx, IHqlExpression * exp
 class HashCodeCreator
 {
 public:
-    HashCodeCreator(HqlCppTranslator & _translator, const CHqlBoundTarget & _target, node_operator _hashKind, bool _optimizeInternal) 
-        : translator(_translator), target(_target), hashKind(_hashKind), optimizeInternal(_optimizeInternal)
+    HashCodeCreator(HqlCppTranslator & _translator, const CHqlBoundTarget & _target, node_operator _hashKind, bool _optimizeInternal, bool _internalHash)
+        : translator(_translator), target(_target), hashKind(_hashKind), optimizeInternal(_optimizeInternal), internalHash(_internalHash)
     {
         prevFunc = NULL;
     }
@@ -9276,6 +9277,16 @@ public:
     //and the generated code size.
     void buildHash(BuildCtx & ctx, IIdAtom * func, IHqlExpression * length, IHqlExpression * ptr)
     {
+        //The internal hash functions are not incremental, so adjacent fields must not be combined - otherwise
+        //the same values in two different layouts (e.g., a row and its extracted key) would hash differently.
+        if (internalHash)
+        {
+            if (func == hash32DataId)
+                func = internalHash32DataId;
+            else if (func == hash32VStrId)
+                func = internalHash32VStrId;
+        }
+
         if ((func == hash32DataId) || (func == hash64DataId))
         {
             ptr = stripTranslatedCasts(ptr);
@@ -9344,6 +9355,17 @@ protected:
             if (func != hash32DataId)
                 length = NULL;
         }
+        else if (func == internalHash32DataId)
+        {
+            unsigned fixedSize = (unsigned)getIntValue(length, 0);
+            switch (fixedSize)
+            {
+            case 4: func = internalHash32Data4Id; break;
+            case 8: func = internalHash32Data8Id; break;
+            }
+            if (func != internalHash32DataId)
+                length = NULL;
+        }
 
         HqlExprArray args;
         if (length)
@@ -9385,6 +9407,7 @@ protected:
     LinkedHqlExpr initialValue;
     node_operator hashKind;
     bool optimizeInternal;
+    bool internalHash;
     IIdAtom * prevFunc;
     OwnedHqlExpr prevLength;
     OwnedHqlExpr prevPtr;
@@ -9401,7 +9424,8 @@ void HqlCppTranslator::doBuildAssignHashCrc(BuildCtx & ctx, const CHqlBoundTarge
     else if (op == no_hash64)
         initialValue.setown(createConstant(createIntValue(HASH64_INIT, 8, false)));
 
-    HashCodeCreator creator(*this, target, op, expr->hasAttribute(internalAtom));
+    bool internalHash = (op == no_hash32) && expr->hasAttribute(fastAtom);
+    HashCodeCreator creator(*this, target, op, expr->hasAttribute(internalAtom), internalHash);
     creator.setInitialValue(initialValue);
     if (child->getOperator() != no_sortlist)
         doBuildAssignHashElement(ctx, creator, child);
@@ -830,6 +830,7 @@ struct HqlCppOptions
     bool                translateDFSlayouts = false;
     bool                timeTransforms = false;
     bool                useGlobalCompareClass = false;
+    bool                generateSortKeyPrefix = false;
     bool                createValueSets = false;
     bool                implicitKeyedDiskFilter = false;
     bool                addDefaultBloom = false;
@@ -1754,6 +1755,7 @@ public:
     void buildActivityFramework(ActivityInstance * instance, bool alwaysExecuted);      // called for all actions
     void buildCompareClass(BuildCtx & ctx, const char * name, IHqlExpression * sortList, const DatasetReference & dataset, StringBuffer & compareFuncName);
     void buildCompareClass(BuildCtx & ctx, const char * name, IHqlExpression * orderExpr, IHqlExpression * datasetLeft, IHqlExpression * datasetRight, IHqlExpression * selSeq);
+    bool buildSortKeyPrefixClass(BuildCtx & ctx, const char * name, IHqlExpression * sortList, const DatasetReference & dataset);
     void buildCompareMemberLR(BuildCtx & ctx, const char * name, IHqlExpression * orderExpr, IHqlExpression * datasetLeft, IHqlExpression * datasetRight, IHqlExpression * selSeq);
     void buildCompareMember(BuildCtx & ctx, const char * name, IHqlExpression * cond, const DatasetReference & dataset);
     void buildOrderedCompare(BuildCtx & ctx, IHqlExpression * dataset, IHqlExpression * sorts, CHqlBoundExpr & bound, IHqlExpression * leftDataset, IHqlExpression * rightDataset);
@@ -1772,7 +1774,7 @@ public:
     void buildDictionaryHashClass(IHqlExpression *record, StringBuffer &lookupHelperName);
     void buildDictionaryHashMember(BuildCtx & ctx, IHqlExpression *dictionary, const char * memberName);
     void buildHashClass(BuildCtx & ctx, const char * name, IHqlExpression * orderExpr, const DatasetReference & dataset);
-    void buildHashOfExprsClass(BuildCtx & ctx, const char * name, IHqlExpression * cond, const DatasetReference & dataset, bool compareToSelf);
+    void buildHashOfExprsClass(BuildCtx & ctx, const char * name, IHqlExpression * cond, const DatasetReference & dataset, bool compareToSelf, bool internalHash);
     void buildInstancePrefix(ActivityInstance * instance);
     void buildInstanceSuffix(ActivityInstance * instance);
     void buildIterateTransformFunction(BuildCtx & ctx, IHqlExpression * boundDataset, IHqlExpression * transform, IHqlExpression * counter, IHqlExpression * selSeq);
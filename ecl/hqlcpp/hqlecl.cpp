@@ -736,6 +736,16 @@ bool HqlDllGenerator::doCompile(ICppCompiler * compiler)
 
         unsigned __int64 elapsed = cycle_to_nanosec(get_cycles_now() - startCycles);
         updateWorkunitStat(wu, SSTcompilestage, "compile:compile c++", StTimeElapsed, NULL, elapsed);
+
+        unsigned cacheHits, cacheMisses;
+        unsigned __int64 cacheSaved;
+        compiler->getObjectCacheStats(cacheHits, cacheMisses, cacheSaved);
+        if (cacheHits || cacheMisses)
+        {
+            updateWorkunitStat(wu, SSTcompilestage, "compile:compile c++", StNumCompileCacheHits, NULL, cacheHits);
+            updateWorkunitStat(wu, SSTcompilestage, "compile:compile c++", StNumCompileCacheMisses, NULL, cacheMisses);
+            updateWorkunitStat(wu, SSTcompilestage, "compile:compile c++", StTimeCompileCacheSaved, NULL, cacheSaved);
+        }
     }
     //Keep the files if there was a compile error.
     if (ok && deleteGenerated)
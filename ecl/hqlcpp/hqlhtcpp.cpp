@@ -5832,10 +5832,17 @@ void HqlCppTranslator::buildCompareClass(BuildCtx & ctx, const char * name, IHql
 }
 
 
-void HqlCppTranslator::buildHashOfExprsClass(BuildCtx & ctx, const char * name, IHqlExpression * cond, const DatasetReference & dataset, bool compareToSelf)
+//If internalHash is set the hash value must never escape the current process (e.g., it is only used for an
+//in-memory hash table), which allows a faster hash function than the stable one used by HASH32 and DISTRIBUTE.
+void HqlCppTranslator::buildHashOfExprsClass(BuildCtx & ctx, const char * name, IHqlExpression * cond, const DatasetReference & dataset, bool compareToSelf, bool internalHash)
 {
-    IHqlExpression * attr = compareToSelf ? createAttribute(internalAtom) : NULL;
-    OwnedHqlExpr hash = createValue(no_hash32, LINK(unsignedType), LINK(cond), attr);
+    HqlExprArray args;
+    args.append(*LINK(cond));
+    if (compareToSelf)
+        args.append(*createAttribute(internalAtom));
+    if (internalHash)
+        args.append(*createAttribute(fastAtom));
+    OwnedHqlExpr hash = createValue(no_hash32, LINK(unsignedType), args);
 
     buildHashClass(ctx, name, hash, dataset);
 }
@@ -5891,7 +5898,7 @@ void HqlCppTranslator::buildDictionaryHashClass(IHqlExpression *record, StringBu
             OwnedHqlExpr keyedSourceList = createValueSafe(no_sortlist, makeSortListType(NULL), keyedSourceFields);
             OwnedHqlExpr keyedDictList = createValueSafe(no_sortlist, makeSortListType(NULL), keyedDictFields);
 
-            buildHashOfExprsClass(classctx, "HashLookup", keyedSourceList, sourceRef, false);
+            buildHashOfExprsClass(classctx, "HashLookup", keyedSourceList, sourceRef, false, false);
 
             OwnedHqlExpr seq = createDummySelectorSequence();
             OwnedHqlExpr leftSelect = createSelector(no_left, source, seq);
@@ -12839,13 +12846,13 @@ ABoundActivity * HqlCppTranslator::doBuildActivityJoinOrDenormalize(BuildCtx & c
     if ((isHashJoin||isLookupJoin|isSmartJoin) && !isAllJoin)
     {
         OwnedHqlExpr leftList = createValueSafe(no_sortlist, makeSortListType(NULL), joinInfo.queryLeftReq());
-        buildHashOfExprsClass(instance->nestedctx, "HashLeft", leftList, lhsDsRef, false);
+        buildHashOfExprsClass(instance->nestedctx, "HashLeft", leftList, lhsDsRef, false, true);
 
         bool canReuseLeftHash = recordTypesMatch(dataset1, dataset2) && arraysMatch(joinInfo.queryLeftReq(), joinInfo.queryRightReq());
         if (!canReuseLeftHash)
         {
             OwnedHqlExpr rightList = createValueSafe(no_sortlist, makeSortListType(NULL), joinInfo.queryRightReq());
-            buildHashOfExprsClass(instance->nestedctx, "HashRight", rightList, rhsDsRef, false);
+            buildHashOfExprsClass(instance->nestedctx, "HashRight", rightList, rhsDsRef, false, true);
         }
         else
             instance->nestedctx.addQuotedLiteral("virtual IHash * queryHashRight() override { return &HashLeft; }");
@@ -14197,8 +14204,8 @@ ABoundActivity * HqlCppTranslator::doBuildActivityAggregate(BuildCtx & ctx, IHql
         OwnedHqlExpr allAggregateFields = createValueSafe(no_sortlist, makeSortListType(NULL), aggregateFields);
         buildCompareMember(instance->nestedctx, "CompareElements", allAggregateFields, outRef);     // compare transformed elements
         doCompareLeftRight(instance->nestedctx, "CompareRowElement", inputRef, outRef, recordFields, aggregateFields);
-        buildHashOfExprsClass(instance->nestedctx, "Hash", allRecordFields, inputRef, true);
-        buildHashOfExprsClass(instance->nestedctx, "HashElement", allAggregateFields, outRef, true);
+        buildHashOfExprsClass(instance->nestedctx, "Hash", allRecordFields, inputRef, true, true);
+        buildHashOfExprsClass(instance->nestedctx, "HashElement", allAggregateFields, outRef, true, true);
     }
     if (passThrough)
     {
@@ -14609,7 +14616,7 @@ ABoundActivity * HqlCppTranslator::doBuildActivityDedup(BuildCtx & ctx, IHqlExpr
 
         OwnedHqlExpr order = createValueSafe(no_sortlist, makeSortListType(NULL), info.equalities);
         buildCompareMember(instance->nestedctx, "Compare", order, DatasetReference(dataset));
-        buildHashOfExprsClass(instance->nestedctx, "Hash", order, DatasetReference(dataset), true);
+        buildHashOfExprsClass(instance->nestedctx, "Hash", order, DatasetReference(dataset), true, true);
 
         bool reuseCompare = false;
         HqlExprArray fields, selects;
@@ -14656,7 +14663,7 @@ ABoundActivity * HqlCppTranslator::doBuildActivityDedup(BuildCtx & ctx, IHqlExpr
             if (!reuseCompare)
             {
                 buildCompareMember(instance->nestedctx, "KeyCompare", keyOrder, DatasetReference(keyDataset, no_activetable, NULL));
-                buildHashOfExprsClass(instance->nestedctx, "KeyHash", keyOrder, DatasetReference(keyDataset, no_activetable, NULL), true);
+                buildHashOfExprsClass(instance->nestedctx, "KeyHash", keyOrder, DatasetReference(keyDataset, no_activetable, NULL), true, true);
                 //virtual ICompare * queryRowKeyCompare()=0; // lhs is a row, rhs is a key
                 doCompareLeftRight(instance->nestedctx, "RowKeyCompare", DatasetReference(dataset), DatasetReference(keyDataset, no_activetable, NULL), info.equalities, selects);
             }
@@ -16588,6 +16595,147 @@ void HqlCppTranslator::buildReturnOrder(BuildCtx & ctx, IHqlExpression *sortList
     doBuildReturnCompare(ctx, order, no_order, false, false);
 }
 
+//Generate an ISortKeyPrefix for the leading components of a sort order that can be represented as memcmp-ordered
+//bytes.  Stops at the first component that cannot be represented, or that is only partially included.  If every
+//component is represented exactly then rows with equal prefixes are known to compare equal.
+bool HqlCppTranslator::buildSortKeyPrefixClass(BuildCtx & ctx, const char * name, IHqlExpression * sortList, const DatasetReference & dataset)
+{
+    OwnedHqlExpr selSeq = createDummySelectorSequence();
+    OwnedHqlExpr rowSelect = dataset.getSelector(no_left, selSeq);
+
+    HqlExprArray values;
+    BoolArray descending;
+    UnsignedArray widths;
+    unsigned prefixSize = 0;
+    bool exact = true;
+    ForEachChild(i, sortList)
+    {
+        IHqlExpression * next = sortList->queryChild(i);
+        bool invert = false;
+        if (next->getOperator() == no_negate)
+        {
+            invert = true;
+            next = next->queryChild(0);
+        }
+
+        ITypeInfo * type = next->queryType();
+        unsigned remaining = MAX_SORT_KEY_PREFIX - prefixSize;
+        unsigned width;
+        bool complete = true;
+        switch (type->getTypeCode())
+        {
+        case type_boolean:
+            width = 1;
+            break;
+        case type_int:
+            width = type->getSize();
+            break;
+        case type_string:
+            if (!isAscii(type))
+                width = 0;
+            else if (type->getSize() == UNKNOWN_LENGTH)
+            {
+                width = remaining;
+                complete = false;
+            }
+            else
+                width = type->getSize();
+            break;
+        case type_data:
+            if (type->getSize() == UNKNOWN_LENGTH)
+            {
+                width = remaining;
+                complete = false;
+            }
+            else
+                width = type->getSize();
+            break;
+        default:
+            width = 0;
+            break;
+        }
+
+        if (width == 0)
+        {
+            exact = false;
+            break;
+        }
+        if (width > remaining)
+        {
+            width = remaining;
+            complete = false;
+        }
+
+        values.append(*dataset.mapScalar(next, rowSelect));
+        descending.append(invert);
+        widths.append(width);
+        prefixSize += width;
+        if (!complete)
+            exact = false;
+        if (!complete || (prefixSize == MAX_SORT_KEY_PREFIX))
+        {
+            if (i+1 != sortList->numChildren())
+                exact = false;
+            break;
+        }
+    }
+
+    if (prefixSize == 0)
+        return false;
+
+    BuildCtx classctx(ctx);
+    IHqlStmt * classStmt = beginNestedClass(classctx, name, "ISortKeyPrefix");
+    classctx.addQuotedF("virtual size32_t getPrefixSize() const override { return %u; }", prefixSize);
+    classctx.addQuotedF("virtual bool isExact() const override { return %s; }", exact ? "true" : "false");
+    {
+        MemberFunction func(*this, classctx, "virtual void buildPrefix(byte * target, const void * _row) const override", MFoptimize);
+        func.ctx.addQuotedLiteral("const unsigned char * row = (const unsigned char *) _row;");
+        func.ctx.associateExpr(constantMemberMarkerExpr, constantMemberMarkerExpr);
+        bindTableCursor(func.ctx, dataset.queryDataset(), "row", no_left, selSeq);
+
+        unsigned offset = 0;
+        ForEachItemIn(iv, values)
+        {
+            IHqlExpression & value = values.item(iv);
+            ITypeInfo * type = value.queryType();
+            unsigned width = widths.item(iv);
+            CHqlBoundExpr bound;
+            buildCachedExpr(func.ctx, &value, bound);
+
+            StringBuffer s;
+            switch (type->getTypeCode())
+            {
+            case type_boolean:
+                s.appendf("target[%u] = ", offset);
+                generateExprCpp(s, bound.expr).append(" ? 1 : 0;");
+                break;
+            case type_int:
+                s.appendf("%s(target+%u, %u, ", type->isSigned() ? "rtlSortPrefixInt" : "rtlSortPrefixUInt", offset, width);
+                generateExprCpp(s, bound.expr).appendf(", %u);", type->getSize());
+                break;
+            case type_string:
+            case type_data:
+                {
+                    OwnedHqlExpr length = getBoundLength(bound);
+                    OwnedHqlExpr address = getElementPointer(bound.expr);
+                    s.appendf("%s(target+%u, %u, ", (type->getTypeCode() == type_string) ? "rtlSortPrefixStr" : "rtlSortPrefixData", offset, width);
+                    generateExprCpp(s, length).append(", ");
+                    generateExprCpp(s, address).append(");");
+                    break;
+                }
+            default:
+                throwUnexpected();
+            }
+            func.ctx.addQuoted(s);
+            if (descending.item(iv))
+                func.ctx.addQuotedF("rtlSortPrefixDescending(target+%u, %u);", offset, width);
+            offset += width;
+        }
+    }
+    endNestedClass(classStmt);
+    return true;
+}
+
 void HqlCppTranslator::doBuildFuncIsSameGroup(BuildCtx & ctx, IHqlExpression * dataset, IHqlExpression * sortlist)
 {
     MemberFunction func(*this, ctx, "virtual bool isSameGroup(const void * _left, const void * _right) override");
@@ -17075,6 +17223,15 @@ ABoundActivity * HqlCppTranslator::doBuildActivitySort(BuildCtx & ctx, IHqlExpre
 
 //  sortlist.setown(spotScalarCSE(sortlist));
     buildCompareFuncHelper(*this, *instance, "compare", sortlist, DatasetReference(dataset));
+    bool hasSortKeyPrefix = false;
+    if ((actKind == TAKsort) && options.generateSortKeyPrefix)
+    {
+        if (buildSortKeyPrefixClass(instance->nestedctx, "sortKeyPrefix", sortlist, DatasetReference(dataset)))
+        {
+            instance->classctx.addQuotedLiteral("virtual ISortKeyPrefix * querySortKeyPrefix() override { return &sortKeyPrefix; }");
+            hasSortKeyPrefix = true;
+        }
+    }
 
     IHqlExpression * record = dataset->queryRecord();
     IAtom * serializeType = diskAtom; //MORE: Does this place a dependency on the implementation?
@@ -17223,6 +17380,8 @@ ABoundActivity * HqlCppTranslator::doBuildActivitySort(BuildCtx & ctx, IHqlExpre
             flags.append("|TAFconstant");
         if (expr->hasAttribute(parallelAtom))
             flags.append("|TAFparallel");
+        if (hasSortKeyPrefix)
+            flags.append("|TAFsortkeyprefix");
 
         if (method)
             doBuildVarStringFunction(instance->startctx, "getAlgorithm", method);
@@ -2249,7 +2249,7 @@ void SourceBuilder::buildGroupAggregateHashHelper(ParentExtract * extractBuilder
         MemberFunction func(translator, classctx, "virtual unsigned hash(const void * _self) override");
         assignLocalExtract(func.ctx, extractBuilder, dataset, "_self");
 
-        OwnedHqlExpr hash = createValue(no_hash32, LINK(unsignedType), LINK(fields), createAttribute(internalAtom));
+        OwnedHqlExpr hash = createValue(no_hash32, LINK(unsignedType), LINK(fields), createAttribute(internalAtom), createAttribute(fastAtom));
         translator.buildReturn(func.ctx, hash);
     }
 
@@ -2400,7 +2400,7 @@ void SourceBuilder::buildGroupAggregateHelpers(ParentExtract * extractBuilder, I
     buildGroupAggregateCompareHelper(extractBuilder, aggregate, recordFields, aggregateFields);
 
     //virtual IHash * queryHashElement()
-    translator.buildHashOfExprsClass(instance->nestedctx, "HashElement", allAggregateFields, outRef, true);
+    translator.buildHashOfExprsClass(instance->nestedctx, "HashElement", allAggregateFields, outRef, true, true);
 
 }
 
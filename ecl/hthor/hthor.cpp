@@ -4087,9 +4087,12 @@ void CHThorGroupSortActivity::createSorter()
     unsigned flags = helper.getAlgorithmFlags();
     sorterIsConst = ((flags & TAFconstant) != 0);
     OwnedRoxieString algoname(helper.getAlgorithm());
+    ISortKeyPrefix * prefix = helper.queryOptSortKeyPrefix();
     if(!algoname)
     {
-        if((flags & TAFunstable) != 0)
+        if(prefix)
+            sorter.setown(new CPrefixSorter(helper.queryCompare(), prefix, false, queryRowManager(), InitialSortElements, CommitStep, this));
+        else if((flags & TAFunstable) != 0)
             sorter.setown(new CQuickSorter(helper.queryCompare(), queryRowManager(), InitialSortElements, CommitStep));
         else
             sorter.setown(new CHeapSorter(helper.queryCompare(), queryRowManager(), InitialSortElements, CommitStep));
@@ -4127,6 +4130,10 @@ void CHThorGroupSortActivity::createSorter()
         sorter.setown(new CParallelStableMergeSorter(helper.queryCompare(), queryRowManager(), InitialSortElements, CommitStep, this));
     else if(stricmp(algoname, "heapsort") == 0)
         sorter.setown(new CHeapSorter(helper.queryCompare(), queryRowManager(), InitialSortElements, CommitStep));
+    else if(stricmp(algoname, "prefixsort") == 0)
+        sorter.setown(new CPrefixSorter(helper.queryCompare(), prefix, false, queryRowManager(), InitialSortElements, CommitStep, this));
+    else if(stricmp(algoname, "parprefixsort") == 0)
+        sorter.setown(new CPrefixSorter(helper.queryCompare(), prefix, true, queryRowManager(), InitialSortElements, CommitStep, this));
     else if(stricmp(algoname, "insertionsort") == 0)
     {
         if((flags & TAFstable) != 0)
@@ -4395,6 +4402,25 @@ void CParallelStableMergeSorter::performSort()
     }
 }
 
+// Prefix sort - falls back to a merge sort if there is no prefix, or the prefix entries cannot be allocated
+
+void CPrefixSorter::performSort()
+{
+    size32_t numRows = rowsToSort.numCommitted();
+    if (numRows)
+    {
+        const void * * rows = rowsToSort.getBlock(numRows);
+        if (!prefix || !prefixsortvec((void * *)rows, numRows, *compare, *prefix, *rowManager, activityId, parallel ? 0 : 1))
+        {
+            if (parallel)
+                parmsortvecstableinplace((void * *)rows, numRows, *compare, (void * *)index);
+            else
+                msortvecstableinplace((void * *)rows, numRows, *compare, (void * *)index);
+        }
+        finger = 0;
+    }
+}
+
 // Heap sort
 
 void CHeapSorter::performSort()
@@ -1240,6 +1240,19 @@ public:
     virtual void performSort();
 };
 
+class CPrefixSorter : public CStableSorter
+{
+public:
+    CPrefixSorter(ICompare * _compare, ISortKeyPrefix * _prefix, bool _parallel, roxiemem::IRowManager * _rowManager, size32_t _initialSize, size32_t _commitDelta, roxiemem::IBufferedRowCallback * _rowCB)
+     : CStableSorter(_compare, _rowManager, _initialSize, _commitDelta, _rowCB), prefix(_prefix), parallel(_parallel) {}
+
+    virtual void performSort();
+
+protected:
+    ISortKeyPrefix * prefix;
+    bool parallel;
+};
+
 class CHeapSorter :  public CSimpleSorterBase
 {
 public:
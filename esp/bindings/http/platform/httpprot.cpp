@@ -51,6 +51,9 @@ CHttpProtocol::CHttpProtocol()
 
 CHttpProtocol::~CHttpProtocol()
 {
+    if (m_requestReader)
+        m_requestReader->stop();
+
     if(http_thread_pool)
     {
         http_thread_pool->Release();
@@ -95,6 +98,13 @@ void CHttpProtocol::init(IPropertyTree * cfg, const char * process, const char *
 
     initPersistentHandler(proc_cfg);
 
+    //Requests are read by the select handler, and only passed to a thread once they have arrived
+    if (!proc_cfg || proc_cfg->getPropBool("@asyncRequestRead", true))
+    {
+        m_requestReader.setown(new CHttpRequestReader(*this, BSOCKET_READ_TIMEOUT));
+        m_requestReader->start();
+    }
+
     Owned<IPropertyTree> proto_cfg = getProtocolConfig(cfg, protocol, process);
     if(proto_cfg)
     {
@@ -134,50 +144,11 @@ bool CHttpProtocol::notifySelected(ISocket *sock,unsigned selected, IPersistentH
                 DBGLOG("HTTP connection from %s:%d on %s socket", peername, port, persistentHandler?"persistent":"new");
     #endif          
 
-                if(m_maxConcurrentThreads > 0)
-                {
-                    // Using Threading pool instead of generating one thread per request.
-                    void ** holder = new void*[7];
-                    holder[0] = (void*)(accepted.getLink());
-                    holder[1] = (void*)apport;
-                    int maxEntityLength = getMaxRequestEntityLength();
-                    holder[2] = (void*)&maxEntityLength;
-                    bool useSSL = false;
-                    holder[3] = (void*)&useSSL;
-                    ISecureSocketContext* ctx = NULL;
-                    holder[4] = (void*)ctx;
-                    holder[5] = (void*)persistentHandler;
-                    holder[6] = (void*)&shouldClose;
-                    try
-                    {
-                        http_thread_pool->start((void*)holder, "", m_threadCreateTimeout > 0?m_threadCreateTimeout*1000:0);
-                    }
-                    catch(...)
-                    {
-                        IERRLOG("Error starting thread from http thread pool.");
-                        if(accepted.get())
-                        {
-                            accepted->close();
-                            //Assumption here is that if start() throws exception, that means the new 
-                            //thread hasn't been started, so there's no other thread holding a link.
-                            CInterface* ci = dynamic_cast<CInterface*>(accepted.get());
-                            if(ci && ci->IsShared())
-                                accepted->Release();
-                        }
-                        delete [] holder;
-                        throw;
-                    }
-                    delete [] holder;
-                }
+                //Wait for the request to arrive before using a thread to process it
+                if (m_requestReader)
+                    m_requestReader->add(accepted, apport, persistentHandler, shouldClose);
                 else
-                {
-                    /* create one thread per request */
-                    CHttpThread *workthread = new CHttpThread(accepted.getLink(), apport, CEspProtocol::getViewConfig(), false, nullptr, persistentHandler);
-                    workthread->setMaxRequestEntityLength(getMaxRequestEntityLength());
-                    workthread->setShouldClose(shouldClose);
-                    workthread->start();
-                    workthread->Release();
-                }
+                    dispatchRequest(accepted, apport, persistentHandler, shouldClose, nullptr);
             }
         }
         else
@@ -199,12 +170,253 @@ bool CHttpProtocol::notifySelected(ISocket *sock,unsigned selected, IPersistentH
     return false;
 }
 
+void CHttpProtocol::dispatchRequest(ISocket* accepted, CEspApplicationPort* apport, IPersistentHandler* persistentHandler, bool shouldClose, MemoryBuffer* preRead)
+{
+    if(m_maxConcurrentThreads > 0)
+    {
+        // Using Threading pool instead of generating one thread per request.
+        void ** holder = new void*[8];
+        holder[0] = (void*)(LINK(accepted));
+        holder[1] = (void*)apport;
+        int maxEntityLength = getMaxRequestEntityLength();
+        holder[2] = (void*)&maxEntityLength;
+        bool useSSL = false;
+        holder[3] = (void*)&useSSL;
+        ISecureSocketContext* ctx = NULL;
+        holder[4] = (void*)ctx;
+        holder[5] = (void*)persistentHandler;
+        holder[6] = (void*)&shouldClose;
+        holder[7] = (void*)preRead;
+        try
+        {
+            http_thread_pool->start((void*)holder, "", m_threadCreateTimeout > 0?m_threadCreateTimeout*1000:0);
+        }
+        catch(...)
+        {
+            IERRLOG("Error starting thread from http thread pool.");
+            accepted->close();
+            //Assumption here is that if start() throws exception, that means the new 
+            //thread hasn't been started, so there's no other thread holding a link.
+            CInterface* ci = dynamic_cast<CInterface*>(accepted);
+            if(ci && ci->IsShared())
+                accepted->Release();
+            delete [] holder;
+            throw;
+        }
+        delete [] holder;
+    }
+    else
+    {
+        /* create one thread per request */
+        CHttpThread *workthread = new CHttpThread(LINK(accepted), apport, CEspProtocol::getViewConfig(), false, nullptr, persistentHandler);
+        workthread->setMaxRequestEntityLength(getMaxRequestEntityLength());
+        workthread->setShouldClose(shouldClose);
+        if (preRead)
+            workthread->setPreRead(*preRead);
+        workthread->start();
+        workthread->Release();
+    }
+}
+
 //IEspProtocol
 const char * CHttpProtocol::getProtocolName()
 {
    return "http_protocol";
 }
 
+/**************************************************************************
+ *  CHttpRequestReader Implementation                                     *
+ **************************************************************************/
+CHttpRequestReader::CHttpRequestReader(CHttpProtocol& protocol, unsigned readTimeoutSecs) : Thread("CHttpRequestReader"), m_protocol(protocol), m_readTimeout(readTimeoutSecs)
+{
+    m_selectHandler.setown(createSocketSelectHandler("HttpRequestReader"));
+}
+
+void CHttpRequestReader::add(ISocket* sock, CEspApplicationPort* apport, IPersistentHandler* persistentHandler, bool shouldClose)
+{
+    Owned<CPendingRequest> pending = new CPendingRequest(sock, apport, persistentHandler, shouldClose);
+    CriticalBlock block(m_critsect);
+    m_pending.setValue(sock, pending.getLink());
+    m_selectHandler->add(sock, SELECTMODE_READ, this);
+}
+
+CHttpRequestReader::CPendingRequest* CHttpRequestReader::removePending(ISocket* sock)
+{
+    CriticalBlock block(m_critsect);
+    Owned<CPendingRequest>* val = m_pending.getValue(sock);
+    if (!val)
+        return nullptr;
+    Linked<CPendingRequest> pending = *val;
+    m_pending.remove(sock);
+    m_selectHandler->remove(sock);
+    return pending.getClear();
+}
+
+void CHttpRequestReader::discard(CPendingRequest* pending)
+{
+    if (pending->persistentHandler)
+        pending->persistentHandler->doneUsing(pending->sock, false);
+    shutdownAndCloseNoThrow(pending->sock);
+}
+
+//Returns true once the data contains the request headers, and either all of the content or as much as is allowed
+//to be pre-read.  Any content that has not been pre-read is read from the socket by the worker thread.
+bool CHttpRequestReader::isPreReadComplete(const MemoryBuffer& data, size32_t maxLength)
+{
+    size32_t len = data.length();
+    if (len >= maxLength)
+        return true;
+
+    const char* start = (const char*)data.toByteArray();
+    const char* end = start + len;
+    const char* cur = start;
+    //Skip any blank lines before the request line
+    while ((cur < end) && ((*cur == '\r') || (*cur == '\n')))
+        cur++;
+    if (cur == end)
+        return false;
+
+    __int64 contentLength = 0;
+    bool contentReadByWorker = false;
+    while (cur < end)
+    {
+        const char* eol = (const char*)memchr(cur, '\n', end - cur);
+        if (!eol)
+            return false;
+        size32_t lineLength = eol - cur;
+        if (lineLength && (cur[lineLength-1] == '\r'))
+            lineLength--;
+        if (lineLength == 0)
+        {
+            if (contentReadByWorker)
+                return true;
+            __int64 requestLength = (eol + 1 - start) + contentLength;
+            return (requestLength <= len) || (requestLength > maxLength);
+        }
+        if (strnicmp(cur, "Content-Length:", 15) == 0)
+        {
+            contentLength = _atoi64(cur + 15);
+            if (contentLength < 0)
+                contentLength = 0;
+        }
+        else if (strnicmp(cur, "Transfer-Encoding:", 18) == 0)
+            contentReadByWorker = true; // chunked content is always read by the worker
+        else if (strnicmp(cur, "Expect:", 7) == 0)
+            contentReadByWorker = true; // the client waits for the worker to send "100 Continue" before sending the content
+        cur = eol + 1;
+    }
+    return false;
+}
+
+bool CHttpRequestReader::notifySelected(ISocket* sock, unsigned selected)
+{
+    Linked<CPendingRequest> pending;
+    {
+        CriticalBlock block(m_critsect);
+        Owned<CPendingRequest>* val = m_pending.getValue(sock);
+        if (!val)
+            return false;
+        pending.set(*val);
+    }
+
+    bool closed = false;
+    try
+    {
+        size32_t avail = sock->avail_read();
+        if (avail == 0)
+            closed = true; // the other end has closed the connection
+        else
+        {
+            MemoryBuffer& data = pending->data;
+            size32_t sizeRead = 0;
+            void* target = data.reserve(avail);
+            sock->readtms(target, 0, avail, sizeRead, 0);
+            data.setLength(data.length() - (avail - sizeRead));
+        }
+    }
+    catch (IException* e)
+    {
+        closed = true;
+        e->Release();
+    }
+
+    if (closed)
+    {
+        Owned<CPendingRequest> removed = removePending(sock);
+        if (removed)
+            discard(removed);
+    }
+    else if (isPreReadComplete(pending->data, maxPreReadLength))
+    {
+        Owned<CPendingRequest> removed = removePending(sock);
+        if (removed)
+        {
+            try
+            {
+                m_protocol.dispatchRequest(removed->sock, removed->apport, removed->persistentHandler, removed->shouldClose, &removed->data);
+            }
+            catch (IException* e)
+            {
+                StringBuffer estr;
+                IERRLOG("Exception(%d, %s) in CHttpRequestReader::notifySelected()", e->errorCode(), e->errorMessage(estr).str());
+                e->Release();
+                discard(removed);
+            }
+        }
+    }
+    return false;
+}
+
+void CHttpRequestReader::start()
+{
+    m_selectHandler->start();
+    Thread::start();
+}
+
+int CHttpRequestReader::run()
+{
+    while (true)
+    {
+        m_waitsem.wait(1000);
+        if (m_stop)
+            break;
+
+        //Close any connections where a complete request has not arrived within the timeout
+        unsigned now = msTick();
+        std::vector<Linked<ISocket>> expired;
+        {
+            CriticalBlock block(m_critsect);
+            for (auto& pi : m_pending)
+            {
+                CPendingRequest* pending = pi.getValue();
+                if (pending && (now - pending->timeAdded > m_readTimeout*1000))
+                    expired.emplace_back(pending->sock);
+            }
+        }
+        for (auto& sock : expired)
+        {
+            Owned<CPendingRequest> removed = removePending(sock);
+            if (removed)
+            {
+                DBGLOG("HTTP request not received on socket %d within %u seconds, closing connection", sock->OShandle(), m_readTimeout);
+                discard(removed);
+            }
+        }
+    }
+    return 0;
+}
+
+void CHttpRequestReader::stop()
+{
+    m_selectHandler->stop(true);
+    m_stop = true;
+    m_waitsem.signal();
+    join(1000);
+
+    CriticalBlock block(m_critsect);
+    m_pending.kill();
+}
+
 /**************************************************************************
  *  CSecureHttpProtocol Implementation                                    *
  **************************************************************************/
@@ -323,7 +535,7 @@ bool CSecureHttpProtocol::notifySelected(ISocket *sock,unsigned selected, IPersi
                     if(m_maxConcurrentThreads > 0)
                     {
                         // Using Threading pool instead of generating one thread per request.
-                        void ** holder = new void*[7];
+                        void ** holder = new void*[8];
                         holder[0] = (void*)accepted.getLink();
                         holder[1] = (void*)apport;
                         int maxEntityLength = getMaxRequestEntityLength();
@@ -333,6 +545,7 @@ bool CSecureHttpProtocol::notifySelected(ISocket *sock,unsigned selected, IPersi
                         holder[4] = (void*)m_ssctx.get();
                         holder[5] = (void*)persistentHandler;
                         holder[6] = (void*)&shouldClose;
+                        holder[7] = nullptr;
                         http_thread_pool->start((void*)holder);
                         delete [] holder;
                     }
@@ -467,6 +680,8 @@ bool CHttpThread::onRequest()
     httpserver->setSocketReturner(this);
     httpserver->setIsSSL(m_is_ssl);
     httpserver->setShouldClose(m_shouldClose);
+    if (m_preRead.length())
+        httpserver->setPreReadRequest(m_preRead);
     httpserver->processRequest();
 
     returnSocket(false);
@@ -514,6 +729,11 @@ void CPooledHttpThread::init(void *param)
     m_ssctx = (ISecureSocketContext*)(((void**)param)[4]);
     m_persistentHandler = (IPersistentHandler*)(((void**)param)[5]);
     m_shouldClose = *(bool*)(((void**)param)[6]);
+    MemoryBuffer* preRead = (MemoryBuffer*)(((void**)param)[7]);
+    if (preRead)
+        m_preRead.swapWith(*preRead);
+    else
+        m_preRead.clear();
     m_httpserver = nullptr;
     m_processAborted = false;
     m_socketReturned = false;
@@ -569,6 +789,8 @@ void CPooledHttpThread::threadmain()
     m_httpserver = httpserver;
     httpserver->setShouldClose(m_shouldClose);
     httpserver->setSocketReturner(this);
+    if (m_preRead.length())
+        httpserver->setPreReadRequest(m_preRead);
     time_t t = time(NULL);  
     initThreadLocal(sizeof(t), &t);
     try
@@ -637,3 +859,76 @@ void CPooledHttpThread::returnSocket()
         IERRLOG("General Exception - CPooledHttpThread::threadmain(), closing socket.");
     }
 }
+
+#ifdef _USE_CPPUNIT
+#include "unittests.hpp"
+
+class HttpRequestReaderTest : public CppUnit::TestFixture
+{
+    CPPUNIT_TEST_SUITE(HttpRequestReaderTest);
+        CPPUNIT_TEST(testPartialHeaders);
+        CPPUNIT_TEST(testContentLength);
+        CPPUNIT_TEST(testChunked);
+        CPPUNIT_TEST(testExpectContinue);
+        CPPUNIT_TEST(testLeadingBlankLines);
+    CPPUNIT_TEST_SUITE_END();
+
+    static constexpr size32_t maxLength = CHttpRequestReader::maxPreReadLength;
+
+    bool isComplete(const char* request, size32_t maxLen = maxLength)
+    {
+        MemoryBuffer data;
+        data.append(strlen(request), request);
+        return CHttpRequestReader::isPreReadComplete(data, maxLen);
+    }
+
+public:
+    void testPartialHeaders()
+    {
+        CPPUNIT_ASSERT(!isComplete(""));
+        CPPUNIT_ASSERT(!isComplete("GET /WsSMC/Activity HTTP/1.1"));
+        CPPUNIT_ASSERT(!isComplete("GET /WsSMC/Activity HTTP/1.1\r\nHost: localhost\r\n"));
+        CPPUNIT_ASSERT(!isComplete("GET /WsSMC/Activity HTTP/1.1\r\nHost: localhost\r\n\r"));
+        CPPUNIT_ASSERT(isComplete("GET /WsSMC/Activity HTTP/1.1\r\nHost: localhost\r\n\r\n"));
+        CPPUNIT_ASSERT(isComplete("GET /WsSMC/Activity HTTP/1.1\nHost: localhost\n\n"));
+        //Anything that fills the pre-read buffer is passed on, complete or not
+        CPPUNIT_ASSERT(isComplete("GET /WsSMC/Activity HTTP/1.1\r\nHost: localhost\r\n", 16));
+    }
+    void testContentLength()
+    {
+        const char* headers = "POST /WsSMC/Activity HTTP/1.1\r\nContent-Length: 10\r\n\r\n";
+        CPPUNIT_ASSERT(!isComplete(headers));
+        CPPUNIT_ASSERT(!isComplete(VStringBuffer("%s01234", headers)));
+        CPPUNIT_ASSERT(isComplete(VStringBuffer("%s0123456789", headers)));
+        CPPUNIT_ASSERT(isComplete("POST /WsSMC/Activity HTTP/1.1\r\ncontent-length: 0\r\n\r\n"));
+        //Content that will not fit in the pre-read buffer is read by the worker
+        VStringBuffer large("POST /WsSMC/Activity HTTP/1.1\r\nContent-Length: %u\r\n\r\n", maxLength);
+        CPPUNIT_ASSERT(isComplete(large));
+    }
+    void testChunked()
+    {
+        CPPUNIT_ASSERT(!isComplete("POST /WsSMC/Activity HTTP/1.1\r\nTransfer-Encoding: chunked\r\n"));
+        CPPUNIT_ASSERT(isComplete("POST /WsSMC/Activity HTTP/1.1\r\nTransfer-Encoding: chunked\r\n\r\n"));
+        CPPUNIT_ASSERT(isComplete("POST /WsSMC/Activity HTTP/1.1\r\nTransfer-Encoding: chunked\r\n\r\n5\r\nab"));
+    }
+    void testExpectContinue()
+    {
+        //The client sends the content once it receives "100 Continue", which is only sent by the worker
+        CPPUNIT_ASSERT(!isComplete("POST /WsSMC/Activity HTTP/1.1\r\nContent-Length: 100\r\nExpect: 100-continue\r\n"));
+        CPPUNIT_ASSERT(isComplete("POST /WsSMC/Activity HTTP/1.1\r\nContent-Length: 100\r\nExpect: 100-continue\r\n\r\n"));
+        CPPUNIT_ASSERT(isComplete("POST /WsSMC/Activity HTTP/1.1\r\nexpect: 100-continue\r\nContent-Length: 100\r\n\r\n"));
+    }
+    void testLeadingBlankLines()
+    {
+        CPPUNIT_ASSERT(!isComplete("\r\n"));
+        CPPUNIT_ASSERT(!isComplete("\r\n\r\nGET /WsSMC/Activity HTTP/1.1\r\n"));
+        CPPUNIT_ASSERT(isComplete("\r\n\r\nGET /WsSMC/Activity HTTP/1.1\r\nHost: localhost\r\n\r\n"));
+        CPPUNIT_ASSERT(!isComplete("\r\nPOST /WsSMC/Activity HTTP/1.1\r\nContent-Length: 4\r\n\r\nab"));
+        CPPUNIT_ASSERT(isComplete("\r\nPOST /WsSMC/Activity HTTP/1.1\r\nContent-Length: 4\r\n\r\nabcd"));
+    }
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION( HttpRequestReaderTest );
+CPPUNIT_TEST_SUITE_NAMED_REGISTRATION( HttpRequestReaderTest, "HttpRequestReaderTest" );
+
+#endif // _USE_CPPUNIT
@@ -51,6 +51,7 @@ private:
     IHttpServerService* m_httpserver = nullptr;
     bool m_socketReturned = false;
     bool m_processAborted = false;
+    MemoryBuffer m_preRead;
 public:
     IMPLEMENT_IINTERFACE;
 
@@ -95,6 +96,7 @@ private:
     bool m_shouldClose = false;
     IHttpServerService* m_httpserver = nullptr;
     bool m_httpSocketReturned = false;
+    MemoryBuffer m_preRead;
     void returnSocket(bool cascade);
 
 public:
@@ -107,14 +109,68 @@ public:
     virtual int getMaxRequestEntityLength() { return m_MaxRequestEntityLength; }
 
     void setShouldClose(bool should) {m_shouldClose = should;}
+    void setPreRead(MemoryBuffer & preRead) {m_preRead.swapWith(preRead);}
     virtual void returnSocket();
 };
 
+class CHttpProtocol;
+
+//Reads requests from new and persistent connections in the select handler, so that a worker thread is only
+//used once a request has arrived.  The headers (and content up to a limit) are passed to the worker pre-read.
+class CHttpRequestReader : implements ISocketSelectNotify, public Thread
+{
+private:
+    class CPendingRequest : public CInterface
+    {
+    public:
+        CPendingRequest(ISocket* _sock, CEspApplicationPort* _apport, IPersistentHandler* _persistentHandler, bool _shouldClose)
+            : sock(_sock), apport(_apport), persistentHandler(_persistentHandler), shouldClose(_shouldClose), timeAdded(msTick()) {}
+
+        Linked<ISocket> sock;
+        CEspApplicationPort* apport;
+        IPersistentHandler* persistentHandler;
+        bool shouldClose;
+        unsigned timeAdded;
+        MemoryBuffer data;
+    };
+    using PendingRequestMap = MapBetween<Linked<ISocket>, ISocket*, Owned<CPendingRequest>, CPendingRequest*>;
+
+    CHttpProtocol& m_protocol;
+    Owned<ISocketSelectHandler> m_selectHandler;
+    PendingRequestMap m_pending;
+    CriticalSection m_critsect;
+    Semaphore m_waitsem;
+    unsigned m_readTimeout;
+    bool m_stop = false;
+
+    CPendingRequest* removePending(ISocket* sock);
+    void discard(CPendingRequest* pending);
+
+public:
+    IMPLEMENT_IINTERFACE_USING(Thread);
+
+    static constexpr size32_t maxPreReadLength = 0x10000;
+
+    CHttpRequestReader(CHttpProtocol& protocol, unsigned readTimeoutSecs);
+
+    void add(ISocket* sock, CEspApplicationPort* apport, IPersistentHandler* persistentHandler, bool shouldClose);
+    void stop();
+    static bool isPreReadComplete(const MemoryBuffer& data, size32_t maxLength);
+
+    //ISocketSelectNotify
+    virtual bool notifySelected(ISocket* sock, unsigned selected) override;
+
+    //Thread
+    virtual void start() override;
+    virtual int run() override;
+};
+
 class esp_http_decl CHttpProtocol : public CEspProtocol
 {
 private:
     int m_maxConcurrentThreads;
     int m_threadCreateTimeout;
+    Owned<CHttpRequestReader> m_requestReader;
 public:
     CHttpProtocol();
     virtual ~CHttpProtocol();
@@ -132,6 +188,7 @@ public:
     virtual void init(IPropertyTree * cfg, const char * process, const char * protocol);
 
     virtual bool notifySelected(ISocket *sock,unsigned selected, IPersistentHandler* persistentHandler, bool shouldClose) override;
+    void dispatchRequest(ISocket* accepted, CEspApplicationPort* apport, IPersistentHandler* persistentHandler, bool shouldClose, MemoryBuffer* preRead);
 //IEspProtocol
     virtual const char * getProtocolName();
 };
@@ -167,6 +167,7 @@ public:
     bool persistentEligible();
     void setIsSSL(bool _isSSL) { isSSL = _isSSL; };
     void setShouldClose(bool should) { shouldClose = should; }
+    void setPreReadRequest(MemoryBuffer & preRead) { m_request->setPreRead(preRead); }
     void setSocketReturner(ISocketReturner* returner)
     {
         m_socketReturner = returner;
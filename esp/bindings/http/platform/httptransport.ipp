@@ -114,6 +114,8 @@ public:
     virtual ~CHttpMessage();
 
     virtual ISocket* getSocket() {return &m_socket;};
+    // Supply data that has already been read from the socket, which is consumed before reading any more
+    void setPreRead(MemoryBuffer & preRead) { m_bufferedsocket.setown(createBufferedSocket(&m_socket, preRead)); }
 
     StringArray &queryHeaders(){return m_headers;}
 
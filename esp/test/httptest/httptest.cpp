@@ -393,6 +393,9 @@ public:
 
 int HttpClient::sendRequest(StringBuffer& req)
 {
+    if(m_connections > 0)
+        return sendConcurrentRequests(req);
+
     int thrds = m_threads;
     if(m_threads > 1)
     {
@@ -446,9 +449,9 @@ int HttpClient::sendRequest(StringBuffer& req)
     return 0;
 }
 
-int HttpClient::sendRequest(int times, HttpStat& stat, StringBuffer& req)
+// Make sure the request headers are terminated by CRLF
+static void normalizeRequest(StringBuffer& req, StringBuffer& request)
 {
-    StringBuffer request;
     if(req.length() <= 2)
     {
         throw MakeStringException(-1, "request too short");
@@ -499,6 +502,12 @@ int HttpClient::sendRequest(int times, HttpStat& stat, StringBuffer& req)
 
     if(seq < req.length())
         request.append(req.length() - seq, req.str() + seq);
+}
+
+int HttpClient::sendRequest(int times, HttpStat& stat, StringBuffer& req)
+{
+    StringBuffer request;
+    normalizeRequest(req, request);
 
     if(httptest_tracelevel > 5)
         fprintf(m_ofile, ">>sending out request to %s:%d for %d times\n", m_host.str(), m_port, times);
@@ -601,6 +610,102 @@ void HttpClient::setDelay(int secs)
     m_delay = secs;
 }
 
+void HttpClient::setConcurrentConnections(int connections)
+{
+    m_connections = connections;
+}
+
+// Open all the connections before any request is complete, sending the first half of each request, waiting for the
+// delay and then sending the rest.  This measures how many slow or idle clients the server can hold at once.
+int HttpClient::sendConcurrentRequests(StringBuffer& req)
+{
+    if(m_use_ssl)
+        throw MakeStringException(-1, "concurrent connections are not supported with ssl");
+
+    StringBuffer request;
+    normalizeRequest(req, request);
+    size32_t firstPartLength = request.length() / 2;
+
+    SocketEndpoint ep;
+    ep.set(m_host.str(), m_port);
+
+    unsigned start = msTick();
+    IArrayOf<ISocket> sockets;
+    int failedConnects = 0;
+    for(int i = 0; i < m_connections; i++)
+    {
+        try
+        {
+            Owned<ISocket> socket = ISocket::connect(ep);
+            socket->write(request.str(), firstPartLength);
+            sockets.append(*socket.getClear());
+        }
+        catch(IException *excpt)
+        {
+            if(httptest_tracelevel > 5)
+            {
+                StringBuffer errMsg;
+                UERRLOG("Error connecting to %s:%d - %d:%s", m_host.str(), m_port, excpt->errorCode(), excpt->errorMessage(errMsg).str());
+            }
+            excpt->Release();
+            failedConnects++;
+        }
+    }
+    unsigned connected = msTick();
+
+    if(m_delay > 0)
+        sleep(m_delay);
+
+    unsigned sendStart = msTick();
+    int failedRequests = 0;
+    ForEachItemIn(idx, sockets)
+    {
+        try
+        {
+            sockets.item(idx).write(request.str() + firstPartLength, request.length() - firstPartLength);
+        }
+        catch(IException *excpt)
+        {
+            excpt->Release();
+        }
+    }
+
+    int responses = 0;
+    __int64 totalresplen = 0;
+    ForEachItemIn(idx2, sockets)
+    {
+        ISocket& socket = sockets.item(idx2);
+        StringBuffer buf;
+        Owned<IByteOutputStream> ostream = createOutputStream(buf);
+        __int64 resplen = receiveData(&socket, ostream.get(), true);
+        if(resplen > 0)
+        {
+            responses++;
+            totalresplen += resplen;
+        }
+        else
+            failedRequests++;
+        if(httptest_tracelevel > 10)
+            fprintf(m_ofile, "%s%s%s\n", sepstr, buf.str(), sepstr);
+        shutdownAndCloseNoThrow(&socket);
+    }
+    unsigned end = msTick();
+
+    fprintf(m_ofile, ">> Statistics:\n");
+    fprintf(m_ofile, "%s", sepstr);
+    fprintf(m_ofile, "Connections requested:            %d\n", m_connections);
+    fprintf(m_ofile, "Connections opened:               %d\n", sockets.ordinality());
+    fprintf(m_ofile, "Connections failed:               %d\n", failedConnects);
+    fprintf(m_ofile, "Time to open(millisecond):        %u\n", connected - start);
+    fprintf(m_ofile, "Responses received:               %d\n", responses);
+    fprintf(m_ofile, "Requests failed:                  %d\n", failedRequests);
+    fprintf(m_ofile, "Total data received:              %" I64F "d\n", totalresplen);
+    fprintf(m_ofile, "Time to respond(millisecond):     %u\n", end - sendStart);
+    fprintf(m_ofile, "%s", sepstr);
+
+    return 0;
+}
+
 //=======================================================================================================
 // class HttpServer
 
@@ -69,8 +69,11 @@ private:
     bool         m_use_ssl = false;
     Owned<ISecureSocketContext> m_ssctx;
     int          m_delay = 0;
+    int          m_connections = 0;
     HttpStat     m_stat;
 
+    int sendConcurrentRequests(StringBuffer& req);
+
 public:
     HttpClient(int threads, int times, FILE* ofile);
     HttpClient(int threads, int times, const char* host, int port, FILE* ofile, bool use_ssl, IPropertyTree* sslconfig);
@@ -80,6 +83,7 @@ public:
     int getUrl(const char* url);
     int sendSoapRequest(const char* url, const char* soapaction, const char* infile);
     void setDelay(int secs);
+    void setConcurrentConnections(int connections);
     HttpStat& getStat() {return m_stat;}
 };
 
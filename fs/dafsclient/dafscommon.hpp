@@ -19,7 +19,7 @@
 #define DAFSCOMMON_HPP
 
 #define DAFILESRV_VERSION_MAJOR 2
-#define DAFILESRV_VERSION_MINOR 7
+#define DAFILESRV_VERSION_MINOR 8
 #define MAJORMINOR(MAJOR, MINOR) MAJOR ## MINOR
 #define DAFILESRV_VERSION_JOIN(X, Y) MAJORMINOR(X, Y)
 #define DAFILESRV_VERSION DAFILESRV_VERSION_JOIN(DAFILESRV_VERSION_MAJOR, DAFILESRV_VERSION_MINOR)
@@ -93,6 +93,8 @@ enum
     RFCStreamReadJSON = '{',
 // 2.6
     RFCFtSlaveCmd,
+// 2.8
+    RFCStreamPipelined,                            // as RFCStreamGeneral, but tagged, so several can be in flight per connection
     RFCmaxnormal,
     RFCmax,
     RFCunknown = 255 // 0 would have been more sensible, but can't break backward compatibility
@@ -112,7 +114,8 @@ enum DAFS_ERROR_CODES {
     DAFSERR_cmd_unauthorized                = -11,
     DAFSERR_cmdstream_unknownwritehandle    = -12,
     DAFSERR_cmdstream_generalwritefailure   = -13,
-    DAFSERR_serveraccept_fail_portcheck     = -14
+    DAFSERR_serveraccept_fail_portcheck     = -14,
+    DAFSERR_pipelined_request_lost          = -15
 };
 
 
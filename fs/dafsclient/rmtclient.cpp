@@ -817,6 +817,8 @@ void CRemoteBase::connectSocket(SocketEndpoint &ep, unsigned connectTimeoutMs, u
 void CRemoteBase::killSocket(SocketEndpoint &tep)
 {
     // NB: always called with CRemoteBase::crit locked
+    pendingTags.kill(); // any outstanding replies are lost with the socket
+    discardedTags.kill();
     try
     {
         Owned<ISocket> s = socket.getClear();
@@ -834,6 +836,8 @@ void CRemoteBase::killSocket(SocketEndpoint &tep)
 void CRemoteBase::sendRemoteCommand(MemoryBuffer & src, MemoryBuffer & reply, bool retry, bool lengthy, bool handleErrCode)
 {
     CriticalBlock block(crit);  // serialize commands on same file
+    if (pendingTags.ordinality())
+        drainPipelinedReplies(); // the replies to any pipelined requests precede the reply to this command
     SocketEndpoint tep(ep);
     setDafsEndpointPort(tep);
     unsigned nretries = retry?3:0;
@@ -939,49 +943,113 @@ void CRemoteBase::sendRemoteCommand(MemoryBuffer & src, MemoryBuffer & reply, bo
     unsigned errCode;
     reply.read(errCode);
     if (errCode)
+        throwReplyError(errCode, reply);
+}
+
+void CRemoteBase::throwReplyError(unsigned errCode, MemoryBuffer &reply)
+{
+    // old Solaris daliservix.cpp error code conversion
+    if ( (errCode >= 8200) && (errCode <= 8210) )
+        errCode = mapDafilesrvixCodes(errCode);
+    StringBuffer msg;
+    if (filename.get())
+        msg.append(filename);
+    ep.getEndpointHostText(msg.append('[')).append("] ");
+    size32_t pos = reply.getPos();
+    if (pos<reply.length())
     {
-        // old Solaris daliservix.cpp error code conversion
-        if ( (errCode >= 8200) && (errCode <= 8210) )
-            errCode = mapDafilesrvixCodes(errCode);
-        StringBuffer msg;
-        if (filename.get())
-            msg.append(filename);
-        ep.getEndpointHostText(msg.append('[')).append("] ");
-        size32_t pos = reply.getPos();
-        if (pos<reply.length())
+        size32_t len = reply.length()-pos;
+        const byte *rest = reply.readDirect(len);
+        if (errCode==RFSERR_InvalidCommand)
         {
-            size32_t len = reply.length()-pos;
-            const byte *rest = reply.readDirect(len);
-            if (errCode==RFSERR_InvalidCommand)
-            {
-                const char *s = (const char *)rest;
-                const char *e = (const char *)rest+len;
-                while (*s&&(s!=e))
-                    s++;
-                msg.append(s-(const char *)rest,(const char *)rest);
-            }
-            else if (len&&(rest[len-1]==0))
-                msg.append((const char *)rest);
-            else
-            {
-                msg.appendf("extra data[%d]",len);
-                for (unsigned i=0;(i<16)&&(i<len);i++)
-                    msg.appendf(" %2x",(int)rest[i]);
-            }
+            const char *s = (const char *)rest;
+            const char *e = (const char *)rest+len;
+            while (*s&&(s!=e))
+                s++;
+            msg.append(s-(const char *)rest,(const char *)rest);
         }
-        // NB: could append getRFSERRText for all error codes
-        else if (errCode == RFSERR_GetDirFailed)
-            msg.append(RFSERR_GetDirFailed_Text);
+        else if (len&&(rest[len-1]==0))
+            msg.append((const char *)rest);
         else
-            msg.append("ERROR #").append(errCode);
+        {
+            msg.appendf("extra data[%d]",len);
+            for (unsigned i=0;(i<16)&&(i<len);i++)
+                msg.appendf(" %2x",(int)rest[i]);
+        }
+    }
+    // NB: could append getRFSERRText for all error codes
+    else if (errCode == RFSERR_GetDirFailed)
+        msg.append(RFSERR_GetDirFailed_Text);
+    else
+        msg.append("ERROR #").append(errCode);
 #ifdef _DEBUG
-        ERRLOG("%s",msg.str());
-        PrintStackReport();
+    ERRLOG("%s",msg.str());
+    PrintStackReport();
 #endif
-        throw createDafsException(errCode,msg.str());
+    throw createDafsException(errCode,msg.str());
+}
+
+void CRemoteBase::receivePipelinedReply(MemoryBuffer &reply, unsigned &tag)
+{
+    // NB: always called with CRemoteBase::crit locked
+    // Appends the next reply on the socket to reply, leaving the read position at its start
+    size32_t start = reply.length();
+    try
+    {
+        if (!socket)
+        {
+            StringBuffer epStr;
+            throw createDafsExceptionV(DAFSERR_pipelined_request_lost, "Pipelined request to %s lost", ep.getEndpointHostText(epStr).str());
+        }
+        receiveDaFsBuffer(socket, reply, NORMAL_RETRIES);
+    }
+    catch (IException *)
+    {
+        SocketEndpoint tep(ep);
+        setDafsEndpointPort(tep);
+        killSocket(tep);
+        reply.setLength(start);
+        throw;
+    }
+    reply.reset(start);
+    unsigned errCode;
+    reply.read(errCode).read(tag);
+    reply.reset(start);
+    pendingTags.zap(tag);
+}
+
+void CRemoteBase::drainPipelinedReplies()
+{
+    // NB: always called with CRemoteBase::crit locked
+    while (pendingTags.ordinality())
+    {
+        Owned<CPipelinedReply> received = new CPipelinedReply;
+        try
+        {
+            receivePipelinedReply(received->mb, received->tag);
+        }
+        catch (IException *e)
+        {
+            // the socket has been closed, so the next command will reconnect
+            EXCLOG(e, "CRemoteBase::drainPipelinedReplies");
+            e->Release();
+            return;
+        }
+        if (!checkDiscarded(received->tag))
+            receivedReplies.append(*received.getClear());
     }
 }
 
+bool CRemoteBase::checkDiscarded(unsigned tag)
+{
+    // NB: always called with CRemoteBase::crit locked
+    // Returns true (and forgets the tag) if the reply that has just arrived for tag is no longer wanted
+    if (!discardedTags.contains(tag))
+        return false;
+    discardedTags.zap(tag);
+    return true;
+}
+
 void CRemoteBase::sendRemoteCommand(MemoryBuffer & src, bool retry)
 {
     MemoryBuffer reply;
@@ -1007,6 +1075,13 @@ CRemoteBase::CRemoteBase(const SocketEndpoint &_ep, const char *_storageSecret,
 {
 }
 
+CRemoteBase::~CRemoteBase()
+{
+    // Replies to posted requests may still arrive, so the socket cannot be reused by another connection
+    if (pendingTags.ordinality())
+        disconnect();
+}
+
 void CRemoteBase::disconnect()
 {
     CriticalBlock block(crit);
@@ -1088,6 +1163,95 @@ const SocketEndpoint &CRemoteBase::queryEp() const
     return ep;
 }
 
+unsigned CRemoteBase::post(MemoryBuffer &sendMb)
+{
+    CriticalBlock block(crit);
+    if (!socket)
+    {
+        StringBuffer epStr;
+        throw createDafsExceptionV(DAFSERR_pipelined_request_lost, "Cannot post request to %s, not connected", ep.getEndpointHostText(epStr).str());
+    }
+    // the tag follows the length prefix and the RFCStreamPipelined command
+    size32_t tagPos = sizeof(size32_t) + sizeof(RemoteFileCommandType);
+    assertex((sendMb.length() >= tagPos + sizeof(unsigned)) && (RFCStreamPipelined == sendMb.bytes()[sizeof(size32_t)]));
+    unsigned tag = ++lastTag;
+    sendMb.writeEndianDirect(tagPos, sizeof(tag), &tag);
+    try
+    {
+        sendDaFsBuffer(socket, sendMb);
+    }
+    catch (IJSOCK_Exception *)
+    {
+        SocketEndpoint tep(ep);
+        setDafsEndpointPort(tep);
+        killSocket(tep);
+        throw;
+    }
+    pendingTags.append(tag);
+    return tag;
+}
+
+void CRemoteBase::receive(unsigned tag, MemoryBuffer &reply)
+{
+    CriticalBlock block(crit);
+    size32_t start = reply.length();
+    bool found = false;
+    ForEachItemIn(i, receivedReplies)
+    {
+        CPipelinedReply &received = receivedReplies.item(i);
+        if (received.tag == tag)
+        {
+            reply.append(received.mb.length(), received.mb.toByteArray());
+            receivedReplies.remove(i);
+            found = true;
+            break;
+        }
+    }
+    while (!found)
+    {
+        if (!pendingTags.contains(tag))
+        {
+            StringBuffer epStr;
+            throw createDafsExceptionV(DAFSERR_pipelined_request_lost, "Pipelined request to %s lost", ep.getEndpointHostText(epStr).str());
+        }
+        unsigned replyTag;
+        receivePipelinedReply(reply, replyTag);
+        if (replyTag == tag)
+            break;
+        if (!checkDiscarded(replyTag))
+        {
+            // a reply to another request in flight, keep until asked for
+            Owned<CPipelinedReply> received = new CPipelinedReply;
+            received->tag = replyTag;
+            received->mb.append(reply.length()-start, reply.bytes()+start);
+            receivedReplies.append(*received.getClear());
+        }
+        reply.setLength(start);
+    }
+    reply.setEndian(__BIG_ENDIAN);
+    reply.reset(start);
+    unsigned errCode, replyTag;
+    reply.read(errCode).read(replyTag);
+    if (errCode)
+        throwReplyError(errCode, reply);
+}
+
+void CRemoteBase::discard(unsigned tag)
+{
+    CriticalBlock block(crit);
+    ForEachItemIn(i, receivedReplies)
+    {
+        if (receivedReplies.item(i).tag == tag)
+        {
+            receivedReplies.remove(i);
+            return;
+        }
+    }
+    // still on its way, drop it when it arrives
+    if (pendingTags.contains(tag))
+        discardedTags.append(tag);
+}
+
 SocketEndpoint CRemoteBase::lastfailep;
 unsigned CRemoteBase::lastfailtime;
 CriticalSection CRemoteBase::lastFailEpCrit;
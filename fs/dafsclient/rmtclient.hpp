@@ -34,6 +34,7 @@
 
 #define DAFILESRV_STREAMREAD_MINVERSION 22
 #define DAFILESRV_STREAMGENERAL_MINVERSION 25
+#define DAFILESRV_STREAMPIPELINE_MINVERSION 28
 
 typedef int RemoteFileIOHandle;
 // backward compatible modes
@@ -88,6 +89,12 @@ interface IDaFsConnection : extends IInterface
     virtual void send(MemoryBuffer &sendMb, MemoryBuffer &reply) = 0;
     virtual unsigned getVersion(StringBuffer &ver) = 0;
     virtual const SocketEndpoint &queryEp() const = 0;
+
+// Pipelined requests, only if the server version >= DAFILESRV_STREAMPIPELINE_MINVERSION
+// sendMb must be a RFCStreamPipelined command, followed by a placeholder for the tag, which post() fills in.
+    virtual unsigned post(MemoryBuffer &sendMb) = 0;                // sends without waiting for the reply, returns the tag
+    virtual void receive(unsigned tag, MemoryBuffer &reply) = 0;    // appends the reply to a posted request, positioned after the tag
+    virtual void discard(unsigned tag) = 0;                         // the reply to a posted request will not be received, drop it
 };
 
 extern DAFSCLIENT_API IDAFS_Exception *createDafsException(int code, const char *msg);
@@ -149,14 +149,28 @@ extern DAFSCLIENT_API byte traceFlags;
 
 class CRemoteBase : public CSimpleInterfaceOf<IDaFsConnection>
 {
+    struct CPipelinedReply : public CInterface
+    {
+        unsigned tag = 0;
+        MemoryBuffer mb;
+    };
+
     Owned<ISocket>          socket;
     static SocketEndpoint   lastfailep;
     static unsigned         lastfailtime;
     static CriticalSection  lastFailEpCrit;
     DAFSConnectCfg          connectMethod = SSLNone;
+    unsigned                lastTag = 0;
+    UnsignedArray           pendingTags;        // posted requests, whose replies have not been read from the socket yet
+    CIArrayOf<CPipelinedReply> receivedReplies; // replies read while waiting for another reply, or before a plain command
+    UnsignedArray           discardedTags;      // pending requests whose replies are dropped when they arrive
 
     void connectSocket(SocketEndpoint &ep, unsigned connectTimeoutMs=0, unsigned connectRetries=INFINITE, bool secure=false);
     void killSocket(SocketEndpoint &tep);
+    void throwReplyError(unsigned errCode, MemoryBuffer &reply);
+    void receivePipelinedReply(MemoryBuffer &reply, unsigned &tag);
+    void drainPipelinedReplies();
+    bool checkDiscarded(unsigned tag);
 
 protected: friend class CRemoteFileIO;
 
@@ -171,6 +185,7 @@ public:
     CRemoteBase(const SocketEndpoint &_ep, const char * _filename);
     CRemoteBase(const SocketEndpoint &_ep, DAFSConnectCfg _connectMethod, const char * _filename);
     CRemoteBase(const SocketEndpoint &_ep, const char *_storageSecret, const char * _filename);
+    ~CRemoteBase();
 
     void disconnect();
     const char *queryLocalName()
@@ -182,6 +197,9 @@ public:
     virtual void send(MemoryBuffer &sendMb, MemoryBuffer &reply) override;
     virtual unsigned getVersion(StringBuffer &ver) override;
     virtual const SocketEndpoint &queryEp() const override;
+    virtual unsigned post(MemoryBuffer &sendMb) override;
+    virtual void receive(unsigned tag, MemoryBuffer &reply) override;
+    virtual void discard(unsigned tag) override;
 };
 
 typedef enum { ACScontinue, ACSdone, ACSerror} AsyncCommandStatus;
@@ -255,6 +255,8 @@ static const char *getRFCText(RemoteFileCommandType cmd)
 {
     if (cmd==RFCStreamReadJSON)
         return "RFCStreamReadJSON";
+    else if (cmd==RFCStreamPipelined)
+        return "RFCStreamPipelined";
     else
     {
         unsigned elems = sizeof(RFCStrings) / sizeof(RFCStrings[0]);
@@ -841,6 +843,13 @@ class CRemoteRequest : public CSimpleInterfaceOf<IInterface>
     Linked<IExpander> expander;
     MemoryBuffer expandMb;
     Owned<IXmlWriterExt> responseWriter; // for xml or json response
+    CriticalSection crit;               // pipelined requests for the same stream can be processed by different threads
+    MemoryBuffer readAheadMb;           // the next reply, built after the last one was sent
+    MemoryBuffer readAheadCursor;       // cursor at the start of readAheadMb, to rewind to if it cannot be used
+    unsigned __int64 readAheadLimit = 0;
+    bool readAhead = false;
+    bool readAheadReady = false;
+    bool eoi = false;
 
     bool handleFull(MemoryBuffer &inMb, size32_t inPos, MemoryBuffer &compressMb, ICompressor *compressor, size32_t replyLimit, size32_t &totalSz)
     {
@@ -858,7 +867,7 @@ class CRemoteRequest : public CSimpleInterfaceOf<IInterface>
         inMb.setLength(inPos);
         return compressMb.capacity() > replyLimit;
     }
-    void processRead(IPropertyTree *requestTree, MemoryBuffer &responseMb)
+    bool processRead(IPropertyTree *requestTree, MemoryBuffer &responseMb)
     {
         IRemoteReadActivity *readActivity = activity->queryIsReadActivity();
         assertex(readActivity);
@@ -1058,6 +1067,12 @@ class CRemoteRequest : public CSimpleInterfaceOf<IInterface>
                 responseWriter->outputString(cursorBinStr.length(), cursorBinStr.str(), "cursorBin");
             }
         }
+        return eoi;
+    }
+    bool canReadAhead() const
+    {
+        // Fetch continuations supply the next batch of positions, so cannot be read ahead
+        return (outFmt_Binary == format) && activity->queryIsReadActivity() && !activity->queryIsFetchActivity();
     }
     void processWrite(IPropertyTree *requestTree, MemoryBuffer &rowDataMb, MemoryBuffer &responseMb)
     {
@@ -1086,6 +1101,8 @@ public:
     CRemoteRequest(int _cursorHandle, OutputFormat _format, ICompressor *_compressor, IExpander *_expander, IRemoteActivity *_activity)
         : cursorHandle(_cursorHandle), format(_format), compressor(_compressor), expander(_expander), activity(_activity)
     {
+        readAheadMb.setEndian(__BIG_ENDIAN);
+        readAheadCursor.setEndian(__BIG_ENDIAN);
         if (outFmt_Binary != format)
         {
             responseWriter.setown(createIXmlWriterExt(0, 0, nullptr, outFmt_Xml == format ? WTStandard : WTJSONObject));
@@ -1102,8 +1119,11 @@ public:
 
     void process(IPropertyTree *requestTree, MemoryBuffer &restMb, MemoryBuffer &responseMb, CClientStats &stats)
     {
+        CriticalBlock block(crit);
         if (requestTree->hasProp("replyLimit"))
             replyLimit = requestTree->getPropInt64("replyLimit", defaultDaFSReplyLimitKB) * 1024;
+        if (requestTree->hasProp("readAhead"))
+            readAhead = requestTree->getPropBool("readAhead") && canReadAhead();
 
         if (outFmt_Binary == format)
             responseMb.append(cursorHandle);
@@ -1116,10 +1136,26 @@ public:
             cursorMb.setEndian(__BIG_ENDIAN);
             JBASE64_Decode(requestTree->queryProp("cursorBin"), cursorMb);
             activity->restoreCursor(cursorMb);
+            readAheadReady = false;
+            eoi = false;
+        }
+
+        if (readAheadReady)
+        {
+            readAheadReady = false;
+            if (readAheadLimit == replyLimit)
+            {
+                responseMb.append(readAheadMb.length(), readAheadMb.toByteArray());
+                readAheadMb.clear();
+                activity->flushStatistics(stats);
+                return;
+            }
+            activity->restoreCursor(readAheadCursor); // the client has changed the reply limit, so read the block again
+            eoi = false;
         }
 
         if (activity->queryIsReadActivity())
-            processRead(requestTree, responseMb);
+            eoi = processRead(requestTree, responseMb);
         else if (activity->queryIsWriteActivity())
             processWrite(requestTree, restMb, responseMb);
         activity->flushStatistics(stats);
@@ -1132,6 +1168,36 @@ public:
             responseMb.append(responseWriter->length(), responseWriter->str());
         }
     }
+    bool isReadAheadPending()
+    {
+        CriticalBlock block(crit);
+        return readAhead && !readAheadReady && !eoi;
+    }
+    void processReadAhead()
+    {
+        // Called once the previous reply has been sent, so the next continuation can be replied to immediately
+        CriticalBlock block(crit);
+        if (!readAhead || readAheadReady || eoi)
+            return;
+        readAheadCursor.clear();
+        activity->serializeCursor(readAheadCursor);
+        readAheadMb.clear();
+        try
+        {
+            eoi = processRead(nullptr, readAheadMb);
+            readAheadLimit = replyLimit;
+            readAheadReady = true;
+        }
+        catch (IException *e)
+        {
+            // leave the error to be reported by the continuation, if it recurs
+            EXCLOG(e, "CRemoteRequest::processReadAhead");
+            e->Release();
+            readAhead = false;
+            eoi = false;
+            activity->restoreCursor(readAheadCursor);
+        }
+    }
 };
 
 enum OpenFileFlag { of_null=0x0, of_key=0x01 };
@@ -2854,6 +2920,13 @@ class CRemoteFileServer : implements IRemoteFileServer, public CInterface
         unsigned            lasttick, lastInactiveTick;
         std::atomic<unsigned> &globallasttick;
         unsigned            previdx;        // for debug
+        /* Pipelined requests are dispatched inline like RFCStreamGeneral, so a connection's requests are processed in the
+         * order they arrive.  Replies to throttled commands are sent from the throttler's threads though, so sends on
+         * the socket are serialized to stop them interleaving.
+         */
+        CriticalSection     sendCrit;
+        CriticalSection     readAheadCrit;
+        IArrayOf<CRemoteRequest> readAheads;  // streams to read ahead on, once the current reply has been sent
 
 
         IMPLEMENT_IINTERFACE;
@@ -3038,7 +3111,7 @@ class CRemoteFileServer : implements IRemoteFileServer, public CInterface
             initSendBuffer(reply);
             unsigned err = (cmd == RFCopenIO) ? RFSERR_OpenFailed : 0;
             parent->formatException(reply, e, cmd, false, err, this);
-            sendDaFsBuffer(socket, reply);
+            sendReply(reply, false);
             return false;
         }
 
@@ -3049,7 +3122,43 @@ class CRemoteFileServer : implements IRemoteFileServer, public CInterface
 
             // some commands (i.e. RFCFtSlaveCmd), reply early, so should not reply again here.
             if (!hasMask(cmdFlags, CommandRetFlags::replyHandled))
-                sendDaFsBuffer(socket, reply, hasMask(cmdFlags, CommandRetFlags::testSocket));
+                sendReply(reply, hasMask(cmdFlags, CommandRetFlags::testSocket));
+            processReadAheads();
+        }
+
+        void sendReply(MemoryBuffer &reply, bool testSocketFlag)
+        {
+            CriticalBlock block(sendCrit);
+            sendDaFsBuffer(socket, reply, testSocketFlag);
+        }
+
+        void addReadAhead(CRemoteRequest *request)
+        {
+            CriticalBlock block(readAheadCrit);
+            readAheads.append(*LINK(request));
+        }
+
+        void processReadAheads()
+        {
+            for (;;)
+            {
+                Owned<CRemoteRequest> request;
+                {
+                    CriticalBlock block(readAheadCrit);
+                    if (!readAheads.ordinality())
+                        break;
+                    request.setown(&readAheads.popGet());
+                }
+                try
+                {
+                    request->processReadAhead();
+                }
+                catch (IException *e)
+                {
+                    EXCLOG(e, "CRemoteClientHandler::processReadAheads");
+                    e->Release();
+                }
+            }
         }
 
         bool immediateCommand() // returns false if socket closed or failure
@@ -4619,6 +4728,7 @@ public:
      * "handle" - the handle of for a file session that was previously open (for continuation)
      * "commCompression" - compression format of the communication protocol. Supports "LZ4", "LZW", "FLZ" (TBD: "ZLIB")
      * "replyLimit" - Number of K to limit each reply size to. (default 1024)
+     * "readAhead" - if true, once a reply has been sent the next is read ahead, ready for the next continuation. Binary reads only.
      * "node" - contains all 'activity' properties below:
      *
      * For a secured dafilesrv (streaming protocol), requests will only be accepted if the meta blob ("metaInfo") has a matching signature.
@@ -4958,6 +5068,8 @@ public:
                 client.openFiles.append(OpenFileInfo(cursorHandle, remoteRequest, name));
 
                 remoteRequest->process(requestTree, rest, reply, stats);
+                if (remoteRequest->isReadAheadPending())
+                    client.addReadAhead(remoteRequest);
                 return;
             }
             case StreamCmd::CONTINUE:
@@ -4971,6 +5083,8 @@ public:
                     outputFormat = fileInfo.remoteRequest->queryFormat();
 
                     remoteRequest->process(requestTree, rest, reply, stats);
+                    if (remoteRequest->isReadAheadPending())
+                        client.addReadAhead(remoteRequest);
                     return;
                 }
 
@@ -5109,7 +5223,7 @@ public:
         LOG(MCdebugProgress, unknownJob, "Results sent from slave: %s", client.peerName.str());
     }
 
-    void formatException(MemoryBuffer &reply, IException *e, RemoteFileCommandType cmd, bool testSocketFlag, unsigned _dfsErrorCode, CRemoteClientHandler *client)
+    void formatException(MemoryBuffer &reply, IException *e, RemoteFileCommandType cmd, bool testSocketFlag, unsigned _dfsErrorCode, CRemoteClientHandler *client, const unsigned *tag=nullptr)
     {
         unsigned dfsErrorCode = _dfsErrorCode;
         if (!dfsErrorCode)
@@ -5133,6 +5247,8 @@ public:
             reply.append('-');
         else
             reply.append(dfsErrorCode);
+        if (tag)
+            reply.append(*tag);
         reply.append(errMsg.str());
 
         if (client && cmd!=RFCunlock)
@@ -5218,8 +5334,12 @@ public:
         Owned<CClientStats> stats = clientStatsTable.getClientReference(cmd, client->queryPeerName());
         CommandRetFlags retFlags = CommandRetFlags::none;
         unsigned posOfErr = reply.length();
+        unsigned tag = 0; // RFCStreamPipelined replies, including errors, are preceded by the request's tag
         try
         {
+            if (RFCStreamPipelined == cmd)
+                msg.read(tag);
+
             FeatureSupport featureSupportCheck = featureSupport;
 
             /* isRowServiceClient only set for bare-metal clients
@@ -5231,6 +5351,7 @@ public:
             switch (cmd)
             {
                 case RFCStreamGeneral:
+                case RFCStreamPipelined:
                 case RFCStreamRead:
                 case RFCStreamReadJSON:
                     if (!hasMask(featureSupportCheck, FeatureSupport::stream))
@@ -5298,6 +5419,13 @@ public:
                     cmdStreamGeneral(msg, reply, *client, *stats);
                     break;
                 }
+                case RFCStreamPipelined:
+                {
+                    checkAuthorizedStreamCommand(*client);
+                    reply.append(RFEnoerror).append(tag);
+                    cmdStreamGeneral(msg, reply, *client, *stats);
+                    break;
+                }
                 case RFCStreamRead:
                 {
                     checkAuthorizedStreamCommand(*client);
@@ -5329,7 +5457,7 @@ public:
         {
             checkOutOfHandles(e);
             reply.setWritePos(posOfErr);
-            formatException(reply, e, cmd, hasMask(retFlags, CommandRetFlags::testSocket), 0, client);
+            formatException(reply, e, cmd, hasMask(retFlags, CommandRetFlags::testSocket), 0, client, (RFCStreamPipelined == cmd) ? &tag : nullptr);
             e->Release();
         }
         return retFlags;
@@ -5916,6 +6044,7 @@ class RemoteFileSlowTest : public CppUnit::TestFixture
         CPPUNIT_TEST(testBasicFunctionality);
         CPPUNIT_TEST(testCopy);
         CPPUNIT_TEST(testOther);
+        CPPUNIT_TEST(testPipelinedStreamRead);
         CPPUNIT_TEST(testConfiguration);
         CPPUNIT_TEST(testDirectoryMonitoring);
         CPPUNIT_TEST(testFinish);
@@ -6178,6 +6307,162 @@ protected:
             CPPUNIT_ASSERT_MESSAGE("iFile2->setFilePermissions() exception", 0);
         }
     }
+    void buildStreamRequest(MemoryBuffer &sendMb, IPropertyTree *request, RemoteFileCommandType cmd)
+    {
+        initSendBuffer(sendMb.clear());
+        sendMb.append(cmd);
+        if (RFCStreamPipelined == cmd)
+            sendMb.append((unsigned)0); // tag is filled in by post()
+        StringBuffer jsonStr;
+        toJSON(request, jsonStr, 0, 0);
+        sendMb.append((size32_t)jsonStr.length()).append(jsonStr.length(), jsonStr.str());
+    }
+    bool readStreamRows(MemoryBuffer &reply, size32_t rowSize, UnsignedArray &rows)
+    {
+        // Appends the row numbers in a binary stream reply, returns true if the stream has a continuation
+        size32_t rowDataSz;
+        reply.read(rowDataSz);
+        const char *rowData = (const char *)reply.readDirect(rowDataSz);
+        for (size32_t pos=0; pos<rowDataSz; pos+=rowSize)
+        {
+            StringBuffer rowNum;
+            rowNum.append(rowSize, rowData+pos);
+            rows.append(atoi(rowNum));
+        }
+        size32_t cursorSz;
+        reply.read(cursorSz);
+        return 0 != cursorSz;
+    }
+    void readStream(IDaFsConnection &conn, const char *fileName, const char *inputBin, size32_t rowSize, unsigned serverVersion, unsigned maxRows, UnsignedArray &rows)
+    {
+        // Reads the same way as CDFUPartReader, pipelining continuations if the server version supports it, and finalizing
+        // early (with a continuation still in flight) once maxRows have been read.
+        bool pipelined = serverVersion >= DAFILESRV_STREAMPIPELINE_MINVERSION;
+        Owned<IPropertyTree> request = createPTree();
+        request->setProp("format", "binary");
+        request->setPropInt("replyLimit", 1); // 1K, so that the file spans many continuations
+        if (pipelined)
+            request->setPropBool("readAhead", true);
+        IPropertyTree *node = request->setPropTree("node");
+        node->setProp("kind", "diskread");
+        node->setProp("fileName", fileName);
+        node->setProp("inputBin", inputBin);
+
+        MemoryBuffer sendMb, reply;
+        buildStreamRequest(sendMb, request, RFCStreamGeneral);
+        conn.send(sendMb, reply);
+        int handle;
+        reply.read(handle);
+        CPPUNIT_ASSERT(handle != 0);
+
+        Owned<IPropertyTree> continuation = createPTree();
+        continuation->setPropInt("handle", handle);
+        continuation->setProp("format", "binary");
+        unsigned pendingTag = 0;
+        while (true)
+        {
+            bool more = readStreamRows(reply, rowSize, rows);
+            if (more && pipelined)
+            {
+                buildStreamRequest(sendMb, continuation, RFCStreamPipelined);
+                pendingTag = conn.post(sendMb);
+            }
+            if (!more || (rows.ordinality() >= maxRows))
+                break;
+            reply.clear();
+            if (pendingTag)
+            {
+                conn.receive(pendingTag, reply);
+                pendingTag = 0;
+            }
+            else
+            {
+                buildStreamRequest(sendMb, continuation, RFCStreamGeneral);
+                conn.send(sendMb, reply);
+            }
+            int replyHandle;
+            reply.read(replyHandle);
+            CPPUNIT_ASSERT_EQUAL(handle, replyHandle);
+        }
+
+        if (pendingTag)
+            conn.discard(pendingTag);
+        conn.close(handle); // reads the reply to any continuation still in flight
+        if (pendingTag)
+        {
+            // the abandoned reply must have been dropped, rather than kept for a receive that will never come
+            try
+            {
+                conn.receive(pendingTag, reply.clear());
+                CPPUNIT_ASSERT_MESSAGE("Reply to a discarded pipelined request was kept", 0);
+            }
+            catch (IDAFS_Exception *e)
+            {
+                int errCode = e->errorCode();
+                e->Release();
+                CPPUNIT_ASSERT(DAFSERR_pipelined_request_lost == errCode);
+            }
+        }
+    }
+    void testPipelinedStreamRead()
+    {
+        constexpr size32_t rowSize = 8;
+        constexpr unsigned numRows = 5000;
+        VStringBuffer filePath("%s%s", basePath.str(), "pipelined");
+        Owned<IFile> iFile = createIFile(filePath);
+        Owned<IFileIO> iFileIO = iFile->open(IFOcreate);
+        CPPUNIT_ASSERT(iFileIO);
+        StringBuffer fileData;
+        for (unsigned r=0; r<numRows; r++)
+            fileData.appendf("%08u", r);
+        CPPUNIT_ASSERT(iFileIO->write(0, fileData.length(), fileData.str()) == fileData.length());
+        iFileIO.clear();
+
+        RemoteFilename rfn;
+        rfn.setRemotePath(filePath);
+        StringBuffer localPath;
+        rfn.getLocalPath(localPath);
+
+        static const RtlStringTypeInfo rowNumType(type_string, rowSize);
+        static const RtlFieldStrInfo rowNumField("rownum", nullptr, &rowNumType);
+        static const RtlFieldInfo * const fields[] = { &rowNumField, nullptr };
+        static const RtlRecordTypeInfo recordType(type_record, rowSize, fields);
+        MemoryBuffer typeInfoMb;
+        CPPUNIT_ASSERT(dumpTypeInfo(typeInfoMb, &recordType));
+        StringBuffer inputBin;
+        JBASE64_Encode(typeInfoMb.toByteArray(), typeInfoMb.length(), inputBin, false);
+
+        SocketEndpoint ep(serverPort);
+        Owned<IDaFsConnection> conn = createDaFsConnection(ep, SSLNone, "testPipelinedStreamRead");
+        StringBuffer verStr;
+        unsigned serverVersion = conn->getVersion(verStr);
+        CPPUNIT_ASSERT(serverVersion >= DAFILESRV_STREAMPIPELINE_MINVERSION);
+
+        auto checkRows = [](const UnsignedArray &rows, unsigned expected)
+        {
+            CPPUNIT_ASSERT_EQUAL(expected, rows.ordinality());
+            ForEachItemIn(r, rows)
+                CPPUNIT_ASSERT_EQUAL(r, rows.item(r));
+        };
+
+        // a client of a server older than the pipelined protocol sends each continuation and waits for its reply
+        UnsignedArray rows;
+        readStream(*conn, localPath, inputBin, rowSize, DAFILESRV_STREAMPIPELINE_MINVERSION-1, numRows, rows);
+        checkRows(rows, numRows);
+
+        // finalize early with a continuation in flight, then restart on the same connection
+        rows.kill();
+        readStream(*conn, localPath, inputBin, rowSize, serverVersion, 1000, rows);
+        CPPUNIT_ASSERT(rows.ordinality() < numRows);
+        checkRows(rows, rows.ordinality());
+
+        rows.kill();
+        readStream(*conn, localPath, inputBin, rowSize, serverVersion, numRows, rows);
+        checkRows(rows, numRows);
+
+        conn.clear();
+        iFile->remove();
+    }
     void testConfiguration()
     {
         SocketEndpoint ep(serverPort); // test trace open connections
@@ -665,6 +665,8 @@ class CDFUPartReader : public CDaFileSrvClientBase, implements IDFUFilePartReade
     const size32_t replyHdrSize = sizeof(unsigned) + sizeof(unsigned) + sizeof(unsigned); // errCode+handle+rowDataSz
     Linked<IFPosStream> fposStream;
     static constexpr unsigned maxFetchPerBatch = 1000;
+    bool pipelined = false;         // the next continuation is requested as soon as a block arrives
+    unsigned pendingTag = 0;        // tag of the continuation in flight, 0 if none
 
     void ensureAvailable(size32_t oldSz, const void *oldData)
     {
@@ -728,15 +730,20 @@ class CDFUPartReader : public CDaFileSrvClientBase, implements IDFUFilePartReade
 
         return send(tgt);
     }
-    unsigned sendReadContinuation(MemoryBuffer &newReply, IPropertyTree *fetchBatch)
+    IPropertyTree *createContinuationRequest(IPropertyTree *fetchBatch)
     {
-        sendMb.clear();
-        initSendBuffer(sendMb);
-        Owned<IPropertyTree> tree = createPTree();
+        IPropertyTree *tree = createPTree();
         tree->setPropInt("handle", handle);
         tree->setProp("format", "binary");
         if (fetchBatch)
             tree->setPropTree("fetch", LINK(fetchBatch));
+        return tree;
+    }
+    unsigned sendReadContinuation(MemoryBuffer &newReply, IPropertyTree *fetchBatch)
+    {
+        sendMb.clear();
+        initSendBuffer(sendMb);
+        Owned<IPropertyTree> tree = createContinuationRequest(fetchBatch);
         addRequest(tree, RFCStreamRead);
 
         daFsConnection->send(sendMb, newReply);
@@ -744,6 +751,67 @@ class CDFUPartReader : public CDaFileSrvClientBase, implements IDFUFilePartReade
         newReply.read(newHandle);
         return newHandle;
     }
+    bool hasContinuation()
+    {
+        // the continuation cursor (with leading length) follows the row data, and is empty at the end of the stream
+        if (endOfStream)
+            return false;
+        size32_t pos = replyMb.getPos();
+        replyMb.skip(bufRemaining);
+        size32_t cursorLength;
+        replyMb.read(cursorLength);
+        replyMb.reset(pos);
+        return cursorLength != 0;
+    }
+    void postReadContinuation()
+    {
+        // Request the next block now, so that it is on its way whilst this one is being consumed
+        if (!pipelined || pendingTag || !hasContinuation())
+            return;
+        sendMb.clear();
+        initSendBuffer(sendMb);
+        sendMb.append((RemoteFileCommandType)RFCStreamPipelined).append((unsigned)0); // tag is filled in by post()
+        Owned<IPropertyTree> tree = createContinuationRequest(nullptr);
+        markJsonStart();
+        serializeJsonRequest(tree);
+        markJsonEnd();
+        try
+        {
+            pendingTag = daFsConnection->post(sendMb);
+        }
+        catch (IException *e)
+        {
+            EXCLOG(e, "CDFUPartReader: failed to post continuation, no longer pipelining");
+            e->Release();
+            pipelined = false;
+        }
+    }
+    unsigned receiveReadContinuation(MemoryBuffer &newReply)
+    {
+        // Returns 0 if the request was lost with the connection, so that the caller resends the original request with the cursor
+        unsigned tag = pendingTag;
+        pendingTag = 0;
+        try
+        {
+            daFsConnection->receive(tag, newReply);
+        }
+        catch (IJSOCK_Exception *e)
+        {
+            EXCLOG(e, "CDFUPartReader: pipelined continuation failed");
+            e->Release();
+            return 0;
+        }
+        catch (IDAFS_Exception *e)
+        {
+            if (DAFSERR_pipelined_request_lost != e->errorCode())
+                throw;
+            e->Release();
+            return 0;
+        }
+        unsigned newHandle;
+        newReply.read(newHandle);
+        return newHandle;
+    }
     void extendReplyMb(size32_t wanted)
     {
         if (0 == bufRemaining)
@@ -791,7 +859,7 @@ class CDFUPartReader : public CDaFileSrvClientBase, implements IDFUFilePartReade
             fetchBatch.setown(getFPosBatch(batchSize)); // filled if fetching
         }
 
-        unsigned newHandle = sendReadContinuation(newReplyMb, fetchBatch);
+        unsigned newHandle = pendingTag ? receiveReadContinuation(newReplyMb) : sendReadContinuation(newReplyMb, fetchBatch);
         if (newHandle != handle) // dafilesrv did not recognize handle, send cursor
         {
             assertex(newHandle == 0);
@@ -809,6 +877,7 @@ class CDFUPartReader : public CDaFileSrvClientBase, implements IDFUFilePartReade
         }
         replyMb.swapWith(newReplyMb);
         ensureAvailable(oldRemaining, newReplyMb.bytes()+oldRemainingPos); // reads from replyMb, leaves 'oldRemaining' space at front of expanded buffer (if used)
+        postReadContinuation();
     }
     void refill()
     {
@@ -837,7 +906,7 @@ class CDFUPartReader : public CDaFileSrvClientBase, implements IDFUFilePartReade
         }
 
         MemoryBuffer newReply;
-        unsigned newHandle = sendReadContinuation(newReply, fetchBatch);
+        unsigned newHandle = pendingTag ? receiveReadContinuation(newReply) : sendReadContinuation(newReply, fetchBatch);
         if (newHandle == handle)
             replyMb.swapWith(newReply);
         else // dafilesrv did not recognize handle, send cursor
@@ -851,6 +920,7 @@ class CDFUPartReader : public CDaFileSrvClientBase, implements IDFUFilePartReade
             requestTree->removeProp("cursorBin");
         }
         ensureAvailable(0, nullptr); // reads from replyMb
+        postReadContinuation();
     }
 // ISerialStream impl.
     virtual const void *peek(size32_t wanted, size32_t &got) override
@@ -989,13 +1059,25 @@ public:
         eog = false;
         eoi = false;
         pendingFinishRow = false;
+        pendingTag = 0;
+        // Fetch continuations carry the next batch of positions, so are not pipelined
+        pipelined = (serverVersion >= DAFILESRV_STREAMPIPELINE_MINVERSION) && !fposStream;
+        if (pipelined)
+            requestTree->setPropBool("readAhead", true);
         Owned<IPropertyTree> fetchBatch = getFPosBatch(maxFetchPerBatch); // filled if fetching
         handle = sendReadStart(replyMb.clear(), fetchBatch);
         ensureAvailable(0, nullptr); // reads from replyMb
         started = true;
+        postReadContinuation();
     }
     virtual void finalize() override
     {
+        if (pendingTag)
+        {
+            // the continuation in flight is abandoned, its reply is dropped when closing the handle reads it
+            daFsConnection->discard(pendingTag);
+            pendingTag = 0;
+        }
         PARENT::finalize();
     }
     virtual IOutputMetaData *queryMeta() const override
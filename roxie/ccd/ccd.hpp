@@ -439,6 +439,7 @@ extern unsigned defaultFetchPreload;
 extern unsigned defaultFullKeyedJoinPreload;
 extern unsigned defaultKeyedJoinPreload;
 extern unsigned defaultPrefetchProjectPreload;
+extern unsigned defaultIndexReadAhead;
 extern unsigned defaultStrandBlockSize;
 extern unsigned defaultForceNumStrands;
 extern unsigned defaultHeapFlags;
@@ -2428,6 +2428,7 @@ static const StatisticsMapping indexAgentStats({StNumIndexSeeks, StNumIndexScans
                                                 StCycleBlobReadCycles, StCycleLeafReadCycles, StCycleNodeReadCycles, // only need to accumulate cycles in the agents - serialized as times
                                                 StCycleBlobFetchCycles, StCycleLeafFetchCycles, StCycleNodeFetchCycles, // only need to accumulate cycles in the agents - serialized as times
                                                 StNumNodeDiskFetches, StNumLeafDiskFetches, StNumBlobDiskFetches,
+                                                StNumLeafPrefetches, StNumLeafPrefetchHits, StNumLeafPrefetchWasted,
                                                 StNumIndexRowsRead});
 
 class CRoxieIndexActivityFactory : public CRoxieKeyedActivityFactory
@@ -2472,6 +2473,12 @@ protected:
     virtual bool hasNewSegmentMonitors() = 0;
 
     virtual void createSegmentMonitors() = 0;
+    void setReadAhead()
+    {
+        unsigned readAhead = basefactory->queryQueryFactory().queryOptions().indexReadAhead;
+        if (tlk && readAhead)
+            tlk->setReadAhead(readAhead);
+    }
     virtual void setPartNo(bool filechanged)
     {
         if (!lastPartNo.partNo)  // Check for ,LOCAL indexes
@@ -2494,6 +2501,7 @@ protected:
             if (allKeys->numParts())
             {
                 tlk.setown(createKeyMerger(*keyRecInfo, allKeys, 0, &logctx, hasNewSegmentMonitors(), !logctx.isBlind()));
+                setReadAhead();
                 createSegmentMonitorsPending = true;
             }
             else
@@ -2507,6 +2515,7 @@ protected:
             if (filechanged)
             {
                 tlk.setown(createLocalKeyManager(*keyRecInfo, k, &logctx, hasNewSegmentMonitors(), !logctx.isBlind()));
+                setReadAhead();
                 createSegmentMonitorsPending = true;
             }
             else
@@ -2788,7 +2797,10 @@ public:
                 i++;
             }
             if (allKeys->numParts())
+            {
                 tlk.setown(::createKeyMerger(*keyRecInfo, allKeys, steppingOffset, &logctx, hasNewSegmentMonitors(), !logctx.isBlind()));
+                setReadAhead();
+            }
             else
                 tlk.clear();
             createSegmentMonitorsPending = true;
@@ -288,7 +288,11 @@ public:
                         if (isCompressed && !isKey)
                             current.setown(createCompressedFileReader(f));
                         else
-                            current.setown(f->open(IFOread));
+                        {
+                            //Index nodes are cached by jhtree, so caching them in the page cache as well is often wasteful
+                            static bool directIndexIO = getExpertOptBool("directIndexIO", false);
+                            current.setown(f->open(IFOread, (isKey && directIndexIO) ? IFEdirect : IFEnone));
+                        }
                         if (current)
                         {
                             if (doTrace(traceRoxieFiles))
@@ -781,6 +785,13 @@ public:
         noteRead(fileIdx, pos, len, pageType);
     }
 
+    virtual void noteCacheStats(NodeType type, const char * policy, unsigned __int64 hits, unsigned __int64 misses, unsigned __int64 rejections) override
+    {
+        if (doTrace(traceRoxiePrewarm) && (hits || misses))
+            DBGLOG("Node cache(%u) policy(%s) hits(%llu) misses(%llu) rejected(%llu) hit ratio %.2f%%", (unsigned)type, policy, hits, misses, rejections,
+                   (100.0 * hits) / (hits + misses));
+    }
+
 private:
     static StringBuffer &appendRange(StringBuffer &ret, offset_t start, offset_t end, CacheInfoEntry::PageType pageType)
     {
@@ -30,6 +30,7 @@
 #include "jutil.hpp"
 #include "jsecrets.hpp"
 #include "udptopo.hpp"
+#include "ctfile.hpp"
 
 #include "rtlformat.hpp"
 
@@ -167,6 +168,7 @@ unsigned defaultThorConnectTimeout;
 
 unsigned defaultParallelJoinPreload = 0;
 unsigned defaultPrefetchProjectPreload = 10;
+unsigned defaultIndexReadAhead = 0;
 unsigned defaultConcatPreload = 0;
 unsigned defaultFetchPreload = 0;
 unsigned defaultFullKeyedJoinPreload = 0;
@@ -1094,6 +1096,8 @@ int CCD_API roxie_main(int argc, const char *argv[], const char * defaultYaml)
 
         udpFlowSocketsSize = topology->getPropInt("@udpFlowSocketsSize", udpFlowSocketsSize);
         udpLocalWriteSocketSize = topology->getPropInt("@udpLocalWriteSocketSize", udpLocalWriteSocketSize);
+        udpIoBatchSize = topology->getPropInt("@udpIoBatchSize", udpIoBatchSize);
+        udpUseGSO = topology->getPropBool("@udpUseGSO", udpUseGSO);
 #if !defined(_CONTAINERIZED) && !defined(SUBCHANNELS_IN_HEADER)
         roxieMulticastEnabled = topology->getPropBool("@roxieMulticastEnabled", true) && !useAeron;   // enable use of multicast for sending requests to agents
 #endif
@@ -1155,6 +1159,7 @@ int CCD_API roxie_main(int argc, const char *argv[], const char * defaultYaml)
         defaultFullKeyedJoinPreload = topology->getPropInt("@defaultFullKeyedJoinPreload", 0);
         defaultKeyedJoinPreload = topology->getPropInt("@defaultKeyedJoinPreload", 0);
         defaultPrefetchProjectPreload = topology->getPropInt("@defaultPrefetchProjectPreload", 10);
+        defaultIndexReadAhead = topology->getPropInt("@defaultIndexReadAhead", 0);
         defaultStrandBlockSize = topology->getPropInt("@defaultStrandBlockSize", 512);
         defaultForceNumStrands = topology->getPropInt("@defaultForceNumStrands", 0);
         defaultCheckingHeap = topology->getPropBool("@checkingHeap", false);  // NOTE - not in configmgr - too dangerous!
@@ -1272,12 +1277,17 @@ int CCD_API roxie_main(int argc, const char *argv[], const char * defaultYaml)
         inMemoryKeysEnabled = topology->getPropBool("@inMemoryKeysEnabled", true);
 
         setKeyIndexCacheSize((unsigned)-1); // unbound
+        //Set the number of node cache shards before the cache sizes so the cache contents are not discarded.  0 = one per cpu
+        unsigned nodeCacheShards = topology->getPropInt("@nodeCacheShards", 0);
+        setNodeCacheShards(nodeCacheShards ? nodeCacheShards : getAffinityCpus());
         nodeCacheMB = topology->getPropInt("@nodeCacheMem", 100); 
         setNodeCacheMem(nodeCacheMB * 0x100000);
         leafCacheMB = topology->getPropInt("@leafCacheMem", 50);
         setLeafCacheMem(leafCacheMB * 0x100000);
         blobCacheMB = topology->getPropInt("@blobCacheMem", 0);
         setBlobCacheMem(blobCacheMB * 0x100000);
+        setNodeCachePolicy(NodeLeaf, getNodeCachePolicy(topology->queryProp("@leafCachePolicy")));
+        setNodeCachePolicy(NodeBlob, getNodeCachePolicy(topology->queryProp("@blobCachePolicy")));
         if (topology->hasProp("@nodeFetchThresholdNs"))
             setNodeFetchThresholdNs(topology->getPropInt64("@nodeFetchThresholdNs"));
         setIndexWarningThresholds(topology);
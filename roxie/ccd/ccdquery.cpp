@@ -334,6 +334,7 @@ QueryOptions::QueryOptions()
     strandBlockSize = defaultStrandBlockSize;
     forceNumStrands = defaultForceNumStrands;
     heapFlags = defaultHeapFlags;
+    indexReadAhead = defaultIndexReadAhead;
 
     checkingHeap = defaultCheckingHeap;
     disableLocalOptimizations = defaultDisableLocalOptimizations;
@@ -373,6 +374,7 @@ QueryOptions::QueryOptions(const QueryOptions &other)
     strandBlockSize = other.strandBlockSize;
     forceNumStrands = other.forceNumStrands;
     heapFlags = other.heapFlags;
+    indexReadAhead = other.indexReadAhead;
 
     checkingHeap = other.checkingHeap;
     disableLocalOptimizations = other.disableLocalOptimizations;
@@ -422,6 +424,7 @@ void QueryOptions::setFromWorkUnit(IConstWorkUnit &wu, const IPropertyTree *stat
     updateFromWorkUnit(strandBlockSize, wu, "strandBlockSize");
     updateFromWorkUnit(forceNumStrands, wu, "forceNumStrands");
     updateFromWorkUnit(heapFlags, wu, "heapFlags");
+    updateFromWorkUnit(indexReadAhead, wu, "indexReadAhead");
 
     updateFromWorkUnit(checkingHeap, wu, "checkingHeap");
     updateFromWorkUnit(disableLocalOptimizations, wu, "disableLocalOptimizations");
@@ -499,6 +502,7 @@ void QueryOptions::setFromContext(const IPropertyTree *ctx)
         updateFromContext(strandBlockSize, ctx, "@strandBlockSize", "_strandBlockSize");
         updateFromContext(forceNumStrands, ctx, "@forceNumStrands", "_forceNumStrands");
         updateFromContext(heapFlags, ctx, "@heapFlags", "_HeapFlags");
+        updateFromContext(indexReadAhead, ctx, "@indexReadAhead", "_IndexReadAhead");
 
         updateFromContext(checkingHeap, ctx, "@checkingHeap", "_CheckingHeap");
         // Note: disableLocalOptimizations is not permitted at context level (too late)
@@ -98,6 +98,7 @@ public:
     unsigned strandBlockSize;
     unsigned forceNumStrands;
     unsigned heapFlags;
+    unsigned indexReadAhead;
 
     bool checkingHeap;
     bool disableLocalOptimizations;
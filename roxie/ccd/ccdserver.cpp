@@ -409,6 +409,7 @@ static const StatisticsMapping keyedJoinStatistics({ StNumServerCacheHits, StNum
                                                     StCycleBlobFetchCycles, StCycleLeafFetchCycles, StCycleNodeFetchCycles, StTimeBlobFetch, StTimeLeafFetch, StTimeNodeFetch,
                                                     StCycleIndexCacheBlockedCycles, StTimeIndexCacheBlocked,
                                                     StNumNodeDiskFetches, StNumLeafDiskFetches, StNumBlobDiskFetches,
+                                                    StNumLeafPrefetches, StNumLeafPrefetchHits, StNumLeafPrefetchWasted,
                                                     StNumDiskRejected, StSizeAgentReply, StTimeAgentWait, StTimeAgentQueue, StTimeAgentProcess, StTimeIBYTIDelay }, joinStatistics);
 static const StatisticsMapping indexStatistics({StNumServerCacheHits, StNumIndexSeeks, StNumIndexScans, StNumIndexWildSeeks,
                                                 StNumIndexSkips, StNumIndexNullSkips, StNumIndexMerges, StNumIndexMergeCompares,
@@ -420,6 +421,7 @@ static const StatisticsMapping indexStatistics({StNumServerCacheHits, StNumIndex
                                                 StCycleBlobFetchCycles, StCycleLeafFetchCycles, StCycleNodeFetchCycles, StTimeBlobFetch, StTimeLeafFetch, StTimeNodeFetch,
                                                 StCycleIndexCacheBlockedCycles, StTimeIndexCacheBlocked,
                                                 StNumNodeDiskFetches, StNumLeafDiskFetches, StNumBlobDiskFetches,
+                                                StNumLeafPrefetches, StNumLeafPrefetchHits, StNumLeafPrefetchWasted,
                                                 StNumIndexRowsRead, StSizeAgentReply, StTimeAgentWait, StTimeAgentQueue, StTimeAgentProcess, StTimeIBYTIDelay }, actStatistics);
 static const StatisticsMapping diskStatistics({StNumServerCacheHits, StNumDiskRowsRead, StNumDiskSeeks, StNumDiskAccepted,
                                                StNumDiskRejected, StSizeAgentReply, StTimeAgentWait, StTimeAgentQueue, StTimeAgentProcess, StTimeIBYTIDelay }, actStatistics);
@@ -444,6 +446,7 @@ extern const StatisticsMapping accumulatedStatistics({StWhenFirstRow, StTimeLoca
                                                       StCycleBlobReadCycles, StCycleLeafReadCycles, StCycleNodeReadCycles, StTimeBlobRead, StTimeLeafRead, StTimeNodeRead,
                                                       StCycleBlobFetchCycles, StCycleLeafFetchCycles, StCycleNodeFetchCycles, StTimeBlobFetch, StTimeLeafFetch, StTimeNodeFetch,
                                                       StNumNodeDiskFetches, StNumLeafDiskFetches, StNumBlobDiskFetches,
+                                                      StNumLeafPrefetches, StNumLeafPrefetchHits, StNumLeafPrefetchWasted,
                                                       StNumDiskRejected, StSizeAgentReply, StTimeAgentWait,
                                                       StTimeSoapcall,
                                                       StNumGroups,
@@ -8551,7 +8554,7 @@ public:
         if (sortAlgorithm==unknownSortAlgorithm)
             sorter.clear();
         else
-            sorter.setown(createSortAlgorithm(sortAlgorithm, compare, ctx->queryRowManager(), meta, ctx->queryCodeContext(), spillDirectory, activityId));
+            sorter.setown(createSortAlgorithm(sortAlgorithm, compare, ctx->queryRowManager(), meta, ctx->queryCodeContext(), spillDirectory, activityId, helper.queryOptSortKeyPrefix()));
     }
 
     virtual void doStart(unsigned parentExtractSize, const byte *parentExtract, bool paused)
@@ -8568,7 +8571,7 @@ public:
         readInput = false;
     }
 
-    static RoxieSortAlgorithm useAlgorithm(const char *algorithmName, unsigned sortFlags)
+    static RoxieSortAlgorithm useAlgorithm(const char *algorithmName, unsigned sortFlags, bool hasSortKeyPrefix)
     {
         RoxieSortAlgorithm sortAlgorithm = unknownSortAlgorithm;
         if (!algorithmName)
@@ -8613,12 +8616,18 @@ public:
         else if (stricmp(algorithmName, "tbbstableqsort")==0)
             sortAlgorithm = tbbStableQuickSortAlgorithm;
 #endif
+        else if (stricmp(algorithmName, "prefixsort")==0)
+            sortAlgorithm = prefixSortAlgorithm;
+        else if (stricmp(algorithmName, "parprefixsort")==0)
+            sortAlgorithm = parallelPrefixSortAlgorithm;
         else
         {
             if (*algorithmName)
                 OWARNLOG(ROXIE_UNKNOWN_ALGORITHM, "Ignoring unsupported sort order algorithm '%s', using default", algorithmName);
             if (sortFlags & TAFspill)
                 sortAlgorithm = ((sortFlags & TAFunstable) != 0) ? spillingQuickSortAlgorithm : stableSpillingQuickSortAlgorithm;
+            else if (hasSortKeyPrefix)
+                sortAlgorithm = prefixSortAlgorithm;    // stable, so also suitable for unstable sorts
             else if (sortFlags & TAFunstable)
                 sortAlgorithm = quickSortAlgorithm;
             else
@@ -8636,8 +8645,8 @@ public:
             {
                 sorter.clear();
                 OwnedRoxieString algorithmName(helper.getAlgorithm());
-                sortAlgorithm = useAlgorithm(algorithmName, sortFlags);
-                sorter.setown(createSortAlgorithm(sortAlgorithm, compare, ctx->queryRowManager(), meta, ctx->queryCodeContext(), spillDirectory, activityId));
+                sortAlgorithm = useAlgorithm(algorithmName, sortFlags, helper.queryOptSortKeyPrefix() != nullptr);
+                sorter.setown(createSortAlgorithm(sortAlgorithm, compare, ctx->queryRowManager(), meta, ctx->queryCodeContext(), spillDirectory, activityId, helper.queryOptSortKeyPrefix()));
             }
             sorter->prepare(inputStream);
             noteStatistic(StTimeSortElapsed, cycle_to_nanosec(sorter->getElapsedCycles(true)));
@@ -8674,7 +8683,7 @@ public:
         if (!(sortFlags & TAFunstable))
             sortFlags |= TAFstable;    // Assume stable unless specifically requested otherwise
         if (sortFlags & TAFconstant)
-            sortAlgorithm = CRoxieServerSortActivity::useAlgorithm(algorithmName, sortFlags);
+            sortAlgorithm = CRoxieServerSortActivity::useAlgorithm(algorithmName, sortFlags, sortHelper->queryOptSortKeyPrefix() != nullptr);
         else
             sortAlgorithm = unknownSortAlgorithm;
     }
@@ -10285,6 +10294,54 @@ public:
         }
     }
 
+    virtual unsigned nextRows(const void * * rows, unsigned maxRows, bool & eos) override
+    {
+        ActivityTimer t(activityStats, timeActivities);
+        eos = eof;
+        if (eof)
+            return 0;
+        for (;;)
+        {
+            unsigned numIn = inputStream->nextRows(rows, maxRows, eos);
+            if (eos)
+                eof = true;
+            // Filter the block in place
+            unsigned numOut = 0;
+            unsigned i = 0;
+            try
+            {
+                for (; i < numIn; i++)
+                {
+                    const void * row = rows[i];
+                    if (!row)
+                    {
+                        if (anyThisGroup)
+                        {
+                            rows[numOut++] = nullptr;
+                            anyThisGroup = false;
+                        }
+                    }
+                    else if (helper.isValid(row))
+                    {
+                        rows[numOut++] = row;
+                        anyThisGroup = true;
+                        processed++;
+                    }
+                    else
+                        ReleaseRoxieRow(row);
+                }
+            }
+            catch (...)
+            {
+                roxiemem::ReleaseRoxieRowRange(rows, 0, numOut);
+                roxiemem::ReleaseRoxieRowRange(rows, i, numIn);
+                throw;
+            }
+            if (numOut || eos)
+                return numOut;
+        }
+    }
+
     virtual const void * nextRowGE(const void * seek, unsigned numFields, bool &wasCompleteMatch, const SmartStepExtra & stepExtra)
     {
         //Could assert that this isn't grouped
@@ -14979,12 +15036,18 @@ class CRoxieServerStrandedProjectActivity : public CRoxieServerStrandedActivity
     {
     protected:
         IHThorProjectArg &helper;
+        bool eof = false;   // the input has reported the end of the stream to nextRows()
 
     public:
         ProjectProcessor(CRoxieServerActivity &_parent, IEngineRowStream *_inputStream, IHThorProjectArg &_helper)
         : StrandProcessor(_parent, _inputStream, true), helper(_helper)
         {
         }
+        virtual void start() override
+        {
+            StrandProcessor::start();
+            eof = false;
+        }
         virtual const void * nextRow()
         {
             ActivityTimer t(activityStats, timeActivities);
@@ -15019,6 +15082,53 @@ class CRoxieServerStrandedProjectActivity : public CRoxieServerStrandedActivity
                 }
             }
         }
+        virtual unsigned nextRows(const void * * rows, unsigned maxRows, bool & eos) override
+        {
+            ActivityTimer t(activityStats, timeActivities);
+            eos = eof;
+            if (eof)
+                return 0;
+            for (;;)
+            {
+                unsigned numIn = inputStream->nextRows(rows, maxRows, eos);
+                if (eos)
+                    eof = true;
+                // Each output row replaces an input row at the same or an earlier position in the block
+                unsigned numOut = 0;
+                unsigned i = 0;
+                try
+                {
+                    for (; i < numIn; i++)
+                    {
+                        OwnedConstRoxieRow in(rows[i]);
+                        if (!in)
+                        {
+                            if (numProcessedLastGroup != processed)
+                            {
+                                rows[numOut++] = nullptr;
+                                numProcessedLastGroup = processed;
+                            }
+                            continue;
+                        }
+                        RtlDynamicRowBuilder rowBuilder(rowAllocator);
+                        size32_t outSize = helper.transform(rowBuilder, in);
+                        if (outSize)
+                        {
+                            processed++;
+                            rows[numOut++] = rowBuilder.finalizeRowClear(outSize);
+                        }
+                    }
+                }
+                catch (IException *E)
+                {
+                    roxiemem::ReleaseRoxieRowRange(rows, 0, numOut);
+                    roxiemem::ReleaseRoxieRowRange(rows, i+1, numIn);
+                    throw parent.makeWrappedException(E);
+                }
+                if (numOut || eos)
+                    return numOut;
+            }
+        }
     };
 
 public:
@@ -28969,6 +29079,28 @@ public:
 };
 extern "C" IHThorArg * splitActivityTestFactory() { return new SplitActivityTest; }
 
+struct FilterActivityTest : public CThorFilterArg {
+public:
+    virtual IOutputMetaData * queryOutputMeta() { return &testMeta; }
+    virtual bool isValid(const void * _left) { return *(const char *) _left != '3'; }
+};
+extern "C" IHThorArg * filterActivityTestFactory() { return new FilterActivityTest; }
+
+struct ProjectActivityTest : public CThorProjectArg {
+public:
+    virtual IOutputMetaData * queryOutputMeta() { return &testMeta; }
+    virtual bool canFilter() { return true; }
+    virtual size32_t transform(ARowBuilder & rowBuilder, const void * _left)
+    {
+        if (*(const char *) _left == '2')
+            return 0;
+        byte * self = rowBuilder.ensureCapacity(10, NULL);
+        memcpy(self, _left, 10);
+        return 10;
+    }
+};
+extern "C" IHThorArg * projectActivityTestFactory() { return new ProjectActivityTest; }
+
 class CcdServerTest : public CppUnit::TestFixture  
 {
     CPPUNIT_TEST_SUITE(CcdServerTest);
@@ -28979,6 +29111,7 @@ class CcdServerTest : public CppUnit::TestFixture
         CPPUNIT_TEST(testMergeDedup);
         CPPUNIT_TEST(testMiscellaneous);
         CPPUNIT_TEST(testSplitter);
+        CPPUNIT_TEST(testRowBlocks);
         CPPUNIT_TEST(testCleanup);
     CPPUNIT_TEST_SUITE_END();
 protected:
@@ -29372,6 +29505,103 @@ protected:
         doTestSplitter(10);
     }
 
+    // Read a stream using either nextRow() or nextRows(), with '|' recorded for each end of group that is followed by a row
+    static unsigned readStream(IEngineRowStream *stream, bool useBlocks, StringBuffer &result)
+    {
+        unsigned numRows = 0;
+        bool pendingEog = false;
+        bool eos = false;
+        const void * rows[defaultNextRowsBlockSize];
+        while (!eos)
+        {
+            unsigned num;
+            if (useBlocks)
+                num = stream->nextRows(rows, defaultNextRowsBlockSize, eos);
+            else
+            {
+                rows[0] = stream->nextRow();
+                num = 1;
+                if (!rows[0])
+                {
+                    rows[1] = stream->nextRow();
+                    num = rows[1] ? 2 : 0;
+                    eos = (num == 0);
+                }
+            }
+            for (unsigned i=0; i < num; i++)
+            {
+                const char *row = (const char *) rows[i];
+                if (!row)
+                    pendingEog = true;
+                else
+                {
+                    if (pendingEog)
+                        result.append('|');
+                    pendingEog = false;
+                    result.append(row[0]);
+                    ReleaseRoxieRow(row);
+                    numRows++;
+                }
+            }
+        }
+        return numRows;
+    }
+
+    unsigned runFilterProject(IRoxieServerActivity *filter, IRoxieServerActivity *project, TestInput &in, bool useBlocks, StringBuffer &result)
+    {
+        IEngineRowStream *outStream = connectSingleStream(ctx, project->queryOutput(0), 0, true);
+        project->start(0, NULL, false);
+        unsigned numRows = readStream(outStream, useBlocks, result);
+        project->stop();
+        ASSERT(in.state == TestInput::STATEstopped);
+        project->reset();
+        ASSERT(in.state == TestInput::STATEreset);
+        ctx->queryRowManager().reportLeaks();
+        ASSERT(ctx->queryRowManager().numPagesAfterCleanup(true) == 0);
+        return numRows;
+    }
+
+    void testRowBlocks()
+    {
+        DBGLOG("testRowBlocks");
+        init();
+        Owned<IPropertyTree> node = createPTree("node");
+        Owned<IRoxieServerActivityFactory> filterFactory = createRoxieServerFilterActivityFactory(1, 1, *queryFactory, filterActivityTestFactory, TAKfilter, *node);
+        Owned<IRoxieServerActivityFactory> projectFactory = createRoxieServerProjectActivityFactory(2, 1, *queryFactory, projectActivityTestFactory, TAKproject, *node);
+        Owned<IRoxieServerActivity> filter = filterFactory->createActivity(ctx, NULL);
+        Owned<IRoxieServerActivity> project = projectFactory->createActivity(ctx, NULL);
+
+        // The group of 3s is removed by the filter, the 2s by the project
+        const char * grouped[] = { "1", "2", "3", "4", NULL, "3", "3", NULL, "2", NULL, "5", "1", NULL, NULL };
+        TestInput in(ctx, grouped);
+        filter->setInput(0, 0, &in);
+        project->setInput(0, 0, filter->queryOutput(0));
+        filter->onCreate(NULL);
+        project->onCreate(NULL);
+        for (unsigned i = 0; i < 2; i++)
+        {
+            StringBuffer result;
+            runFilterProject(filter, project, in, i != 0, result);
+            ASSERT(streq(result, "14|51"));
+        }
+
+        // A simple graph level benchmark - the per-row overheads dominate for such cheap activities
+        const char * ungrouped[] = { "1", "2", "3", "4", "5", "6", "7", "8", "9", "0", NULL, NULL };
+        TestInput big(ctx, ungrouped);
+        filter->setInput(0, 0, &big);
+        const unsigned repeats = 100000;
+        for (unsigned i = 0; i < 2; i++)
+        {
+            big.repeat = repeats;
+            StringBuffer result;
+            CCycleTimer timer;
+            unsigned numRows = runFilterProject(filter, project, big, i != 0, result);
+            ASSERT(numRows == (repeats+1) * 8);
+            DBGLOG("testRowBlocks: %u rows using %s in %u ms", numRows, i ? "nextRows()" : "nextRow()", timer.elapsedMs());
+        }
+        DBGLOG("testRowBlocks done");
+    }
+
     void testMiscellaneous()
     {
         DBGLOG("sizeof(CriticalSection)=%u", (unsigned) sizeof(CriticalSection));
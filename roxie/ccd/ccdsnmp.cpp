@@ -306,6 +306,9 @@ CRoxieMetricsManager::CRoxieMetricsManager()
     addMetric(nodeCacheHits, 1000);
     addMetric(nodeCacheAdds, 1000);
     addMetric(nodeCacheDups, 1000);
+    addMetric(leafPrefetches, 1000);
+    addMetric(leafPrefetchHits, 1000);
+    addMetric(leafPrefetchWasted, 1000);
 
     addMetric(unwantedDiscarded, 1000);
 
@@ -35,6 +35,15 @@
 # endif
 #endif
 
+#ifdef _USE_NUMA
+#include <numa.h>
+#include <numaif.h>
+#include <sched.h>
+ #if defined(LIBNUMA_API_VERSION) && (LIBNUMA_API_VERSION>=2)
+  #define NUMA_HEAP_PARTITIONS
+ #endif
+#endif
+
 #if defined(_USE_TBB)
  //Only enable for TBB >=3 because code had problems with spawn as a non static function (see HPC-14588)
  #if defined(TBB_VERSION_MAJOR)
@@ -183,6 +192,22 @@ static unsigned heapAllocated;
 static std::atomic_uint dataBufferPages;
 static std::atomic_uint dataBuffersActive;
 
+//The heap can be divided into one contiguous region for each numa node.  The memory for each region is bound to
+//its node, and single pages (the heaplets used by the row managers) are allocated from the region that is local to
+//the allocating thread if possible.  Multiple page allocations ignore the regions.
+const unsigned MAX_HEAP_REGIONS = 16;
+struct HeapRegion
+{
+    unsigned firstWord;  // first word of heapBitmap within this region
+    unsigned endWord;    // word following the end of the region
+    unsigned lwm;        // there are no free pages within [firstWord, lwm)
+    unsigned node;       // the numa node the memory is bound to
+};
+static HeapRegion heapRegions[MAX_HEAP_REGIONS];
+static unsigned heapNumRegions = 0;  // 0 if the heap is not partitioned
+static unsigned heapWordsPerRegion = 0;
+static std::vector<byte> heapCpuRegion; // which region is local to each cpu
+
 const unsigned HEAP_BITS = sizeof(heap_t) * 8;
 const heap_t HEAP_ALLBITS = (heap_t) -1;
 const heap_t TOPBITMASK = ((heap_t)1U)<<(HEAP_BITS-1);
@@ -551,9 +576,115 @@ extern void releaseRoxieHeap()
         heapEnd = NULL;
         heapBitmapSize = 0;
         heapTotalPages = 0;
+        heapNumRegions = 0;
     }
 }
 
+//---------------------------------------------------------------------------------------------------------------------
+
+// Divide the heap into numRegions regions of (almost) equal size, region i associated with node nodes[i]
+static void partitionHeap(unsigned numRegions, const unsigned * nodes)
+{
+    heapNumRegions = 0;
+    if ((numRegions <= 1) || (heapBitmapSize < numRegions))
+        return;
+    heapWordsPerRegion = heapBitmapSize / numRegions;
+    for (unsigned region = 0; region < numRegions; region++)
+    {
+        HeapRegion & cur = heapRegions[region];
+        cur.firstWord = region * heapWordsPerRegion;
+        cur.endWord = (region + 1 == numRegions) ? heapBitmapSize : cur.firstWord + heapWordsPerRegion;
+        cur.lwm = cur.firstWord;
+        cur.node = nodes[region];
+    }
+    heapNumRegions = numRegions;
+}
+
+static inline unsigned queryHeapRegion(unsigned word)
+{
+    unsigned region = word / heapWordsPerRegion;
+    return (region < heapNumRegions) ? region : heapNumRegions - 1;
+}
+
+static inline unsigned queryLocalHeapRegion()
+{
+#ifdef NUMA_HEAP_PARTITIONS
+    int cpu = sched_getcpu();
+    if ((cpu >= 0) && ((unsigned)cpu < heapCpuRegion.size()))
+        return heapCpuRegion[cpu];
+#endif
+    return 0;
+}
+
+extern void setHeapNumaPartitions(bool enable)
+{
+    CriticalBlock b(heapBitCrit);
+    heapNumRegions = 0;
+    if (!enable || !heapBase)
+        return;
+#ifdef NUMA_HEAP_PARTITIONS
+    if (numa_available() == -1)
+    {
+        DBGLOG("RoxieMemMgr: Numa functions not available - heap will not be partitioned");
+        return;
+    }
+
+    //Only use the nodes that have memory, and that have cpus this process can run on
+    unsigned maxCpus = numa_num_configured_cpus();
+    unsigned nodes[MAX_HEAP_REGIONS];
+    unsigned numNodes = 0;
+    std::vector<byte> cpuRegion(maxCpus, 0);
+    for (unsigned cpu=0; cpu < maxCpus; cpu++)
+    {
+        if (!numa_bitmask_isbitset(numa_all_cpus_ptr, cpu))
+            continue;
+        int node = numa_node_of_cpu(cpu);
+        if ((node < 0) || !numa_bitmask_isbitset(numa_all_nodes_ptr, node))
+            continue;
+        unsigned region = 0;
+        while ((region < numNodes) && (nodes[region] != (unsigned)node))
+            region++;
+        if (region == numNodes)
+        {
+            if (numNodes == MAX_HEAP_REGIONS)
+                continue;
+            nodes[numNodes++] = node;
+        }
+        cpuRegion[cpu] = region;
+    }
+
+    partitionHeap(numNodes, nodes);
+    if (!heapNumRegions)
+    {
+        DBGLOG("RoxieMemMgr: Process only uses a single numa node - heap will not be partitioned");
+        return;
+    }
+    heapCpuRegion.swap(cpuRegion);
+
+    for (unsigned region = 0; region < heapNumRegions; region++)
+    {
+        HeapRegion & cur = heapRegions[region];
+        char * start = heapBase + cur.firstWord * heapBlockSize;
+        memsize_t len = (cur.endWord - cur.firstWord) * heapBlockSize;
+        //Prefer (rather than require) the node, so allocations do not fail if a node is short of memory.
+        //Pages that have already been touched are moved if possible.
+        struct bitmask * nodeMask = numa_allocate_nodemask();
+        numa_bitmask_setbit(nodeMask, cur.node);
+        if (mbind(start, len, MPOL_PREFERRED, nodeMask->maskp, nodeMask->size + 1, MPOL_MF_MOVE) != 0)
+            DBGLOG("RoxieMemMgr: Failed to bind heap region %u to numa node %u, errno = %d", region, cur.node, errno);
+        numa_bitmask_free(nodeMask);
+    }
+    DBGLOG("RoxieMemMgr: Heap partitioned into %u numa regions of %u pages", heapNumRegions, heapWordsPerRegion * HEAP_BITS);
+#else
+    DBGLOG("RoxieMemMgr: Numa support not available in this build - heap will not be partitioned");
+#endif
+}
+
+extern unsigned getHeapNumaPartitions()
+{
+    return heapNumRegions;
+}
+
 static void notifyAllUnusedRoxieMem()
 {
     char *blockStart = nullptr;
@@ -669,13 +800,44 @@ extern void memstats(unsigned &totalpg, unsigned &freepg, unsigned &maxblk)
     maxblk = maxBlock;
 }
 
+extern bool numaMemstats(unsigned region, unsigned &node, unsigned &totalpg, unsigned &freepg)
+{
+    CriticalBlock b(heapBitCrit);
+    if (region >= heapNumRegions)
+        return false;
+    const HeapRegion & cur = heapRegions[region];
+    unsigned freePages = 0;
+    for (unsigned i = cur.firstWord; i < cur.endWord; i++)
+    {
+        heap_t t = heapBitmap[i];
+        if (t == HEAP_ALLBITS)
+            freePages += HEAP_BITS;
+        else
+        {
+            while (t)
+            {
+                freePages++;
+                t &= (t - 1);
+            }
+        }
+    }
+    node = cur.node;
+    totalpg = (cur.endWord - cur.firstWord) * HEAP_BITS;
+    freepg = freePages;
+    return true;
+}
+
 extern StringBuffer &memstats(StringBuffer &stats)
 {
     unsigned totalPages;
     unsigned freePages;
     unsigned maxBlock;
     memstats(totalPages, freePages, maxBlock);
-    return stats.appendf("Heap size %u pages, %u free, largest block %u", heapTotalPages, freePages, maxBlock);
+    stats.appendf("Heap size %u pages, %u free, largest block %u", heapTotalPages, freePages, maxBlock);
+    unsigned node;
+    for (unsigned region = 0; numaMemstats(region, node, totalPages, freePages); region++)
+        stats.appendf(", node %u %u allocated %u free", node, totalPages - freePages, freePages);
+    return stats;
 }
 
 #ifdef _USE_CPPUNIT
@@ -792,6 +954,32 @@ static void throwGlobalHeapExhausted(unsigned activityId, unsigned newPages, uns
     throw MakeStringExceptionDirect(ROXIEMM_MEMORY_POOL_EXHAUSTED, msg.str());
 }
 
+static char *suballocRegionPage(HeapRegion & region)
+{
+    // NOTE heapBitCrit MUST be held while here
+    //heapLWM is also a lower bound for the first free page in the region
+    unsigned i = region.lwm > heapLWM ? region.lwm : heapLWM;
+    for (; i < region.endWord; i++)
+    {
+        heap_t hbi = heapBitmap[i];
+        if (hbi)
+        {
+            const unsigned pos = countTrailingUnsetBits(hbi);
+            const unsigned match = i*HEAP_BITS + pos;
+            hbi &= ~(((heap_t)1U) << pos);
+            heapBitmap[i] = hbi;
+            region.lwm = (hbi == 0) ? i+1 : i;
+            heapAllocated++;
+            char *ret = heapBase + match*HEAP_ALIGNMENT_SIZE;
+            if (memTraceLevel >= 2)
+                DBGLOG("RoxieMemMgr: suballoc_aligned() 1 page ok from node %u - addr=%p", region.node, ret);
+            return ret;
+        }
+    }
+    region.lwm = region.endWord;
+    return nullptr;
+}
+
 static void *suballoc_aligned(size32_t pages, bool returnNullWhenExhausted)
 {
     //It would be tempting to make this lock free and use cas, but on reflection I suspect it will perform worse.
@@ -844,6 +1032,14 @@ static void *suballoc_aligned(size32_t pages, bool returnNullWhenExhausted)
 
     if (pages == 1)
     {
+        if (heapNumRegions)
+        {
+            char * ret = suballocRegionPage(heapRegions[queryLocalHeapRegion()]);
+            if (ret)
+                return ret;
+            //Otherwise fall back to the first free page in any region
+        }
+
         unsigned i;
         for (i = heapLWM; i < heapBitmapSize; i++)
         {
@@ -996,6 +1192,7 @@ static bool subfree_aligned(void *ptr, unsigned pages = 1)
 
         if (wordOffset < heapLWM)
             heapLWM = wordOffset;
+        const unsigned firstWord = wordOffset;
 
         for (;;)
         {
@@ -1028,6 +1225,19 @@ static bool subfree_aligned(void *ptr, unsigned pages = 1)
         if (wordOffset >= heapHWM)
             heapHWM = wordOffset+1;
 
+        if (heapNumRegions)
+        {
+            //The pages that were freed may span more than one region
+            unsigned lastRegion = queryHeapRegion(wordOffset);
+            for (unsigned region = queryHeapRegion(firstWord); region <= lastRegion; region++)
+            {
+                HeapRegion & cur = heapRegions[region];
+                unsigned firstFree = (firstWord > cur.firstWord) ? firstWord : cur.firstWord;
+                if (firstFree < cur.lwm)
+                    cur.lwm = firstFree;
+            }
+        }
+
         if (firstReleaseBlock)
             notifyMemoryUnused(firstReleaseBlock, (lastReleaseBlock - firstReleaseBlock) + heapBlockSize);
     }
@@ -2947,6 +3157,96 @@ protected:
     unsigned numRows = 0;
 };
 
+//A blocked row heap that can be shared by multiple threads.  Each thread allocates from its own magazine of rows,
+//which is refilled with a single call to the heap, so the heaplet free lists are only updated once per block.
+//Threads are mapped to magazines by the order they first allocate, so two threads only share a magazine (and its
+//lock) if there are more threads than magazines.
+static std::atomic<unsigned> nextMagazineThread{0};
+static thread_local unsigned magazineThread = (unsigned)-1;
+
+template <class T>
+class CRoxieDirectFixedMagazineRowHeap : public CRoxieDirectFixedRowHeap<T>
+{
+public:
+    CRoxieDirectFixedMagazineRowHeap(CChunkingRowManager * _rowManager, unsigned _allocatorId, RoxieHeapFlags _flags, T * _heap)
+        : CRoxieDirectFixedRowHeap<T>(_rowManager, _allocatorId, _flags, _heap)
+    {
+    }
+
+    virtual void beforeDispose() override
+    {
+        emptyCache();
+        CRoxieDirectFixedRowHeap<T>::beforeDispose();
+    }
+
+    virtual void *allocate()
+    {
+        Magazine & magazine = queryMagazine();
+        NonReentrantSpinBlock block(magazine.lock);
+        if (magazine.curRow == magazine.numRows)
+        {
+            magazine.numRows = this->heap->allocateBlock(this->allocatorId, maxRows, magazine.rows);
+            magazine.curRow = 0;
+        }
+        return magazine.rows[magazine.curRow++];
+    }
+
+    virtual void clearRowManager()
+    {
+        emptyCache();
+        CRoxieDirectFixedRowHeap<T>::clearRowManager();
+    }
+
+    //Return all the rows that have not been allocated back to their heaplets
+    virtual void emptyCache() override
+    {
+        for (unsigned i=0; i < numMagazines; i++)
+        {
+            Magazine & magazine = magazines[i];
+            NonReentrantSpinBlock block(magazine.lock);
+            unsigned numCached = magazine.numRows - magazine.curRow;
+            if (numCached)
+            {
+                ReleaseRoxieRowArray(numCached, (const void * *)(magazine.rows + magazine.curRow));
+                magazine.curRow = magazine.numRows;
+            }
+        }
+    }
+
+    virtual void releaseAllRows() override
+    {
+        for (unsigned i=0; i < numMagazines; i++)
+        {
+            Magazine & magazine = magazines[i];
+            NonReentrantSpinBlock block(magazine.lock);
+            magazine.curRow = magazine.numRows;
+        }
+        CRoxieDirectFixedRowHeap<T>::releaseAllRows();
+    }
+
+protected:
+    static const unsigned maxRows = 16; // Maximum number of rows to allocate at once.
+    static const unsigned numMagazines = 16; // Must be a power of 2
+
+    //Each magazine is on a separate cache line so that threads using different magazines do not interfere
+    struct alignas(CACHE_LINE_SIZE) Magazine
+    {
+        NonReentrantSpinLock lock;
+        unsigned curRow = 0;
+        unsigned numRows = 0;
+        char * rows[maxRows]; // Deliberately uninitialized
+    };
+
+    inline Magazine & queryMagazine()
+    {
+        if (unlikely(magazineThread == (unsigned)-1))
+            magazineThread = nextMagazineThread.fetch_add(1, std::memory_order_relaxed) & ((unsigned)-1 >> 1);
+        return magazines[magazineThread & (numMagazines-1)];
+    }
+
+    Magazine magazines[numMagazines];
+};
+
 //================================================================================
 //
 class CRoxieVariableRowHeap : implements IVariableRowHeap, public CInterface
@@ -5262,6 +5562,8 @@ protected:
         if (heapFlags & RHFpacked)
         {
             CPackedChunkingHeap * heap = createPackedHeap(fixedSize, activityId, heapFlags, maxSpillCost);
+            if (roxieHeapFlags & RHFmagazine)
+                return new CRoxieDirectFixedMagazineRowHeap<CPackedChunkingHeap>(this, activityId, (RoxieHeapFlags)roxieHeapFlags, heap);
             if (roxieHeapFlags & RHFblocked)
                 return new CRoxieDirectFixedBlockedRowHeap<CPackedChunkingHeap>(this, activityId, (RoxieHeapFlags)roxieHeapFlags, heap);
             return new CRoxieDirectFixedRowHeap<CPackedChunkingHeap>(this, activityId, (RoxieHeapFlags)roxieHeapFlags, heap);
@@ -5269,6 +5571,8 @@ protected:
         else
         {
             CFixedChunkedHeap * heap = createFixedHeap(fixedSize, activityId, heapFlags, maxSpillCost);
+            if (roxieHeapFlags & RHFmagazine)
+                return new CRoxieDirectFixedMagazineRowHeap<CFixedChunkedHeap>(this, activityId, (RoxieHeapFlags)roxieHeapFlags, heap);
             if (roxieHeapFlags & RHFblocked)
                 return new CRoxieDirectFixedBlockedRowHeap<CFixedChunkedHeap>(this, activityId, (RoxieHeapFlags)roxieHeapFlags, heap);
             return new CRoxieDirectFixedRowHeap<CFixedChunkedHeap>(this, activityId, (RoxieHeapFlags)roxieHeapFlags, heap);
@@ -6911,6 +7215,8 @@ void setMemoryOptions(IPropertyTree * options)
         return;
     memTraceInconsistencies = options->getPropBool("@roxiememTraceInconsistencies", true);
     memTraceReleaseWhenFree = options->getPropBool("@roxiememTraceReleaseWhenFree", true);
+    if (options->hasProp("@heapNumaPartitions"))
+        setHeapNumaPartitions(options->getPropBool("@heapNumaPartitions"));
     //MORE: Other options should probably be processed here - so they can be read consistently
 }
 
@@ -7173,6 +7479,7 @@ class RoxieMemTests : public CppUnit::TestFixture
         CPPUNIT_TEST(testRoundup);
         CPPUNIT_TEST(testCompressSize);
         CPPUNIT_TEST(testBitmap);
+        CPPUNIT_TEST(testNumaRegions);
         CPPUNIT_TEST(testAllocSize);
         CPPUNIT_TEST(testReleaseAll);
         CPPUNIT_TEST(testHuge);
@@ -7293,6 +7600,7 @@ protected:
             _heapUseHugePages = heapUseHugePages;
             _heapNotifyUnusedEachFree = heapNotifyUnusedEachFree;
             _heapNotifyUnusedEachBlock = heapNotifyUnusedEachBlock;
+            _heapNumRegions = heapNumRegions;
         }
         ~HeapPreserver()
         {
@@ -7307,6 +7615,7 @@ protected:
             heapUseHugePages = _heapUseHugePages;
             heapNotifyUnusedEachFree = _heapNotifyUnusedEachFree;
             heapNotifyUnusedEachBlock = _heapNotifyUnusedEachBlock;
+            heapNumRegions = _heapNumRegions;
         }
         char *_heapBase;
         char *_heapEnd;
@@ -7319,6 +7628,7 @@ protected:
         bool _heapUseHugePages;
         bool _heapNotifyUnusedEachFree;
         bool _heapNotifyUnusedEachBlock;
+        unsigned _heapNumRegions;
     };
     void initBitmap(unsigned size)
     {
@@ -7330,6 +7640,7 @@ protected:
         heapLWM = 0;
         heapHWM = heapBitmapSize;
         heapAllocated = 0;
+        heapNumRegions = 0;
     }
 
     void testBitmap()
@@ -7430,6 +7741,63 @@ protected:
         delete[] heapBitmap;
     }
 
+    void testNumaRegions()
+    {
+        HeapPreserver preserver;
+
+        const unsigned bitmapSize = 32;
+        const unsigned numRegions = 4;
+        const unsigned regionPages = (bitmapSize / numRegions) * HEAP_BITS;
+        const unsigned nodes[numRegions] = { 0, 1, 2, 3 };
+        initBitmap(bitmapSize);
+        partitionHeap(numRegions, nodes);
+        ASSERT(heapNumRegions == numRegions);
+
+        memsize_t minAddr = 0x80000000;
+        char * region1 = (char *)(memsize_t)(minAddr + regionPages * HEAP_ALIGNMENT_SIZE);
+        char * region2 = region1 + regionPages * HEAP_ALIGNMENT_SIZE;
+        {
+            CriticalBlock b(heapBitCrit);
+            for (unsigned i=0; i < regionPages; i++)
+            {
+                ASSERT(suballocRegionPage(heapRegions[2]) == region2 + i * HEAP_ALIGNMENT_SIZE);
+                ASSERT(suballocRegionPage(heapRegions[1]) == region1 + i * HEAP_ALIGNMENT_SIZE);
+            }
+            ASSERT(suballocRegionPage(heapRegions[2]) == nullptr);
+        }
+
+        unsigned node, totalPages, freePages;
+        ASSERT(numaMemstats(2, node, totalPages, freePages));
+        ASSERT(node == 2 && totalPages == regionPages && freePages == 0);
+        ASSERT(numaMemstats(3, node, totalPages, freePages));
+        ASSERT(node == 3 && totalPages == regionPages && freePages == regionPages);
+        ASSERT(!numaMemstats(numRegions, node, totalPages, freePages));
+
+        //A page that is freed can be reused by its region
+        subfree_aligned(region2 + 5 * HEAP_ALIGNMENT_SIZE, 1);
+        {
+            CriticalBlock b(heapBitCrit);
+            ASSERT(suballocRegionPage(heapRegions[2]) == region2 + 5 * HEAP_ALIGNMENT_SIZE);
+        }
+
+        //Freeing pages that span two regions makes the pages available to both
+        subfree_aligned(region2 - 2 * HEAP_ALIGNMENT_SIZE, 4);
+        {
+            CriticalBlock b(heapBitCrit);
+            ASSERT(suballocRegionPage(heapRegions[1]) == region2 - 2 * HEAP_ALIGNMENT_SIZE);
+            ASSERT(suballocRegionPage(heapRegions[2]) == region2);
+        }
+
+        //Threads without a known local region use the first region, and once it is full pages are allocated
+        //from the lowest free page in any region.
+        for (unsigned i=0; i < regionPages; i++)
+            ASSERT(suballoc_aligned(1, false) == (void *)(memsize_t)(minAddr + i * HEAP_ALIGNMENT_SIZE));
+        ASSERT(suballoc_aligned(1, false) == (void *)(region2 - HEAP_ALIGNMENT_SIZE));
+        ASSERT(suballoc_aligned(1, false) == (void *)(region2 + HEAP_ALIGNMENT_SIZE));
+
+        delete[] heapBitmap;
+    }
+
 #ifdef __64BIT__
     //Testing allocating bits that represent 1Tb of memory.  With 256K pages, that is simulating 4M pages.
     enum { maxBitmapThreads = 20, maxBitmapSize = (unsigned)(I64C(0xFFFFFFFFFF) / HEAP_ALIGNMENT_SIZE / HEAP_BITS) };      // Test larger range - in case we ever reduce the granularity
@@ -8242,6 +8610,8 @@ protected:
         testOldFixedCas();
         testSharedFixedCas("fixed", 0);
         testSharedFixedCas("fixed scan", RHFscanning);
+        testSharedFixedCas("fixed magazine", RHFmagazine);
+        testSharedFixedCas("packed magazine", RHFpacked|RHFmagazine);
         //NB: blocked allocators cannot be shared
         testFixedCas("fixed", 0);
         testFixedCas("packed", RHFpacked);
@@ -8300,6 +8670,8 @@ protected:
         testReleaseAll(rowCache, rowManager, RHFhasdestructor|RHFunique|RHFpacked|RHFscanning);
         testReleaseAll(rowCache, rowManager, RHFhasdestructor|RHFunique|RHFblocked);
         testReleaseAll(rowCache, rowManager, RHFhasdestructor|RHFunique|RHFpacked|RHFblocked);
+        testReleaseAll(rowCache, rowManager, RHFhasdestructor|RHFunique|RHFmagazine);
+        testReleaseAll(rowCache, rowManager, RHFhasdestructor|RHFunique|RHFpacked|RHFmagazine);
         testReleaseAll(rowCache, rowManager, RHFhasdestructor|RHFunique|RHFscanning|RHFdelayrelease);
         testReleaseAll(rowCache, rowManager, RHFhasdestructor|RHFunique|RHFpacked|RHFscanning|RHFdelayrelease);
     }
@@ -8933,6 +9305,7 @@ class RoxieMemStressTests : public CppUnit::TestFixture
     CPPUNIT_TEST(testResizeFragmenting);
     CPPUNIT_TEST(testSequential);
     CPPUNIT_TEST(testDatamanagerThreading);
+    CPPUNIT_TEST(testFixedHeapThreading);
     CPPUNIT_TEST(testCleanup);
     CPPUNIT_TEST_SUITE_END();
     const IContextLogger &logctx;
@@ -9241,6 +9614,60 @@ protected:
         dm.cleanUp();
     }
 
+    //Time allocating and freeing rows from a single fixed size heap that is shared by all the threads
+    unsigned timeSharedFixedHeap(IRowManager * rowManager, unsigned flags, unsigned numThreads)
+    {
+        const unsigned numIter = 20000;
+        const unsigned numRows = 64;
+        Owned<IFixedRowHeap> heap = rowManager->createFixedRowHeap(24, 0, flags);
+
+        class casyncfor: public CAsyncFor
+        {
+        public:
+            casyncfor(IFixedRowHeap * _heap) : heap(_heap) {}
+
+            void Do(unsigned idx)
+            {
+                void * rows[numRows];
+                for (unsigned i=0; i < numIter; i++)
+                {
+                    for (unsigned j=0; j < numRows; j++)
+                        rows[j] = heap->allocate();
+                    ReleaseRoxieRowArray(numRows, (const void * *)rows);
+                }
+            }
+        private:
+            IFixedRowHeap * heap;
+        } afor(heap);
+
+        cycle_t startCycles = get_cycles_now();
+        afor.For(numThreads, numThreads);
+        unsigned elapsedMs = (unsigned)(cycle_to_nanosec(get_cycles_now() - startCycles) / 1000000);
+        heap->emptyCache();
+        return elapsedMs;
+    }
+
+    void testFixedHeapThreading()
+    {
+        Owned<IRowManager> rowManager = createRowManager(0, NULL, logctx, NULL, false);
+        const unsigned flagVariants[] = { 0, RHFpacked, RHFmagazine, RHFpacked|RHFmagazine };
+        const char * variantNames[] = { "fixed", "packed", "fixed magazine", "packed magazine" };
+        unsigned maxThreads = getAffinityCpus();
+        for (unsigned variant=0; variant < _elements_in(flagVariants); variant++)
+        {
+            for (unsigned numThreads = 1; ; numThreads *= 2)
+            {
+                if (numThreads > maxThreads)
+                    numThreads = maxThreads;
+                unsigned elapsedMs = timeSharedFixedHeap(rowManager, flagVariants[variant], numThreads);
+                double rowsPerSec = (double)numThreads * 20000 * 64 * 1000 / (elapsedMs ? elapsedMs : 1);
+                DBGLOG("Shared %s heap with %u threads: %ums (%.1fM rows/s)", variantNames[variant], numThreads, elapsedMs, rowsPerSec / 1000000);
+                if (numThreads == maxThreads)
+                    break;
+            }
+        }
+    }
+
 
 };
 
@@ -474,6 +474,7 @@ enum RoxieHeapFlags
     RHFblocked          = 0x0040,  // allocate blocks of rows
     RHFscanning         = 0x0080,  // scan the heaplet for free items instead of using a free list
     RHFdelayrelease     = 0x0100,
+    RHFmagazine         = 0x0200,  // allocate blocks of rows into a cache per thread - the heap can be shared by threads
 
     //internal flags
     RHFhuge             = 0x40000000,   // only used for tracing
@@ -579,6 +580,10 @@ extern roxiemem_decl IDataBufferManager *createDataBufferManager(size32_t size);
 extern roxiemem_decl void setMemoryStatsInterval(unsigned secs);
 extern roxiemem_decl void setTotalMemoryLimit(bool allowHugePages, bool allowTransparentHugePages, bool retainMemory, bool lockMemory, memsize_t max, memsize_t largeBlockSize, const unsigned * allocSizes, ILargeMemCallback * largeBlockCallback);
 extern roxiemem_decl void setMemoryOptions(IPropertyTree * options);
+// Divide the heap into a region per numa node, and allocate pages from the region local to the calling thread where possible.
+// Must be called after setTotalMemoryLimit().  Has no effect if numa support is unavailable or the process only uses one node.
+extern roxiemem_decl void setHeapNumaPartitions(bool enable);
+extern roxiemem_decl unsigned getHeapNumaPartitions();
 extern roxiemem_decl memsize_t getTotalMemoryLimit();
 extern roxiemem_decl void releaseRoxieHeap();
 extern roxiemem_decl bool memPoolExhausted();
@@ -600,6 +605,7 @@ extern roxiemem_decl bool getRoxieMemLocked();
 
 extern roxiemem_decl StringBuffer &memstats(StringBuffer &stats);
 extern roxiemem_decl void memstats(unsigned &totalpg, unsigned &freepg, unsigned &maxblk);
+extern roxiemem_decl bool numaMemstats(unsigned region, unsigned &node, unsigned &totalpg, unsigned &freepg); // false if the region does not exist
 extern roxiemem_decl IPerfMonHook *createRoxieMemStatsPerfMonHook(IPerfMonHook *chain=NULL); // for passing to jdebug startPerformanceMonitor
 extern roxiemem_decl size_t getRelativeRoxiePtr(const void *_ptr); // Useful for debugging - to provide a value that is consistent from run to run
 
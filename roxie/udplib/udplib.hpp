@@ -207,6 +207,8 @@ extern UDPLIB_API unsigned udpSendTraceThresholdMs;
 
 extern UDPLIB_API unsigned udpFlowSocketsSize;
 extern UDPLIB_API unsigned udpLocalWriteSocketSize;
+extern UDPLIB_API unsigned udpIoBatchSize;              // Maximum number of data packets read or written by a single system call (<=1 disables batching)
+extern UDPLIB_API bool udpUseGSO;                       // Use UDP generic segmentation offload to send runs of equal sized packets
 
 extern UDPLIB_API unsigned udpMaxPermitDeadTimeouts;    // How many permit grants are allowed to expire (with no flow message) until sender is assumed down
 extern UDPLIB_API unsigned udpRequestDeadTimeout;       // Timeout for sender getting no response to request to send before assuming that the receiver is dead
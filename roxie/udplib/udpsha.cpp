@@ -28,6 +28,13 @@
 #else
 #include <sys/socket.h>
 #endif
+#ifdef __linux__
+#include <netinet/in.h>
+#include <netinet/udp.h>
+#ifndef UDP_SEGMENT
+#define UDP_SEGMENT 103
+#endif
+#endif
 
 using roxiemem::DataBuffer;
 using roxiemem::IDataBufferManager;
@@ -48,6 +55,8 @@ bool udpTraceTimeouts = false;
 unsigned udpTraceLevel = 0;
 unsigned udpFlowSocketsSize = 131072;
 unsigned udpLocalWriteSocketSize = 1024000;
+unsigned udpIoBatchSize = 1;
+bool udpUseGSO = false;
 unsigned udpStatsReportInterval = 60000;
 
 unsigned udpOutQsPriority = 0;
@@ -570,6 +579,187 @@ void sanityCheckUdpSettings(unsigned receiveQueueSize, unsigned sendQueueSize, u
         ERRLOG("udpMinSlotsPerSender of %u is higher than recommended", udpMinSlotsPerSender);
 }
 
+//---------------------------------------------------------------------------------------------------------------------
+
+bool canBatchUdpIo()
+{
+#ifdef __linux__
+    if (udpIoBatchSize <= 1)
+        return false;
+#ifdef SOCKET_SIMULATION
+    if (isUdpTestMode && !udpTestUseUdpSockets)
+        return false;
+#endif
+    return true;
+#else
+    return false;
+#endif
+}
+
+#ifdef __linux__
+// The kernel limits on the number of segments, and the total size of a single gso send
+static constexpr unsigned maxGsoSegments = 64;
+static constexpr size32_t maxGsoBytes = 65000;
+static constexpr size32_t gsoControlSize = CMSG_SPACE(sizeof(uint16_t));
+#endif
+
+UdpBatchReader::UdpBatchReader(ISocket * _socket, unsigned _maxBatch) : socket(_socket), maxBatch(_maxBatch)
+{
+    assertex(maxBatch);
+#ifdef __linux__
+    msgs = new mmsghdr[maxBatch];
+    iovecs = new iovec[maxBatch];
+#endif
+}
+
+UdpBatchReader::~UdpBatchReader()
+{
+#ifdef __linux__
+    delete [] msgs;
+    delete [] iovecs;
+#endif
+}
+
+unsigned UdpBatchReader::read(DataBuffer * * buffers, size32_t * lengths, unsigned timeout)
+{
+#ifdef __linux__
+    if (socket->wait_read(timeout) <= 0)
+        return 0;
+    for (unsigned i=0; i < maxBatch; i++)
+    {
+        iovecs[i].iov_base = buffers[i]->data;
+        iovecs[i].iov_len = DATA_PAYLOAD;
+        memset(&msgs[i], 0, sizeof(msgs[i]));
+        msgs[i].msg_hdr.msg_iov = &iovecs[i];
+        msgs[i].msg_hdr.msg_iovlen = 1;
+    }
+    int ret;
+    do
+    {
+        ret = recvmmsg(socket->OShandle(), msgs, maxBatch, MSG_DONTWAIT, nullptr);
+    } while ((ret < 0) && (errno == EINTR));
+    if (ret < 0)
+    {
+        if ((errno == EAGAIN) || (errno == EWOULDBLOCK))
+            return 0;
+        throw makeOsException(errno, "UdpBatchReader::read");
+    }
+    for (int i=0; i < ret; i++)
+        lengths[i] = msgs[i].msg_len;
+    return ret;
+#else
+    UNIMPLEMENTED;
+#endif
+}
+
+UdpBatchWriter::UdpBatchWriter(ISocket * _socket, unsigned _maxBatch, bool _useGSO) : socket(_socket), maxBatch(_maxBatch), useGSO(_useGSO)
+{
+    assertex(maxBatch);
+#ifdef __linux__
+    msgs = new mmsghdr[maxBatch];
+    iovecs = new iovec[maxBatch];
+    if (useGSO)
+    {
+        int segmentSize = 0;
+        socklen_t len = sizeof(segmentSize);
+        if (getsockopt(socket->OShandle(), SOL_UDP, UDP_SEGMENT, &segmentSize, &len) != 0)
+        {
+            DBGLOG("UdpSender: UDP generic segmentation offload is not supported by this kernel - disabled");
+            useGSO = false;
+        }
+        else
+            controls = new char[maxBatch * gsoControlSize];
+    }
+#endif
+}
+
+UdpBatchWriter::~UdpBatchWriter()
+{
+#ifdef __linux__
+    delete [] msgs;
+    delete [] iovecs;
+    delete [] controls;
+#endif
+}
+
+void UdpBatchWriter::add(const void * data, size32_t len)
+{
+#ifdef __linux__
+    assertex(pending < maxBatch);
+    iovecs[pending].iov_base = const_cast<void *>(data);
+    iovecs[pending].iov_len = len;
+    pending++;
+#else
+    UNIMPLEMENTED;
+#endif
+}
+
+void UdpBatchWriter::flush()
+{
+#ifdef __linux__
+    if (!pending)
+        return;
+
+    //Each message is normally a single packet.  With gso a run of packets of the same size (optionally followed by a
+    //single smaller packet) is passed as a single message, and the kernel splits it into separate datagrams.
+    unsigned numMsgs = 0;
+    unsigned next = 0;
+    while (next < pending)
+    {
+        unsigned first = next;
+        size32_t segmentSize = iovecs[first].iov_len;
+        size32_t total = segmentSize;
+        next++;
+        if (useGSO)
+        {
+            while ((next < pending) && (next - first < maxGsoSegments) && (iovecs[next].iov_len <= segmentSize) && (total + iovecs[next].iov_len <= maxGsoBytes))
+            {
+                size32_t len = iovecs[next].iov_len;
+                total += len;
+                next++;
+                if (len < segmentSize)
+                    break;
+            }
+        }
+
+        mmsghdr & msg = msgs[numMsgs];
+        memset(&msg, 0, sizeof(msg));
+        msg.msg_hdr.msg_iov = &iovecs[first];
+        msg.msg_hdr.msg_iovlen = next - first;
+        if (next - first > 1)
+        {
+            msg.msg_hdr.msg_control = controls + numMsgs * gsoControlSize;
+            msg.msg_hdr.msg_controllen = gsoControlSize;
+            cmsghdr * cm = CMSG_FIRSTHDR(&msg.msg_hdr);
+            cm->cmsg_level = SOL_UDP;
+            cm->cmsg_type = UDP_SEGMENT;
+            cm->cmsg_len = CMSG_LEN(sizeof(uint16_t));
+            uint16_t gsoSize = segmentSize;
+            memcpy(CMSG_DATA(cm), &gsoSize, sizeof(gsoSize));
+        }
+        numMsgs++;
+    }
+    pending = 0;
+
+    unsigned sent = 0;
+    while (sent < numMsgs)
+    {
+        int ret = sendmmsg(socket->OShandle(), msgs + sent, numMsgs - sent, 0);
+        if (ret < 0)
+        {
+            if (errno == EINTR)
+                continue;
+            //The packets that have not been sent are treated as lost
+            DBGLOG("UdpSender: sendmmsg failed for %u of %u messages - error %d", numMsgs - sent, numMsgs, errno);
+            break;
+        }
+        sent += ret;
+    }
+#else
+    UNIMPLEMENTED;
+#endif
+}
+
 //---------------------------------------------------------------------------------------------------------------------
 #ifdef _USE_CPPUNIT
 #include "unittests.hpp"
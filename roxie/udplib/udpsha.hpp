@@ -322,6 +322,55 @@ inline bool checkTraceLevel(unsigned category, unsigned level)
 
 extern UDPLIB_API void sanityCheckUdpSettings(unsigned receiveQueueSize, unsigned sendQueueSize, unsigned numSenders, __uint64 networkSpeedBitsPerSecond);
 
+// Batched socket io - reads or writes multiple packets with a single recvmmsg()/sendmmsg() call.  Only available on
+// linux, and only for real sockets (or simulated sockets that are backed by a real udp socket).
+extern UDPLIB_API bool canBatchUdpIo();
+
+struct mmsghdr;
+struct iovec;
+
+class UDPLIB_API UdpBatchReader
+{
+public:
+    UdpBatchReader(ISocket * _socket, unsigned _maxBatch);
+    ~UdpBatchReader();
+
+    // Wait up to timeout ms for packets to arrive, and read up to maxBatch of them into buffers[].  Returns the number of
+    // packets read (0 if the timeout expired), and the size of each packet in lengths[]
+    unsigned read(roxiemem::DataBuffer * * buffers, size32_t * lengths, unsigned timeout);
+    unsigned queryMaxBatch() const { return maxBatch; }
+
+private:
+    ISocket * socket;
+    unsigned maxBatch;
+    struct mmsghdr * msgs = nullptr;
+    struct iovec * iovecs = nullptr;
+};
+
+class UDPLIB_API UdpBatchWriter
+{
+public:
+    UdpBatchWriter(ISocket * _socket, unsigned _maxBatch, bool _useGSO);
+    ~UdpBatchWriter();
+
+    // data must remain valid until the next call to flush()
+    void add(const void * data, size32_t len);
+    // Errors are logged rather than thrown - the same as failed socket writes, lost packets are resent if necessary
+    void flush();
+    unsigned numPending() const { return pending; }
+    bool isFull() const { return pending == maxBatch; }
+    unsigned queryMaxBatch() const { return maxBatch; }
+
+private:
+    ISocket * socket;
+    unsigned maxBatch;
+    unsigned pending = 0;
+    bool useGSO;
+    struct mmsghdr * msgs = nullptr;
+    struct iovec * iovecs = nullptr;
+    char * controls = nullptr;
+};
+
 
 #define SOCKET_SIMULATION
 
@@ -484,6 +533,7 @@ class CSimulatedUdpSocket : public CSocketSimulator
 {
     virtual void  shutdown(unsigned mode) override { realSocket->shutdown(mode); }
     virtual void  shutdownNoThrow(unsigned mode) override{ realSocket->shutdownNoThrow(mode); }
+    virtual unsigned OShandle() const override { return realSocket->OShandle(); }    // allows batched io
 protected:
     Owned<ISocket> realSocket;
 };
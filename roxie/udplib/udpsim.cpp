@@ -21,6 +21,7 @@
 #include "udpipmap.hpp"
 #include "roxiemem.hpp"
 #include "jptree.hpp"
+#include "jdebug.hpp"
 #include "portlist.h"
 
 using roxiemem::DataBuffer;
@@ -84,6 +85,8 @@ udpsim:
   udpTraceFlow: false
   useQueue: false
   udpAdjustThreadPriorities: false
+  udpIoBatchSize: 1
+  udpUseGSO: false
 )!!";
 
 bool isNumeric(const char *str)
@@ -216,6 +219,10 @@ void initOptions(int argc, const char **argv)
         udpTestUseUdpSockets = false;
     }
     udpAdjustThreadPriorities = options->getPropBool("@udpAdjustThreadPriorities", udpAdjustThreadPriorities);
+    udpIoBatchSize = options->getPropInt("@udpIoBatchSize", udpIoBatchSize);
+    udpUseGSO = options->getPropBool("@udpUseGSO", udpUseGSO);
+    if ((udpIoBatchSize > 1) && !udpTestUseUdpSockets)
+        printf("udpIoBatchSize is ignored in queue mode (--useQueue=1)\n");
     packetsPerThread = options->getPropInt("@packetsPerThread");
     numReceiveSlots = options->getPropInt("@numReceiveSlots");
 
@@ -246,6 +253,7 @@ void simulateTraffic()
         myNode.setIp(IpAddress("1.2.3.4"));
         Owned<IReceiveManager> rm = createReceiveManager(CCD_SERVER_FLOW_PORT, CCD_DATA_PORT, CCD_CLIENT_FLOW_PORT, numReceiveSlots, false);
         unsigned begin = msTick();
+        ProcessInfo startCpu(ReadCpuInfo);
         std::atomic<unsigned> workValue{0};
 
         asyncFor(numThreads+1, numThreads+1, [&workValue, maxSendQueueSize, &rm](unsigned i)
@@ -309,7 +317,15 @@ void simulateTraffic()
                 DBGLOG("UdpSim sender thread %d completed", i);
             }
         });
-        printf("UdpSim test took %ums\n", msTick() - begin);
+        unsigned elapsed = msTick() - begin;
+        printf("UdpSim test took %ums\n", elapsed);
+
+        //Every packet is both sent and received by this process, so report the cpu per packet received
+        ProcessInfo endCpu(ReadCpuInfo);
+        SystemProcessInfo used = endCpu - startCpu;
+        unsigned packets = dataPacketsReceived;
+        printf("UdpSim %s io: %u packets (%.0f/s), cpu %.2fus per packet\n", canBatchUdpIo() ? "batched" : "single packet",
+               packets, elapsed ? packets * 1000.0 / elapsed : 0.0, packets ? (double)used.getTotalNs() / packets / 1000.0 : 0.0);
     }
     catch (IException * e)
     {
@@ -19,6 +19,7 @@
 #include <map>
 #include <queue>
 #include <algorithm>
+#include <memory>
 
 #include "jthread.hpp"
 #include "jlog.hpp"
@@ -262,6 +263,14 @@ Other udp settings
 
 * udpLocalWriteSocketSize
 
+* udpIoBatchSize
+  The maximum number of data packets read (recvmmsg) or written (sendmmsg) by a single system call.  At high packet
+  rates the number of system calls limits the throughput.  Only supported on linux, values <= 1 disable batching.
+
+* udpUseGSO
+  When sending a batch of packets, pass each run of packets that are the same size to the kernel as a single buffer,
+  which is split into separate datagrams by the kernel (or the network card).  Ignored if the kernel does not support it.
+
 Behaviour on lost servers
 -------------------------
 
@@ -1316,6 +1325,82 @@ class CReceiveManager : implements IReceiveManager, public CInterface
             ::Release(selfFlowSocket);
         }
 
+        // Returns true if the buffer has been consumed
+        bool processPacket(DataBuffer *b, unsigned res)
+        {
+            if (res==sizeof(UdpRequestToSendMsg))
+            {
+                //Sending flow packets (eg send_completed) to the data thread ensures they do not overtake the data
+                //Redirect them to the flow thread to process them.
+                selfFlowSocket->write(b->data, res);
+                return false;
+            }
+
+            dataPacketsReceived++;
+            UdpPacketHeader &hdr = *(UdpPacketHeader *) b->data;
+            assert(hdr.length == res && hdr.length > sizeof(hdr));
+            UdpSenderEntry *sender = &parent.sendersTable[hdr.node];
+            if (sender->noteSeen(hdr))
+            {
+                if (udpTraceLevel > 5) // don't want to interrupt this thread if we can help it
+                {
+                    StringBuffer s;
+                    DBGLOG("UdpReceiver: discarding unwanted resent packet %" SEQF "u %x from %s", hdr.sendSeq, hdr.pktSeq, hdr.node.getTraceText(s).str());
+                }
+                // We should perhaps track how often this happens, but it's not the same as unwantedDiscarded
+                hdr.node.clear();  // Used to indicate a duplicate that collate thread should discard. We don't discard on this thread as don't want to do anything that requires locks...
+            }
+            else
+            {
+                //Decrease the number of active reservations to balance having received a new data packet (otherwise they will be double counted)
+                sender->decPermit(hdr.msgSeq);
+                if (udpTraceLevel > 5) // don't want to interrupt this thread if we can help it
+                {
+                    StringBuffer s;
+                    DBGLOG("UdpReceiver: %u bytes received packet %" SEQF "u %x from %s", res, hdr.sendSeq, hdr.pktSeq, hdr.node.getTraceText(s).str());
+                }
+            }
+            parent.input_queue->pushOwn(b);
+            return true;
+        }
+
+        void reportStats(unsigned &lastOOOReport, unsigned &lastPacketsOOO, unsigned &lastUnwantedDiscarded)
+        {
+            if (udpStatsReportInterval)
+            {
+                unsigned now = msTick();
+                if (now-lastOOOReport > udpStatsReportInterval)
+                {
+                    lastOOOReport = now;
+                    if (unwantedDiscarded > lastUnwantedDiscarded)
+                    {
+                        DBGLOG("%u more unwanted packets discarded by this server (%u total)", unwantedDiscarded - lastUnwantedDiscarded, unwantedDiscarded-0);
+                        lastUnwantedDiscarded = unwantedDiscarded;
+                    }
+                    if (packetsOOO > lastPacketsOOO)
+                    {
+                        DBGLOG("%u more packets received out-of-order by this server (%u total)", packetsOOO-lastPacketsOOO, packetsOOO-0);
+                        lastPacketsOOO = packetsOOO;
+                    }
+                    if (flowRequestsReceived > lastFlowRequestsReceived)
+                    {
+                        DBGLOG("%u more flow requests received by this server (%u total)", flowRequestsReceived-lastFlowRequestsReceived, flowRequestsReceived-0);
+                        lastFlowRequestsReceived = flowRequestsReceived;
+                    }
+                    if (flowPermitsSent > lastFlowPermitsSent)
+                    {
+                        DBGLOG("%u more flow permits sent by this server (%u total)", flowPermitsSent-lastFlowPermitsSent, flowPermitsSent-0);
+                        lastFlowPermitsSent = flowPermitsSent;
+                    }
+                    if (dataPacketsReceived > lastDataPacketsReceived)
+                    {
+                        DBGLOG("%u more data packets received by this server (%u total)", dataPacketsReceived-lastDataPacketsReceived, dataPacketsReceived-0);
+                        lastDataPacketsReceived = dataPacketsReceived;
+                    }
+                }
+            }
+        }
+
         virtual int run() 
         {
             DBGLOG("UdpReceiver: receive_data started");
@@ -1330,83 +1415,48 @@ class CReceiveManager : implements IReceiveManager, public CInterface
             unsigned lastUnwantedDiscarded = 0;
             unsigned timeout = 5000;
             roxiemem::IDataBufferManager * udpBufferManager = bufferManager;
-            DataBuffer *b = udpBufferManager->allocate();
+
+            //If batching, a buffer is allocated for each packet that can be read by a single call
+            std::unique_ptr<UdpBatchReader> batchReader;
+            if (canBatchUdpIo())
+            {
+                batchReader.reset(new UdpBatchReader(receive_socket, udpIoBatchSize));
+                DBGLOG("UdpReceiver: reading up to %u data packets per call", udpIoBatchSize);
+            }
+            unsigned numBuffers = batchReader ? batchReader->queryMaxBatch() : 1;
+            std::unique_ptr<DataBuffer *[]> buffers(new DataBuffer *[numBuffers]);
+            std::unique_ptr<size32_t[]> lengths(new size32_t[numBuffers]);
+            for (unsigned i=0; i < numBuffers; i++)
+                buffers[i] = nullptr;
             while (running) 
             {
                 try 
                 {
-                    unsigned int res;
-                    while (true)
+                    for (unsigned i=0; i < numBuffers; i++)
                     {
-                        receive_socket->readtms(b->data, 1, DATA_PAYLOAD, res, timeout);
-                        if (res!=sizeof(UdpRequestToSendMsg))
-                            break;
-
-                        //Sending flow packets (eg send_completed) to the data thread ensures they do not overtake the data
-                        //Redirect them to the flow thread to process them.
-                        selfFlowSocket->write(b->data, res);
+                        if (!buffers[i])
+                            buffers[i] = udpBufferManager->allocate();
                     }
-
-                    dataPacketsReceived++;
-                    UdpPacketHeader &hdr = *(UdpPacketHeader *) b->data;
-                    assert(hdr.length == res && hdr.length > sizeof(hdr));
-                    UdpSenderEntry *sender = &parent.sendersTable[hdr.node];
-                    if (sender->noteSeen(hdr))
+                    if (batchReader)
                     {
-                        if (udpTraceLevel > 5) // don't want to interrupt this thread if we can help it
+                        unsigned numRead = batchReader->read(buffers.get(), lengths.get(), timeout);
+                        for (unsigned i=0; i < numRead; i++)
                         {
-                            StringBuffer s;
-                            DBGLOG("UdpReceiver: discarding unwanted resent packet %" SEQF "u %x from %s", hdr.sendSeq, hdr.pktSeq, hdr.node.getTraceText(s).str());
+                            if (processPacket(buffers[i], lengths[i]))
+                                buffers[i] = nullptr;   // reallocated before the next read
                         }
-                        // We should perhaps track how often this happens, but it's not the same as unwantedDiscarded
-                        hdr.node.clear();  // Used to indicate a duplicate that collate thread should discard. We don't discard on this thread as don't want to do anything that requires locks...
                     }
                     else
                     {
-                        //Decrease the number of active reservations to balance having received a new data packet (otherwise they will be double counted)
-                        sender->decPermit(hdr.msgSeq);
-                        if (udpTraceLevel > 5) // don't want to interrupt this thread if we can help it
+                        DataBuffer *b = buffers[0];
+                        unsigned int res;
+                        do
                         {
-                            StringBuffer s;
-                            DBGLOG("UdpReceiver: %u bytes received packet %" SEQF "u %x from %s", res, hdr.sendSeq, hdr.pktSeq, hdr.node.getTraceText(s).str());
-                        }
-                    }
-                    parent.input_queue->pushOwn(b);
-                    b = udpBufferManager->allocate();
-
-                    if (udpStatsReportInterval)
-                    {
-                        unsigned now = msTick();
-                        if (now-lastOOOReport > udpStatsReportInterval)
-                        {
-                            lastOOOReport = now;
-                            if (unwantedDiscarded > lastUnwantedDiscarded)
-                            {
-                                DBGLOG("%u more unwanted packets discarded by this server (%u total)", unwantedDiscarded - lastUnwantedDiscarded, unwantedDiscarded-0);
-                                lastUnwantedDiscarded = unwantedDiscarded;
-                            }
-                            if (packetsOOO > lastPacketsOOO)
-                            {
-                                DBGLOG("%u more packets received out-of-order by this server (%u total)", packetsOOO-lastPacketsOOO, packetsOOO-0);
-                                lastPacketsOOO = packetsOOO;
-                            }
-                            if (flowRequestsReceived > lastFlowRequestsReceived)
-                            {
-                                DBGLOG("%u more flow requests received by this server (%u total)", flowRequestsReceived-lastFlowRequestsReceived, flowRequestsReceived-0);
-                                lastFlowRequestsReceived = flowRequestsReceived;
-                            }
-                            if (flowPermitsSent > lastFlowPermitsSent)
-                            {
-                                DBGLOG("%u more flow permits sent by this server (%u total)", flowPermitsSent-lastFlowPermitsSent, flowPermitsSent-0);
-                                lastFlowPermitsSent = flowPermitsSent;
-                            }
-                            if (dataPacketsReceived > lastDataPacketsReceived)
-                            {
-                                DBGLOG("%u more data packets received by this server (%u total)", dataPacketsReceived-lastDataPacketsReceived, dataPacketsReceived-0);
-                                lastDataPacketsReceived = dataPacketsReceived;
-                            }
-                        }
+                            receive_socket->readtms(b->data, 1, DATA_PAYLOAD, res, timeout);
+                        } while (!processPacket(b, res));
+                        buffers[0] = nullptr;
                     }
+                    reportStats(lastOOOReport, lastPacketsOOO, lastUnwantedDiscarded);
                 }
                 catch (IException *e) 
                 {
@@ -1424,7 +1474,8 @@ class CReceiveManager : implements IReceiveManager, public CInterface
                     MilliSleep(1000);
                 }
             }
-            ::Release(b);
+            for (unsigned i=0; i < numBuffers; i++)
+                ::Release(buffers[i]);
             return 0;
         }
     };
@@ -34,6 +34,7 @@
 #endif
 #include <math.h>
 #include <atomic>
+#include <memory>
 #include <algorithm>
 
 using roxiemem::DataBuffer;
@@ -203,6 +204,9 @@ private:
     const bool encrypted = false;
     ISocket *send_flow_socket = nullptr;
     ISocket *data_socket = nullptr;
+    UdpBatchWriter *batchWriter = nullptr;
+    std::unique_ptr<MemoryBuffer[]> batchEncryptBuffers;
+    std::vector<DataBuffer *> batchBuffers;     // linked until the batch has been written
     const unsigned numQueues;
     int     current_q = 0;
     int     currentQNumPkts = 0;         // Current Queue Number of Consecutive Processed Packets.
@@ -533,6 +537,8 @@ public:
             sendStart(toSend.size());
             for (DataBuffer *buffer: toSend)
             {
+                if (batchWriter && batchWriter->isFull())
+                    flushBatch();
                 UdpPacketHeader *header = (UdpPacketHeader*) buffer->data;
                 unsigned length = header->length;
                 if (bucket)
@@ -552,18 +558,28 @@ public:
     #endif
                     if (encrypted)
                     {
-                        encryptBuffer.clear();
-                        encryptBuffer.append(sizeof(UdpPacketHeader), header);    // We don't encrypt the header
+                        //Each packet in a batch needs its own buffer, since they are not written until the batch is flushed
+                        MemoryBuffer &target = batchWriter ? batchEncryptBuffers[batchWriter->numPending()] : encryptBuffer;
+                        target.clear();
+                        target.append(sizeof(UdpPacketHeader), header);    // We don't encrypt the header
                         length -= sizeof(UdpPacketHeader);
                         const char *data = buffer->data + sizeof(UdpPacketHeader);
                         const MemoryAttr &udpkey = getSecretUdpKey(true);
-                        aesEncrypt(udpkey.get(), udpkey.length(), data, length, encryptBuffer);
-                        header->length = encryptBuffer.length();
-                        encryptBuffer.writeDirect(0, sizeof(UdpPacketHeader), header);   // Only really need length updating
+                        aesEncrypt(udpkey.get(), udpkey.length(), data, length, target);
+                        header->length = target.length();
+                        target.writeDirect(0, sizeof(UdpPacketHeader), header);   // Only really need length updating
                         assert(length <= DATA_PAYLOAD);
                         if (udpTraceLevel > 5)
-                            DBGLOG("ENCRYPT: Writing %u bytes to data socket", encryptBuffer.length());
-                        data_socket->write(encryptBuffer.toByteArray(), encryptBuffer.length());
+                            DBGLOG("ENCRYPT: Writing %u bytes to data socket", target.length());
+                        if (batchWriter)
+                            batchWriter->add(target.toByteArray(), target.length());
+                        else
+                            data_socket->write(target.toByteArray(), target.length());
+                    }
+                    else if (batchWriter)
+                    {
+                        batchWriter->add(buffer->data, length);
+                        batchBuffers.push_back(LINK(buffer));
                     }
                     else
                         data_socket->write(buffer->data, length);
@@ -589,6 +605,8 @@ public:
                 else
                     ::Release(buffer);
             }
+            if (batchWriter)
+                flushBatch();
         }
         activePermitSeq = 0;
         unsigned socketElapsed = sendTimer.elapsedMs();
@@ -666,6 +684,14 @@ public:
             requestToSendNew();
     }
 
+    void flushBatch()
+    {
+        batchWriter->flush();
+        for (DataBuffer *buffer : batchBuffers)
+            ::Release(buffer);
+        batchBuffers.clear();
+    }
+
     DataBuffer *popQueuedData() 
     {
         DataBuffer *buffer;
@@ -749,6 +775,12 @@ public:
                     if (udpTraceLevel > 0)
                         DBGLOG("UdpSender: sendbuffer set for local socket (size=%d)", udpLocalWriteSocketSize);
                 }
+                if (canBatchUdpIo())
+                {
+                    batchWriter = new UdpBatchWriter(data_socket, udpIoBatchSize, udpUseGSO);
+                    if (encrypted)
+                        batchEncryptBuffers.reset(new MemoryBuffer[udpIoBatchSize]);
+                }
             }
             catch(IException *e) 
             {
@@ -788,6 +820,7 @@ public:
     ~UdpReceiverEntry()
     {
         if (send_flow_socket) send_flow_socket->Release();
+        delete batchWriter;
         if (data_socket) data_socket->Release();
         if (output_queue) delete [] output_queue;
         if (maxPktsPerQ) delete [] maxPktsPerQ;
@@ -44,6 +44,8 @@ void usage()
         "--jumboFrames\n"
         "--useAeron\n"
         "--udpLocalWriteSocketSize nn\n"
+        "--udpIoBatchSize nn\n"
+        "--udpUseGSO\n"
         "--udpRetryBusySenders nn\n"
         "--maxPacketsPerSender nn\n"
         "--udpQueueSize nn\n"
@@ -285,6 +287,21 @@ public:
     }
 };
 
+// Report the packet rates, and the cpu time used per packet - to compare single and batched socket io
+void reportPacketRates(unsigned startMs, const ProcessInfo & startCpu, unsigned startSent, unsigned startReceived)
+{
+    ProcessInfo endCpu(ReadCpuInfo);
+    SystemProcessInfo used = endCpu - startCpu;
+    unsigned elapsed = msTick() - startMs;
+    unsigned sent = dataPacketsSent - startSent;
+    unsigned received = dataPacketsReceived - startReceived;
+    double seconds = elapsed ? elapsed / 1000.0 : 0.001;
+    unsigned packets = sent + received;
+    DBGLOG("Node %d %s io: %u packets sent (%.0f/s), %u packets received (%.0f/s), cpu %.2fus per packet",
+           myIndex, (udpIoBatchSize > 1) ? "batched" : "single packet", sent, sent / seconds, received, received / seconds,
+           packets ? (double)used.getTotalNs() / packets / 1000.0 : 0.0);
+}
+
 void testNxN()
 {
     if (maxPacketsPerSender > udpQueueSize)
@@ -313,9 +330,17 @@ void testNxN()
     }
     offset_t sentTotal = 0;
     offset_t lastTotal = 0;
+    ProcessInfo startCpu(ReadCpuInfo);
+    unsigned startMs = msTick();
+    unsigned startSent = dataPacketsSent;
+    unsigned startReceived = dataPacketsReceived;
     if (sending)
     {
         Sleep(5000); // Give receivers a fighting chance
+        startCpu.update(ReadCpuInfo);
+        startMs = msTick();
+        startSent = dataPacketsSent;
+        startReceived = dataPacketsReceived;
         unsigned dest = 0;
         unsigned start = msTick();
         unsigned last = start;
@@ -385,6 +410,7 @@ void testNxN()
         Sleep(3000000);
     receiver.stop(sentTotal);
     receiver.join();
+    reportPacketRates(startMs, startCpu, startSent, startReceived);
     Sleep(10*1000); // possible receivers may request retries so should leave senders alive for a bit
     for (unsigned ii = 0; ii < numNodes; ii++)
     {
@@ -682,6 +708,17 @@ int main(int argc, char * argv[] )
                     usage();
                 udpLocalWriteSocketSize = atoi(argv[c]);
             }
+            else if (strcmp(ip, "--udpIoBatchSize")==0)
+            {
+                c++;
+                if (c==argc || !isdigit(*argv[c]))
+                    usage();
+                udpIoBatchSize = atoi(argv[c]);
+            }
+            else if (strcmp(ip, "--udpUseGSO")==0)
+            {
+                udpUseGSO = true;
+            }
             else if (strcmp(ip, "--maxPacketsPerSender")==0)
             {
                 c++;
@@ -318,6 +318,7 @@ ICompare * CThorSortArg::queryCompareLeftRight() { return NULL; }
 ICompare * CThorSortArg::queryCompareSerializedRow() { return NULL; }
 unsigned CThorSortArg::getAlgorithmFlags() { return TAFconstant; }
 const char * CThorSortArg::getAlgorithm() { return NULL; }
+ISortKeyPrefix * CThorSortArg::querySortKeyPrefix() { return NULL; }
 
 //CThorTopNArg
 
@@ -332,6 +333,7 @@ ICompare * CThorTopNArg::queryCompareLeftRight() { return NULL; }
 ICompare * CThorTopNArg::queryCompareSerializedRow() { return NULL; }
 unsigned CThorTopNArg::getAlgorithmFlags() { return TAFconstant; }
 const char * CThorTopNArg::getAlgorithm() { return NULL; }
+ISortKeyPrefix * CThorTopNArg::querySortKeyPrefix() { return NULL; }
 
 bool CThorTopNArg::hasBest() { return false; }
 int CThorTopNArg::compareBest(const void * _left) { return +1; }
@@ -347,6 +349,7 @@ IOutputMetaData * CThorSubSortArg::querySortedRecordSize() { return NULL; }
 const char * CThorSubSortArg::getSortedFilename() { return NULL; }
 ICompare * CThorSubSortArg::queryCompareLeftRight() { return NULL; }
 ICompare * CThorSubSortArg::queryCompareSerializedRow() { return NULL; }
+ISortKeyPrefix * CThorSubSortArg::querySortKeyPrefix() { return NULL; }
 
 //CThorKeyedJoinArg
 
@@ -3967,6 +3967,72 @@ unsigned rtlHash32VUnicode(UChar const * k, unsigned initval)
     return rtlHash32Unicode(rtlUnicodeStrlen(k), k, initval);
 }
 
+//---------------------------------------------------------------------------
+// Internal hash functions - never persisted, so free to use a faster algorithm than FNV.
+// Inputs of 32 bytes or more are processed as 4 independent lanes so the multiplies can be pipelined.
+
+hash64_t rtlInternalHash64Data(size32_t len, const void *buf, hash64_t hval)
+{
+    const byte * bp = (const byte *)buf;
+    const byte * be = bp + len;
+    hash64_t h;
+    if (len >= 32)
+    {
+        hash64_t v1 = hval + INTERNAL_HASH_PRIME1 + INTERNAL_HASH_PRIME2;
+        hash64_t v2 = hval + INTERNAL_HASH_PRIME2;
+        hash64_t v3 = hval;
+        hash64_t v4 = hval - INTERNAL_HASH_PRIME1;
+        const byte * limit = be - 32;
+        do
+        {
+            hash64_t next[4];
+            memcpy(next, bp, sizeof(next));
+            v1 = rtlInternalHashRound(v1, next[0]);
+            v2 = rtlInternalHashRound(v2, next[1]);
+            v3 = rtlInternalHashRound(v3, next[2]);
+            v4 = rtlInternalHashRound(v4, next[3]);
+            bp += 32;
+        } while (bp <= limit);
+
+        h = rtlInternalHashRotl(v1, 1) + rtlInternalHashRotl(v2, 7) + rtlInternalHashRotl(v3, 12) + rtlInternalHashRotl(v4, 18);
+        for (hash64_t v : { v1, v2, v3, v4 })
+        {
+            h ^= rtlInternalHashRound(0, v);
+            h = h * INTERNAL_HASH_PRIME1 + INTERNAL_HASH_PRIME4;
+        }
+    }
+    else
+        h = hval + INTERNAL_HASH_PRIME5;
+
+    h += len;
+    while (bp + sizeof(hash64_t) <= be)
+    {
+        h = rtlInternalHashWord(h, bp);
+        bp += sizeof(hash64_t);
+    }
+    if (bp + sizeof(unsigned) <= be)
+    {
+        h = rtlInternalHashHalfWord(h, bp);
+        bp += sizeof(unsigned);
+    }
+    while (bp < be)
+    {
+        h ^= (*bp++) * INTERNAL_HASH_PRIME5;
+        h = rtlInternalHashRotl(h, 11) * INTERNAL_HASH_PRIME1;
+    }
+    return rtlInternalHashFinish(h);
+}
+
+unsigned rtlInternalHash32Data(size32_t len, const void *buf, unsigned hval)
+{
+    return rtlInternalHashFold32(rtlInternalHash64Data(len, buf, hval));
+}
+
+unsigned rtlInternalHash32VStr(const char *str, unsigned hval)
+{
+    return rtlInternalHash32Data(rtlTrimVStrLen(str), str, hval);
+}
+
 
 //---------------------------------------------------------------------------
 // Hash Helper functions
@@ -6541,6 +6607,7 @@ class EclRtlTests : public CppUnit::TestFixture
     CPPUNIT_TEST_SUITE( EclRtlTests );
         CPPUNIT_TEST(RegexTest);
         CPPUNIT_TEST(MultiRegexTest);
+        CPPUNIT_TEST(InternalHashTest);
     CPPUNIT_TEST_SUITE_END();
 
 protected:
@@ -6588,9 +6655,111 @@ protected:
         t2.join();
         t3.join();
     }
+
+    void InternalHashTest()
+    {
+        byte buffer[256+8];
+        for (unsigned i=0; i < sizeof(buffer); i++)
+            buffer[i] = (byte)(i * 37 + 11);
+
+        //The inline fixed size versions must match the general function
+        for (unsigned offset=0; offset < 8; offset++)
+        {
+            ASSERT(rtlInternalHash32Data4(buffer+offset, HASH32_INIT) == rtlInternalHash32Data(4, buffer+offset, HASH32_INIT));
+            ASSERT(rtlInternalHash32Data8(buffer+offset, HASH32_INIT) == rtlInternalHash32Data(8, buffer+offset, HASH32_INIT));
+        }
+
+        //The hash must not depend on the alignment of the data, and every length must give a different value
+        byte copy[256+8];
+        for (unsigned len=0; len <= 256; len++)
+        {
+            hash64_t expected = rtlInternalHash64Data(len, buffer, HASH64_INIT);
+            for (unsigned offset=1; offset < 8; offset++)
+            {
+                memcpy(copy+offset, buffer, len);
+                ASSERT(rtlInternalHash64Data(len, copy+offset, HASH64_INIT) == expected);
+            }
+            if (len)
+                ASSERT(rtlInternalHash64Data(len-1, buffer, HASH64_INIT) != expected);
+        }
+
+        ASSERT(rtlInternalHash32VStr("abc  ", 0) == rtlInternalHash32Data(3, "abc", 0));
+        ASSERT(rtlInternalHash32Data(3, "abc", 0) != rtlInternalHash32Data(3, "abc", 1));
+
+        //Flipping a single input bit should change roughly half the output bits
+        unsigned totalChanged = 0;
+        unsigned numTests = 0;
+        for (unsigned len : { 4, 8, 13, 40 })
+        {
+            for (unsigned bit=0; bit < len*8; bit++)
+            {
+                hash64_t before = rtlInternalHash64Data(len, buffer, HASH64_INIT);
+                buffer[bit/8] ^= (byte)(1 << (bit % 8));
+                hash64_t after = rtlInternalHash64Data(len, buffer, HASH64_INIT);
+                buffer[bit/8] ^= (byte)(1 << (bit % 8));
+                totalChanged += countBits(before ^ after);
+                numTests++;
+            }
+        }
+        unsigned averageChanged = totalChanged / numTests;
+        ASSERT(averageChanged >= 28 && averageChanged <= 36);
+
+        //Sequential integers should be spread evenly over the low bits (which are used to select a hash bucket)
+        const unsigned numBuckets = 1024;
+        const unsigned numValues = numBuckets * 256;
+        unsigned counts[numBuckets] = { 0 };
+        for (unsigned __int64 i=0; i < numValues; i++)
+            counts[rtlInternalHash32Data8(&i, HASH32_INIT) % numBuckets]++;
+        for (unsigned i=0; i < numBuckets; i++)
+            ASSERT(counts[i] > 256/2 && counts[i] < 256*2);
+    }
+
+    static unsigned countBits(hash64_t value)
+    {
+        unsigned count = 0;
+        for (; value; value &= value-1)
+            count++;
+        return count;
+    }
 };
 
 CPPUNIT_TEST_SUITE_REGISTRATION( EclRtlTests );
 CPPUNIT_TEST_SUITE_NAMED_REGISTRATION( EclRtlTests, "EclRtlTests" );
 
+class EclRtlHashTiming : public CppUnit::TestFixture
+{
+    CPPUNIT_TEST_SUITE( EclRtlHashTiming );
+        CPPUNIT_TEST(testHashSpeed);
+    CPPUNIT_TEST_SUITE_END();
+
+protected:
+    void testHashSpeed()
+    {
+        byte buffer[1024];
+        for (unsigned i=0; i < sizeof(buffer); i++)
+            buffer[i] = (byte)(i * 37 + 11);
+
+        for (unsigned len : { 4, 8, 16, 40, 100, 1000 })
+        {
+            const unsigned numIter = 100000000 / (len + 16);
+            unsigned total = 0;
+            cycle_t start = get_cycles_now();
+            for (unsigned pass=0; pass < numIter; pass++)
+                total += rtlHash32Data(len, buffer, pass);
+            cycle_t fnvElapsed = get_cycles_now() - start;
+
+            start = get_cycles_now();
+            for (unsigned pass=0; pass < numIter; pass++)
+                total += rtlInternalHash32Data(len, buffer, pass);
+            cycle_t internalElapsed = get_cycles_now() - start;
+
+            DBGLOG("Hash of %u bytes: rtlHash32Data %.2fns rtlInternalHash32Data %.2fns (%u)", len,
+                   (double)cycle_to_nanosec(fnvElapsed) / numIter, (double)cycle_to_nanosec(internalElapsed) / numIter, total);
+        }
+    }
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION( EclRtlHashTiming );
+CPPUNIT_TEST_SUITE_NAMED_REGISTRATION( EclRtlHashTiming, "EclRtlHashTiming" );
+
 #endif
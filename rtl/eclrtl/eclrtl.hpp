@@ -395,6 +395,13 @@ ECLRTL_API unsigned rtlHash32Unicode(unsigned length, UChar const * k, unsigned
 ECLRTL_API unsigned rtlHash32Utf8(unsigned length, const char * k, unsigned initval);
 ECLRTL_API unsigned rtlHash32VUnicode(UChar const * k, unsigned initval);
 
+//The internal hash functions process the data a word at a time, so are much faster than the functions above.
+//They should only be used for values that never leave the current process (e.g. in-memory hash tables) - the
+//results may change between builds, and chaining two calls is not equivalent to hashing the concatenated data.
+ECLRTL_API hash64_t rtlInternalHash64Data(size32_t len, const void *buf, hash64_t hval);
+ECLRTL_API unsigned rtlInternalHash32Data(size32_t len, const void *buf, unsigned hval);
+ECLRTL_API unsigned rtlInternalHash32VStr(const char *str, unsigned hval);
+
 ECLRTL_API unsigned rtlCrcData( unsigned length, const void *_k, unsigned initval);
 ECLRTL_API unsigned rtlCrcUnicode(unsigned length, UChar const * k, unsigned initval);
 ECLRTL_API unsigned rtlCrcUtf8(unsigned length, const char * k, unsigned initval);
@@ -329,4 +329,111 @@ inline unsigned rtlHash32Data8(const void *_buf, unsigned hval)
                 buf[7]);
 }
 
+//Inline building blocks for the internal hash functions - word at a time with a multiply/rotate mixing step.
+//rtlInternalHash32Data4/8 must return exactly the same values as rtlInternalHash32Data() for the same length,
+//since a fixed length field on one side of a join can be matched against a variable length field on the other.
+#define INTERNAL_HASH_PRIME1 I64C(0x9E3779B185EBCA87)
+#define INTERNAL_HASH_PRIME2 I64C(0xC2B2AE3D27D4EB4F)
+#define INTERNAL_HASH_PRIME3 I64C(0x165667B19E3779F9)
+#define INTERNAL_HASH_PRIME4 I64C(0x85EBCA77C2B2AE63)
+#define INTERNAL_HASH_PRIME5 I64C(0x27D4EB2F165667C5)
+
+inline hash64_t rtlInternalHashRotl(hash64_t value, unsigned shift)
+{
+    return (value << shift) | (value >> (64 - shift));
+}
+
+inline hash64_t rtlInternalHashRound(hash64_t acc, hash64_t next)
+{
+    acc += next * INTERNAL_HASH_PRIME2;
+    acc = rtlInternalHashRotl(acc, 31);
+    return acc * INTERNAL_HASH_PRIME1;
+}
+
+inline hash64_t rtlInternalHashWord(hash64_t hval, const void * buf)
+{
+    hash64_t next;
+    memcpy(&next, buf, sizeof(next));
+    hval ^= rtlInternalHashRound(0, next);
+    return rtlInternalHashRotl(hval, 27) * INTERNAL_HASH_PRIME1 + INTERNAL_HASH_PRIME4;
+}
+
+inline hash64_t rtlInternalHashHalfWord(hash64_t hval, const void * buf)
+{
+    unsigned next;
+    memcpy(&next, buf, sizeof(next));
+    hval ^= (hash64_t)next * INTERNAL_HASH_PRIME1;
+    return rtlInternalHashRotl(hval, 23) * INTERNAL_HASH_PRIME2 + INTERNAL_HASH_PRIME3;
+}
+
+inline hash64_t rtlInternalHashFinish(hash64_t hval)
+{
+    hval ^= hval >> 33;
+    hval *= INTERNAL_HASH_PRIME2;
+    hval ^= hval >> 29;
+    hval *= INTERNAL_HASH_PRIME3;
+    hval ^= hval >> 32;
+    return hval;
+}
+
+inline unsigned rtlInternalHashFold32(hash64_t hval)
+{
+    return (unsigned)(hval ^ (hval >> 32));
+}
+
+inline unsigned rtlInternalHash32Data4(const void *_buf, unsigned hval)
+{
+    hash64_t h = (hash64_t)hval + INTERNAL_HASH_PRIME5 + 4;
+    return rtlInternalHashFold32(rtlInternalHashFinish(rtlInternalHashHalfWord(h, _buf)));
+}
+
+inline unsigned rtlInternalHash32Data8(const void *_buf, unsigned hval)
+{
+    hash64_t h = (hash64_t)hval + INTERNAL_HASH_PRIME5 + 8;
+    return rtlInternalHashFold32(rtlInternalHashFinish(rtlInternalHashWord(h, _buf)));
+}
+
+//Building blocks for the generated ISortKeyPrefix::buildPrefix().  Each writes width bytes which compare (with memcmp)
+//in the same order as the value.  If width is smaller than the natural size only the most significant bytes are written.
+inline void rtlSortPrefixUInt(byte * target, unsigned width, unsigned __int64 value, unsigned size)
+{
+    for (unsigned i=0; i < width; i++)
+        target[i] = (byte)(value >> ((size - 1 - i) * 8));
+}
+
+inline void rtlSortPrefixInt(byte * target, unsigned width, __int64 value, unsigned size)
+{
+    //Flipping the sign bit maps the signed range onto an unsigned range with the same ordering
+    rtlSortPrefixUInt(target, width, (unsigned __int64)value ^ ((unsigned __int64)1 << (size * 8 - 1)), size);
+}
+
+//Strings compare as if padded with spaces, data as if padded with zero bytes.
+inline void rtlSortPrefixStr(byte * target, unsigned width, size32_t len, const char * str)
+{
+    if (len >= width)
+        memcpy(target, str, width);
+    else
+    {
+        memcpy(target, str, len);
+        memset(target + len, ' ', width - len);
+    }
+}
+
+inline void rtlSortPrefixData(byte * target, unsigned width, size32_t len, const void * data)
+{
+    if (len >= width)
+        memcpy(target, data, width);
+    else
+    {
+        memcpy(target, data, len);
+        memset(target + len, 0, width - len);
+    }
+}
+
+inline void rtlSortPrefixDescending(byte * target, unsigned width)
+{
+    for (unsigned i=0; i < width; i++)
+        target[i] = ~target[i];
+}
+
 #endif
@@ -48,7 +48,7 @@ typedef unsigned short UChar;
 
 //Should be incremented whenever the virtuals in the context or a helper are changed, so
 //that a work unit can't be rerun.  Try as hard as possible to retain compatibility.
-#define ACTIVITY_INTERFACE_VERSION      653
+#define ACTIVITY_INTERFACE_VERSION      654
 #define MIN_ACTIVITY_INTERFACE_VERSION  650             //minimum value that is compatible with current interface
 
 typedef unsigned char byte;
@@ -1075,6 +1075,19 @@ inline bool isSimpleJoin(ThorActivityKind kind) { return (kind >= TAKjoin) && (k
 inline bool isDenormalizeJoin(ThorActivityKind kind) { return (kind >= TAKdenormalize) && (kind <= TAKlastdenormalize); }
 inline bool isDenormalizeGroupJoin(ThorActivityKind kind) { return (kind >= TAKdenormalizegroup) && (kind <= TAKlastdenormalizegroup); }
 
+//A fixed width key prefix, which orders rows in the same way as the sort's compare function when compared with memcmp.
+//If two prefixes differ the rows are ordered by the prefixes, if they match the full compare function must be used
+//unless isExact() is true, in which case the rows are known to compare equal.
+#define MAX_SORT_KEY_PREFIX 16
+struct ISortKeyPrefix
+{
+    virtual size32_t getPrefixSize() const = 0;                                 // <= MAX_SORT_KEY_PREFIX
+    virtual void buildPrefix(byte * target, const void * row) const = 0;        // fills getPrefixSize() bytes
+    virtual bool isExact() const = 0;                                           // prefix covers the whole sort order
+protected:
+    virtual ~ISortKeyPrefix() {}
+};
+
 struct ISortKeySerializer
 {
     virtual size32_t keyToRecord(ARowBuilder & rowBuilder, const void * _key, size32_t & recordSize) = 0;       // both return size of key!
@@ -1636,6 +1649,7 @@ enum
     TAFunstable         = 0x0004,
     TAFspill            = 0x0008,
     TAFparallel         = 0x0010,
+    TAFsortkeyprefix    = 0x0020,       // querySortKeyPrefix() is implemented (helpers generated before version 654 do not have it)
 };
 
 struct IHThorSortArg : public IHThorArg
@@ -1652,6 +1666,10 @@ struct IHThorSortArg : public IHThorArg
     virtual ICompare * queryCompareSerializedRow()=0;                           // null if row already serialized, or if compare not available
     virtual unsigned getAlgorithmFlags() = 0;
     virtual const char * getAlgorithm() = 0;
+    virtual ISortKeyPrefix * querySortKeyPrefix() = 0;                          // null if the sort order cannot be represented as a prefix
+
+    //Engines must use this rather than calling querySortKeyPrefix() directly, so that older helpers can still be used
+    inline ISortKeyPrefix * queryOptSortKeyPrefix() { return (getAlgorithmFlags() & TAFsortkeyprefix) ? querySortKeyPrefix() : nullptr; }
 };
 
 typedef IHThorSortArg IHThorSortedArg;
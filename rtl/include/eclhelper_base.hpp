@@ -429,6 +429,7 @@ class ECLRTL_API CThorSortArg : public CThorArgOf<IHThorSortArg>
     virtual ICompare * queryCompareSerializedRow() override;
     virtual unsigned getAlgorithmFlags() override;
     virtual const char * getAlgorithm() override;
+    virtual ISortKeyPrefix * querySortKeyPrefix() override;
 };
 
 class ECLRTL_API CThorTopNArg : public CThorArgOf<IHThorTopNArg>
@@ -444,6 +445,7 @@ class ECLRTL_API CThorTopNArg : public CThorArgOf<IHThorTopNArg>
     virtual ICompare * queryCompareSerializedRow() override;
     virtual unsigned getAlgorithmFlags() override;
     virtual const char * getAlgorithm() override;
+    virtual ISortKeyPrefix * querySortKeyPrefix() override;
 
     virtual bool hasBest() override;
     virtual int compareBest(const void * _left) override;
@@ -460,6 +462,7 @@ class ECLRTL_API CThorSubSortArg : public CThorArgOf<IHThorSubSortArg>
     virtual const char * getSortedFilename() override;
     virtual ICompare * queryCompareLeftRight() override;
     virtual ICompare * queryCompareSerializedRow() override;
+    virtual ISortKeyPrefix * querySortKeyPrefix() override;
 };
 
 class ECLRTL_API CThorKeyedJoinArg : public CThorArgOf<IHThorKeyedJoinArg>
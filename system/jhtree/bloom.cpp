@@ -16,6 +16,7 @@
 ############################################################################## */
 
 #include "platform.h"
+#include <algorithm>
 #include "jlib.hpp"
 #include "jset.hpp"
 #include "bloom.hpp"
@@ -23,31 +24,131 @@
 #include "eclhelper.hpp"
 #include "rtlrecord.hpp"
 
-BloomFilter::BloomFilter(unsigned _cardinality, double _probability)
+// Blocked filters set one bit in each 64bit lane of a 64 byte block.  The bit within each lane is selected by multiplying
+// the low 32 bits of the hash by a different odd constant and taking the top 6 bits of the result.
+static constexpr unsigned bloomBlockSize = 64;
+static constexpr unsigned bloomBlockLanes = bloomBlockSize / sizeof(uint64_t);
+static constexpr uint32_t bloomBlockSalts[bloomBlockLanes] = { 0x47b6137bU, 0x44974d91U, 0x8824ad5bU, 0xa2b7289dU, 0x705495c7U, 0x2df1424bU, 0x9efc4947U, 0x5c6bfb31U };
+static constexpr unsigned bloomTestBatch = 16;
+
+static inline hash64_t mixBloomHash(hash64_t hash)
+{
+    // The block and the bits within it are taken from different halves of the hash, so make sure every bit of the
+    // hash affects both halves.
+    hash ^= hash >> 33;
+    hash *= 0xff51afd7ed558ccdULL;
+    hash ^= hash >> 33;
+    hash *= 0xc4ceb9fe1a85ec53ULL;
+    hash ^= hash >> 33;
+    return hash;
+}
+
+static inline const uint64_t * queryBloomBlock(const byte * table, unsigned numBlocks, hash64_t mixed)
+{
+    uint64_t block = ((mixed >> 32) * numBlocks) >> 32;
+    return (const uint64_t *)(table + block * bloomBlockSize);
+}
+
+static inline bool testBloomBlock(const uint64_t * block, uint32_t lowHash)
+{
+    uint64_t found = 1;
+    for (unsigned i=0; i < bloomBlockLanes; i++)
+        found &= block[i] >> ((lowHash * bloomBlockSalts[i]) >> 26);
+    return found != 0;
+}
+
+// The expected false positive rate of a blocked filter.  The number of values in each block follows a Poisson distribution.
+static double getBlockedFalsePositiveRate(double valuesPerBlock)
+{
+    const double bitsPerLane = sizeof(uint64_t) * 8;
+    double probability = exp(-valuesPerBlock);
+    double rate = 0.0;
+    unsigned maxValues = (unsigned)(valuesPerBlock + 10 * sqrt(valuesPerBlock) + 20);
+    for (unsigned values = 0; values <= maxValues; values++)
+    {
+        double laneBitSet = 1.0 - pow(1.0 - 1.0 / bitsPerLane, values);
+        rate += probability * pow(laneBitSet, bloomBlockLanes);
+        probability = probability * valuesPerBlock / (values + 1);
+    }
+    return rate;
+}
+
+BloomFilter::BloomFilter(unsigned _cardinality, double _probability, bool _blocked) : blocked(_blocked)
 {
     unsigned cardinality = _cardinality ? _cardinality : 1;
     double probability = _probability >= 0.3 ? 0.3 : (_probability < 0.01 ? 0.01 : _probability);
     numBits = rtlRoundUp(-(cardinality*log(probability))/pow(log(2),2));
+    if (blocked)
+    {
+        // Start from the size of the equivalent classic filter, and grow it until the uneven load on the blocks is accounted for
+        const unsigned blockBits = bloomBlockSize * 8;
+        unsigned blocks = (numBits + blockBits - 1) / blockBits;
+        while (getBlockedFalsePositiveRate((double)cardinality / blocks) > probability)
+            blocks += (blocks + 31) / 32;
+        numHashes = bloomBlockLanes;
+        allocateBlocks(blocks * bloomBlockSize);
+        return;
+    }
     unsigned tableSize = (numBits + 7) / 8;
     numBits = tableSize * 8;
     numHashes = round((numBits * log(2))/cardinality);
     table = (byte *) calloc(tableSize, 1);
 }
 
-BloomFilter::BloomFilter(unsigned _numHashes, unsigned _tableSize, byte *_table)
+BloomFilter::BloomFilter(unsigned _numHashes, unsigned _tableSize, byte *_table, bool _blocked) : blocked(_blocked)
 {
     numBits = _tableSize * 8;
     numHashes = _numHashes;
-    table = _table;  // Note - takes ownership
+    if (blocked)
+    {
+        // Copy the table so that each block is within a single cache line
+        assertex(_tableSize && (_tableSize % bloomBlockSize == 0) && (numHashes == bloomBlockLanes));
+        allocateBlocks(_tableSize);
+        memcpy(table, _table, _tableSize);
+        free(_table);
+    }
+    else
+        table = _table;  // Note - takes ownership
 }
 
 BloomFilter::~BloomFilter()
 {
-    free(table);
+    if (allocated)
+        free(allocated);
+    else
+        free(table);
+}
+
+void BloomFilter::allocateBlocks(unsigned tableSize)
+{
+    numBlocks = tableSize / bloomBlockSize;
+    numBits = tableSize * 8;
+    allocated = calloc(tableSize + bloomBlockSize - 1, 1);
+    table = (byte *)(((memsize_t)allocated + bloomBlockSize - 1) & ~(memsize_t)(bloomBlockSize - 1));
+}
+
+void BloomFilter::addBlocked(hash64_t hash)
+{
+    hash64_t mixed = mixBloomHash(hash);
+    uint64_t * block = const_cast<uint64_t *>(queryBloomBlock(table, numBlocks, mixed));
+    uint32_t lowHash = (uint32_t)mixed;
+    for (unsigned i=0; i < bloomBlockLanes; i++)
+        block[i] |= ((uint64_t)1) << ((lowHash * bloomBlockSalts[i]) >> 26);
+}
+
+bool BloomFilter::testBlocked(hash64_t hash) const
+{
+    hash64_t mixed = mixBloomHash(hash);
+    return testBloomBlock(queryBloomBlock(table, numBlocks, mixed), (uint32_t)mixed);
 }
 
 void BloomFilter::add(hash64_t hash)
 {
+    if (blocked)
+    {
+        addBlocked(hash);
+        return;
+    }
     uint32_t hash1 = hash >> 32;
     uint32_t hash2 = hash & 0xffffffff;
     for (unsigned i=0; i < numHashes; i++)
@@ -63,6 +164,8 @@ void BloomFilter::add(hash64_t hash)
 
 bool BloomFilter::test(hash64_t hash) const
 {
+    if (blocked)
+        return testBlocked(hash);
     uint32_t hash1 = hash >> 32;
     uint32_t hash2 = hash & 0xffffffff;
     for (unsigned i=0; i < numHashes; i++)
@@ -78,8 +181,45 @@ bool BloomFilter::test(hash64_t hash) const
     return true;
 }
 
-IndexBloomFilter::IndexBloomFilter(unsigned _numHashes, unsigned _tableSize, byte *_table, __uint64 _fields)
-: BloomFilter(_numHashes, _tableSize, _table), fields(_fields)
+unsigned BloomFilter::testMany(unsigned num, const hash64_t * hashes, bool * results) const
+{
+    unsigned rejected = 0;
+    if (!blocked)
+    {
+        for (unsigned i=0; i < num; i++)
+        {
+            results[i] = test(hashes[i]);
+            if (!results[i])
+                rejected++;
+        }
+        return rejected;
+    }
+
+    const uint64_t * blocks[bloomTestBatch];
+    uint32_t lowHashes[bloomTestBatch];
+    for (unsigned base=0; base < num; base += bloomTestBatch)
+    {
+        unsigned batch = std::min(num - base, bloomTestBatch);
+        for (unsigned i=0; i < batch; i++)
+        {
+            hash64_t mixed = mixBloomHash(hashes[base+i]);
+            blocks[i] = queryBloomBlock(table, numBlocks, mixed);
+            lowHashes[i] = (uint32_t)mixed;
+            __builtin_prefetch(blocks[i]);
+        }
+        for (unsigned i=0; i < batch; i++)
+        {
+            bool match = testBloomBlock(blocks[i], lowHashes[i]);
+            results[base+i] = match;
+            if (!match)
+                rejected++;
+        }
+    }
+    return rejected;
+}
+
+IndexBloomFilter::IndexBloomFilter(unsigned _numHashes, unsigned _tableSize, byte *_table, __uint64 _fields, bool _blocked)
+: BloomFilter(_numHashes, _tableSize, _table, _blocked), fields(_fields)
 {}
 
 int IndexBloomFilter::compare(CInterface *const *_a, CInterface *const *_b)
@@ -95,6 +235,12 @@ bool IndexBloomFilter::reject(const IIndexFilterList &filters) const
     return getBloomHash(fields, filters, hashval) && !test(hashval);
 }
 
+bool IndexBloomFilter::getProbe(const IIndexFilterList &filters, hash64_t &hashval) const
+{
+    hashval = HASH64_INIT;
+    return getBloomHash(fields, filters, hashval);
+}
+
 extern bool getBloomHash(__int64 fields, const IIndexFilterList &filters, hash64_t &hashval)
 {
     while (fields)
@@ -166,8 +312,8 @@ hash64_t SimpleRowHasher::hash(const byte *row) const
 class jhtree_decl SortedBloomBuilder : public CInterfaceOf<IBloomBuilder>
 {
 public:
-    SortedBloomBuilder(const IBloomBuilderInfo &_helper);
-    SortedBloomBuilder(unsigned _maxHashes, double _probability);
+    SortedBloomBuilder(const IBloomBuilderInfo &_helper, bool _blocked);
+    SortedBloomBuilder(unsigned _maxHashes, double _probability, bool _blocked=true);
     virtual const BloomFilter * build() const override;
     virtual bool add(hash64_t val) override;
     virtual unsigned queryCount() const override;
@@ -179,19 +325,22 @@ protected:
     hash64_t lastHash = 0;
     const double probability = 0.0;
     bool isValid = true;
+    const bool blocked;
 };
 
-SortedBloomBuilder::SortedBloomBuilder(const IBloomBuilderInfo &helper)
+SortedBloomBuilder::SortedBloomBuilder(const IBloomBuilderInfo &helper, bool _blocked)
 : maxHashes(helper.getBloomLimit()),
-  probability(helper.getBloomProbability())
+  probability(helper.getBloomProbability()),
+  blocked(_blocked)
 {
     if (maxHashes==0 || !helper.getBloomEnabled())
         isValid = false;
 }
 
-SortedBloomBuilder::SortedBloomBuilder(unsigned _maxHashes, double _probability)
+SortedBloomBuilder::SortedBloomBuilder(unsigned _maxHashes, double _probability, bool _blocked)
 : maxHashes(_maxHashes),
-  probability(_probability)
+  probability(_probability),
+  blocked(_blocked)
 {
     if (maxHashes==0)
         isValid = false;
@@ -227,7 +376,7 @@ const BloomFilter * SortedBloomBuilder::build() const
 {
     if (!valid())
         return nullptr;
-    BloomFilter *b = new BloomFilter(hashes.length(), probability);
+    BloomFilter *b = new BloomFilter(hashes.length(), probability, blocked);
     ForEachItemIn(idx, hashes)
     {
         b->add(hashes.item(idx));
@@ -240,8 +389,8 @@ const BloomFilter * SortedBloomBuilder::build() const
 class jhtree_decl UnsortedBloomBuilder : public CInterfaceOf<IBloomBuilder>
 {
 public:
-    UnsortedBloomBuilder(const IBloomBuilderInfo &_helper);
-    UnsortedBloomBuilder(unsigned _maxHashes, double _probability);
+    UnsortedBloomBuilder(const IBloomBuilderInfo &_helper, bool _blocked);
+    UnsortedBloomBuilder(unsigned _maxHashes, double _probability, bool _blocked=true);
     ~UnsortedBloomBuilder();
     virtual const BloomFilter * build() const override;
     virtual bool add(hash64_t val) override;
@@ -254,13 +403,15 @@ protected:
     const unsigned tableSize;
     unsigned tableCount = 0;
     const double probability = 0.0;
+    const bool blocked;
 };
 
 
-UnsortedBloomBuilder::UnsortedBloomBuilder(const IBloomBuilderInfo &helper)
+UnsortedBloomBuilder::UnsortedBloomBuilder(const IBloomBuilderInfo &helper, bool _blocked)
 : maxHashes(helper.getBloomLimit()),
   probability(helper.getBloomProbability()),
-  tableSize(((helper.getBloomLimit()*4)/3)+1)
+  tableSize(((helper.getBloomLimit()*4)/3)+1),
+  blocked(_blocked)
 {
     if (tableSize && helper.getBloomEnabled())
     {
@@ -269,10 +420,11 @@ UnsortedBloomBuilder::UnsortedBloomBuilder(const IBloomBuilderInfo &helper)
 
 }
 
-UnsortedBloomBuilder::UnsortedBloomBuilder(unsigned _maxHashes, double _probability)
+UnsortedBloomBuilder::UnsortedBloomBuilder(unsigned _maxHashes, double _probability, bool _blocked)
 : maxHashes(_maxHashes),
   probability(_probability),
-  tableSize(((_maxHashes*4)/3)+1)
+  tableSize(((_maxHashes*4)/3)+1),
+  blocked(_blocked)
 {
     if (tableSize)
         hashes = (hash64_t *) calloc(sizeof(hash64_t), tableSize);
@@ -338,7 +490,7 @@ const BloomFilter * UnsortedBloomBuilder::build() const
 {
     if (!valid())
         return nullptr;
-    BloomFilter *b = new BloomFilter(tableCount, probability);
+    BloomFilter *b = new BloomFilter(tableCount, probability, blocked);
     for (unsigned idx = 0; idx < tableSize; idx++)
     {
         hash64_t val = hashes[idx];
@@ -348,13 +500,13 @@ const BloomFilter * UnsortedBloomBuilder::build() const
     return b;
 }
 
-extern jhtree_decl IBloomBuilder *createBloomBuilder(const IBloomBuilderInfo &helper)
+extern jhtree_decl IBloomBuilder *createBloomBuilder(const IBloomBuilderInfo &helper, bool blocked)
 {
     __uint64 fields = helper.getBloomFields();
     if (!(fields & (fields+1)))   // only true if all the ones are at the lsb end...
-        return new SortedBloomBuilder(helper);
+        return new SortedBloomBuilder(helper, blocked);
     else
-        return new UnsortedBloomBuilder(helper);
+        return new UnsortedBloomBuilder(helper, blocked);
 }
 
 extern jhtree_decl IRowHasher *createRowHasher(const RtlRecord &recInfo, __uint64 fields)
@@ -385,6 +537,8 @@ class BloomTest : public CppUnit::TestFixture
     CPPUNIT_TEST(testUnsortedBloom);
     CPPUNIT_TEST(testFailedSortedBloomBuilder);
     CPPUNIT_TEST(testFailedUnsortedBloomBuilder);
+    CPPUNIT_TEST(testBlockedFormats);
+    CPPUNIT_TEST(testTestMany);
     CPPUNIT_TEST_SUITE_END();
 
     const unsigned count = 1000000;
@@ -463,10 +617,125 @@ class BloomTest : public CppUnit::TestFixture
         ASSERT(!b3.add(2))
     }
 
+    void checkFalsePositives(bool blocked, double probability)
+    {
+        SortedBloomBuilder b(count, probability, blocked);
+        for (unsigned val = 0; val < count; val++)
+            b.add(rtlHash64Data(sizeof(val), &val, HASH64_INIT));
+        Owned<const BloomFilter> f = b.build();
+        CPPUNIT_ASSERT_EQUAL(blocked, f->isBlocked());
+        unsigned falsePositives = 0;
+        for (unsigned val = 0; val < count; val++)
+        {
+            unsigned missing = val + count;
+            CPPUNIT_ASSERT(f->test(rtlHash64Data(sizeof(val), &val, HASH64_INIT)));
+            if (f->test(rtlHash64Data(sizeof(missing), &missing, HASH64_INIT)))
+                falsePositives++;
+        }
+        double rate = (double)falsePositives / count;
+        DBGLOG("%s bloom filter (%u, %u) for p=%.03f gave %.03f %% false positives", blocked ? "Blocked" : "Classic", f->queryNumHashes(), f->queryTableSize(), probability, rate * 100);
+        CPPUNIT_ASSERT(rate < probability * 1.2);
+
+        //Check that a table reloaded from its serialized form gives the same results
+        byte * copy = (byte *)malloc(f->queryTableSize());
+        memcpy(copy, f->queryTable(), f->queryTableSize());
+        IndexBloomFilter reloaded(f->queryNumHashes(), f->queryTableSize(), copy, 1, blocked);
+        for (unsigned val = 0; val < 2 * count; val += 97)
+        {
+            hash64_t hash = rtlHash64Data(sizeof(val), &val, HASH64_INIT);
+            CPPUNIT_ASSERT_EQUAL(f->test(hash), reloaded.test(hash));
+        }
+    }
+
+    void testBlockedFormats()
+    {
+        checkFalsePositives(false, 0.01);
+        checkFalsePositives(true, 0.01);
+        checkFalsePositives(true, 0.05);
+        checkFalsePositives(true, 0.3);
+    }
+
+    void testTestMany()
+    {
+        for (unsigned pass = 0; pass < 2; pass++)
+        {
+            bool blocked = (pass != 0);
+            UnsortedBloomBuilder b(count, 0.02, blocked);
+            for (unsigned val = 0; val < count; val += 2)
+                b.add(rtlHash64Data(sizeof(val), &val, HASH64_INIT));
+            Owned<const BloomFilter> f = b.build();
+
+            //Use a length that is not a multiple of the internal batch size
+            const unsigned num = 1001;
+            hash64_t hashes[num];
+            bool results[num];
+            unsigned expectedRejected = 0;
+            for (unsigned val = 0; val < num; val++)
+            {
+                hashes[val] = rtlHash64Data(sizeof(val), &val, HASH64_INIT);
+                if (!f->test(hashes[val]))
+                    expectedRejected++;
+            }
+            unsigned rejected = f->testMany(num, hashes, results);
+            CPPUNIT_ASSERT_EQUAL(expectedRejected, rejected);
+            for (unsigned val = 0; val < num; val++)
+            {
+                CPPUNIT_ASSERT_EQUAL(f->test(hashes[val]), results[val]);
+                if ((val % 2) == 0)
+                    CPPUNIT_ASSERT(results[val]);
+            }
+        }
+    }
 
 };
 
 CPPUNIT_TEST_SUITE_REGISTRATION( BloomTest );
 CPPUNIT_TEST_SUITE_NAMED_REGISTRATION( BloomTest, "BloomTest" );
 
+class BloomTimingTest : public CppUnit::TestFixture
+{
+    CPPUNIT_TEST_SUITE(BloomTimingTest);
+    CPPUNIT_TEST(testTiming);
+    CPPUNIT_TEST_SUITE_END();
+
+    void testTiming()
+    {
+        //Large enough that the table does not fit in the cache
+        const unsigned count = 20000000;
+        const unsigned numProbes = 4000000;
+        hash64_t * probes = new hash64_t[numProbes];
+        bool * results = new bool[numProbes];
+        for (unsigned i = 0; i < numProbes; i++)
+        {
+            unsigned val = i * 7;
+            probes[i] = rtlHash64Data(sizeof(val), &val, HASH64_INIT);
+        }
+        for (unsigned pass = 0; pass < 2; pass++)
+        {
+            bool blocked = (pass != 0);
+            Owned<BloomFilter> f = new BloomFilter(count, 0.01, blocked);
+            for (unsigned val = 0; val < count; val += 2)
+                f->add(rtlHash64Data(sizeof(val), &val, HASH64_INIT));
+
+            unsigned matches = 0;
+            CCycleTimer timer;
+            for (unsigned i = 0; i < numProbes; i++)
+            {
+                if (f->test(probes[i]))
+                    matches++;
+            }
+            unsigned __int64 singleNs = timer.elapsedNs();
+            timer.reset();
+            unsigned rejected = f->testMany(numProbes, probes, results);
+            unsigned __int64 batchNs = timer.elapsedNs();
+            CPPUNIT_ASSERT_EQUAL(numProbes - matches, rejected);
+            DBGLOG("%s bloom filter size %u: test() %.1f ns/probe testMany() %.1f ns/probe", blocked ? "Blocked" : "Classic", f->queryTableSize(), (double)singleNs / numProbes, (double)batchNs / numProbes);
+        }
+        delete [] probes;
+        delete [] results;
+    }
+};
+
+CPPUNIT_TEST_SUITE_NAMED_REGISTRATION( BloomTimingTest, "BloomTimingTest" );
+
 #endif
@@ -27,6 +27,7 @@
 #include "hlzw.h"
 
 #include "ctfile.hpp"
+#include "jhsearch.hpp"
 #include "jstats.h"
 #include "zcrypt.hpp"
 
@@ -84,6 +85,7 @@ void SwapBigEndian(KeyHdr &hdr)
     _WINREV(hdr.bloomHead);
     _WINREV(hdr.partitionFieldMask);
     _WINREV(hdr.firstLeaf);
+    _WINREV(hdr.blockedBloomHead);
 }
 
 inline void SwapBigEndian(NodeHdr &hdr)
@@ -730,18 +732,7 @@ int CJHSplitSearchNode::locateGE(const char * search, unsigned minIndex) const
 #ifdef TIME_NODE_SEARCH
     CCycleTimer timer;
 #endif
-    unsigned int a = minIndex;
-    int b = getNumKeys();
-    // first search for first GTE entry (result in b(<),a(>=))
-    while ((int)a<b)
-    {
-        int i = a+(b-a)/2;
-        int rc = compareValueAt(search, i);
-        if (rc>0)
-            a = i+1;
-        else
-            b = i;
-    }
+    unsigned int a = findGEFixedRows(keyRows, keyRecLen, minIndex, getNumKeys(), (const byte *)search, keyRecLen, commonPrefixLen);
 
 #ifdef TIME_NODE_SEARCH
     unsigned __int64 elapsed = timer.elapsedCycles();
@@ -793,6 +784,7 @@ void CJHSplitSearchNode::load(CKeyHdr *keyHdr, const void *rawData, offset_t fpo
     keyRecLen = keyHdr->getNodeKeyLength();
     keyRows = nodeData + sizeof(NodeHdr) + sizeof(SplitNodeHdr);
     payloadOffsets = (const short *) (keyRows + keyRecLen*getNumKeys());
+    commonPrefixLen = getCommonPrefixLen(keyRows, keyRecLen, getNumKeys(), keyRecLen);
 }
 
 void CJHSplitSearchNode::dump(FILE *out, int length, unsigned rowCount, bool raw) const
@@ -809,16 +801,21 @@ int CJHLegacySearchNode::locateGE(const char * search, unsigned minIndex) const
     CCycleTimer timer;
 #endif
     unsigned int a = minIndex;
-    int b = getNumKeys();
-    // first search for first GTE entry (result in b(<),a(>=))
-    while ((int)a<b)
+    if (fixedRows)
+        a = findGEFixedRows(fixedRows, keyRecLen, minIndex, getNumKeys(), (const byte *)search, keyCompareLen, commonPrefixLen);
+    else
     {
-        int i = a+(b-a)/2;
-        int rc = compareValueAt(search, i);
-        if (rc>0)
-            a = i+1;
-        else
-            b = i;
+        int b = getNumKeys();
+        // first search for first GTE entry (result in b(<),a(>=))
+        while ((int)a<b)
+        {
+            int i = a+(b-a)/2;
+            int rc = compareValueAt(search, i);
+            if (rc>0)
+                a = i+1;
+            else
+                b = i;
+        }
     }
 
 #ifdef TIME_NODE_SEARCH
@@ -967,6 +964,13 @@ void CJHLegacySearchNode::load(CKeyHdr *_keyHdr, const void *rawData, offset_t _
             expandedSize = 0;
         }
     }
+
+    //Variable and row compressed leaves cannot be searched directly - derived classes implement compareValueAt
+    if (keyBuf && !(isLeaf() && (keyHdr->isVariable() || keyHdr->isRowCompressed())))
+    {
+        fixedRows = (const byte *)keyBuf + (keyHdr->hasSpecialFileposition() ? sizeof(offset_t) : 0);
+        commonPrefixLen = getCommonPrefixLen(fixedRows, keyRecLen, getNumKeys(), keyCompareLen);
+    }
 }
 
 offset_t CJHSearchNode::prevNodeFpos() const
@@ -102,6 +102,7 @@ struct __declspec(novtable) jhtree_decl KeyHdr
     __int64 bloomHead; /* fpos of bloom table data, if present 100x */
     __uint64 partitionFieldMask; /* Bitmap indicating partition keyed fields 108x */
     __int64 firstLeaf; /* fpos of first leaf node 110x */
+    __int64 blockedBloomHead; /* fpos of blocked bloom table data, if present 118x */
 };
 
 enum NodeType : byte
@@ -242,6 +243,8 @@ public:
     CNodeBase();
     ~CNodeBase();
     void init(CKeyHdr *keyHdr, offset_t fpos);
+protected:
+    void setFpos(offset_t _fpos) { fpos = _fpos; }
 };
 
 class jhtree_decl CJHTreeNode : public CNodeBase
@@ -292,6 +295,7 @@ class CJHSplitSearchNode : public CJHSearchNode
 {
 protected:
     size32_t keyRecLen = 0;
+    size32_t commonPrefixLen = 0;       // number of leading bytes that are the same in every row
     unsigned __int64 firstSequence = 0;
     const byte *nodeData = nullptr;
     const byte *keyRows = nullptr;
@@ -325,6 +329,8 @@ protected:
     size32_t keyLen = 0;
     size32_t keyCompareLen = 0;
     size32_t keyRecLen = 0;
+    size32_t commonPrefixLen = 0;
+    const byte * fixedRows = nullptr;   // keyed portion of the first row if all rows are the same size, otherwise null
 
     unsigned __int64 firstSequence = 0;
 
@@ -424,6 +430,7 @@ public:
     virtual void write(IFileIOStream *, CRC32 *crc) override;
     void setLeftSib(offset_t leftSib) { hdr.leftSib = leftSib; }
     void setRightSib(offset_t rightSib) { hdr.rightSib = rightSib; }
+    using CNodeBase::setFpos;   // Leaves built in parallel are only given a position once it is known they will be used
 };
 
 class CWriteNode : public CWriteNodeBase
@@ -30,6 +30,7 @@
 
 #include "ctfile.hpp"
 #include "jhinplace.hpp"
+#include "jhsearch.hpp"
 #include "jstats.h"
 
 #ifdef _DEBUG
@@ -1363,23 +1364,19 @@ unsigned InplaceNodeSearcher::findGE(const unsigned len, const byte * search) co
         case SqQuote:
         {
             unsigned numBytes = count;
-            for (unsigned i=0; i < numBytes; i++)
+            unsigned i = findFirstMismatch(finger, search, numBytes);
+            if (i < numBytes)
             {
-                const byte nextSearch = search[i];
-                const byte nextFinger = finger[i];
-                if (nextFinger != nextSearch)
+                if (finger[i] > search[i])
                 {
-                    if (nextFinger > nextSearch)
-                    {
-                        //This entry is larger than the search value => we have a match
-                        return resultPrev;
-                    }
-                    else
-                    {
-                        //This entry (and all children) are less than the search value
-                        //=> the next entry is the match
-                        return resultNext;
-                    }
+                    //This entry is larger than the search value => we have a match
+                    return resultPrev;
+                }
+                else
+                {
+                    //This entry (and all children) are less than the search value
+                    //=> the next entry is the match
+                    return resultNext;
                 }
             }
             search += numBytes;
@@ -1435,16 +1432,13 @@ unsigned InplaceNodeSearcher::findGE(const unsigned len, const byte * search) co
         {
             const byte nextFinger = (op == SqZero) ? 0 : ' ';
             unsigned numBytes = count + repeatDelta;
-            for (unsigned i=0; i < numBytes; i++)
+            unsigned i = findFirstNotEqual(search, nextFinger, numBytes);
+            if (i < numBytes)
             {
-                const byte nextSearch = search[i];
-                if (nextFinger != nextSearch)
-                {
-                    if (nextFinger > nextSearch)
-                        return resultPrev;
-                    else
-                        return resultNext;
-                }
+                if (nextFinger > search[i])
+                    return resultPrev;
+                else
+                    return resultNext;
             }
             search += numBytes;
             offset += numBytes;
@@ -1454,16 +1448,13 @@ unsigned InplaceNodeSearcher::findGE(const unsigned len, const byte * search) co
         {
             const byte nextFinger = *finger++;
             unsigned numBytes = count + repeatXDelta;
-            for (unsigned i=0; i < numBytes; i++)
+            unsigned i = findFirstNotEqual(search, nextFinger, numBytes);
+            if (i < numBytes)
             {
-                const byte nextSearch = search[i];
-                if (nextFinger != nextSearch)
-                {
-                    if (nextFinger > nextSearch)
-                        return resultPrev;
-                    else
-                        return resultNext;
-                }
+                if (nextFinger > search[i])
+                    return resultPrev;
+                else
+                    return resultNext;
             }
             search += numBytes;
             offset += numBytes;
@@ -1483,7 +1474,11 @@ unsigned InplaceNodeSearcher::findGE(const unsigned len, const byte * search) co
             dbgassertex(bytesPerOffset <= 2);
 
             const byte * counts = finger + ((sizeInfo & OFsequential) ? 1 : numOptions); // counts (if present) follow the data
-            for (unsigned i=0; i < numOptions; i++)
+            //Options are sorted, so skip all the options that are less than the search byte in a single pass
+            unsigned firstOption = 0;
+            if (!(sizeInfo & OFsequential) && (numOptions >= minVectorSearchLen))
+                firstOption = nodeSearchKernels.countLess(finger, numOptions, nextSearch);
+            for (unsigned i=firstOption; i < numOptions; i++)
             {
                 const byte nextFinger = getOptionValue(sizeInfo, finger, i);
 
@@ -1672,7 +1667,7 @@ int InplaceNodeSearcher::compareValueAtFallback(const char *src, unsigned int in
 InplaceKeyBuildContext::~InplaceKeyBuildContext()
 {
 #ifdef TRACE_BUILDING_STATS
-    DBGLOG("NumDuplicates = %u  DataSize(%llu) KeyedSize(%llu), NumLeaves(%llu), BlockCompress(%llu)", numKeyedDuplicates, totalDataSize, totalKeyedSize, numLeafNodes, numBlockCompresses);
+    DBGLOG("NumDuplicates = %u  DataSize(%llu) KeyedSize(%llu), NumLeaves(%llu), BlockCompress(%llu)", numKeyedDuplicates, totalDataSize, totalKeyedSize, numLeafNodes, numBlockCompresses.load());
 #endif
 
     delete [] nullRow;
@@ -2231,10 +2226,7 @@ bool CInplaceLeafWriteNode::add(offset_t pos, const void * _data, size32_t size,
         return false;
 
     if (0 == hdr.numKeys)
-    {
         firstSequence = sequence;
-        ctx.numLeafNodes++;
-    }
 
     LeafFilepositionInfo savedPositionInfo = positionInfo;
     const byte * data = (const byte *)_data;
@@ -2565,6 +2557,7 @@ void CInplaceLeafWriteNode::write(IFileIOStream *out, CRC32 *crc)
             }
         }
 
+        ctx.numLeafNodes++;
         ctx.totalDataSize += data.length();
         ctx.leafMemorySize += data.length();
         assertex(data.length() == getDataSize(true));
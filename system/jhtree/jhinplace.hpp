@@ -170,7 +170,7 @@ public:
     offset_t totalKeyedSize = 0;
     offset_t totalDataSize = 0;
     offset_t numLeafNodes = 0;
-    offset_t numBlockCompresses = 0;
+    RelaxedAtomic<offset_t> numBlockCompresses{0};  // updated while leaves are being filled, possibly on several threads
     offset_t branchMemorySize = 0;
     offset_t leafMemorySize = 0;
     struct {
@@ -0,0 +1,329 @@
+/*##############################################################################
+
+    HPCC SYSTEMS software Copyright (C) 2024 HPCC Systems®.
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+############################################################################## */
+
+#include "platform.h"
+#include <string.h>
+#include <algorithm>
+
+#include "jmisc.hpp"
+#include "jhsearch.hpp"
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define JHSEARCH_X86
+#include <immintrin.h>
+#endif
+
+// Once the binary search has narrowed the range of candidate rows to this many, compare them all in batches
+constexpr unsigned vectorSearchRows = 16;
+
+static inline unsigned __int64 readPrefix(const byte * row)
+{
+    unsigned __int64 value;
+    memcpy(&value, row, sizeof(value));
+    _WINREV(value);
+    return value;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+// Portable implementations
+
+static size32_t firstMismatchScalar(const byte * left, const byte * right, size32_t len)
+{
+    for (size32_t i=0; i < len; i++)
+    {
+        if (left[i] != right[i])
+            return i;
+    }
+    return len;
+}
+
+static size32_t firstNotEqualScalar(const byte * data, byte value, size32_t len)
+{
+    for (size32_t i=0; i < len; i++)
+    {
+        if (data[i] != value)
+            return i;
+    }
+    return len;
+}
+
+static unsigned countLessScalar(const byte * values, unsigned num, byte search)
+{
+    unsigned i = 0;
+    while ((i < num) && (values[i] < search))
+        i++;
+    return i;
+}
+
+static unsigned countPrefixLessScalar(const byte * rows, size32_t stride, unsigned num, unsigned __int64 prefix)
+{
+    unsigned i = 0;
+    while ((i < num) && (readPrefix(rows + i * stride) < prefix))
+        i++;
+    return i;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+// x86 implementations.  These are compiled for the specific target, and only called if the cpu supports it.
+// Because the inputs are sorted, each kernel can stop at the first batch containing a value that is not less.
+
+#ifdef JHSEARCH_X86
+
+static inline unsigned __int64 loadUnaligned64(const byte * row)
+{
+    unsigned __int64 value;
+    memcpy(&value, row, sizeof(value));
+    return value;
+}
+
+__attribute__((target("sse4.2")))
+static size32_t firstMismatchSSE42(const byte * left, const byte * right, size32_t len)
+{
+    size32_t i = 0;
+    for (; i + 16 <= len; i += 16)
+    {
+        __m128i l = _mm_loadu_si128((const __m128i *)(left + i));
+        __m128i r = _mm_loadu_si128((const __m128i *)(right + i));
+        unsigned mismatch = _mm_movemask_epi8(_mm_cmpeq_epi8(l, r)) ^ 0xffff;
+        if (mismatch)
+            return i + __builtin_ctz(mismatch);
+    }
+    return i + firstMismatchScalar(left + i, right + i, len - i);
+}
+
+__attribute__((target("sse4.2")))
+static size32_t firstNotEqualSSE42(const byte * data, byte value, size32_t len)
+{
+    const __m128i match = _mm_set1_epi8(value);
+    size32_t i = 0;
+    for (; i + 16 <= len; i += 16)
+    {
+        __m128i next = _mm_loadu_si128((const __m128i *)(data + i));
+        unsigned mismatch = _mm_movemask_epi8(_mm_cmpeq_epi8(next, match)) ^ 0xffff;
+        if (mismatch)
+            return i + __builtin_ctz(mismatch);
+    }
+    return i + firstNotEqualScalar(data + i, value, len - i);
+}
+
+__attribute__((target("sse4.2")))
+static unsigned countLessSSE42(const byte * values, unsigned num, byte search)
+{
+    const __m128i target = _mm_set1_epi8(search);
+    unsigned i = 0;
+    for (; i + 16 <= num; i += 16)
+    {
+        __m128i next = _mm_loadu_si128((const __m128i *)(values + i));
+        //max(next, search) == next iff next >= search (unsigned)
+        unsigned notLess = _mm_movemask_epi8(_mm_cmpeq_epi8(_mm_max_epu8(next, target), next));
+        if (notLess)
+            return i + __builtin_ctz(notLess);
+    }
+    return i + countLessScalar(values + i, num - i, search);
+}
+
+__attribute__((target("sse4.2")))
+static unsigned countPrefixLessSSE42(const byte * rows, size32_t stride, unsigned num, unsigned __int64 prefix)
+{
+    //There is no unsigned 64bit compare, so flip the top bit of both sides and use the signed compare
+    const __m128i bias = _mm_set1_epi64x(0x8000000000000000LL);
+    const __m128i target = _mm_xor_si128(_mm_set1_epi64x((__int64)prefix), bias);
+    const __m128i byteSwap = _mm_set_epi8(8, 9, 10, 11, 12, 13, 14, 15, 0, 1, 2, 3, 4, 5, 6, 7);
+    unsigned i = 0;
+    for (; i + 2 <= num; i += 2)
+    {
+        const byte * row = rows + i * stride;
+        __m128i next = _mm_set_epi64x(loadUnaligned64(row + stride), loadUnaligned64(row));
+        next = _mm_xor_si128(_mm_shuffle_epi8(next, byteSwap), bias);
+        unsigned less = _mm_movemask_pd(_mm_castsi128_pd(_mm_cmpgt_epi64(target, next)));
+        if (less != 0x3)
+            return i + __builtin_popcount(less);
+    }
+    return i + countPrefixLessScalar(rows + i * stride, stride, num - i, prefix);
+}
+
+__attribute__((target("avx2")))
+static size32_t firstMismatchAVX2(const byte * left, const byte * right, size32_t len)
+{
+    size32_t i = 0;
+    for (; i + 32 <= len; i += 32)
+    {
+        __m256i l = _mm256_loadu_si256((const __m256i *)(left + i));
+        __m256i r = _mm256_loadu_si256((const __m256i *)(right + i));
+        unsigned mismatch = ~(unsigned)_mm256_movemask_epi8(_mm256_cmpeq_epi8(l, r));
+        if (mismatch)
+            return i + __builtin_ctz(mismatch);
+    }
+    return i + firstMismatchSSE42(left + i, right + i, len - i);
+}
+
+__attribute__((target("avx2")))
+static size32_t firstNotEqualAVX2(const byte * data, byte value, size32_t len)
+{
+    const __m256i match = _mm256_set1_epi8(value);
+    size32_t i = 0;
+    for (; i + 32 <= len; i += 32)
+    {
+        __m256i next = _mm256_loadu_si256((const __m256i *)(data + i));
+        unsigned mismatch = ~(unsigned)_mm256_movemask_epi8(_mm256_cmpeq_epi8(next, match));
+        if (mismatch)
+            return i + __builtin_ctz(mismatch);
+    }
+    return i + firstNotEqualSSE42(data + i, value, len - i);
+}
+
+__attribute__((target("avx2")))
+static unsigned countLessAVX2(const byte * values, unsigned num, byte search)
+{
+    const __m256i target = _mm256_set1_epi8(search);
+    unsigned i = 0;
+    for (; i + 32 <= num; i += 32)
+    {
+        __m256i next = _mm256_loadu_si256((const __m256i *)(values + i));
+        unsigned notLess = (unsigned)_mm256_movemask_epi8(_mm256_cmpeq_epi8(_mm256_max_epu8(next, target), next));
+        if (notLess)
+            return i + __builtin_ctz(notLess);
+    }
+    return i + countLessSSE42(values + i, num - i, search);
+}
+
+#endif
+
+//---------------------------------------------------------------------------------------------------------------------
+
+static const NodeSearchKernels searchKernels[NodeSearchIsaMax] =
+{
+    { firstMismatchScalar, firstNotEqualScalar, countLessScalar, countPrefixLessScalar },
+#ifdef JHSEARCH_X86
+    { firstMismatchSSE42, firstNotEqualSSE42, countLessSSE42, countPrefixLessSSE42 },
+    //Gathering 4 strided rows into a 256bit register costs more than it saves, so the row search uses 2 per compare
+    { firstMismatchAVX2, firstNotEqualAVX2, countLessAVX2, countPrefixLessSSE42 },
+#else
+    { firstMismatchScalar, firstNotEqualScalar, countLessScalar, countPrefixLessScalar },
+    { firstMismatchScalar, firstNotEqualScalar, countLessScalar, countPrefixLessScalar },
+#endif
+};
+
+static const char * const isaNames[NodeSearchIsaMax] = { "scalar", "sse4.2", "avx2" };
+
+NodeSearchKernels nodeSearchKernels = searchKernels[NodeSearchScalar];
+static NodeSearchIsa currentIsa = NodeSearchScalar;
+
+static NodeSearchIsa querySupportedIsa()
+{
+#ifdef JHSEARCH_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2"))
+        return NodeSearchAVX2;
+    if (__builtin_cpu_supports("sse4.2"))
+        return NodeSearchSSE42;
+#endif
+    return NodeSearchScalar;
+}
+
+NodeSearchIsa setNodeSearchIsa(NodeSearchIsa isa)
+{
+    NodeSearchIsa supported = querySupportedIsa();
+    if (isa > supported)
+        isa = supported;
+    nodeSearchKernels = searchKernels[isa];
+    currentIsa = isa;
+    return isa;
+}
+
+NodeSearchIsa queryNodeSearchIsa()
+{
+    return currentIsa;
+}
+
+const char * queryNodeSearchIsaName(NodeSearchIsa isa)
+{
+    return (isa < NodeSearchIsaMax) ? isaNames[isa] : "unknown";
+}
+
+MODULE_INIT(INIT_PRIORITY_STANDARD)
+{
+    setNodeSearchIsa(NodeSearchAVX2);
+    return true;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+unsigned findGEFixedRows(const byte * rows, size32_t stride, unsigned lo, unsigned hi, const byte * search, size32_t len, size32_t commonLen)
+{
+    if (lo >= hi)
+        return lo;
+
+    unsigned a = lo;
+    unsigned b = hi;
+    if (commonLen)
+    {
+        //Every row starts with the same commonLen bytes, so if the search differs there it is before or after all of them
+        int rc = memcmp(search, rows, commonLen);
+        if (rc != 0)
+            return (rc < 0) ? lo : hi;
+    }
+
+    if (len < sizeof(unsigned __int64))
+    {
+        while (a < b)
+        {
+            unsigned i = a+(b-a)/2;
+            if (memcmp(search, rows + i * stride, len) > 0)
+                a = i+1;
+            else
+                b = i;
+        }
+        return a;
+    }
+
+    //Compare the 8 bytes following the common prefix as an integer, and only compare the rest if they match.
+    //The bytes before the prefix are known to be equal.  If the common prefix extends to within 8 bytes of the
+    //end, then the integer overlaps the common prefix - which is harmless since those bytes are also equal.
+    const size32_t prefixOffset = std::min(commonLen, (size32_t)(len - sizeof(unsigned __int64)));
+    const size32_t restOffset = prefixOffset + sizeof(unsigned __int64);
+    const size32_t restLen = len - restOffset;
+    const unsigned __int64 prefix = readPrefix(search + prefixOffset);
+    const byte * searchRest = search + restOffset;
+    const byte * rowPrefixes = rows + prefixOffset;
+    while (b - a > vectorSearchRows)
+    {
+        unsigned i = a+(b-a)/2;
+        const byte * row = rows + i * stride;
+        unsigned __int64 rowPrefix = readPrefix(row + prefixOffset);
+        bool greater;
+        if (prefix != rowPrefix)
+            greater = (prefix > rowPrefix);
+        else
+            greater = memcmp(searchRest, row + restOffset, restLen) > 0;
+        if (greater)
+            a = i+1;
+        else
+            b = i;
+    }
+
+    //Skip all the candidates with a smaller prefix in a single pass, then resolve any with the same prefix
+    a += nodeSearchKernels.countPrefixLess(rowPrefixes + a * stride, stride, b - a, prefix);
+    while (a < b)
+    {
+        const byte * row = rows + a * stride;
+        if ((readPrefix(row + prefixOffset) != prefix) || (memcmp(searchRest, row + restOffset, restLen) <= 0))
+            break;
+        a++;
+    }
+    return a;
+}
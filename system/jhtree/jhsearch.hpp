@@ -0,0 +1,90 @@
+/*##############################################################################
+
+    HPCC SYSTEMS software Copyright (C) 2024 HPCC Systems®.
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+############################################################################## */
+
+#ifndef JHSEARCH_HPP
+#define JHSEARCH_HPP
+
+#include "jhtree.hpp"
+
+// Primitives used to search within index nodes.  Each has a portable implementation, and on x86 an SSE4.2 and
+// an AVX2 implementation that compare a batch of candidates per instruction.  The best version supported by
+// the cpu is selected when the library is loaded.
+
+enum NodeSearchIsa : byte { NodeSearchScalar, NodeSearchSSE42, NodeSearchAVX2, NodeSearchIsaMax };
+
+struct NodeSearchKernels
+{
+    // Return the offset of the first byte that differs between left and right, or len if they are identical
+    size32_t (*firstMismatch)(const byte * left, const byte * right, size32_t len);
+    // Return the offset of the first byte in data that is not equal to value, or len if there are none
+    size32_t (*firstNotEqual)(const byte * data, byte value, size32_t len);
+    // Return how many entries of the ascending array values are less than search
+    unsigned (*countLess)(const byte * values, unsigned num, byte search);
+    // Return how many of the num ascending fixed width rows (stride bytes apart) have a leading 8 bytes that
+    // are less than prefix, where both are compared as big endian values.
+    unsigned (*countPrefixLess)(const byte * rows, size32_t stride, unsigned num, unsigned __int64 prefix);
+};
+
+extern jhtree_decl NodeSearchKernels nodeSearchKernels;
+
+// Select the implementation to use (limited to the instruction sets the cpu supports).  Returns the isa selected.
+// Only intended for testing and benchmarking - it must not be called while other threads are searching nodes.
+extern jhtree_decl NodeSearchIsa setNodeSearchIsa(NodeSearchIsa isa);
+extern jhtree_decl NodeSearchIsa queryNodeSearchIsa();
+extern jhtree_decl const char * queryNodeSearchIsaName(NodeSearchIsa isa);
+
+// Return the index of the first row in [lo, hi) that is >= search, comparing the first len bytes of each row.
+// The rows are a fixed number of bytes (stride) apart, sorted in ascending order, and all begin with the
+// same commonLen bytes (see getCommonPrefixLen).  rows points to the first row of the node, not row lo.
+extern jhtree_decl unsigned findGEFixedRows(const byte * rows, size32_t stride, unsigned lo, unsigned hi, const byte * search, size32_t len, size32_t commonLen);
+
+// Return the number of leading bytes shared by all num rows - i.e. by the first and last row, since they are sorted.
+inline size32_t getCommonPrefixLen(const byte * rows, size32_t stride, unsigned num, size32_t len)
+{
+    if (num < 2)
+        return 0;
+    return nodeSearchKernels.firstMismatch(rows, rows + (num - 1) * stride, len);
+}
+
+// Runs shorter than this are compared inline - the overhead of calling a kernel outweighs the benefit
+constexpr size32_t minVectorSearchLen = 16;
+
+inline size32_t findFirstMismatch(const byte * left, const byte * right, size32_t len)
+{
+    if (len >= minVectorSearchLen)
+        return nodeSearchKernels.firstMismatch(left, right, len);
+    for (size32_t i=0; i < len; i++)
+    {
+        if (left[i] != right[i])
+            return i;
+    }
+    return len;
+}
+
+inline size32_t findFirstNotEqual(const byte * data, byte value, size32_t len)
+{
+    if (len >= minVectorSearchLen)
+        return nodeSearchKernels.firstNotEqual(data, value, len);
+    for (size32_t i=0; i < len; i++)
+    {
+        if (data[i] != value)
+            return i;
+    }
+    return len;
+}
+
+#endif
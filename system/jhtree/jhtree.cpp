@@ -43,6 +43,9 @@
 #include <fcntl.h>
 #include <stdlib.h>
 #include <limits.h>
+#include <algorithm>
+#include <string>
+#include <vector>
 #ifdef __linux__
 #include <alloca.h>
 #endif
@@ -50,11 +53,14 @@
 #include "hlzw.h"
 
 #include "jmutex.hpp"
+#include "jtask.hpp"
+#include "juring.hpp"
 #include "jhutil.hpp"
 #include "jmisc.hpp"
 #include "jstats.h"
 #include "ctfile.hpp"
 #include "jhinplace.hpp"
+#include "jhsearch.hpp"
 
 #include "jhtree.ipp"
 #include "keybuild.hpp"
@@ -353,10 +359,12 @@ protected:
     KeyStatsCollector stats;
     Owned <IIndexFilterList> filter;
     IKeyCursor *keyCursor;
+    Linked<IKeyIndex> bloomKey;
     ConstPointerArray activeBlobs;
     __uint64 partitionFieldMask = 0;
     unsigned indexParts = 0;
     unsigned keyedSize;     // size of non-payload part of key
+    unsigned readAhead = 0;
     bool started = false;
     bool newFilters = false;
     bool logExcessiveSeeks = false;
@@ -399,11 +407,15 @@ public:
     {
         ::Release(keyCursor);
         keyCursor = NULL;
+        bloomKey.clear();
         if (_key)
         {
             assertex(_key->numParts()==1);
             IKeyIndex *ki = _key->queryPart(0);
             keyCursor = ki->getCursor(filter, logExcessiveSeeks);
+            bloomKey.set(ki);
+            if (readAhead)
+                keyCursor->setReadAhead(readAhead);
             if (keyedSize)
                 assertex(keyedSize == ki->keyedSize());
             else
@@ -429,6 +441,24 @@ public:
         // TODO ?
     }
 
+    virtual void setReadAhead(unsigned numLeaves) override
+    {
+        readAhead = numLeaves;
+        if (keyCursor)
+            keyCursor->setReadAhead(numLeaves);
+    }
+
+    virtual bool getBloomProbe(unsigned &whichFilter, hash64_t &hash) override
+    {
+        return bloomKey && bloomKey->getBloomProbe(*filter, whichFilter, hash);
+    }
+
+    virtual unsigned bloomFilterTestMany(unsigned whichFilter, unsigned num, const hash64_t * hashes, bool * results) override
+    {
+        assertex(bloomKey);
+        return bloomKey->bloomFilterTestMany(whichFilter, num, hashes, results);
+    }
+
     virtual void reset(bool crappyHack)
     {
         if (keyCursor)
@@ -592,6 +622,7 @@ enum CacheType : unsigned
     CacheMax = 3
 };
 static constexpr const char * cacheTypeText[CacheMax]  = { "branch", "leaf", "blob" };
+static constexpr const char * cachePolicyText[NodeCachePolicyMax] = { "lru", "tinylfu" };
 
 static_assert((unsigned)CacheBranch == (unsigned)NodeBranch, "Mismatch Cache Branch");
 static_assert((unsigned)CacheLeaf == (unsigned)NodeLeaf, "Mismatch Cache Leaf");
@@ -622,6 +653,17 @@ public:
     bool operator==(const CKeyIdAndPos &other) { return keyId == other.keyId && pos == other.pos; }
 };
 
+//A well mixed 64bit hash of the key, used to index the frequency sketch.  Independent of the hash table's hash code,
+//whose top bits are also used to select the cache shard.
+static inline unsigned __int64 hashNodeKey(const CKeyIdAndPos & key)
+{
+    unsigned __int64 hash = key.pos * 0x9e3779b97f4a7c15ULL + key.keyId;
+    hash ^= hash >> 33;
+    hash *= 0xff51afd7ed558ccdULL;
+    hash ^= hash >> 33;
+    return hash;
+}
+
 class CNodeCacheEntry : public CInterface
 {
 public:
@@ -674,6 +716,11 @@ class CNodeMRUCache : public CMRUCacheOf<CKeyIdAndPos, CNodeCacheEntry, CNodeMap
     std::atomic<size32_t> sizeInMem{0};
     size32_t memLimit = 0;
 public:
+    //The following are only updated within the owning shard's critical section
+    CFrequencySketch sketch;    // only enabled for the TinyLFU policy
+    unsigned evictions = 0;
+    unsigned rejections = 0;
+
     size32_t setMemLimit(size32_t _memLimit)
     {
         size32_t oldMemLimit = memLimit;
@@ -694,6 +741,7 @@ public:
                 break;
 
             clear(1);
+            evictions++;
         }
         while (full());
     }
@@ -728,23 +776,87 @@ public:
     {
         sizeInMem += node.getMemSize();
     }
+    inline void noteAccess(const CKeyIdAndPos &key)
+    {
+        if (sketch.isEnabled())
+            sketch.increment(hashNodeKey(key));
+    }
+    inline bool hasAdmissionFilter() const
+    {
+        return sketch.isEnabled();
+    }
+    //TinyLFU admission.  Called once a newly added node has been loaded.  If the new node has made the cache full, then
+    //only keep it if it is predicted to be used more often than the least recently used entry that it would displace.
+    //This prevents a single scan of a large index from flushing the frequently used nodes from the cache.
+    void checkAdmission(CKeyIdAndPos key, const CNodeCacheEntry * entry)
+    {
+        if (!sketch.isEnabled() || !full())
+            return;
+
+        CNodeMapping *mapping = table.find(key);
+        if (!mapping || (&mapping->query() != entry))
+            return; // The entry has been removed from the cache while it was being loaded
+
+        CNodeMapping *victim = mruList.tail();
+        if (victim && (victim != mapping) && victim->query().isReady())
+        {
+            unsigned candidateFrequency = sketch.estimate(hashNodeKey(key));
+            unsigned victimFrequency = sketch.estimate(hashNodeKey(victim->queryFindValue()));
+            if (candidateFrequency <= victimFrequency)
+            {
+                remove(mapping);
+                rejections++;
+                return;
+            }
+        }
+        makeSpace();
+    }
     void traceState(StringBuffer & out)
     {
         //Should be safe to call outside of a critical section, but values may be inconsistent
         out.append(table.ordinality()).append(":").append(sizeInMem);
     }
+    unsigned numEntries() const
+    {
+        return table.ordinality();
+    }
+    size32_t querySizeInMem() const
+    {
+        return sizeInMem;
+    }
 };
 
 
+//The node cache for each cache type is split into a number of shards, each with its own lock and LRU list, so that
+//lookups for different nodes from different threads rarely contend.  The memory limit for each cache type is
+//divided evenly between its shards.
+static constexpr unsigned MaxNodeCacheShards = 64;
+static unsigned defaultNodeCacheShards = 1;
+
+class CNodeCacheShard
+{
+public:
+    CriticalSection lock;
+    CNodeMRUCache cache;
+    //The following are only updated within the critical section, so they do not need to be atomic
+    unsigned hits = 0;
+    unsigned misses = 0;
+private:
+    char padding[CACHE_LINE_SIZE]; // Avoid false sharing between the locks of adjacent shards
+};
+
 class CNodeCache : public CInterface
 {
 private:
-    mutable CriticalSection lock[CacheMax];
-    CNodeMRUCache cache[CacheMax];
+    CNodeCacheShard shards[CacheMax][MaxNodeCacheShards];
+    std::atomic<unsigned> shardBits{0};
+    size32_t cacheMemLimit[CacheMax] = { 0, 0, 0 };
+    NodeCachePolicy cachePolicy[CacheMax] = { NodeCacheLRU, NodeCacheLRU, NodeCacheLRU };
     bool cacheEnabled[CacheMax] = { false, false, false };
 public:
-    CNodeCache(size32_t maxNodeMem, size32_t maxLeaveMem, size32_t maxBlobMem)
+    CNodeCache(size32_t maxNodeMem, size32_t maxLeaveMem, size32_t maxBlobMem, unsigned numShards)
     {
+        shardBits = getShardBits(numShards);
         setNodeCacheMem(maxNodeMem);
         setLeafCacheMem(maxLeaveMem);
         setBlobCacheMem(maxBlobMem);
@@ -766,37 +878,166 @@ public:
     {
         return setCacheMem(newSize, CacheBlob);
     }
+    inline unsigned queryNumShards() const
+    {
+        return 1U << shardBits.load(std::memory_order_relaxed);
+    }
+    unsigned setNumShards(unsigned numShards)
+    {
+        unsigned newBits = getShardBits(numShards);
+        unsigned oldBits = shardBits.load();
+        if (newBits == oldBits)
+            return 1U << oldBits;
+
+        //Lock every shard (always in the same order) so no other thread can be using the cache while the entries are
+        //discarded and the shards are redistributed.  Changing the number of shards is expected to be very rare.
+        for (unsigned i=0; i < CacheMax; i++)
+            for (unsigned shard=0; shard < MaxNodeCacheShards; shard++)
+                shards[i][shard].lock.enter();
+
+        shardBits = newBits;
+        for (unsigned i=0; i < CacheMax; i++)
+        {
+            for (unsigned shard=0; shard < MaxNodeCacheShards; shard++)
+            {
+                CNodeCacheShard & cur = shards[i][shard];
+                cur.cache.kill();
+                configureShard(cur, (CacheType)i);
+            }
+        }
+
+        for (unsigned i=CacheMax; i-- > 0;)
+            for (unsigned shard=MaxNodeCacheShards; shard-- > 0;)
+                shards[i][shard].lock.leave();
+        return 1U << oldBits;
+    }
     void clear()
     {
         for (unsigned i=0; i < CacheMax; i++)
         {
-            CriticalBlock block(lock[i]);
-            cache[i].kill();
+            for (unsigned shard=0; shard < MaxNodeCacheShards; shard++)
+            {
+                CNodeCacheShard & cur = shards[i][shard];
+                CriticalBlock block(cur.lock);
+                cur.cache.kill();
+                cur.cache.sketch.reset();
+                cur.cache.evictions = 0;
+                cur.cache.rejections = 0;
+                cur.hits = 0;
+                cur.misses = 0;
+            }
         }
     }
     void traceState(StringBuffer & out)
     {
+        //Should be safe to call outside of a critical section, but values may be inconsistent
+        unsigned numShards = queryNumShards();
         for (unsigned i=0; i < CacheMax; i++)
         {
+            unsigned numEntries = 0;
+            unsigned __int64 sizeInMem = 0;
+            for (unsigned shard=0; shard < numShards; shard++)
+            {
+                numEntries += shards[i][shard].cache.numEntries();
+                sizeInMem += shards[i][shard].cache.querySizeInMem();
+            }
             out.append(cacheTypeText[i]).append('(');
-            cache[i].traceState(out);
+            out.append(numEntries).append(":").append(sizeInMem);
             out.appendf(" [%u:%u:%u]", hitMetric[i]->load(), addMetric[i]->load(), dupMetric[i]->load());
             out.append(") ");
         }
     }
+    void traceShardState(StringBuffer & out, CacheType type)
+    {
+        //Report entries:size[hits:misses:evictions:rejections] for each shard - useful for spotting an unbalanced distribution
+        unsigned numShards = queryNumShards();
+        out.append(cacheTypeText[type]).append(" shards(").append(numShards).append(")");
+        for (unsigned shard=0; shard < numShards; shard++)
+        {
+            CNodeCacheShard & cur = shards[type][shard];
+            out.append(' ');
+            cur.cache.traceState(out);
+            out.appendf("[%u:%u:%u:%u]", cur.hits, cur.misses, cur.cache.evictions, cur.cache.rejections);
+        }
+    }
     void logState()
     {
         StringBuffer state;
         traceState(state);
         DBGLOG("NodeCache: %s", state.str());
+        if (queryNumShards() > 1)
+        {
+            for (unsigned i=0; i < CacheMax; i++)
+            {
+                if (cacheEnabled[i])
+                {
+                    state.clear();
+                    traceShardState(state, (CacheType)i);
+                    DBGLOG("NodeCache: %s", state.str());
+                }
+            }
+        }
+    }
+
+    NodeCachePolicy setCachePolicy(NodeCachePolicy policy, CacheType type)
+    {
+        for (unsigned shard=0; shard < MaxNodeCacheShards; shard++)
+            shards[type][shard].lock.enter();
+
+        NodeCachePolicy oldPolicy = cachePolicy[type];
+        cachePolicy[type] = policy;
+        for (unsigned shard=0; shard < MaxNodeCacheShards; shard++)
+            configureShard(shards[type][shard], type);
+
+        for (unsigned shard=MaxNodeCacheShards; shard-- > 0;)
+            shards[type][shard].lock.leave();
+        return oldPolicy;
     }
 
 protected:
+    //Called with the shard locked
+    void configureShard(CNodeCacheShard & shard, CacheType type)
+    {
+        size32_t shardLimit = getShardMemLimit(cacheMemLimit[type]);
+        shard.cache.setMemLimit(shardLimit);
+
+        //Size the frequency sketch from the number of (uncompressed) nodes that will fit in the shard
+        bool useSketch = (cachePolicy[type] == NodeCacheTinyLFU) && (shardLimit != 0) && (shardLimit != (size32_t)-1);
+        shard.cache.sketch.setCapacity(useSketch ? (shardLimit / NODESIZE) + 1 : 0);
+    }
+    static unsigned getShardBits(unsigned numShards)
+    {
+        unsigned bits = 0;
+        while (((1U << bits) < numShards) && ((1U << bits) < MaxNodeCacheShards))
+            bits++;
+        return bits;
+    }
+    static inline unsigned getShardIndex(unsigned hashcode, unsigned bits)
+    {
+        //Use the top bits of the hash code - the low bits are used to select the bucket within each shard's hash table
+        return bits ? (hashcode >> (32 - bits)) : 0;
+    }
+    size32_t getShardMemLimit(size32_t limit) const
+    {
+        if (limit == (size32_t)-1)
+            return limit;
+        return limit >> shardBits.load(std::memory_order_relaxed);
+    }
     size32_t setCacheMem(size32_t newSize, CacheType type)
     {
-        CriticalBlock block(lock[type]);
-        unsigned oldV = cache[type].setMemLimit(newSize);
+        //Lock all of the shards for the cache type to serialize changes to the limit, and to prevent the number of
+        //shards being changed at the same time.
+        for (unsigned shard=0; shard < MaxNodeCacheShards; shard++)
+            shards[type][shard].lock.enter();
+
+        size32_t oldV = cacheMemLimit[type];
+        cacheMemLimit[type] = newSize;
+        for (unsigned shard=0; shard < MaxNodeCacheShards; shard++)
+            configureShard(shards[type][shard], type);
         cacheEnabled[type] = (newSize != 0);
+
+        for (unsigned shard=MaxNodeCacheShards; shard-- > 0;)
+            shards[type][shard].lock.leave();
         return oldV;
     }
 };
@@ -805,7 +1046,7 @@ static inline CNodeCache *queryNodeCache()
 {
     if (nodeCache) return nodeCache; // avoid crit
     CriticalBlock b(*initCrit);
-    if (!nodeCache) nodeCache = new CNodeCache(100*0x100000, 50*0x100000, 0);
+    if (!nodeCache) nodeCache = new CNodeCache(100*0x100000, 50*0x100000, 0, defaultNodeCacheShards);
     return nodeCache;
 }
 
@@ -820,6 +1061,8 @@ void logCacheState()
     if (nodeCache)
         nodeCache->logState();
     DBGLOG("Search times branch(%lluns) leaf(%lluns)", cycle_to_nanosec(branchSearchCycles), cycle_to_nanosec(leafSearchCycles));
+    if (leafPrefetches)
+        DBGLOG("Leaf prefetches issued(%u) hits(%u) wasted(%u)", leafPrefetches.load(), leafPrefetchHits.load(), leafPrefetchWasted.load());
     branchSearchCycles = 0;
     leafSearchCycles = 0;
 }
@@ -1166,8 +1409,10 @@ const CJHTreeNode *CDiskKeyIndex::loadNode(cycle_t * fetchCycles, offset_t pos)
 {
     nodesLoaded++;
     unsigned nodeSize = keyHdr->getNodeSize();
+    //Nodes are aligned within the file, so aligning the buffer allows files opened with IFEdirect to read directly into it
     MemoryAttr ma;
-    char *nodeData = (char *) ma.allocate(nodeSize);
+    char *nodeData = (char *) ma.allocate(nodeSize + directIOAlignment);
+    nodeData += (directIOAlignment - ((memsize_t)nodeData & (directIOAlignment - 1))) & (directIOAlignment - 1);
 
     CCycleTimer fetchTimer(fetchCycles != nullptr);
     if (io->read(pos, nodeSize, nodeData) != nodeSize)
@@ -1406,13 +1651,19 @@ offset_t CKeyIndex::queryFirstBranchOffset()
 
 void CKeyIndex::loadBloomFilters()
 {
+    // indexes created before the introduction of bloom filters would have FFFF... in these fields
     offset_t bloomAddr = keyHdr->getHdrStruct()->bloomHead;
-    if (!bloomAddr || bloomAddr == static_cast<offset_t>(-1))
-    {
-        bloomFiltersLoaded = true;
-        return; // indexes created before introduction of bloomfilter would have FFFF... in this space
-    }
+    if (bloomAddr && bloomAddr != static_cast<offset_t>(-1))
+        loadBloomFilterChain(bloomAddr, false);
+    offset_t blockedBloomAddr = keyHdr->getHdrStruct()->blockedBloomHead;
+    if (blockedBloomAddr && blockedBloomAddr != static_cast<offset_t>(-1))
+        loadBloomFilterChain(blockedBloomAddr, true);
+    bloomFilters.sort(IndexBloomFilter::compare);
+    bloomFiltersLoaded = true;
+}
 
+void CKeyIndex::loadBloomFilterChain(offset_t bloomAddr, bool blocked)
+{
     while (bloomAddr)
     {
         Owned<const CJHTreeNode> node = loadNode(nullptr, bloomAddr);
@@ -1435,22 +1686,25 @@ void CKeyIndex::loadBloomFilters()
         }
         assertex(bloomTable.length()==bloomTableSize);
         //DBGLOG("Creating bloomfilter(%d, %d) for fields %" I64F "x",numHashes, bloomTableSize, fields);
-        bloomFilters.append(*new IndexBloomFilter(numHashes, bloomTableSize, (byte *) bloomTable.detach(), fields));
+        bloomFilters.append(*new IndexBloomFilter(numHashes, bloomTableSize, (byte *) bloomTable.detach(), fields, blocked));
     }
-    bloomFilters.sort(IndexBloomFilter::compare);
-    bloomFiltersLoaded = true;
 }
 
-bool CKeyIndex::bloomFilterReject(const IIndexFilterList &segs) const
+void CKeyIndex::ensureBloomFiltersLoaded() const
 {
-    if (segs.isUnfiltered())
-        return false;
     if (!bloomFiltersLoaded)
     {
         CriticalBlock b(cacheCrit);
         if (!bloomFiltersLoaded)
             const_cast<CKeyIndex *>(this)->loadBloomFilters();
     }
+}
+
+bool CKeyIndex::bloomFilterReject(const IIndexFilterList &segs) const
+{
+    if (segs.isUnfiltered())
+        return false;
+    ensureBloomFiltersLoaded();
     ForEachItemIn(idx, bloomFilters)
     {
         IndexBloomFilter &filter = bloomFilters.item(idx);
@@ -1460,6 +1714,28 @@ bool CKeyIndex::bloomFilterReject(const IIndexFilterList &segs) const
     return false;
 }
 
+bool CKeyIndex::getBloomProbe(const IIndexFilterList &segs, unsigned &whichFilter, hash64_t &hash)
+{
+    if (segs.isUnfiltered())
+        return false;
+    ensureBloomFiltersLoaded();
+    ForEachItemIn(idx, bloomFilters)
+    {
+        if (bloomFilters.item(idx).getProbe(segs, hash))
+        {
+            whichFilter = idx;
+            return true;
+        }
+    }
+    return false;
+}
+
+unsigned CKeyIndex::bloomFilterTestMany(unsigned whichFilter, unsigned num, const hash64_t * hashes, bool * results)
+{
+    assertex(bloomFiltersLoaded && bloomFilters.isItem(whichFilter));
+    return bloomFilters.item(whichFilter).testMany(num, hashes, results);
+}
+
 IPropertyTree * CKeyIndex::getMetadata()
 {
     offset_t nodepos = queryMetadataHead();
@@ -1588,6 +1864,232 @@ void KeyStatsCollector::reset()
 {
 }
 
+//---------------------------------------------------------------------------------------------------------------------
+
+RelaxedAtomic<unsigned> leafPrefetches;
+RelaxedAtomic<unsigned> leafPrefetchHits;
+RelaxedAtomic<unsigned> leafPrefetchWasted;
+
+class CLeafPrefetchTask : public CTask
+{
+public:
+    CLeafPrefetchTask(CLeafPrefetcher &_owner, offset_t _pos, unsigned _chainLength, unsigned _generation)
+    : CTask(0), owner(&_owner), pos(_pos), chainLength(_chainLength), generation(_generation)
+    {
+    }
+
+    virtual CTask * execute() override
+    {
+        if (chainLength)
+            owner->processChain(pos, chainLength, generation);
+        else
+            owner->processLeaf(pos, generation);
+        return nullptr;
+    }
+
+protected:
+    Linked<CLeafPrefetcher> owner;
+    offset_t pos;
+    unsigned chainLength;   // 0 means load a single leaf, otherwise the number of right siblings to follow
+    unsigned generation;
+};
+
+CLeafPrefetcher::CLeafPrefetcher(CKeyIndex &_key, unsigned _depth) : key(&_key)
+{
+    depth = std::min(_depth, MaxLeafReadAhead);
+}
+
+CLeafPrefetcher::~CLeafPrefetcher()
+{
+    //Any leaves that were never reached can only be reported globally - the logging context may have gone
+    leafPrefetches.fastAdd(unreportedIssued);
+    leafPrefetchHits.fastAdd(unreportedHits);
+    leafPrefetchWasted.fastAdd(unreportedWasted + numOutstanding);
+}
+
+bool CLeafPrefetcher::isOutstanding(offset_t pos) const
+{
+    for (unsigned i=0; i < numOutstanding; i++)
+    {
+        if (outstanding[i] == pos)
+            return true;
+    }
+    return false;
+}
+
+bool CLeafPrefetcher::consume(offset_t pos)
+{
+    for (unsigned i=0; i < numOutstanding; i++)
+    {
+        if (outstanding[i] == pos)
+        {
+            //Anything requested before this leaf has been skipped over
+            unreportedHits++;
+            unreportedWasted += i;
+            numOutstanding -= (i+1);
+            memmove(outstanding, outstanding+i+1, numOutstanding * sizeof(outstanding[0]));
+            return true;
+        }
+    }
+    return false;
+}
+
+void CLeafPrefetcher::discardOutstanding()
+{
+    unreportedWasted += numOutstanding;
+    numOutstanding = 0;
+    chainNext = 0;
+    chainActive = false;
+    generation++;
+}
+
+void CLeafPrefetcher::issue(offset_t pos)
+{
+    outstanding[numOutstanding++] = pos;
+    unreportedIssued++;
+}
+
+void CLeafPrefetcher::noteStats(KeyStatsCollector &stats)
+{
+    if (unreportedIssued)
+    {
+        leafPrefetches.fastAdd(unreportedIssued);
+        if (stats.ctx)
+            stats.ctx->noteStatistic(StNumLeafPrefetches, unreportedIssued);
+        unreportedIssued = 0;
+    }
+    if (unreportedHits)
+    {
+        leafPrefetchHits.fastAdd(unreportedHits);
+        if (stats.ctx)
+            stats.ctx->noteStatistic(StNumLeafPrefetchHits, unreportedHits);
+        unreportedHits = 0;
+    }
+    if (unreportedWasted)
+    {
+        leafPrefetchWasted.fastAdd(unreportedWasted);
+        if (stats.ctx)
+            stats.ctx->noteStatistic(StNumLeafPrefetchWasted, unreportedWasted);
+        unreportedWasted = 0;
+    }
+}
+
+void CLeafPrefetcher::noteLeaf(const CJHSearchNode *leaf, KeyStatsCollector &stats)
+{
+    Owned<CTask> chain;
+    {
+        CriticalBlock block(crit);
+        if (!consume(leaf->getFpos()))
+        {
+            //The cursor has moved past everything that was requested (or scanning has only just started)
+            discardOutstanding();
+            chainNext = leaf->getRightSib();
+        }
+        else if (!numOutstanding && !chainActive)
+            chainNext = leaf->getRightSib();
+
+        //Only top up once half the read-ahead has been consumed, so that tasks are started in batches
+        if (chainNext && !chainActive && (numOutstanding <= depth / 2))
+        {
+            chainActive = true;
+            chain.setown(new CLeafPrefetchTask(*this, chainNext, depth - numOutstanding, generation));
+        }
+        noteStats(stats);
+    }
+    if (chain)
+        enqueueOwnedTask(queryIOTaskScheduler(), *chain.getClear());
+}
+
+void CLeafPrefetcher::noteSeek(const CJHSearchNode *branch, unsigned idx, KeyStatsCollector &stats)
+{
+    //The leaves that follow the target within the same branch are likely to be read by the following
+    //scan or forward seek, and unlike following the sibling chain they can all be requested in parallel.
+    offset_t target = branch->getFPosAt(idx);
+    unsigned numKeys = branch->getNumKeys();
+    unsigned startGeneration;
+    offset_t pending[MaxLeafReadAhead];
+    unsigned numPending = 0;
+    {
+        CriticalBlock block(crit);
+        if (!consume(target))
+            discardOutstanding();
+        //Abandon any sibling chain - the leaves it has already requested remain outstanding
+        generation++;
+        chainNext = 0;
+        chainActive = false;
+        startGeneration = generation;
+        for (unsigned i=idx+1; i < numKeys && numOutstanding < depth; i++)
+        {
+            offset_t pos = branch->getFPosAt(i);
+            if (!isOutstanding(pos))
+            {
+                issue(pos);
+                pending[numPending++] = pos;
+            }
+        }
+        noteStats(stats);
+    }
+    ITaskScheduler & scheduler = queryIOTaskScheduler();
+    for (unsigned i=0; i < numPending; i++)
+        enqueueOwnedTask(scheduler, *new CLeafPrefetchTask(*this, pending[i], 0, startGeneration));
+}
+
+void CLeafPrefetcher::cancel()
+{
+    CriticalBlock block(crit);
+    discardOutstanding();
+}
+
+void CLeafPrefetcher::processLeaf(offset_t pos, unsigned leafGeneration)
+{
+    {
+        CriticalBlock block(crit);
+        if ((leafGeneration != generation) && !isOutstanding(pos))
+            return;
+    }
+    key->prewarmPage(pos, NodeLeaf);
+}
+
+void CLeafPrefetcher::processChain(offset_t pos, unsigned chainLength, unsigned chainGeneration)
+{
+    for (unsigned i=0; i < chainLength; i++)
+    {
+        {
+            CriticalBlock block(crit);
+            if ((chainGeneration != generation) || (numOutstanding >= depth))
+                break;
+            issue(pos);
+        }
+
+        offset_t next = 0;
+        try
+        {
+            Owned<const CJHSearchNode> leaf = key->getNode(pos, NodeLeaf, nullptr);
+            if (leaf)
+                next = leaf->getRightSib();
+        }
+        catch (IException *E)
+        {
+            //Errors will be reported when (and if) the cursor reads the leaf itself
+            ::Release(E);
+        }
+
+        CriticalBlock block(crit);
+        if (chainGeneration != generation)
+            return;
+        chainNext = next;
+        if (!next)
+            break;
+        pos = next;
+    }
+
+    CriticalBlock block(crit);
+    if (chainGeneration == generation)
+        chainActive = false;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
 CKeyCursor::CKeyCursor(CKeyIndex &_key, const IIndexFilterList *_filter, bool _logExcessiveSeeks)
     : key(OLINK(_key)), filter(_filter), logExcessiveSeeks(_logExcessiveSeeks)
 {
@@ -1599,6 +2101,7 @@ CKeyCursor::CKeyCursor(const CKeyCursor &from)
 : key(OLINK(from.key)), filter(from.filter)
 {
     nodeKey = from.nodeKey;
+    setReadAhead(from.readAhead);
     node.set(from.node);
     unsigned keySize = key.keySize();
     recordBuffer = (char *) malloc(keySize);  // MORE - would be nice to know real max - is it stored in metadata?
@@ -1618,12 +2121,23 @@ CKeyCursor::~CKeyCursor()
 void CKeyCursor::reset()
 {
     node.clear();
+    if (prefetcher)
+        prefetcher->cancel();
     matched = false;
     eof = key.bloomFilterReject(*filter) || !filter->canMatch();
     if (!eof)
         setLow(0);
 }
 
+void CKeyCursor::setReadAhead(unsigned numLeaves)
+{
+    readAhead = numLeaves;
+    if (numLeaves && !key.isTLK())
+        prefetcher.setown(new CLeafPrefetcher(key, numLeaves));
+    else
+        prefetcher.clear();
+}
+
 bool CKeyCursor::next(KeyStatsCollector &stats)
 {
     return _next(stats) && node && node->getKeyAt(nodeKey, recordBuffer);
@@ -1636,6 +2150,8 @@ bool CKeyCursor::_next(KeyStatsCollector &stats)
     {
         node.setown(key.locateFirstLeafNode(stats));
         nodeKey = 0;
+        if (node && prefetcher)
+            prefetcher->noteLeaf(node, stats);
         return node && node->isKeyAt(nodeKey);
     }
     else
@@ -1651,6 +2167,8 @@ bool CKeyCursor::_next(KeyStatsCollector &stats)
                 node.setown(key.getNode(rsib, type, stats.ctx));
                 if (node != NULL)
                 {
+                    if (prefetcher)
+                        prefetcher->noteLeaf(node, stats);
                     nodeKey = 0;
                     return node->isKeyAt(0);
                 }
@@ -1762,6 +2280,8 @@ bool CKeyCursor::_gtEqual(KeyStatsCollector &stats)
                 offset_t nextPos = node->nextNodeFpos();  // This can happen at eof because of key peculiarity where level above reports ffff as last
                 node.setown(key.getNode(nextPos, NodeLeaf, stats.ctx));
                 nodeKey = 0;
+                if (node && prefetcher)
+                    prefetcher->noteLeaf(node, stats);
             }
             if (node)
                 return true; 
@@ -1775,6 +2295,8 @@ bool CKeyCursor::_gtEqual(KeyStatsCollector &stats)
                 offset_t npos = node->getFPosAt(a);
                 depth++;
                 NodeType type = (depth < branchDepth) ? NodeBranch : NodeLeaf;
+                if ((type == NodeLeaf) && prefetcher)
+                    prefetcher->noteSeek(node, a, stats);
                 node.setown(key.getNode(npos, type, stats.ctx));
             }
             else
@@ -2467,6 +2989,8 @@ public:
         realKey->mergeStats(stats);
     }
     virtual offset_t queryFirstBranchOffset() override { return checkOpen().queryFirstBranchOffset(); }
+    virtual bool getBloomProbe(const IIndexFilterList &filter, unsigned &whichFilter, hash64_t &hash) override { return checkOpen().getBloomProbe(filter, whichFilter, hash); }
+    virtual unsigned bloomFilterTestMany(unsigned whichFilter, unsigned num, const hash64_t * hashes, bool * results) override { return checkOpen().bloomFilterTestMany(whichFilter, num, hashes, results); }
 };
 
 extern jhtree_decl IKeyIndex *createKeyIndex(const char *keyfile, unsigned crc, IFileIO &iFileIO, unsigned fileIdx, bool isTLK)
@@ -2524,6 +3048,39 @@ extern jhtree_decl size32_t setBlobCacheMem(size32_t cacheSize)
     return queryNodeCache()->setBlobCacheMem(cacheSize);
 }
 
+extern jhtree_decl NodeCachePolicy setNodeCachePolicy(NodeType type, NodeCachePolicy policy)
+{
+    assertex((type < CacheMax) && (policy < NodeCachePolicyMax));
+    return queryNodeCache()->setCachePolicy(policy, (CacheType)type);
+}
+
+extern jhtree_decl NodeCachePolicy getNodeCachePolicy(const char * name)
+{
+    if (!isEmptyString(name))
+    {
+        for (unsigned i = 0; i < NodeCachePolicyMax; i++)
+        {
+            if (strieq(name, cachePolicyText[i]))
+                return (NodeCachePolicy)i;
+        }
+        WARNLOG("Unrecognised node cache policy '%s' - using lru", name);
+    }
+    return NodeCacheLRU;
+}
+
+extern jhtree_decl unsigned setNodeCacheShards(unsigned numShards)
+{
+    if (!numShards)
+        numShards = 1;
+    {
+        CriticalBlock b(*initCrit);
+        defaultNodeCacheShards = numShards;
+        if (!nodeCache)
+            return 1;
+    }
+    return nodeCache->setNumShards(numShards);
+}
+
 void setNodeFetchThresholdNs(__uint64 thresholdNs)
 {
     fetchThresholdCycles = nanosec_to_cycle(thresholdNs);
@@ -2555,8 +3112,19 @@ void CNodeCache::getCacheInfo(ICacheInfoRecorder &cacheInfo)
 {
     for (unsigned i = 0; i < CacheMax; i++)
     {
-        CriticalBlock block(lock[i]);
-        cache[i].reportEntries(cacheInfo);
+        unsigned __int64 hits = 0;
+        unsigned __int64 misses = 0;
+        unsigned __int64 rejections = 0;
+        for (unsigned shard = 0; shard < MaxNodeCacheShards; shard++)
+        {
+            CNodeCacheShard & cur = shards[i][shard];
+            CriticalBlock block(cur.lock);
+            cur.cache.reportEntries(cacheInfo);
+            hits += cur.hits;
+            misses += cur.misses;
+            rejections += cur.cache.rejections;
+        }
+        cacheInfo.noteCacheStats((NodeType)i, cachePolicyText[cachePolicy[i]], hits, misses, rejections);
     }
 }
 
@@ -2571,7 +3139,6 @@ static std::atomic<unsigned> countExcessiveLock_x100{0};
 const CJHTreeNode *CNodeCache::getNode(const INodeLoader *keyIndex, unsigned iD, offset_t pos, NodeType type, IContextLogger *ctx, bool isTLK)
 {
     // MORE - could probably be improved - I think having the cache template separate is not helping us here
-    // Also one cache per key would surely be faster, and could still use a global total
     if (!pos)
         return NULL;
 
@@ -2592,18 +3159,27 @@ const CJHTreeNode *CNodeCache::getNode(const INodeLoader *keyIndex, unsigned iD,
     //  Lock, add if missing, unlock.  Lock a page-dependent-cr load() release lock.
     //There will be the same number of critical section locks, but loading a page will contend on a different lock - so it should reduce contention.
     CKeyIdAndPos key(iD, pos);
-    CNodeMRUCache & curCache = cache[cacheType];
-    CriticalSection & cacheLock = lock[cacheType];
+    unsigned hashcode = shards[cacheType][0].cache.getKeyHash(key); // The hash function is the same for all shards
+    CNodeCacheShard * curShard;
     Owned<CNodeCacheEntry> ownedCacheEntry; // ensure node gets cleaned up if it fails to load
     bool alreadyExists = true;
+    for (;;)
     {
+        unsigned bits = shardBits.load(std::memory_order_acquire);
+        curShard = &shards[cacheType][getShardIndex(hashcode, bits)];
+        CNodeMRUCache & curCache = curShard->cache;
         CNodeCacheEntry * cacheEntry;
-        unsigned hashcode = curCache.getKeyHash(key);
 
-        CLeavableCriticalBlock block(cacheLock);
+        CLeavableCriticalBlock block(curShard->lock);
+        //The number of shards can only change while every shard is locked - if it has changed try again
+        if (unlikely(bits != shardBits.load(std::memory_order_relaxed)))
+            continue;
+
+        curCache.noteAccess(key);
         cacheEntry = curCache.query(hashcode, &key);
         if (likely(cacheEntry))
         {
+            curShard->hits++;
             const CJHTreeNode * fastPathMatch = cacheEntry->queryNode();
             if (likely(fastPathMatch))
             {
@@ -2620,6 +3196,7 @@ const CJHTreeNode *CNodeCache::getNode(const INodeLoader *keyIndex, unsigned iD,
         }
         else
         {
+            curShard->misses++;
             cacheEntry = new CNodeCacheEntry;
             curCache.replace(key, *cacheEntry);
             alreadyExists = false;
@@ -2628,6 +3205,7 @@ const CJHTreeNode *CNodeCache::getNode(const INodeLoader *keyIndex, unsigned iD,
         //same as ownedcacheEntry.set(cacheEntry), but avoids a null check or two
         cacheEntry->Link();
         ownedCacheEntry.setown(cacheEntry);
+        break;
     }
 
     //If an exception is thrown before the node is cleanly loaded we need to remove the partially constructed
@@ -2655,6 +3233,7 @@ const CJHTreeNode *CNodeCache::getNode(const INodeLoader *keyIndex, unsigned iD,
         cycle_t startCycles = get_cycles_now();
         cycle_t fetchCycles = 0;
         cycle_t startLoadCycles;
+        bool loaded = false;
 
         //Protect loading the node contents with a critical section - so that the node will only be loaded by one thread.
         //MORE: If this was called by high and low priority threads then there is an outside possibility that it could take a
@@ -2668,12 +3247,18 @@ const CJHTreeNode *CNodeCache::getNode(const INodeLoader *keyIndex, unsigned iD,
                 assertex(type == node->getNodeType());
 
                 //Update the associated size of the entry in the hash table before setting isReady (never evicted until isReady is set)
-                curCache.noteReady(*node);
+                curShard->cache.noteReady(*node);
                 ownedCacheEntry->noteReady(node);
+                loaded = true;
             }
             else
                 (*dupMetric[cacheType])++;
         }
+        if (loaded && curShard->cache.hasAdmissionFilter())
+        {
+            CriticalBlock block(curShard->lock);
+            curShard->cache.checkAdmission(key, ownedCacheEntry);
+        }
         cycle_t endLoadCycles = get_cycles_now();
         cycle_t lockingCycles = startLoadCycles - startCycles;
         if (lockingCycles > traceCacheLockingThreshold)
@@ -2726,9 +3311,9 @@ const CJHTreeNode *CNodeCache::getNode(const INodeLoader *keyIndex, unsigned iD,
         //Ensure any partially constructed nodes are removed from the cache
         if (!ownedCacheEntry->isReady())
         {
-            CriticalBlock block(cacheLock);
+            CriticalBlock block(curShard->lock);
             if (!ownedCacheEntry->isReady())
-                curCache.remove(key);
+                curShard->cache.remove(key);
         }
         throw;
     }
@@ -2757,6 +3342,9 @@ void clearNodeStats()
     nodeCacheHits.store(0);
     nodeCacheAdds.store(0);
     nodeCacheDups.store(0);
+    leafPrefetches.store(0);
+    leafPrefetchHits.store(0);
+    leafPrefetchWasted.store(0);
 }
 
 //------------------------------------------------------------------------------------------------
@@ -2860,11 +3448,23 @@ public:
         return activekeys;
     }
 
+    virtual void setReadAhead(unsigned numLeaves) override
+    {
+        readAhead = numLeaves;
+        ForEachItemIn(i, cursorArray)
+            cursorArray.item(i).setReadAhead(numLeaves);
+    }
+
     virtual unsigned getPartition() override
     {
         return 0;   // If all keys share partition info (is that required?) then we can do better
     }
 
+    virtual bool getBloomProbe(unsigned &whichFilter, hash64_t &hash) override
+    {
+        return false;   // Each key has its own bloom filters, so a single probe cannot check them all
+    }
+
     virtual bool lookupSkip(const void *seek, size32_t seekOffset, size32_t seeklen)
     {
         // Rather like a lookup, except that no records below the value indicated by seek* should be returned.
@@ -3020,6 +3620,8 @@ public:
         for (i = 0; i < numkeys; i++)
         {
             Owned<IKeyCursor> cursor = keyset->queryPart(i)->getCursor(filter, logExcessiveSeeks);
+            if (readAhead)
+                cursor->setReadAhead(readAhead);
             cursor->reset();
             for (;;)
             {
@@ -3379,6 +3981,7 @@ class IKeyManagerTest : public CppUnit::TestFixture
     CPPUNIT_TEST_SUITE( IKeyManagerTest  );
         CPPUNIT_TEST(testStepping);
         CPPUNIT_TEST(testKeys);
+        CPPUNIT_TEST(testReadAhead);
     CPPUNIT_TEST_SUITE_END();
 
     void testStepping()
@@ -3770,6 +4373,66 @@ protected:
         removeTestKeys();
     }
 
+    void testReadAhead()
+    {
+        const char *json = "{ \"ty1\": { \"fieldType\": 4, \"length\": 10 }, "
+                           " \"fieldType\": 13, \"length\": 10, "
+                           " \"fields\": [ "
+                           " { \"name\": \"f1\", \"type\": \"ty1\", \"flags\": 4 }, "
+                           " ] "
+                           "}";
+        Owned<IOutputMetaData> meta = createTypeInfoOutputMetaData(json, false);
+        const RtlRecord &recInfo = meta->queryRecordAccessor(true);
+        buildTestKeys(false, true, false, false, meta, nullptr);
+        {
+            Owned <IKeyIndex> index1 = createKeyIndex("keyfile1.$$$", 0, false);
+            Owned <IKeyIndex> index2 = createKeyIndex("keyfile2.$$$", 0, false);
+            Owned<IKeyIndexSet> both = createKeyIndexSet();
+            both->addIndex(index1.getLink());
+            both->addIndex(index2.getLink());
+
+            // The rows returned must not depend on whether (or how far) leaves are read ahead
+            MemoryBuffer expected[2];
+            for (unsigned readAhead : { 0, 1, 4, 64 })
+            {
+                clearNodeCache();
+                Owned <IKeyManager> tlk1 = createLocalKeyManager(recInfo, index1, NULL, false, false);
+                Owned <IKeyManager> tlk2 = createKeyMerger(recInfo, NULL, 0, NULL, false, false);
+                tlk2->setKey(both);
+                IKeyManager * managers[2] = { tlk1, tlk2 };
+                for (unsigned i=0; i < 2; i++)
+                {
+                    IKeyManager * tlk = managers[i];
+                    tlk->setReadAhead(readAhead);
+                    Owned<IStringSet> sset = createStringSet(10);
+                    sset->addRange("0000000001", "0000001000");     // A scan across several leaves
+                    sset->addRange("0000004001", "0000004001");     // Seeks to isolated rows
+                    sset->addRange("0000005002", "0000005002");
+                    sset->addRange("0000009000", "0000009999");     // A scan to the end of the index
+                    tlk->append(createKeySegmentMonitor(false, sset.getClear(), 0, 0, 10));
+                    tlk->finishSegmentMonitors();
+                    tlk->reset();
+
+                    MemoryBuffer rows;
+                    while (tlk->lookup(true))
+                        rows.append(10, tlk->queryKeyBuffer());
+                    if (readAhead == 0)
+                        expected[i].swapWith(rows);
+                    else
+                    {
+                        ASSERT_EQUAL(expected[i].length(), rows.length());
+                        ASSERT(memcmp(expected[i].toByteArray(), rows.toByteArray(), rows.length()) == 0);
+                    }
+                }
+            }
+            ASSERT_EQUAL(1503U * 10, expected[0].length());
+            ASSERT_EQUAL(2004U * 10, expected[1].length());
+            DBGLOG("Leaf prefetches issued(%u) hits(%u) wasted(%u)", leafPrefetches.load(), leafPrefetchHits.load(), leafPrefetchWasted.load());
+        }
+        clearKeyStoreCache(true);
+        removeTestKeys();
+    }
+
     void testKeys()
     {
         ASSERT(sizeof(CKeyIdAndPos) == sizeof(unsigned __int64) + sizeof(offset_t));
@@ -3785,4 +4448,474 @@ protected:
 CPPUNIT_TEST_SUITE_REGISTRATION( IKeyManagerTest );
 CPPUNIT_TEST_SUITE_NAMED_REGISTRATION( IKeyManagerTest, "IKeyManagerTest" );
 
+class NodeCacheTimingTest : public CppUnit::TestFixture
+{
+    CPPUNIT_TEST_SUITE( NodeCacheTimingTest  );
+        CPPUNIT_TEST(testShardScaling);
+        CPPUNIT_TEST(testPolicies);
+    CPPUNIT_TEST_SUITE_END();
+
+    class CacheStatsRecorder : public CInterfaceOf<ICacheInfoRecorder>
+    {
+    public:
+        virtual void noteWarm(unsigned fileIdx, offset_t page, size32_t len, NodeType type) override {}
+        virtual void noteCacheStats(NodeType type, const char * policy, unsigned __int64 _hits, unsigned __int64 _misses, unsigned __int64 _rejections) override
+        {
+            if (type == NodeLeaf)
+            {
+                hits = _hits;
+                misses = _misses;
+                rejections = _rejections;
+            }
+        }
+    public:
+        unsigned __int64 hits = 0;
+        unsigned __int64 misses = 0;
+        unsigned __int64 rejections = 0;
+    };
+
+    static constexpr const char * filename = "nodecache.$$$";
+    static constexpr unsigned numRows = 1000000;
+    static constexpr unsigned numProbes = 2000;
+    static constexpr unsigned numPasses = 50;
+
+    IOutputMetaData * createKeyMeta()
+    {
+        const char *json =
+                "{ \"ty1\": { \"fieldType\": 4, \"length\": 10 }, "
+                " \"fieldType\": 13, \"length\": 10, "
+                " \"fields\": [ "
+                " { \"name\": \"f1\", \"type\": \"ty1\", \"flags\": 4 }, "
+                " ] "
+                "}";
+        return createTypeInfoOutputMetaData(json, false);
+    }
+
+    void buildKey(IOutputMetaData * meta)
+    {
+        TestIndexWriteArg helper(filename, nullptr, meta);
+        OwnedIFile file = createIFile(filename);
+        OwnedIFileIO io = file->openShared(IFOcreate, IFSHfull);
+        Owned<IFileIOStream> out = createIOStream(io);
+        Owned<IKeyBuilder> builder = createKeyBuilder(out, COL_PREFIX | HTREE_FULLSORT_KEY | HTREE_COMPRESSED_KEY, 10, NODESIZE, 10, 0, &helper, nullptr, true, false);
+
+        char keybuf[11];
+        for (unsigned row = 0; row < numRows; row++)
+        {
+            sprintf(keybuf, "%010u", row);
+            builder->processKeyData(keybuf, row*10, 10);
+        }
+        builder->finish(nullptr, nullptr, 10);
+        out->flush();
+    }
+
+    void testShardScaling()
+    {
+        Owned<IOutputMetaData> meta = createKeyMeta();
+        const RtlRecord &recInfo = meta->queryRecordAccessor(true);
+        buildKey(meta);
+
+        //Each probe is a separate seek from the root of the index, so it gets at least one branch and one leaf node from the cache
+        Owned<IStringSet> probes = createStringSet(10);
+        char keybuf[11];
+        for (unsigned i = 0; i < numProbes; i++)
+        {
+            sprintf(keybuf, "%010u", (unsigned)(((unsigned __int64)i * 7919) % numRows));
+            probes->addRange(keybuf, keybuf);
+        }
+
+        Owned <IKeyIndex> index = createKeyIndex(filename, 0, false);
+        unsigned maxThreads = getAffinityCpus();
+        size32_t oldLeafCacheMem = setLeafCacheMem(0x10000000);
+        unsigned oldShards = setNodeCacheShards(1);
+        for (unsigned numShards : { 1U, MaxNodeCacheShards })
+        {
+            setNodeCacheShards(numShards);
+            for (unsigned numThreads = 1;; numThreads *= 2)
+            {
+                if (numThreads > maxThreads)
+                    numThreads = maxThreads;
+
+                std::atomic<unsigned __int64> totalMatches{0};
+                CCycleTimer timer;
+                asyncFor(numThreads, numThreads, [&](unsigned i)
+                {
+                    Owned<IKeyManager> manager = createLocalKeyManager(recInfo, index, nullptr, false, false);
+                    manager->append(createKeySegmentMonitor(false, probes.getLink(), 0, 0, 10));
+                    manager->finishSegmentMonitors();
+                    for (unsigned pass = 0; pass < numPasses; pass++)
+                    {
+                        manager->reset();
+                        totalMatches += manager->getCount();
+                    }
+                });
+                unsigned __int64 elapsedNs = timer.elapsedNs();
+                ASSERT(totalMatches == (unsigned __int64)numThreads * numPasses * numProbes);
+                DBGLOG("NodeCache shards(%u) threads(%u) %llums (%lluns/probe)", numShards, numThreads, elapsedNs / 1000000,
+                       elapsedNs / ((unsigned __int64)numPasses * numProbes));
+                if (numThreads == maxThreads)
+                    break;
+            }
+            logCacheState();
+        }
+        setNodeCacheShards(oldShards);
+        setLeafCacheMem(oldLeafCacheMem);
+        index.clear();
+        clearKeyStoreCache(true);
+        ASSERT(remove(filename)==0);
+    }
+
+    //Replay the same trace - repeated lookups of a hot set of keys interleaved with scans of large ranges of the index -
+    //with each policy, and compare the leaf cache hit ratios.
+    void testPolicies()
+    {
+        Owned<IOutputMetaData> meta = createKeyMeta();
+        const RtlRecord &recInfo = meta->queryRecordAccessor(true);
+        buildKey(meta);
+
+        Owned<IStringSet> hotProbes = createStringSet(10);
+        char keybuf[11];
+        for (unsigned i = 0; i < 200; i++)
+        {
+            sprintf(keybuf, "%010u", (unsigned)(((unsigned __int64)i * 104729) % numRows));
+            hotProbes->addRange(keybuf, keybuf);
+        }
+
+        Owned <IKeyIndex> index = createKeyIndex(filename, 0, false);
+        size32_t oldLeafCacheMem = setLeafCacheMem(0x400000);
+        unsigned oldShards = setNodeCacheShards(1);
+        for (NodeCachePolicy policy : { NodeCacheLRU, NodeCacheTinyLFU })
+        {
+            setNodeCachePolicy(NodeLeaf, policy);
+            clearNodeCache();
+            Owned<IKeyManager> hot = createLocalKeyManager(recInfo, index, nullptr, false, false);
+            hot->append(createKeySegmentMonitor(false, hotProbes.getLink(), 0, 0, 10));
+            hot->finishSegmentMonitors();
+
+            CCycleTimer timer;
+            for (unsigned pass = 0; pass < 20; pass++)
+            {
+                for (unsigned repeat = 0; repeat < 5; repeat++)
+                {
+                    hot->reset();
+                    ASSERT(hot->getCount() == 200);
+                }
+
+                Owned<IStringSet> scanRange = createStringSet(10);
+                char lowbuf[11];
+                char highbuf[11];
+                sprintf(lowbuf, "%010u", (pass * numRows / 20) % (numRows / 2));
+                sprintf(highbuf, "%010u", (pass * numRows / 20) % (numRows / 2) + numRows / 2);
+                scanRange->addRange(lowbuf, highbuf);
+                Owned<IKeyManager> scan = createLocalKeyManager(recInfo, index, nullptr, false, false);
+                scan->append(createKeySegmentMonitor(false, scanRange.getClear(), 0, 0, 10));
+                scan->finishSegmentMonitors();
+                scan->reset();
+                ASSERT(scan->getCount() == numRows / 2 + 1);
+            }
+            unsigned __int64 elapsedMs = timer.elapsedMs();
+
+            CacheStatsRecorder stats;
+            getNodeCacheInfo(stats);
+            DBGLOG("NodeCache policy(%s) leaf hits(%llu) misses(%llu) rejected(%llu) hit ratio %.2f%% %llums", policy == NodeCacheLRU ? "lru" : "tinylfu",
+                   stats.hits, stats.misses, stats.rejections, (100.0 * stats.hits) / (stats.hits + stats.misses), elapsedMs);
+            if (policy == NodeCacheTinyLFU)
+                ASSERT(stats.rejections != 0);
+        }
+        setNodeCachePolicy(NodeLeaf, NodeCacheLRU);
+        setNodeCacheShards(oldShards);
+        setLeafCacheMem(oldLeafCacheMem);
+        index.clear();
+        clearKeyStoreCache(true);
+        ASSERT(remove(filename)==0);
+    }
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION( NodeCacheTimingTest );
+CPPUNIT_TEST_SUITE_NAMED_REGISTRATION( NodeCacheTimingTest, "NodeCacheTimingTest" );
+
+//Build an index with a 10 byte key and a 30 byte payload, which is compressible to a varying degree
+static void buildKeyBuildTestKey(const char * filename, const char * compression, unsigned flags, unsigned numRows, unsigned buildThreads, unsigned * crc)
+{
+    const char *json =
+            "{ \"ty1\": { \"fieldType\": 4, \"length\": 10 }, "
+            "  \"ty2\": { \"fieldType\": 4, \"length\": 30 }, "
+            " \"fieldType\": 13, \"length\": 40, "
+            " \"fields\": [ "
+            " { \"name\": \"f1\", \"type\": \"ty1\", \"flags\": 4 }, "
+            " { \"name\": \"f2\", \"type\": \"ty2\", \"flags\": 4 } "
+            " ] "
+            "}";
+    Owned<IOutputMetaData> meta = createTypeInfoOutputMetaData(json, false);
+    TestIndexWriteArg helper(filename, compression, meta);
+    OwnedIFile file = createIFile(filename);
+    OwnedIFileIO io = file->openShared(IFOcreate, IFSHfull);
+    Owned<IFileIOStream> out = createIOStream(io);
+    Owned<IKeyBuilder> builder = createKeyBuilder(out, COL_PREFIX | HTREE_FULLSORT_KEY | flags, 40, NODESIZE, 10, 0, &helper, nullptr, true, false, buildThreads);
+
+    Owned<IRandomNumberGenerator> random = createRandomNumberGenerator();
+    random->seed(numRows);
+    char row[41];
+    for (unsigned i=0; i < numRows; i++)
+    {
+        sprintf(row, "%010u", i * 3);
+        unsigned repeat = random->next() % 30;
+        for (unsigned j=0; j < 30; j++)
+            row[10+j] = (j < repeat) ? 'a' : 'a' + random->next() % 26;
+        builder->processKeyData(row, i * 40, 40);
+    }
+    builder->finish(nullptr, crc, 40);
+}
+
+class KeyBuildTest : public CppUnit::TestFixture
+{
+    CPPUNIT_TEST_SUITE( KeyBuildTest );
+        CPPUNIT_TEST(testParallelBuild);
+    CPPUNIT_TEST_SUITE_END();
+
+    void checkSameKey(const char * compression, unsigned flags, unsigned numRows)
+    {
+        unsigned serialCrc = 0;
+        buildKeyBuildTestKey("keybuild1.$$$", compression, flags, numRows, 0, &serialCrc);
+        StringBuffer serial;
+        loadBinaryFile(serial, "keybuild1.$$$", true);
+        for (unsigned threads : { 2, 4, 8 })
+        {
+            unsigned parallelCrc = 0;
+            buildKeyBuildTestKey("keybuild2.$$$", compression, flags, numRows, threads, &parallelCrc);
+            StringBuffer parallel;
+            loadBinaryFile(parallel, "keybuild2.$$$", true);
+            CPPUNIT_ASSERT_EQUAL(serialCrc, parallelCrc);
+            CPPUNIT_ASSERT_EQUAL(serial.length(), parallel.length());
+            CPPUNIT_ASSERT(memcmp(serial.str(), parallel.str(), serial.length()) == 0);
+        }
+        remove("keybuild1.$$$");
+        remove("keybuild2.$$$");
+    }
+
+    void testParallelBuild()
+    {
+        for (unsigned numRows : { 1, 10000, 200000 })
+        {
+            checkSameKey(nullptr, HTREE_COMPRESSED_KEY, numRows);
+            checkSameKey(nullptr, HTREE_COMPRESSED_KEY|HTREE_QUICK_COMPRESSED_KEY, numRows);
+            checkSameKey(nullptr, 0, numRows);      // every leaf has the same number of rows, so the boundaries rarely coincide
+            checkSameKey("inplace", HTREE_COMPRESSED_KEY, numRows);
+            checkSameKey("inplace:recompress", HTREE_COMPRESSED_KEY, numRows);
+        }
+    }
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION( KeyBuildTest );
+CPPUNIT_TEST_SUITE_NAMED_REGISTRATION( KeyBuildTest, "KeyBuildTest" );
+
+class KeyBuildTimingTest : public CppUnit::TestFixture
+{
+    CPPUNIT_TEST_SUITE( KeyBuildTimingTest );
+        CPPUNIT_TEST(testThroughput);
+    CPPUNIT_TEST_SUITE_END();
+
+    static constexpr unsigned numRows = 2000000;
+
+    void timeBuild(const char * compression, unsigned flags)
+    {
+        for (unsigned threads : { 0, 2, 4, 8 })
+        {
+            unsigned crc;
+            CCycleTimer timer;
+            buildKeyBuildTestKey("keybuildtiming.$$$", compression, flags, numRows, threads, &crc);
+            unsigned __int64 elapsedMs = timer.elapsedMs();
+            DBGLOG("KeyBuild compression(%s) threads(%u) %llums %.0f rows/s crc(%x)", compression ? compression : "legacy", threads,
+                   elapsedMs, elapsedMs ? (numRows * 1000.0) / elapsedMs : 0.0, crc);
+        }
+        remove("keybuildtiming.$$$");
+    }
+
+    void testThroughput()
+    {
+        timeBuild(nullptr, HTREE_COMPRESSED_KEY);
+        timeBuild("inplace", HTREE_COMPRESSED_KEY);
+        timeBuild("inplace:lz4hc", HTREE_COMPRESSED_KEY);
+    }
+};
+
+CPPUNIT_TEST_SUITE_NAMED_REGISTRATION( KeyBuildTimingTest, "KeyBuildTimingTest" );
+
+// Generate sorted fixed width rows that share a common prefix, with many duplicate prefixes so ties are resolved
+static void generateSearchRows(MemoryBuffer & rows, unsigned numRows, size32_t rowLen, size32_t commonLen, unsigned seed)
+{
+    Owned<IRandomNumberGenerator> random = createRandomNumberGenerator();
+    random->seed(seed);
+    byte * data = (byte *)rows.clear().reserveTruncate(numRows * rowLen);
+    memset(data, 'x', numRows * rowLen);
+    for (unsigned i=0; i < numRows; i++)
+    {
+        byte * row = data + i * rowLen;
+        for (unsigned j=commonLen; j < rowLen; j++)
+            row[j] = (byte)(random->next() % 4);
+    }
+    std::vector<std::string> sorted;
+    for (unsigned i=0; i < numRows; i++)
+        sorted.emplace_back((const char *)data + i * rowLen, rowLen);
+    std::sort(sorted.begin(), sorted.end());
+    for (unsigned i=0; i < numRows; i++)
+        memcpy(data + i * rowLen, sorted[i].data(), rowLen);
+}
+
+static unsigned findGEReference(const byte * rows, size32_t stride, unsigned lo, unsigned hi, const byte * search, size32_t len)
+{
+    while (lo < hi)
+    {
+        unsigned i = lo+(hi-lo)/2;
+        if (memcmp(search, rows + i * stride, len) > 0)
+            lo = i+1;
+        else
+            hi = i;
+    }
+    return lo;
+}
+
+class NodeSearchTest : public CppUnit::TestFixture
+{
+    CPPUNIT_TEST_SUITE( NodeSearchTest );
+        CPPUNIT_TEST(testKernels);
+        CPPUNIT_TEST(testFindGE);
+    CPPUNIT_TEST_SUITE_END();
+
+    void testKernels()
+    {
+        NodeSearchIsa oldIsa = queryNodeSearchIsa();
+        byte left[100], right[100], values[100];
+        for (unsigned i=0; i < 100; i++)
+        {
+            left[i] = right[i] = (byte)(i * 7);
+            values[i] = (byte)(i * 2 + 1);
+        }
+        for (unsigned isa=NodeSearchScalar; isa < NodeSearchIsaMax; isa++)
+        {
+            setNodeSearchIsa((NodeSearchIsa)isa);
+            for (unsigned len=0; len < 70; len++)
+            {
+                CPPUNIT_ASSERT_EQUAL(len, (unsigned)nodeSearchKernels.firstMismatch(left, right, len));
+                for (unsigned pos=0; pos < len; pos++)
+                {
+                    right[pos] ^= 0x80;
+                    CPPUNIT_ASSERT_EQUAL(pos, (unsigned)nodeSearchKernels.firstMismatch(left, right, len));
+                    right[pos] ^= 0x80;
+
+                    memset(right, 'a', len);
+                    right[pos] = 'b';
+                    CPPUNIT_ASSERT_EQUAL(pos, (unsigned)nodeSearchKernels.firstNotEqual(right, 'a', len));
+                    memcpy(right, left, len);
+                }
+                for (unsigned search=0; search < 256; search += 3)
+                    CPPUNIT_ASSERT_EQUAL(std::min(len, search/2), nodeSearchKernels.countLess(values, len, (byte)search));
+            }
+        }
+        setNodeSearchIsa(oldIsa);
+    }
+
+    void testFindGE()
+    {
+        NodeSearchIsa oldIsa = queryNodeSearchIsa();
+        const unsigned numRows = 200;
+        MemoryBuffer rows;
+        byte search[64];
+        for (size32_t rowLen : { 4, 8, 9, 12, 20, 40 })
+        {
+            for (size32_t commonLen : { 0U, 1U, rowLen / 2, rowLen - 2 })
+            {
+                generateSearchRows(rows, numRows, rowLen, commonLen, rowLen * 100 + commonLen);
+                const byte * data = rows.bytes();
+                size32_t actualCommon = getCommonPrefixLen(data, rowLen, numRows, rowLen);
+                CPPUNIT_ASSERT(actualCommon >= commonLen);
+                for (unsigned isa=NodeSearchScalar; isa < NodeSearchIsaMax; isa++)
+                {
+                    setNodeSearchIsa((NodeSearchIsa)isa);
+                    for (unsigned i=0; i < numRows; i++)
+                    {
+                        //Search for each row, and values just before and after it
+                        for (int delta=-1; delta <= 1; delta++)
+                        {
+                            memcpy(search, data + i * rowLen, rowLen);
+                            byte & last = search[rowLen-1];
+                            if ((delta < 0 && last == 0) || (delta > 0 && last == 0xff))
+                                continue;
+                            last += delta;
+                            for (unsigned lo : { 0U, i / 2 })
+                            {
+                                unsigned expected = findGEReference(data, rowLen, lo, numRows, search, rowLen);
+                                unsigned actual = findGEFixedRows(data, rowLen, lo, numRows, search, rowLen, actualCommon);
+                                CPPUNIT_ASSERT_EQUAL(expected, actual);
+                            }
+                        }
+                    }
+                }
+            }
+        }
+        setNodeSearchIsa(oldIsa);
+    }
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION( NodeSearchTest );
+CPPUNIT_TEST_SUITE_NAMED_REGISTRATION( NodeSearchTest, "NodeSearchTest" );
+
+class NodeSearchTimingTest : public CppUnit::TestFixture
+{
+    CPPUNIT_TEST_SUITE( NodeSearchTimingTest );
+        CPPUNIT_TEST(testFindGE);
+    CPPUNIT_TEST_SUITE_END();
+
+    static constexpr unsigned numRows = 400;        // roughly the number of 20 byte keys in an 8K node
+    static constexpr unsigned numSearches = 2000000;
+
+    void timeFindGE(size32_t rowLen, size32_t commonLen)
+    {
+        MemoryBuffer rows;
+        generateSearchRows(rows, numRows, rowLen, commonLen, rowLen);
+        const byte * data = rows.bytes();
+        size32_t actualCommon = getCommonPrefixLen(data, rowLen, numRows, rowLen);
+
+        //Search for values between the rows, in an order that the branch predictor cannot learn
+        MemoryBuffer searches;
+        byte * searchData = (byte *)searches.reserveTruncate(numRows * rowLen);
+        for (unsigned i=0; i < numRows; i++)
+        {
+            unsigned row = (i * 7919) % numRows;
+            memcpy(searchData + i * rowLen, data + row * rowLen, rowLen);
+            searchData[i * rowLen + rowLen - 1] ^= 1;
+        }
+
+        NodeSearchIsa oldIsa = queryNodeSearchIsa();
+        {
+            unsigned __int64 total = 0;
+            CCycleTimer timer;
+            for (unsigned i=0; i < numSearches; i++)
+                total += findGEReference(data, rowLen, 0, numRows, searchData + (i % numRows) * rowLen, rowLen);
+            DBGLOG("NodeSearch rowLen(%u) common(%u) memcmp: %lluns/search (%llu)", rowLen, actualCommon, timer.elapsedNs() / numSearches, total);
+        }
+        for (unsigned isa=NodeSearchScalar; isa < NodeSearchIsaMax; isa++)
+        {
+            if (setNodeSearchIsa((NodeSearchIsa)isa) != isa)
+                continue;
+            unsigned __int64 total = 0;
+            CCycleTimer timer;
+            for (unsigned i=0; i < numSearches; i++)
+                total += findGEFixedRows(data, rowLen, 0, numRows, searchData + (i % numRows) * rowLen, rowLen, actualCommon);
+            DBGLOG("NodeSearch rowLen(%u) common(%u) %s: %lluns/search (%llu)", rowLen, actualCommon, queryNodeSearchIsaName((NodeSearchIsa)isa), timer.elapsedNs() / numSearches, total);
+        }
+        setNodeSearchIsa(oldIsa);
+    }
+
+    void testFindGE()
+    {
+        timeFindGE(12, 0);
+        timeFindGE(20, 0);
+        timeFindGE(20, 10);
+        timeFindGE(40, 30);
+    }
+};
+
+CPPUNIT_TEST_SUITE_NAMED_REGISTRATION( NodeSearchTimingTest, "NodeSearchTimingTest" );
+
 #endif
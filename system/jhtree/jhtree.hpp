@@ -77,6 +77,7 @@ interface jhtree_decl IKeyCursor : public IInterface
     virtual const byte *queryRecordBuffer() const = 0;
     virtual const byte *queryKeyedBuffer() const = 0;
     virtual void mergeStats(CRuntimeStatisticCollection & stats) const = 0;
+    virtual void setReadAhead(unsigned numLeaves) = 0;  // Number of leaf nodes to load asynchronously ahead of the cursor (0 = disabled)
 };
 
 interface IKeyIndex;
@@ -116,6 +117,10 @@ interface jhtree_decl IKeyIndex : public IKeyIndexBase
     virtual bool prewarmPage(offset_t offset, NodeType type) = 0;
     virtual void mergeStats(CRuntimeStatisticCollection & stats) const = 0;
     virtual offset_t queryFirstBranchOffset() = 0;
+    // Batched bloom filter checks - getBloomProbe() selects a bloom filter that can check the filter and returns the hash to test,
+    // and bloomFilterTestMany() tests a batch of hashes that were returned for the same bloom filter.
+    virtual bool getBloomProbe(const IIndexFilterList &filter, unsigned &whichFilter, hash64_t &hash) = 0;
+    virtual unsigned bloomFilterTestMany(unsigned whichFilter, unsigned num, const hash64_t * hashes, bool * results) = 0;
 };
 
 interface IKeyArray : extends IInterface
@@ -138,6 +143,15 @@ interface jhtree_decl IKeyIndexSet : public IKeyIndexBase
 interface ICacheInfoRecorder
 {
     virtual void noteWarm(unsigned fileIdx, offset_t page, size32_t len, NodeType type) = 0;
+    virtual void noteCacheStats(NodeType type, const char * policy, unsigned __int64 hits, unsigned __int64 misses, unsigned __int64 rejections) = 0;
+};
+
+// Policy used to decide which nodes are retained in a node cache
+enum NodeCachePolicy : byte
+{
+    NodeCacheLRU,           // Always add new nodes, evicting the least recently used
+    NodeCacheTinyLFU,       // Only add new nodes if they are likely to be used more frequently than the node they would evict
+    NodeCachePolicyMax
 };
 
 
@@ -151,6 +165,9 @@ extern jhtree_decl void logCacheState();
 extern jhtree_decl size32_t setNodeCacheMem(size32_t cacheSize);
 extern jhtree_decl size32_t setLeafCacheMem(size32_t cacheSize);
 extern jhtree_decl size32_t setBlobCacheMem(size32_t cacheSize);
+extern jhtree_decl unsigned setNodeCacheShards(unsigned numShards); // rounded up to a power of 2.  Discards the current cache contents
+extern jhtree_decl NodeCachePolicy setNodeCachePolicy(NodeType type, NodeCachePolicy policy);
+extern jhtree_decl NodeCachePolicy getNodeCachePolicy(const char * name);
 extern jhtree_decl void setNodeFetchThresholdNs(__uint64 thresholdNs);
 extern jhtree_decl void setIndexWarningThresholds(IPropertyTree * options);
 
@@ -179,6 +196,9 @@ extern jhtree_decl RelaxedAtomic<unsigned> leafCacheDups;
 extern jhtree_decl RelaxedAtomic<unsigned> nodeCacheHits;
 extern jhtree_decl RelaxedAtomic<unsigned> nodeCacheAdds;
 extern jhtree_decl RelaxedAtomic<unsigned> nodeCacheDups;
+extern jhtree_decl RelaxedAtomic<unsigned> leafPrefetches;
+extern jhtree_decl RelaxedAtomic<unsigned> leafPrefetchHits;
+extern jhtree_decl RelaxedAtomic<unsigned> leafPrefetchWasted;
 
 extern std::atomic<unsigned __int64> branchSearchCycles;
 extern std::atomic<unsigned __int64> leafSearchCycles;
@@ -287,6 +307,10 @@ interface IKeyManager : public IInterface, extends IIndexReadContext
 
     virtual unsigned numActiveKeys() const = 0;
     virtual void mergeStats(CRuntimeStatisticCollection & stats) const = 0;
+    virtual void setReadAhead(unsigned numLeaves) = 0;
+    // Get the bloom probe for the current filter, so that a batch of lookups can be checked together (see IKeyIndex)
+    virtual bool getBloomProbe(unsigned &whichFilter, hash64_t &hash) = 0;
+    virtual unsigned bloomFilterTestMany(unsigned whichFilter, unsigned num, const hash64_t * hashes, bool * results) = 0;
 };
 
 inline offset_t extractFpos(IKeyManager * manager)
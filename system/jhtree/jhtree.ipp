@@ -84,6 +84,7 @@ class jhtree_decl CKeyIndex : implements IKeyIndex, implements INodeLoader, publ
 {
     friend class CKeyStore;
     friend class CKeyCursor;
+    friend class CLeafPrefetcher;
 
 private:
     CKeyIndex(CKeyIndex &);
@@ -113,6 +114,8 @@ protected:
     ~CKeyIndex();
     void init(KeyHdr &hdr, bool isTLK);
     void loadBloomFilters();
+    void loadBloomFilterChain(offset_t bloomAddr, bool blocked);
+    void ensureBloomFiltersLoaded() const;
     const CJHSearchNode *getRootNode() const;
 
     inline bool isTLK() const { return (keyHdr->getKeyType() & HTREE_TOPLEVEL_KEY) != 0; }
@@ -154,6 +157,8 @@ public:
     virtual bool needsRowBuffer() const;
     virtual bool prewarmPage(offset_t page, NodeType type);
     virtual offset_t queryFirstBranchOffset() override;
+    virtual bool getBloomProbe(const IIndexFilterList &filter, unsigned &whichFilter, hash64_t &hash) override;
+    virtual unsigned bloomFilterTestMany(unsigned whichFilter, unsigned num, const hash64_t * hashes, bool * results) override;
 
  // INodeLoader impl.
     virtual const CJHTreeNode *loadNode(cycle_t * fetchCycles, offset_t offset) const override = 0;  // Must be implemented in derived classes
@@ -193,6 +198,45 @@ public:
     virtual void mergeStats(CRuntimeStatisticCollection & stats) const override { ::mergeStats(stats, io); }
 };
 
+// Issues asynchronous loads of the leaf nodes a cursor is expected to visit next, so that the io overlaps with
+// the processing of the current leaf.  Leaves are read into the node cache - the cursor itself is unchanged.
+// Sequential scans follow the right sibling chain, seeks prefetch the following entries of the parent branch.
+class CLeafPrefetcher : public CInterface
+{
+    friend class CLeafPrefetchTask;
+public:
+    static constexpr unsigned MaxLeafReadAhead = 64;
+
+    CLeafPrefetcher(CKeyIndex &_key, unsigned _depth);
+    ~CLeafPrefetcher();
+
+    void noteLeaf(const CJHSearchNode *leaf, KeyStatsCollector &stats);
+    void noteSeek(const CJHSearchNode *branch, unsigned idx, KeyStatsCollector &stats);
+    void cancel();
+
+protected:
+    bool isOutstanding(offset_t pos) const;
+    bool consume(offset_t pos);
+    void discardOutstanding();
+    void issue(offset_t pos);
+    void noteStats(KeyStatsCollector &stats);
+    void processChain(offset_t pos, unsigned chainLength, unsigned chainGeneration);
+    void processLeaf(offset_t pos, unsigned leafGeneration);
+
+protected:
+    CriticalSection crit;
+    Linked<CKeyIndex> key;
+    offset_t outstanding[MaxLeafReadAhead];     // leaves requested but not yet reached by the cursor, in key order
+    unsigned numOutstanding = 0;
+    unsigned depth;
+    unsigned generation = 0;                    // incremented to abandon any chain that is in progress
+    offset_t chainNext = 0;                     // the next leaf to be read by the sibling chain
+    bool chainActive = false;
+    unsigned unreportedIssued = 0;
+    unsigned unreportedHits = 0;
+    unsigned unreportedWasted = 0;
+};
+
 class jhtree_decl CKeyCursor : public CInterfaceOf<IKeyCursor>
 {
 protected:
@@ -200,7 +244,9 @@ protected:
     const IIndexFilterList *filter;
     char *recordBuffer = nullptr;
     Owned<const CJHSearchNode> node;
+    Owned<CLeafPrefetcher> prefetcher;
     unsigned int nodeKey;
+    unsigned readAhead = 0;
     
     mutable bool fullBufferValid = false;
     bool eof=false;
@@ -231,6 +277,7 @@ public:
     virtual bool nextRange(unsigned groupSegCount) override;
     virtual const byte *queryRecordBuffer() const override;
     virtual const byte *queryKeyedBuffer() const override;
+    virtual void setReadAhead(unsigned numLeaves) override;
 protected:
     CKeyCursor(const CKeyCursor &from);
 
@@ -23,6 +23,82 @@
 
 #include "jhutil.hpp"
 
+//---------------------------------------------------------------------------------------------------------------------
+
+constexpr unsigned __int64 CFrequencySketch::seeds[numRows];
+
+void CFrequencySketch::setCapacity(unsigned maxEntries)
+{
+    if (!maxEntries)
+    {
+        tableMem.clear();
+        table = nullptr;
+        tableMask = 0;
+        sampleSize = 0;
+        numIncrements = 0;
+        return;
+    }
+
+    //One 64bit word (=16 counters) for each potential entry in the cache
+    unsigned numWords = 8;
+    while ((numWords < maxEntries) && (numWords < 0x4000000))
+        numWords *= 2;
+    table = (unsigned __int64 *)tableMem.allocate(numWords * sizeof(unsigned __int64));
+    tableMask = numWords * 16 - 1;
+    sampleSize = (maxEntries < 0x10000000) ? maxEntries * 10 : 0xffffffff;
+    reset();
+}
+
+void CFrequencySketch::reset()
+{
+    if (table)
+        memset(table, 0, (tableMask + 1) / 2);
+    numIncrements = 0;
+}
+
+void CFrequencySketch::increment(unsigned __int64 hash)
+{
+    if (!table)
+        return;
+
+    bool added = false;
+    for (unsigned row = 0; row < numRows; row++)
+    {
+        unsigned index = getCounterIndex(hash, row);
+        if (getCounter(index) != 0xf)
+        {
+            table[index / 16] += (1ULL << ((index % 16) * 4));
+            added = true;
+        }
+    }
+
+    if (added && (++numIncrements >= sampleSize))
+        halve();
+}
+
+unsigned CFrequencySketch::estimate(unsigned __int64 hash) const
+{
+    if (!table)
+        return 0;
+
+    unsigned minCount = 0xf;
+    for (unsigned row = 0; row < numRows; row++)
+    {
+        unsigned count = getCounter(getCounterIndex(hash, row));
+        if (count < minCount)
+            minCount = count;
+    }
+    return minCount;
+}
+
+void CFrequencySketch::halve()
+{
+    unsigned numWords = (tableMask + 1) / 16;
+    for (unsigned i = 0; i < numWords; i++)
+        table[i] = (table[i] >> 1) & 0x7777777777777777ULL;
+    numIncrements /= 2;
+}
+
 #if 0
 // CSwapper impl.
 
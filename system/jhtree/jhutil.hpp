@@ -147,4 +147,50 @@ public:
     }
 };
 
+/*
+ * A count-min sketch of 4-bit counters, used to estimate how frequently a key has been accessed in the recent past
+ * (as used by the TinyLFU cache admission policy).  Once the number of increments reaches the sample size all of the
+ * counters are halved, so that the estimates favour recent activity.  Not thread safe - the caller must serialize access.
+ */
+class jhtree_decl CFrequencySketch
+{
+public:
+    /*
+     * Size the sketch for a cache that is expected to contain at most maxEntries entries.  Resets all counters.
+     */
+    void setCapacity(unsigned maxEntries);
+    /*
+     * Note an access to the key with the given hash
+     */
+    void increment(unsigned __int64 hash);
+    /*
+     * Return the estimated number of accesses (0..15) to the key with the given hash
+     */
+    unsigned estimate(unsigned __int64 hash) const;
+    void reset();
+
+    inline bool isEnabled() const { return tableMask != 0; }
+
+private:
+    inline unsigned getCounterIndex(unsigned __int64 hash, unsigned row) const
+    {
+        hash = (hash + seeds[row]) * seeds[row];
+        return (unsigned)(hash >> 32) & tableMask;
+    }
+    inline unsigned getCounter(unsigned index) const
+    {
+        return (unsigned)(table[index / 16] >> ((index % 16) * 4)) & 0xf;
+    }
+    void halve();
+
+private:
+    static constexpr unsigned numRows = 4;
+    static constexpr unsigned __int64 seeds[numRows] = { 0xc3a5c85c97cb3127ULL, 0xb492b66fbe98f273ULL, 0x9ae16a3b2f90404fULL, 0xcbf29ce484222325ULL };
+    MemoryAttr tableMem;
+    unsigned __int64 * table = nullptr;    // 16 x 4-bit counters in each entry
+    unsigned tableMask = 0;             // mask to apply to select a counter
+    unsigned sampleSize = 0;
+    unsigned numIncrements = 0;
+};
+
 #endif
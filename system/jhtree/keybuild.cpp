@@ -15,10 +15,14 @@
     limitations under the License.
 ############################################################################## */
 
+#include <vector>
+
 #include "keybuild.hpp"
 #include "eclhelper.hpp"
 #include "bloom.hpp"
 #include "jmisc.hpp"
+#include "jtask.hpp"
+#include "jthread.hpp"
 #include "jhinplace.hpp"
 
 struct CRC32HTE
@@ -112,7 +116,117 @@ class LegacyIndexCompressor : public CInterfaceOf<IIndexCompressor>
     }
 };
 
-class CKeyBuilder : public CInterfaceOf<IKeyBuilder>
+static void throwRowTooLarge(CKeyHdr * keyHdr, size32_t recsize, offset_t pos)
+{
+    throw MakeStringException(0, "Key row too large to fit within a key node (uncompressed size=%d, variable=%s, pos=%" I64F "d)", recsize, keyHdr->isVariable()?"true":"false", pos);
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+// Building leaf nodes in parallel
+//
+// Whether a row fits in a leaf depends on all the rows before it in the same leaf, so the leaf boundaries can only be
+// found by filling the leaves in order.  To fill them in parallel the rows are split into batches, and a worker fills
+// the leaves for each batch as if a new leaf started with the first row in the batch.
+//
+// The writer thread commits the batches in order.  It continues adding rows from the next batch to the last leaf from
+// the previous batch until it is full.  If the next leaf starts with the same row as one of the leaves filled by the
+// worker, that leaf and all the leaves that follow it must be identical to the leaves a serial build would create,
+// so they are used as they are.  Otherwise the writer fills the next leaf itself, and tries again when it is full.
+// The boundaries normally coincide within a few leaves, and the file is always identical to the serial build.
+
+class CLeafBatch : public CInterface
+{
+    struct RowInfo
+    {
+        offset_t pos;
+        size32_t offset;
+        size32_t size;
+    };
+
+public:
+    CLeafBatch(unsigned __int64 _firstSequence, bool _speculative)
+    : firstSequence(_firstSequence), speculative(_speculative)
+    {
+    }
+
+    void addRow(const char * keyData, offset_t pos, size32_t size)
+    {
+        rows.push_back({ pos, rowData.length(), size });
+        rowData.append(size, keyData);
+    }
+
+    bool addTo(CWriteNode * node, unsigned row) const
+    {
+        const RowInfo & info = rows[row];
+        return node->add(info.pos, rowData.bytes() + info.offset, info.size, firstSequence + row);
+    }
+
+    void build(const IIndexCompressor & compressor, CKeyHdr * keyHdr)
+    {
+        try
+        {
+            CWriteNode * node = nullptr;
+            for (unsigned row = 0; row < numRows(); row++)
+            {
+                if (!node || !addTo(node, row))
+                {
+                    //The file position is assigned when the writer commits the leaf
+                    node = compressor.createNode(0, keyHdr, true);
+                    nodes.append(*node);
+                    nodeStarts.append(row);
+                    if (!addTo(node, row))
+                        throwRowTooLarge(keyHdr, queryRowSize(row), queryRowPos(row));
+                }
+            }
+        }
+        catch (IException * e)
+        {
+            exception.setown(e);
+        }
+        built.signal();
+    }
+
+    unsigned numRows() const { return rows.size(); }
+    size32_t queryDataSize() const { return rowData.length(); }
+    size32_t queryRowSize(unsigned row) const { return rows[row].size; }
+    offset_t queryRowPos(unsigned row) const { return rows[row].pos; }
+
+public:
+    CIArrayOf<CWriteNode> nodes;        // leaves filled by the worker - the last one is not full
+    UnsignedArray nodeStarts;           // the first row in each of the leaves
+    Owned<IException> exception;
+    Semaphore built;
+    const bool speculative;             // if false the writer fills all the leaves for the batch itself
+
+private:
+    MemoryBuffer rowData;
+    std::vector<RowInfo> rows;
+    const unsigned __int64 firstSequence;
+};
+
+class CLeafBatchTask : public CTask
+{
+public:
+    CLeafBatchTask(CLeafBatch & _batch, IIndexCompressor & _compressor, CKeyHdr * _keyHdr)
+    : CTask(0), batch(&_batch), compressor(&_compressor), keyHdr(_keyHdr)
+    {
+    }
+
+    virtual CTask * execute() override
+    {
+        batch->build(*compressor, keyHdr);
+        return nullptr;
+    }
+
+protected:
+    Linked<CLeafBatch> batch;
+    Linked<IIndexCompressor> compressor;
+    Linked<CKeyHdr> keyHdr;
+};
+
+//---------------------------------------------------------------------------------------------------------------------
+
+class CKeyBuilder : public CInterfaceOf<IKeyBuilder>, implements IThreaded
 {
 protected:
     unsigned keyValueSize;
@@ -146,11 +260,33 @@ private:
     bool enforceOrder = true;
     bool isTLK = false;
 
+    // Parallel leaf building - see CLeafBatch.  Only used if buildThreads > 1
+    static constexpr unsigned leavesPerBatch = 32;
+    static constexpr size32_t maxBatchDataSize = 0x4000000;
+    static constexpr unsigned maxSpeculationMisses = 4;
+    unsigned buildThreads = 0;
+    bool pipelineActive = false;
+    bool writerStarted = false;
+    Owned<CLeafBatch> nextBatch;
+    MemoryAttr lastKey;
+    CIArrayOf<CLeafBatch> pendingBatches;
+    CriticalSection pendingCrit;
+    Semaphore pendingSem;
+    Semaphore slotsAvailable;
+    Owned<IException> pipelineException;
+    CThreaded writer;
+    RelaxedAtomic<unsigned> rowsPerLeaf{1};
+    RelaxedAtomic<bool> speculate{true};
+    unsigned __int64 committedRows = 0;
+    unsigned speculationMisses = 0;
+
 public:
-    CKeyBuilder(IFileIOStream *_out, unsigned flags, unsigned rawSize, unsigned nodeSize, unsigned _keyedSize, unsigned __int64 _startSequence,  IHThorIndexWriteArg *_helper, const char * defaultCompression, bool _enforceOrder, bool _isTLK)
+    CKeyBuilder(IFileIOStream *_out, unsigned flags, unsigned rawSize, unsigned nodeSize, unsigned _keyedSize, unsigned __int64 _startSequence,  IHThorIndexWriteArg *_helper, const char * defaultCompression, bool _enforceOrder, bool _isTLK, unsigned _buildThreads)
         : out(_out),
           enforceOrder(_enforceOrder),
-          isTLK(_isTLK)
+          isTLK(_isTLK),
+          buildThreads(_buildThreads),
+          writer("KeyBuildWriter")
     {
         sequence = _startSequence;
         keyHdr.setown(new CWriteKeyHdr());
@@ -195,6 +331,7 @@ public:
         hdr->blobHead = 0;
         hdr->metadataHead = 0;
         hdr->firstLeaf = 0;
+        hdr->blockedBloomHead = 0;
 
         keyHdr->write(out, &headCRC);  // Reserve space for the header - we may seek back and write it properly later
 
@@ -231,10 +368,30 @@ public:
         }
         else
             indexCompressor.setown(new LegacyIndexCompressor);
+
+        //The top level key is small, so there is no benefit building it in parallel
+        if ((buildThreads > 1) && !isTLK)
+        {
+            pipelineActive = true;
+            rowsPerLeaf = std::max(nodeSize / std::max(rawSize, 1U), 1U);
+            lastKey.allocate(keyedSize);
+            slotsAvailable.signal(buildThreads + 1);
+        }
     }
 
     ~CKeyBuilder()
     {
+        if (writerStarted)
+        {
+            try
+            {
+                stopPipeline(false);
+            }
+            catch (IException * e)
+            {
+                e->Release();
+            }
+        }
         for (;;)
         {
             CRC32HTE *et = (CRC32HTE *)crcEndPosTable.next(NULL);
@@ -443,6 +600,8 @@ protected:
 
     void finish(IPropertyTree * metadata, unsigned * fileCrc, size32_t maxRecordSizeSeen)
     {
+        if (pipelineActive)
+            stopPipeline(true);
         if (maxRecordSizeSeen)
             keyHdr->setMaxKeyLength(maxRecordSizeSeen);
         if (activeBlobNode && (keyHdr->getKeyType() & TRAILING_HEADER_ONLY))
@@ -519,51 +678,37 @@ protected:
 
     void addLeafInfo(CNodeInfo *info)
     {
+        if (pipelineActive)
+            stopPipeline(true);
         leafInfo.append(* info);
     }
 
     void processKeyData(const char *keyData, offset_t pos, size32_t recsize)
     {
         records++;
-        if (NULL == activeNode)
-        {
-            keyHdr->getHdrStruct()->firstLeaf = nextPos;
-            activeNode = indexCompressor->createNode(nextPos, keyHdr, true);
-            nextPos += keyHdr->getNodeSize();
-            numLeaves++;
-        }
-        else if (enforceOrder) // NB: order is indeterminate when build a TLK for a LOCAL index. duplicateCount is not calculated in this case.
-        {
-            int cmp = memcmp(keyData, activeNode->getLastKeyValue(), keyedSize);
-            if (cmp<0)
-                throw MakeStringException(JHTREE_KEY_NOT_SORTED, "Unable to build index - dataset not sorted in key order");
-            if (cmp==0)
-                ++duplicateCount;
-        }
-        if (!isTLK)
+        if (pipelineActive)
         {
-            ForEachItemInRev(idx, bloomBuilders)
-            {
-                IBloomBuilder &bloomBuilder = bloomBuilders.item(idx);
-                IRowHasher &hasher = rowHashers.item(idx);
-                if (!bloomBuilder.add(hasher.hash((const byte *) keyData)))
-                {
-                    bloomBuilders.remove(idx);
-                    rowHashers.remove(idx);
-                }
-            }
+            if (records != 1)
+                checkKeyOrder(keyData, lastKey.get());
+            memcpy(lastKey.bufferBase(), keyData, keyedSize);
+            addToBloomFilters(keyData);
+            queueKeyData(keyData, pos, recsize);
+            sequence++;
+            return;
         }
+
+        if (NULL == activeNode)
+            startLeafNode(indexCompressor->createNode(nextPos, keyHdr, true));
+        else
+            checkKeyOrder(keyData, activeNode->getLastKeyValue());
+        addToBloomFilters(keyData);
         if (!activeNode->add(pos, keyData, recsize, sequence))
         {
             assertex(NULL != activeNode->getLastKeyValue()); // empty and doesn't fit!
 
-            flushNode(activeNode, leafInfo);
-            activeNode->Release();
-            activeNode = indexCompressor->createNode(nextPos, keyHdr, true);
-            nextPos += keyHdr->getNodeSize();
-            numLeaves++;
+            startLeafNode(indexCompressor->createNode(nextPos, keyHdr, true));
             if (!activeNode->add(pos, keyData, recsize, sequence))
-                throw MakeStringException(0, "Key row too large to fit within a key node (uncompressed size=%d, variable=%s, pos=%" I64F "d)", recsize, keyHdr->isVariable()?"true":"false", pos);
+                throwRowTooLarge(keyHdr, recsize, pos);
         }
         sequence++;
     }
@@ -594,6 +739,9 @@ protected:
     {
         if (!size)
             return 0;
+        //Blob nodes are allocated file positions in between the leaves, so indexes with blobs are built serially
+        if (pipelineActive)
+            stopPipeline(true);
         if (NULL == activeBlobNode)
             newBlobNode();
         unsigned __int64 head = activeBlobNode->add(ptr, size);
@@ -621,6 +769,177 @@ protected:
     virtual unsigned __int64 getLeafMemorySize() const override { return indexCompressor->queryLeafMemorySize(); }
 
 protected:
+    void checkKeyOrder(const char * keyData, const void * prevKeyData)
+    {
+        if (enforceOrder) // NB: order is indeterminate when build a TLK for a LOCAL index. duplicateCount is not calculated in this case.
+        {
+            int cmp = memcmp(keyData, prevKeyData, keyedSize);
+            if (cmp<0)
+                throw MakeStringException(JHTREE_KEY_NOT_SORTED, "Unable to build index - dataset not sorted in key order");
+            if (cmp==0)
+                ++duplicateCount;
+        }
+    }
+
+    void addToBloomFilters(const char * keyData)
+    {
+        if (!isTLK)
+        {
+            ForEachItemInRev(idx, bloomBuilders)
+            {
+                IBloomBuilder &bloomBuilder = bloomBuilders.item(idx);
+                IRowHasher &hasher = rowHashers.item(idx);
+                if (!bloomBuilder.add(hasher.hash((const byte *) keyData)))
+                {
+                    bloomBuilders.remove(idx);
+                    rowHashers.remove(idx);
+                }
+            }
+        }
+    }
+
+    //Allocate the file position for the next leaf node (which takes ownership of node), and write out the previous leaf
+    void startLeafNode(CWriteNode * node)
+    {
+        if (activeNode)
+        {
+            flushNode(activeNode, leafInfo);
+            activeNode->Release();
+        }
+        else
+            keyHdr->getHdrStruct()->firstLeaf = nextPos;
+        node->setFpos(nextPos);
+        activeNode = node;
+        nextPos += keyHdr->getNodeSize();
+        numLeaves++;
+    }
+
+    void queueKeyData(const char * keyData, offset_t pos, size32_t recsize)
+    {
+        if (!nextBatch)
+            nextBatch.setown(new CLeafBatch(sequence, speculate));
+        nextBatch->addRow(keyData, pos, recsize);
+        if ((nextBatch->numRows() >= leavesPerBatch * rowsPerLeaf) || (nextBatch->queryDataSize() >= maxBatchDataSize))
+        {
+            checkPipelineException();
+            dispatchBatch();
+        }
+    }
+
+    void dispatchBatch()
+    {
+        slotsAvailable.wait();      // limits the number of batches (and therefore the memory) in use at once
+        if (!writerStarted)
+        {
+            writer.init(this);
+            writerStarted = true;
+        }
+        CLeafBatch * batch = nextBatch.getClear();
+        if (batch->speculative)
+            enqueueOwnedTask(queryTaskScheduler(), *new CLeafBatchTask(*batch, *indexCompressor, keyHdr));
+        {
+            CriticalBlock block(pendingCrit);
+            pendingBatches.append(*batch);
+        }
+        pendingSem.signal();
+    }
+
+    void checkPipelineException()
+    {
+        CriticalBlock block(pendingCrit);
+        if (pipelineException)
+            throw pipelineException.getClear();
+    }
+
+    //Wait for all the rows to be added to leaves, and continue building on the calling thread
+    void stopPipeline(bool flush)
+    {
+        pipelineActive = false;
+        if (flush && nextBatch)
+            dispatchBatch();
+        nextBatch.clear();
+        if (writerStarted)
+        {
+            pendingSem.signal();    // The writer stops when it is signalled and there are no batches left
+            writer.join();
+            writerStarted = false;
+        }
+        checkPipelineException();
+    }
+
+    virtual void threadmain() override
+    {
+        for (;;)
+        {
+            pendingSem.wait();
+            Owned<CLeafBatch> batch;
+            {
+                CriticalBlock block(pendingCrit);
+                if (!pendingBatches.ordinality())
+                    break;
+                batch.set(&pendingBatches.item(0));
+                pendingBatches.remove(0);
+            }
+            if (batch->speculative)
+                batch->built.wait();
+            //Once there has been an error, any remaining batches are discarded
+            if (!pipelineException)
+            {
+                try
+                {
+                    commitBatch(*batch);
+                }
+                catch (IException * e)
+                {
+                    CriticalBlock block(pendingCrit);
+                    pipelineException.setown(e);
+                }
+            }
+            batch.clear();
+            slotsAvailable.signal();
+        }
+    }
+
+    void commitBatch(CLeafBatch & batch)
+    {
+        if (batch.exception)
+            throw batch.exception.getLink();
+
+        unsigned numRows = batch.numRows();
+        unsigned numNodes = batch.speculative ? batch.nodes.ordinality() : 0;
+        unsigned nextNode = 0;
+        committedRows += numRows;
+        for (unsigned row = 0; row < numRows; row++)
+        {
+            if (activeNode && batch.addTo(activeNode, row))
+                continue;
+
+            //A new leaf starts with this row.  If one of the leaves filled by the worker starts with the same row then
+            //the rest of the leaves for the batch match the serial build.
+            while ((nextNode < numNodes) && (batch.nodeStarts.item(nextNode) < row))
+                nextNode++;
+            if ((nextNode < numNodes) && (batch.nodeStarts.item(nextNode) == row))
+            {
+                for (; nextNode < numNodes; nextNode++)
+                    startLeafNode(LINK(&batch.nodes.item(nextNode)));
+                speculationMisses = 0;
+                rowsPerLeaf = std::max((unsigned)(committedRows / numLeaves), 1U);
+                return;
+            }
+
+            startLeafNode(indexCompressor->createNode(0, keyHdr, true));
+            if (!batch.addTo(activeNode, row))
+                throwRowTooLarge(keyHdr, batch.queryRowSize(row), batch.queryRowPos(row));
+        }
+
+        //The leaf boundaries never coincided, so all the leaves were filled by this thread.  If that keeps happening
+        //(e.g. every leaf holds the same number of rows) stop filling them speculatively.
+        if (batch.speculative && (++speculationMisses >= maxSpeculationMisses))
+            speculate = false;
+        if (numLeaves)
+            rowsPerLeaf = std::max((unsigned)(committedRows / numLeaves), 1U);
+    }
+
     void writeMetadata(char const * data, size32_t size)
     {
         assertex(keyHdr->getHdrStruct()->metadataHead == 0);
@@ -649,8 +968,10 @@ protected:
         size32_t size = filter.queryTableSize();
         if (!size)
             return;
-        auto prevBloom = keyHdr->getHdrStruct()->bloomHead;
-        keyHdr->getHdrStruct()->bloomHead = nextPos;
+        // Blocked filters are chained from a separate header field, so that older readers (which would misinterpret them) ignore them
+        __int64 &bloomHead = filter.isBlocked() ? keyHdr->getHdrStruct()->blockedBloomHead : keyHdr->getHdrStruct()->bloomHead;
+        auto prevBloom = bloomHead;
+        bloomHead = nextPos;
         Owned<CBloomFilterWriteNode> prevNode;
         Owned<CBloomFilterWriteNode> node(new CBloomFilterWriteNode(nextPos, keyHdr));
         // Table info is serialized into first page. Note that we assume that it fits (would need to have a crazy-small page size for that to not be true)
@@ -679,9 +1000,9 @@ protected:
     }
 };
 
-extern jhtree_decl IKeyBuilder *createKeyBuilder(IFileIOStream *_out, unsigned flags, unsigned rawSize, unsigned nodeSize, unsigned keyFieldSize, unsigned __int64 startSequence, IHThorIndexWriteArg *helper, const char * defaultCompression, bool enforceOrder, bool isTLK)
+extern jhtree_decl IKeyBuilder *createKeyBuilder(IFileIOStream *_out, unsigned flags, unsigned rawSize, unsigned nodeSize, unsigned keyFieldSize, unsigned __int64 startSequence, IHThorIndexWriteArg *helper, const char * defaultCompression, bool enforceOrder, bool isTLK, unsigned buildThreads)
 {
-    return new CKeyBuilder(_out, flags, rawSize, nodeSize, keyFieldSize, startSequence, helper, defaultCompression, enforceOrder, isTLK);
+    return new CKeyBuilder(_out, flags, rawSize, nodeSize, keyFieldSize, startSequence, helper, defaultCompression, enforceOrder, isTLK, buildThreads);
 }
 
 
@@ -108,7 +108,8 @@ interface IKeyBuilder : public IInterface
     virtual unsigned __int64 getLeafMemorySize() const = 0;
 };
 
-extern jhtree_decl IKeyBuilder *createKeyBuilder(IFileIOStream *_out, unsigned flags, unsigned rawSize, unsigned nodeSize, unsigned keyFieldSize, unsigned __int64 startSequence, IHThorIndexWriteArg *helper, const char * defaultCompression, bool enforceOrder, bool isTLK);
+// If buildThreads > 1 the leaf nodes are filled on multiple threads - the index is identical to one built serially
+extern jhtree_decl IKeyBuilder *createKeyBuilder(IFileIOStream *_out, unsigned flags, unsigned rawSize, unsigned nodeSize, unsigned keyFieldSize, unsigned __int64 startSequence, IHThorIndexWriteArg *helper, const char * defaultCompression, bool enforceOrder, bool isTLK, unsigned buildThreads = 0);
 
 interface IKeyDesprayer : public IInterface
 {
@@ -30,11 +30,15 @@ private:
     unsigned int m_timeout;
 
     ISocket* m_socket;
+    MemoryBuffer m_preRead;   // data already read from the socket, returned before anything else is read
+
+    void readMore(unsigned & readlen);
 
 public:
     IMPLEMENT_IINTERFACE;
 
     BufferedSocket(ISocket* socket);
+    BufferedSocket(ISocket* socket, MemoryBuffer & preRead);
 
     virtual int readline(char* buf, int maxlen, IMultiException *me)
     { return readline(buf, maxlen, false, me); }
@@ -62,6 +66,24 @@ BufferedSocket::BufferedSocket(ISocket* socket)
     m_curptr = 0;
 };
 
+BufferedSocket::BufferedSocket(ISocket* socket, MemoryBuffer & preRead) : BufferedSocket(socket)
+{
+    m_preRead.swapWith(preRead);
+}
+
+void BufferedSocket::readMore(unsigned & readlen)
+{
+    if(m_preRead.remaining() > 0)
+    {
+        readlen = m_preRead.remaining();
+        if(readlen > BSOCKET_BUFSIZE)
+            readlen = BSOCKET_BUFSIZE;
+        m_preRead.read(readlen, m_buf);
+    }
+    else
+        m_socket->read(m_buf, 0, BSOCKET_BUFSIZE, readlen, m_timeout);
+}
+
 //always make the size of buf at lease maxlen+1
 int BufferedSocket::readline(char* buf, int maxlen, bool keepcrlf, IMultiException *me)
 {
@@ -100,7 +122,7 @@ int BufferedSocket::readline(char* buf, int maxlen, bool keepcrlf, IMultiExcepti
                         m_curptr = 0;
                         m_endptr = 0;
                         unsigned readlen;
-                        m_socket->read(m_buf, 0, BSOCKET_BUFSIZE, readlen, m_timeout);
+                        readMore(readlen);
                         if(readlen > 0)
                         {
                             m_endptr = readlen;
@@ -136,7 +158,7 @@ int BufferedSocket::readline(char* buf, int maxlen, bool keepcrlf, IMultiExcepti
                 m_curptr = 0;
                 m_endptr = 0;
                 unsigned readlen;
-                m_socket->read(m_buf, 0, BSOCKET_BUFSIZE, readlen, m_timeout);
+                readMore(readlen);
                 if(readlen <= 0)
                     break;
                 m_endptr = readlen;
@@ -218,7 +240,7 @@ int BufferedSocket::read(char* buf, int maxlen)
             unsigned readlen;
             try
             {
-                m_socket->read(m_buf, 0, BSOCKET_BUFSIZE, readlen, m_timeout);
+                readMore(readlen);
             }
             catch (IException *e) 
             {
@@ -282,3 +304,8 @@ IBufferedSocket* createBufferedSocket(ISocket* socket)
 {
     return new BufferedSocket(socket);
 }
+
+IBufferedSocket* createBufferedSocket(ISocket* socket, MemoryBuffer & preRead)
+{
+    return new BufferedSocket(socket, preRead);
+}
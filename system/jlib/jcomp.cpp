@@ -40,8 +40,13 @@
 
 #include "jfile.hpp"
 #include "jdebug.hpp"
+#include "jmd5.hpp"
+#include "jutil.hpp"
 #include "jcomp.ipp"
 
+#include <algorithm>
+#include <vector>
+
 #define CC_EXTRA_OPTIONS        ""
 #ifdef GENERATE_LISTING
 #undef CC_EXTRA_OPTIONS
@@ -227,6 +232,8 @@ public:
     Semaphore          &finishedCompiling;
     StringBuffer       &batchOutText;
     bool                describeOnly;
+    StringAttr          sourceName;     // set if the object can be restored from, or added to, the object cache
+    StringAttr          objectName;
 };
 
 //===========================================================================
@@ -335,6 +342,235 @@ void extractErrorsFromCppLog(IArrayOf<IError> & errors, const char * cur, bool l
     } while (cur);
 }
 
+//===========================================================================
+
+static const char * const objectCacheExt = ".o";
+static const char * const objectCacheTimeExt = ".time";
+
+bool extractCompileFilenames(const char * cmdline, StringBuffer & source, StringBuffer & object)
+{
+    //The command line is of the form "compiler" "source" options -c ... -o "object" flags
+    if (!strstr(cmdline, " -c ") && !endsWith(cmdline, " -c"))
+        return false;
+
+    const char * start = strchr(cmdline, '"');
+    if (start)
+        start = strchr(start+1, '"');
+    if (start)
+        start = strchr(start+1, '"');
+    const char * end = start ? strchr(start+1, '"') : nullptr;
+    if (!end)
+        return false;
+    source.clear().append(end - (start+1), start+1);
+
+    const char * target = strstr(end, " -o \"");
+    if (!target)
+        return false;
+    target += 5;
+    end = strchr(target, '"');
+    if (!end)
+        return false;
+    object.clear().append(end - target, target);
+    return endsWith(object, objectCacheExt);
+}
+
+class CCompiledObjectCache : public CInterfaceOf<ICompiledObjectCache>
+{
+public:
+    CCompiledObjectCache(const char * _directory)
+    {
+        StringBuffer path(_directory);
+        addPathSepChar(path);
+        directory.set(path);
+        recursiveCreateDirectory(directory);
+    }
+
+    virtual bool restore(const char * cmdline, const char * source, const char * object, StringBuffer & key, unsigned __int64 & savedNs) override
+    {
+        key.clear();
+        savedNs = 0;
+        try
+        {
+            md5_state_t md5;
+            md5_init(&md5);
+
+            //The source and object names include the workunit name, so exclude them from the options that are hashed
+            StringBuffer options(cmdline);
+            options.replaceString(source, "<source>");
+            options.replaceString(object, "<object>");
+            appendHash(md5, options.str(), options.length());
+            appendCompilerIdentity(md5, cmdline);
+            if (!appendPreprocessedHash(md5, cmdline, object))
+                return false;
+
+            md5_byte_t digest[16];
+            md5_finish(&md5, digest);
+            for (unsigned i=0; i < sizeof(digest); i++)
+                key.appendhex(digest[i], true);
+
+            StringBuffer cachedName;
+            Owned<IFile> cached = createIFile(getCachedName(cachedName, key, objectCacheExt));
+            if (!cached->exists())
+                return false;
+
+            copyFile(object, cachedName);
+
+            //Update the modified time so that purge() removes the least recently used objects first
+            CDateTime now;
+            now.setNow();
+            cached->setTime(nullptr, &now, nullptr);
+
+            StringBuffer timeText;
+            if (checkFileExists(getCachedName(cachedName.clear(), key, objectCacheTimeExt)))
+                savedNs = strtoull(timeText.loadFile(cachedName).str(), nullptr, 10);
+            return true;
+        }
+        catch (IException * e)
+        {
+            //A problem with the cache should never cause a compile to fail - compile it normally instead
+            EXCLOG(e, "CCompiledObjectCache::restore");
+            e->Release();
+            key.clear();
+            return false;
+        }
+    }
+
+    virtual void add(const char * key, const char * object, unsigned __int64 compileNs) override
+    {
+        try
+        {
+            //Copy to a temporary name and then rename, so a concurrent restore() never sees a partial object
+            StringBuffer cachedName, tempName, timeName;
+            getCachedName(cachedName, key, objectCacheExt);
+            tempName.append(cachedName).append('.').append((unsigned)GetCurrentProcessId()).append('.').append((unsigned)GetCurrentThreadId()).append(".tmp");
+            getCachedName(timeName, key, objectCacheTimeExt);
+
+            VStringBuffer timeText("%" I64F "u", compileNs);
+            Owned<IFile> timeFile = createIFile(timeName);
+            Owned<IFileIO> timeIO = timeFile->open(IFOcreate);
+            timeIO->write(0, timeText.length(), timeText.str());
+            timeIO.clear();
+
+            copyFile(tempName, object);
+            renameFile(cachedName, tempName, true);
+        }
+        catch (IException * e)
+        {
+            EXCLOG(e, "CCompiledObjectCache::add");
+            e->Release();
+        }
+    }
+
+    virtual void purge(offset_t maxSize) override
+    {
+        struct CachedObject
+        {
+            StringAttr name;
+            offset_t size;
+            CDateTime modified;
+        };
+
+        std::vector<CachedObject> objects;
+        offset_t totalSize = 0;
+        VStringBuffer mask("*%s", objectCacheExt);
+        Owned<IDirectoryIterator> iter = createDirectoryIterator(directory, mask);
+        ForEach(*iter)
+        {
+            StringBuffer name;
+            CachedObject next;
+            next.name.set(iter->getName(name));
+            next.size = iter->getFileSize();
+            iter->getModifiedTime(next.modified);
+            totalSize += next.size;
+            objects.push_back(next);
+        }
+        if (totalSize <= maxSize)
+            return;
+
+        std::sort(objects.begin(), objects.end(), [](const CachedObject & l, const CachedObject & r) { return l.modified < r.modified; });
+        for (const CachedObject & cur : objects)
+        {
+            if (totalSize <= maxSize)
+                break;
+            StringBuffer path(directory);
+            path.append(cur.name);
+            removeFileTraceIfFail(path);
+            path.setLength(path.length() - strlen(objectCacheExt));
+            path.append(objectCacheTimeExt);
+            removeFileTraceIfFail(path);
+            totalSize -= cur.size;
+        }
+    }
+
+protected:
+    StringBuffer & getCachedName(StringBuffer & out, const char * key, const char * ext) const
+    {
+        return out.append(directory).append(key).append(ext);
+    }
+
+    static void appendHash(md5_state_t & md5, const char * data, size32_t len)
+    {
+        md5_append(&md5, (const md5_byte_t *)data, len);
+    }
+
+    //Generated code includes headers from the platform as well as the compiler, so include the build version
+    //and the size and timestamp of the compiler executable.
+    static void appendCompilerIdentity(md5_state_t & md5, const char * cmdline)
+    {
+        StringBuffer identity;
+        identity.append(hpccBuildInfo.buildVersion).append(':').append(hpccBuildInfo.buildTagTimestamp);
+        if (*cmdline == '"')
+        {
+            const char * end = strchr(cmdline+1, '"');
+            if (end)
+            {
+                StringBuffer compilerName(end - (cmdline+1), cmdline+1);
+                Owned<IFile> compiler = createIFile(compilerName);
+                bool isDir;
+                offset_t size;
+                CDateTime modified;
+                if (compiler->getInfo(isDir, size, modified))
+                {
+                    identity.append(':').append(size).append(':');
+                    modified.getString(identity);
+                }
+            }
+        }
+        appendHash(md5, identity.str(), identity.length());
+    }
+
+    //Hash the preprocessed source, so the key changes if any header that is included changes - wherever it was found.
+    //Line markers are suppressed, since they contain the names of the source and its header, which include the wuid.
+    static bool appendPreprocessedHash(md5_state_t & md5, const char * cmdline, const char * object)
+    {
+        StringBuffer command(cmdline);
+        VStringBuffer objectOption(" -o \"%s\"", object);
+        command.replaceString(objectOption, "");
+        command.append(" -E -P");
+
+        StringBuffer output, error;
+        unsigned retcode = runExternalCommand(output, error, command, nullptr);
+        if (retcode)
+        {
+            //Let the compile report the problem
+            DBGLOG("Failed to preprocess %s for the object cache (retcode %u)", object, retcode);
+            return false;
+        }
+        appendHash(md5, output.str(), output.length());
+        return true;
+    }
+
+protected:
+    StringAttr directory;
+};
+
+ICompiledObjectCache * createCompiledObjectCache(const char * directory)
+{
+    return new CCompiledObjectCache(directory);
+}
+
+//===========================================================================
+
 CppCompiler::CppCompiler(const char * _coreName, const char * _sourceDir, const char * _targetDir, unsigned _targetCompiler, bool _verbose, const char *_compileBatchOut)
 {
     coreName.set(_coreName);
@@ -627,6 +863,7 @@ bool CppCompiler::compileFile(IThreadPool * pool, const char * filename, const c
     
     StringBuffer expanded;
     expandRootDirectory(expanded, cmdline);
+
     StringBuffer logFile;
     logFile.append(filename).append(".log.tmp");
     logFiles.append(logFile);
@@ -635,11 +872,48 @@ bool CppCompiler::compileFile(IThreadPool * pool, const char * filename, const c
     if (verbose)
         DBGLOG("%s", expanded.str());
     parm.setown(new CCompilerThreadParam(expanded, finishedCompiling, logFile, batchOutText, reportOnly()));
+    if (objectCache && !reportOnly() && !precompileHeader)
+    {
+        //The cache is checked by the compile thread, since finding the key involves running the preprocessor
+        StringBuffer sourceName, objectName;
+        if (extractCompileFilenames(expanded, sourceName, objectName))
+        {
+            parm->sourceName.set(sourceName);
+            parm->objectName.set(objectName);
+        }
+    }
     pool->start(parm.get());
 
     return true;
 }
 
+bool CppCompiler::restoreCompiled(const char * cmdline, const char * sourceName, const char * objectName, StringBuffer & cacheKey)
+{
+    unsigned __int64 savedNs;
+    if (objectCache->restore(cmdline, sourceName, objectName, cacheKey, savedNs))
+    {
+        if (verbose)
+            DBGLOG("Using cached object for %s", sourceName);
+        numCacheHits++;
+        cacheSavedNs += savedNs;
+        return true;
+    }
+    numCacheMisses++;
+    return false;
+}
+
+void CppCompiler::noteCompiled(const char * cacheKey, const char * objectName, unsigned __int64 compileNs)
+{
+    objectCache->add(cacheKey, objectName, compileNs);
+}
+
+void CppCompiler::getObjectCacheStats(unsigned & hits, unsigned & misses, unsigned __int64 & savedNs) const
+{
+    hits = numCacheHits;
+    misses = numCacheMisses;
+    savedNs = cacheSavedNs;
+}
+
 void CppCompiler::extractErrors(IArrayOf<IError> & errors)
 {
     ForEachItemIn(i, exceptions)
@@ -994,6 +1268,14 @@ public:
         aborted = false;
         handle = 0;
         Owned<IException> error;
+        StringBuffer cacheKey;
+        if (params->sourceName && compiler->restoreCompiled(params->cmdline, params->sourceName, params->objectName, cacheKey))
+        {
+            params->finishedCompiling.signal();
+            return;
+        }
+
+        CCycleTimer compileTimer;
         try
         {
             if (params->describeOnly)
@@ -1018,6 +1300,8 @@ public:
 
         if (!success || aborted || runcode != 0)
             compiler->numFailed++;
+        else if (cacheKey.length())
+            compiler->noteCompiled(cacheKey, params->objectName, compileTimer.elapsedNs());
         params->finishedCompiling.signal();
         if (error)
             throw error.getClear();
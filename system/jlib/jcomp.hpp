@@ -45,6 +45,22 @@ extern jlib_decl void setCompilerPath(const char * path, const char *ipath, cons
 extern jlib_decl bool fileIsOlder(const char *dest, const char *src);
 extern jlib_decl void extractErrorsFromCppLog(IArrayOf<IError> & errors, const char * cur, bool linkFailed);
 
+//A local cache of object files, indexed by a hash of the preprocessed source (so including every header it includes),
+//the compiler and the options that were used to compile it.
+interface ICompiledObjectCache : public IInterface
+{
+public:
+    //If a matching object is cached it is copied to object, and savedNs is set to the time the original compile took.
+    //Otherwise key is set to the value that should be passed to add() once the object has been compiled.
+    virtual bool restore(const char * cmdline, const char * source, const char * object, StringBuffer & key, unsigned __int64 & savedNs) = 0;
+    virtual void add(const char * key, const char * object, unsigned __int64 compileNs) = 0;
+    virtual void purge(offset_t maxSize) = 0;   // Remove the least recently used objects until the cache is smaller than maxSize
+};
+
+extern jlib_decl ICompiledObjectCache * createCompiledObjectCache(const char * directory);
+//Extract the source and object filenames from a gcc/clang compile command line generated by ICppCompiler
+extern jlib_decl bool extractCompileFilenames(const char * cmdline, StringBuffer & source, StringBuffer & object);
+
 interface ICppCompiler : public IInterface
 {
 public:
@@ -70,6 +86,8 @@ public:
     virtual void setSaveTemps(bool _save) = 0;
     virtual void setPrecompileHeader(bool _pch) = 0;
     virtual void setAbortChecker(IAbortRequestCallback * abortChecker) = 0;
+    virtual void setObjectCache(ICompiledObjectCache * cache) = 0;
+    virtual void getObjectCacheStats(unsigned & hits, unsigned & misses, unsigned __int64 & savedNs) const = 0;
     virtual void removeTemporary(const char *fname) = 0;
     virtual void removeTempDir(const char *fname) = 0;
     virtual bool reportOnly() const = 0;
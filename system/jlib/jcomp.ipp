@@ -51,6 +51,8 @@ public:
     virtual void setSaveTemps(bool _save) { saveTemps = _save; }
     virtual void setPrecompileHeader(bool _pch);
     virtual void setAbortChecker(IAbortRequestCallback * _abortChecker) {abortChecker = _abortChecker;}
+    virtual void setObjectCache(ICompiledObjectCache * cache) { objectCache.set(cache); }
+    virtual void getObjectCacheStats(unsigned & hits, unsigned & misses, unsigned __int64 & savedNs) const;
     virtual bool fireException(IException *e);
     virtual void removeTempDir(const char *fname);
     virtual void removeTemporary(const char *fname);
@@ -67,6 +69,9 @@ protected:
     void writeLogFile(const char* filepath, StringBuffer& log) ;
 
 public:
+    bool restoreCompiled(const char * cmdline, const char * sourceName, const char * objectName, StringBuffer & cacheKey);
+    void noteCompiled(const char * cacheKey, const char * objectName, unsigned __int64 compileNs);
+
     std::atomic_uint numFailed;
 
 protected:
@@ -94,6 +99,10 @@ protected:
     bool            precompileHeader;
     bool            linkFailed;
     IAbortRequestCallback * abortChecker;
+    Linked<ICompiledObjectCache> objectCache;
+    std::atomic_uint numCacheHits{0};
+    std::atomic_uint numCacheMisses{0};
+    std::atomic<unsigned __int64> cacheSavedNs{0};
     CriticalSection cs;
     IArrayOf<IException> exceptions;
 };
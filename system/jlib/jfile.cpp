@@ -59,6 +59,7 @@
 #include "jmutex.hpp"
 #include "jfile.hpp"
 #include "jfile.ipp"
+#include "juring.hpp"
 
 #include <limits.h>
 #include "jexcept.hpp"
@@ -87,6 +88,9 @@
 #define DEFAULT_STREAM_BUFFER_SIZE 0x10000
 #endif
 
+// Number of blocks a sequential reader keeps queued when queued file io is enabled
+constexpr unsigned defaultQueuedReadAhead = 8;
+
 #ifdef _WIN32
 #define NULLFILE INVALID_HANDLE_VALUE
 #else
@@ -1822,7 +1826,11 @@ IFileIO * CFile::openShared(IFOmode mode,IFSHmode share,IFEflags extraFlags)
     if (stdh>=0)
         return new CSequentialFileIO(handle,mode,share,extraFlags);
 
-    Owned<IFileIO> io = new CFileIO(handle,mode,share,extraFlags);
+    Owned<IFileIO> io;
+    if (useQueuedFileIO() || (extraFlags & IFEdirect))
+        io.setown(createQueuedFileIO(handle,mode,share,extraFlags));
+    else
+        io.setown(new CFileIO(handle,mode,share,extraFlags));
 #ifdef CHECK_FILE_IO
     return new CCheckingFileIO(filename, io);
 #else
@@ -1832,6 +1840,22 @@ IFileIO * CFile::openShared(IFOmode mode,IFSHmode share,IFEflags extraFlags)
 
 
 
+IQueuedFileIO * CFile::openQueued(IFOmode mode, IFEflags extraFlags, IFileIOQueue * queue)
+{
+    HANDLE handle = openHandle(mode,(IFSHmode)(flags&(IFSHfull|IFSHread)),false);
+    if (handle==NULLFILE)
+        return NULL;
+    return createQueuedFileIO(handle,mode,(IFSHmode)(flags&(IFSHfull|IFSHread)),extraFlags,queue);
+}
+
+IQueuedFileIO * openQueuedFileIO(IFile * file, IFOmode mode, IFEflags extraFlags, IFileIOQueue * queue)
+{
+    CFile * localFile = QUERYINTERFACE(file, CFile);
+    if (!localFile)
+        return NULL;
+    return localFile->openQueued(mode, extraFlags, queue);
+}
+
 //---------------------------------------------------------------------------
 
 
@@ -6366,10 +6390,183 @@ public:
 };
 
 
+// Keeps a number of sequential blocks queued ahead of the reader, and copies them into the stream's buffer as they complete
+class CQueuedFileSerialStream: public CSerialStreamBase
+{
+    class CBlock : implements IFileIOCompletion
+    {
+    public:
+        virtual void onFileIOComplete(int _result) override
+        {
+            result = _result;
+            ready.signal();
+        }
+        void waitReady()
+        {
+            if (!complete)
+            {
+                ready.wait();
+                complete = true;
+            }
+        }
+    public:
+        Semaphore ready;
+        void * data = nullptr;
+        offset_t pos = 0;
+        size32_t consumed = 0;
+        int result = 0;
+        bool complete = false;
+        bool fromQueue = false;
+    };
+
+    Linked<IQueuedFileIO> fileio;
+    IFileIOQueue & queue;
+    std::vector<CBlock> blocks;
+    MemoryAttr blockMemory;
+    size32_t blockSize;
+    unsigned head = 0;          // the block the next read is satisfied from
+    unsigned numQueued = 0;
+    offset_t nextQueuePos = 0;
+    offset_t endPos;            // read-ahead does not go past this position
+    bool hitEof = false;
+
+    void queueAhead()
+    {
+        while (!hitEof && (numQueued < blocks.size()) && (nextQueuePos < endPos))
+        {
+            CBlock & block = blocks[(head + numQueued) % blocks.size()];
+            block.pos = nextQueuePos;
+            block.consumed = 0;
+            block.complete = false;
+            nextQueuePos += blockSize;
+            numQueued++;
+            fileio->queueRead(block.pos, blockSize, block.data, block);
+        }
+    }
+    void nextBlock()
+    {
+        numQueued--;
+        head = (head + 1) % blocks.size();
+    }
+    void discardQueued()
+    {
+        while (numQueued)
+        {
+            blocks[head].waitReady();
+            nextBlock();
+        }
+    }
+    size32_t readBlock(offset_t pos, size32_t max_size, void *ptr)
+    {
+        if (!numQueued || (blocks[head].pos + blocks[head].consumed != pos))
+        {
+            //The first read, or a seek - discard anything read ahead and start again from this position
+            discardQueued();
+            hitEof = false;
+            nextQueuePos = pos & ~(offset_t)(directIOAlignment - 1);
+            queueAhead();
+            if (!numQueued)
+                return 0;
+            blocks[head].consumed = (size32_t)(pos - blocks[head].pos);
+        }
+
+        CBlock & block = blocks[head];
+        block.waitReady();
+        if (block.result < 0)
+        {
+            int err = -block.result;
+            nextBlock();
+            discardQueued();
+            throw makeErrnoException(err, "CQueuedFileSerialStream::read");
+        }
+        if ((size32_t)block.result < blockSize)
+            hitEof = true;
+        size32_t available = ((size32_t)block.result > block.consumed) ? block.result - block.consumed : 0;
+        size32_t ret = std::min(available, max_size);
+        memcpy(ptr, (const byte *)block.data + block.consumed, ret);
+        block.consumed += ret;
+        if (ret && (block.consumed == (size32_t)block.result))
+        {
+            nextBlock();
+            queueAhead();
+        }
+        return ret;
+    }
+    virtual size32_t rawread(offset_t pos, size32_t max_size, void *ptr) override
+    {
+        //The caller expects the request to be satisfied unless the end of the file is reached
+        size32_t total = 0;
+        while (total < max_size)
+        {
+            size32_t got = readBlock(pos + total, max_size - total, (byte *)ptr + total);
+            if (!got)
+                break;
+            total += got;
+        }
+        return total;
+    }
+
+public:
+    CQueuedFileSerialStream(IQueuedFileIO *_fileio, offset_t _offset, offset_t _len, size32_t _bufsize, unsigned numAhead, IFileSerialStreamCallback *_tally)
+      : CSerialStreamBase(_offset, _len, _bufsize, _tally), fileio(_fileio), queue(_fileio->queryQueue()), blocks(numAhead ? numAhead : 1)
+    {
+        endPos = (_len == (offset_t)-1) ? (offset_t)-1 : _offset + _len;
+        //Use the queue's registered buffers unless the caller has asked for larger reads
+        size32_t queueBufferSize = queue.queryBufferSize();
+        blockSize = queueBufferSize;
+        if (!blockSize || ((_bufsize != (size32_t)-1) && (_bufsize > blockSize)))
+        {
+            size32_t minSize = (_bufsize == (size32_t)-1) ? DEFAULT_STREAM_BUFFER_SIZE : _bufsize;
+            blockSize = ((minSize + directIOAlignment - 1) / directIOAlignment) * directIOAlignment;
+        }
+
+        unsigned numAllocated = 0;
+        for (CBlock & block : blocks)
+        {
+            if (blockSize == queueBufferSize)
+                block.data = queue.allocateBuffer();
+            block.fromQueue = (block.data != nullptr);
+            if (!block.fromQueue)
+                numAllocated++;
+        }
+        if (numAllocated)
+        {
+            //Aligned so that the reads are also valid if the file was opened with IFEdirect
+            byte * next = (byte *)blockMemory.allocate((memsize_t)numAllocated * blockSize + directIOAlignment);
+            next += (directIOAlignment - ((memsize_t)next & (directIOAlignment - 1))) & (directIOAlignment - 1);
+            for (CBlock & block : blocks)
+            {
+                if (!block.fromQueue)
+                {
+                    block.data = next;
+                    next += blockSize;
+                }
+            }
+        }
+    }
+    ~CQueuedFileSerialStream()
+    {
+        discardQueued();
+        for (CBlock & block : blocks)
+        {
+            if (block.fromQueue)
+                queue.releaseBuffer(block.data);
+        }
+    }
+};
+
+ISerialStream *createQueuedFileSerialStream(IQueuedFileIO *fileio, offset_t ofs, offset_t flen, size32_t bufsize, unsigned numAhead, IFileSerialStreamCallback *callback)
+{
+    return new CQueuedFileSerialStream(fileio, ofs, flen, bufsize, numAhead, callback);
+}
+
 ISerialStream *createFileSerialStream(IFileIO *fileio,offset_t ofs, offset_t flen, size32_t bufsize,IFileSerialStreamCallback *callback)
 {
     if (!fileio)
         return NULL;
+    IQueuedFileIO * queuedIO = QUERYINTERFACE(fileio, IQueuedFileIO);
+    if (queuedIO && useQueuedFileIO())
+        return createQueuedFileSerialStream(queuedIO,ofs,flen,bufsize,defaultQueuedReadAhead,callback);
     return new CFileSerialStream(fileio,ofs,flen,bufsize,callback);
 }
 
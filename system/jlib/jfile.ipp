@@ -29,6 +29,9 @@
 #include <dirent.h>
 #endif
 
+interface IQueuedFileIO;
+interface IFileIOQueue;
+
 
 class jlib_decl CFile : implements IFile, public CInterface
 {
@@ -46,6 +49,7 @@ public:
     virtual IFileIO * open(IFOmode mode, IFEflags extraFlags=IFEnone);
     virtual IFileAsyncIO * openAsync(IFOmode mode);
     virtual IFileIO * openShared(IFOmode mode,IFSHmode shmode,IFEflags extraFlags=IFEnone);
+    IQueuedFileIO * openQueued(IFOmode mode, IFEflags extraFlags, IFileIOQueue * queue);
     virtual const char * queryFilename();
     virtual bool remove();
     virtual void rename(const char *newTail);
@@ -25,6 +25,7 @@
 #include "jencrypt.hpp"
 #include "jflz.hpp"
 #include "jlz4.hpp"
+#include "jzstd.hpp"
 
 #ifdef _WIN32
 #include <io.h>
@@ -1900,6 +1901,7 @@ static const __int64 COMPRESSEDFILEFLAG = I64C(0xc0528ce99f10da55);
 #define COMPRESSEDFILEBLOCKSIZE (0x10000)
 static const __int64 FASTCOMPRESSEDFILEFLAG = I64C(0xc1518de99f10da55);
 static const __int64 LZ4COMPRESSEDFILEFLAG = I64C(0xc1200e0b71321c73);
+static const __int64 ZSTDCOMPRESSEDFILEFLAG = I64C(0xc13a5d0f2b96e847);
 
 #pragma pack(push,1)
 
@@ -1919,6 +1921,8 @@ struct CompressedFileTrailer
             return COMPRESS_METHOD_FASTLZ;
         if (compressedType==LZ4COMPRESSEDFILEFLAG)
             return COMPRESS_METHOD_LZ4;
+        if (compressedType==ZSTDCOMPRESSEDFILEFLAG)
+            return COMPRESS_METHOD_ZSTD;
         if (compressedType==COMPRESSEDFILEFLAG)
         {
             if (recordSize)
@@ -2231,6 +2235,9 @@ public:
                         case COMPRESS_METHOD_LZ4HC:
                             compressor.setown(createLZ4Compressor(nullptr, true));
                             break;
+                        case COMPRESS_METHOD_ZSTD:
+                            compressor.setown(createZStdCompressor(nullptr));
+                            break;
                         default:
                             compMethod = COMPRESS_METHOD_LZW;
                             trailer.compressedType = COMPRESSEDFILEFLAG;
@@ -2272,6 +2279,8 @@ public:
                         expander.setown(createFastLZExpander());
                     else if (compMethod == COMPRESS_METHOD_LZ4)
                         expander.setown(createLZ4Expander());
+                    else if (compMethod == COMPRESS_METHOD_ZSTD)
+                        expander.setown(createZStdExpander());
                     else // fallback
                     {
                         compMethod = COMPRESS_METHOD_LZW;
@@ -2458,6 +2467,8 @@ static unsigned getCompressedMethod(__int64 compressedType)
         return COMPRESS_METHOD_FASTLZ;
     else if (compressedType == LZ4COMPRESSEDFILEFLAG)
         return COMPRESS_METHOD_LZ4;
+    else if (compressedType == ZSTDCOMPRESSEDFILEFLAG)
+        return COMPRESS_METHOD_ZSTD;
     return 0;
 }
 
@@ -2596,6 +2607,12 @@ ICompressedFileIO *createCompressedFileWriter(IFileIO *fileio, bool append, size
             trailer.blockSize = LZ4COMPRESSEDFILEBLOCKSIZE;
             trailer.recordSize = 0;
         }
+        else if (_compMethod == COMPRESS_METHOD_ZSTD)
+        {
+            trailer.compressedType = ZSTDCOMPRESSEDFILEFLAG;
+            trailer.blockSize = ZSTDCOMPRESSEDFILEBLOCKSIZE;
+            trailer.recordSize = 0;
+        }
         else // fallback
         {
             trailer.compressedType = COMPRESSEDFILEFLAG;
@@ -2936,6 +2953,13 @@ MODULE_INIT(INIT_PRIORITY_STANDARD)
         virtual ICompressor *getCompressor(const char *options) { return createLZ4Compressor(options, true); }
         virtual IExpander *getExpander(const char *options) { return createLZ4Expander(); }
     };
+    class CZStdCompressHandler : public CCompressHandlerBase
+    {
+    public:
+        CZStdCompressHandler() : CCompressHandlerBase("ZSTD") { }
+        virtual ICompressor *getCompressor(const char *options) { return createZStdCompressor(options); }
+        virtual IExpander *getExpander(const char *options) { return createZStdExpander(); }
+    };
     class CAESCompressHandler : public CCompressHandlerBase
     {
     public:
@@ -2986,6 +3010,7 @@ MODULE_INIT(INIT_PRIORITY_STANDARD)
     addCompressorHandler(new CRandRDiffCompressHandler());
     addCompressorHandler(new CFLZCompressHandler());
     addCompressorHandler(new CLZ4HCCompressHandler());    
+    addCompressorHandler(new CZStdCompressHandler());
     ICompressHandler *lz4Compressor = new CLZ4CompressHandler();
     defaultCompressor.set(lz4Compressor);
     addCompressorHandler(lz4Compressor);
@@ -3053,6 +3078,8 @@ CompressionMethod translateToCompMethod(const char *compStr, CompressionMethod d
             compMethod = COMPRESS_METHOD_LZ4HC;
         else if (strieq("LZ4", compStr))
             compMethod = COMPRESS_METHOD_LZ4;
+        else if (strieq("ZSTD", compStr))
+            compMethod = COMPRESS_METHOD_ZSTD;
         //else // default is LZ4
     }
     return compMethod;
@@ -3076,6 +3103,8 @@ const char *translateFromCompMethod(unsigned compMethod)
             return "LZ4HC";
         case COMPRESS_METHOD_LZMA:
             return "LZMA";
+        case COMPRESS_METHOD_ZSTD:
+            return "ZSTD";
         default:
             return ""; // none
     }
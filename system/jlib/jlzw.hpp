@@ -35,6 +35,7 @@ enum CompressionMethod
     COMPRESS_METHOD_LZ4,
     COMPRESS_METHOD_LZ4HC,
     COMPRESS_METHOD_RANDROW,
+    COMPRESS_METHOD_ZSTD,
 
 
     COMPRESS_METHOD_AES = 0x80,
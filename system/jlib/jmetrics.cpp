@@ -14,6 +14,7 @@
 #include "jmetrics.hpp"
 #include "jlog.hpp"
 #include <regex>
+#include <math.h>
 
 using namespace hpccMetrics;
 
@@ -110,6 +111,108 @@ std::vector<__uint64> ScaledHistogramMetric::queryHistogramBucketLimits() const
 }
 
 
+LogLinearHistogramMetric::LogLinearHistogramMetric(const char *_name, const char *_desc, StatisticMeasure _units, const std::vector<__uint64> &_bucketLimits, double _limitsToMeasurementUnitsScaleFactor, const MetricMetaData &_metaData) :
+    MetricBase(_name, _desc, MetricType::METRICS_HISTOGRAM, _units, _metaData), bucketLimits{_bucketLimits}
+{
+    scaledBucketLimits.reserve(bucketLimits.size());
+    for (auto &limit: bucketLimits)
+    {
+        scaledBucketLimits.emplace_back((__uint64)((double)limit * _limitsToMeasurementUnitsScaleFactor));
+    }
+    outputScaleFactor = 1.0 / _limitsToMeasurementUnitsScaleFactor;
+}
+
+
+__uint64 LogLinearHistogramMetric::getBucketLowerBound(unsigned bucket)
+{
+    if (bucket < numSubBuckets)
+        return bucket;
+    unsigned shift = (bucket >> subBucketBits) - 1;
+    __uint64 mantissa = (bucket & (numSubBuckets - 1)) + numSubBuckets;
+    return mantissa << shift;
+}
+
+
+__uint64 LogLinearHistogramMetric::getBucketUpperBound(unsigned bucket)
+{
+    if (bucket < numSubBuckets)
+        return bucket;
+    unsigned shift = (bucket >> subBucketBits) - 1;
+    return getBucketLowerBound(bucket) + ((((__uint64)1) << shift) - 1);
+}
+
+
+void LogLinearHistogramMetric::gatherCounts(std::vector<__uint64> &counts) const
+{
+    counts.assign(numBuckets, 0);
+    for (auto const &shard: shards)
+    {
+        for (unsigned i=0; i < numBuckets; i++)
+            counts[i] += shard.counts[i].load();
+    }
+}
+
+
+__uint64 LogLinearHistogramMetric::queryValue() const
+{
+    __uint64 sum = 0;
+    for (auto const &shard: shards)
+        sum += shard.sum.load();
+    return (__uint64)((double)sum * outputScaleFactor);
+}
+
+
+std::vector<__uint64> LogLinearHistogramMetric::queryHistogramValues() const
+{
+    std::vector<__uint64> counts;
+    gatherCounts(counts);
+
+    //Each internal bucket is assigned to the first reported bucket whose limit is >= the bucket's lower bound.
+    //The last entry is the inf bucket
+    std::vector<__uint64> histogramValues(scaledBucketLimits.size()+1, 0);
+    unsigned limitIndex = 0;
+    for (unsigned i=0; i < numBuckets; i++)
+    {
+        if (!counts[i])
+            continue;
+        __uint64 lowerBound = getBucketLowerBound(i);
+        while ((limitIndex < scaledBucketLimits.size()) && (lowerBound > scaledBucketLimits[limitIndex]))
+            limitIndex++;
+        histogramValues[limitIndex] += counts[i];
+    }
+    return histogramValues;
+}
+
+
+std::vector<MetricPercentile> LogLinearHistogramMetric::queryHistogramPercentiles() const
+{
+    std::vector<__uint64> counts;
+    gatherCounts(counts);
+    __uint64 total = 0;
+    for (auto count: counts)
+        total += count;
+
+    std::vector<MetricPercentile> result;
+    result.reserve(percentiles.size());
+    unsigned bucket = 0;
+    __uint64 cumulative = 0;
+    for (auto percentile: percentiles)
+    {
+        //Report the upper bound of the bucket containing the percentile, so it is never an underestimate
+        __uint64 target = (__uint64)ceil((double)total * percentile / 100.0);
+        if (target == 0)
+            target = 1;
+        while ((bucket < numBuckets) && (cumulative + counts[bucket] < target))
+            cumulative += counts[bucket++];
+        __uint64 value = 0;
+        if (total && (bucket < numBuckets))
+            value = (__uint64)((double)getBucketUpperBound(bucket) * outputScaleFactor);
+        result.emplace_back(percentile, value);
+    }
+    return result;
+}
+
+
 MetricsManager &hpccMetrics::queryMetricsManager()
 {
     return *metricsManager.query([] { return new MetricsManager; });
@@ -486,3 +589,20 @@ std::shared_ptr<ScaledHistogramMetric> hpccMetrics::registerCyclesToNsScaledHist
     queryMetricsManager().addMetric(pMetric);
     return pMetric;
 }
+
+
+std::shared_ptr<LogLinearHistogramMetric> hpccMetrics::registerLogLinearHistogramMetric(const char *name, const char* desc, StatisticMeasure units, const std::vector<__uint64> &bucketLimits, const MetricMetaData &metaData)
+{
+    std::shared_ptr<LogLinearHistogramMetric> pMetric = std::shared_ptr<LogLinearHistogramMetric>(new LogLinearHistogramMetric(name, desc, units, bucketLimits, 1.0, metaData));
+    queryMetricsManager().addMetric(pMetric);
+    return pMetric;
+}
+
+
+std::shared_ptr<LogLinearHistogramMetric> hpccMetrics::registerCyclesToNsLogLinearHistogramMetric(const char *name, const char* desc, const std::vector<__uint64> &bucketLimits, const MetricMetaData &metaData)
+{
+    double nsToCyclesScaleFactor = 1.0 / getCycleToNanoScale();
+    std::shared_ptr<LogLinearHistogramMetric> pMetric = std::shared_ptr<LogLinearHistogramMetric>(new LogLinearHistogramMetric(name, desc, SMeasureTimeNs, bucketLimits, nsToCyclesScaleFactor, metaData));
+    queryMetricsManager().addMetric(pMetric);
+    return pMetric;
+}
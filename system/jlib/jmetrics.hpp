@@ -60,6 +60,15 @@ struct MetricMetaDataItem
 
 typedef std::vector<MetricMetaDataItem> MetricMetaData;
 
+
+struct MetricPercentile
+{
+    MetricPercentile(double _percentile, __uint64 _value)
+        : percentile{_percentile}, value{_value} {}
+    double percentile;
+    __uint64 value;
+};
+
 /*
  * IMetric
  *
@@ -108,6 +117,11 @@ interface IMetric
      * Query histogram bucket limits
      */
     virtual std::vector<__uint64> queryHistogramBucketLimits() const = 0;
+
+    /*
+     * Query histogram percentiles (empty if the histogram cannot calculate them)
+     */
+    virtual std::vector<MetricPercentile> queryHistogramPercentiles() const = 0;
 };
 
 
@@ -126,6 +140,7 @@ public:
     StatisticMeasure queryUnits() const override { return units; }
     virtual std::vector<__uint64> queryHistogramValues() const override { return {}; }
     virtual std::vector<__uint64> queryHistogramBucketLimits() const override { return {}; }
+    virtual std::vector<MetricPercentile> queryHistogramPercentiles() const override { return {}; }
 
 
 protected:
@@ -303,6 +318,79 @@ protected:
 };
 
 
+/*
+ * Histogram that is cheap enough to use on hot paths.  Measurements are added with relaxed atomics to one of a
+ * fixed number of shards (chosen per thread), using log-linear (HDR style) buckets so the bucket is calculated rather
+ * than searched for, and no lock is taken.  The shards are only merged when the values are collected by a sink.
+ * Values are reported against the supplied bucket limits (to the resolution of the internal buckets - within
+ * 1/(2^subBucketBits) of the value), together with percentiles calculated from the internal buckets.
+ */
+class jlib_decl LogLinearHistogramMetric : public MetricBase
+{
+public:
+    static constexpr unsigned subBucketBits = 3;
+    static constexpr unsigned numSubBuckets = 1U << subBucketBits;
+    static constexpr unsigned numBuckets = (65 - subBucketBits) << subBucketBits;
+    static constexpr unsigned numShards = 8;
+
+    LogLinearHistogramMetric(const char *_name, const char *_desc, StatisticMeasure _units, const std::vector<__uint64> &_bucketLimits, double _limitsToMeasurementUnitsScaleFactor = 1.0, const MetricMetaData &_metaData = MetricMetaData());
+
+    inline void recordMeasurement(__uint64 measurement)
+    {
+        Shard &shard = shards[queryThreadShard()];
+        shard.counts[getBucketIndex(measurement)]++;
+        shard.sum.fetch_add(measurement);
+    }
+
+    virtual __uint64 queryValue() const override;
+    virtual std::vector<__uint64> queryHistogramValues() const override;
+    virtual std::vector<__uint64> queryHistogramBucketLimits() const override { return bucketLimits; }
+    virtual std::vector<MetricPercentile> queryHistogramPercentiles() const override;
+
+    static inline unsigned getBucketIndex(__uint64 measurement)
+    {
+        if (measurement < numSubBuckets)
+            return (unsigned)measurement;
+#if defined(__GNUC__)
+        unsigned msb = 63 - __builtin_clzll(measurement);
+#elif defined (_WIN32)
+        unsigned long msb;
+        _BitScanReverse64(&msb, measurement);
+#else
+        unsigned msb = 63;
+        while (!(measurement & ((__uint64)1 << msb)))
+            msb--;
+#endif
+        unsigned shift = (unsigned)msb - subBucketBits;
+        return ((shift + 1) << subBucketBits) + (unsigned)(measurement >> shift) - numSubBuckets;
+    }
+    static __uint64 getBucketLowerBound(unsigned bucket);
+    static __uint64 getBucketUpperBound(unsigned bucket);
+
+protected:
+    struct Shard
+    {
+        RelaxedAtomic<__uint64> counts[numBuckets] = {};
+        RelaxedAtomic<__uint64> sum{0};
+    };
+
+    static inline unsigned queryThreadShard()
+    {
+        static std::atomic<unsigned> nextShard{0};
+        static thread_local unsigned shard = nextShard.fetch_add(1, std::memory_order_relaxed) % numShards;
+        return shard;
+    }
+    void gatherCounts(std::vector<__uint64> &counts) const;
+
+protected:
+    std::vector<__uint64> bucketLimits;         // in reported units
+    std::vector<__uint64> scaledBucketLimits;   // in measurement units
+    std::vector<double> percentiles{50.0, 90.0, 99.0, 99.9};
+    double outputScaleFactor;
+    Shard shards[numShards];
+};
+
+
 class jlib_decl MetricSink
 {
 public:
@@ -395,6 +483,9 @@ jlib_decl std::shared_ptr<ScaledHistogramMetric> registerScaledHistogramMetric(c
 
 jlib_decl std::shared_ptr<ScaledHistogramMetric> registerCyclesToNsScaledHistogramMetric(const char *name, const char* desc, const std::vector<__uint64> &bucketLimits, const MetricMetaData &metaData = MetricMetaData());
 
+jlib_decl std::shared_ptr<LogLinearHistogramMetric> registerLogLinearHistogramMetric(const char *name, const char* desc, StatisticMeasure units, const std::vector<__uint64> &bucketLimits, const MetricMetaData &metaData = MetricMetaData());
+jlib_decl std::shared_ptr<LogLinearHistogramMetric> registerCyclesToNsLogLinearHistogramMetric(const char *name, const char* desc, const std::vector<__uint64> &bucketLimits, const MetricMetaData &metaData = MetricMetaData());
+
 //
 // Convenience function templates to create metrics and add to the manager
 template <typename T>
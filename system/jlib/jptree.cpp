@@ -35,6 +35,10 @@
 #include "yaml.h"
 
 #include <initializer_list>
+#if defined(__SSE2__) && defined(__GNUC__)
+#include <emmintrin.h>
+#define PTREE_SIMD_SCAN
+#endif
 
 #define MAKE_LSTRING(name,src,length) \
     const char *name = (const char *) alloca((length)+1); \
@@ -3292,7 +3296,7 @@ inline bool match(bool wild, bool numeric, const char *xpath, exprType t, const
     throw MakeXPathException(xpath, PTreeExcpt_XPath_ParseError, 0, "Invalid xpath qualifier expression in xpath: %s", xpath);
 }
 
-bool PTree::checkPattern(const char *&xxpath) const
+static bool checkPTreePattern(const IPropertyTree &tree, bool nocase, const char *&xxpath)
 {
     // Pattern is an additional filter at the current node level
     // It can be [condition], or it can be empty (we don't support anything else)
@@ -3304,7 +3308,7 @@ bool PTree::checkPattern(const char *&xxpath) const
     const char *xpath = xxpath;
     while (*xpath == ' ' || *xpath == '\t') xpath++;
     const char *start = xpath;
-    bool wild = false, nocase = isnocase();
+    bool wild = false;
     if (*xpath=='@')
         xpath++;
     char quote = 0;
@@ -3471,7 +3475,7 @@ bool PTree::checkPattern(const char *&xxpath) const
 
     const char *tProp = splitXPathX(lhs);
     MAKE_LSTRING(head, lhs, tProp-lhs);
-    Owned<IPropertyTreeIterator> iter = getElements(head);
+    Owned<IPropertyTreeIterator> iter = tree.getElements(head);
     ForEach (*iter)
     {
         IPropertyTree &found = iter->query();
@@ -3562,6 +3566,11 @@ bool PTree::checkPattern(const char *&xxpath) const
     return ret;
 }
 
+bool PTree::checkPattern(const char *&xxpath) const
+{
+    return checkPTreePattern(*this, isnocase(), xxpath);
+}
+
 AttrValue *PTree::findAttribute(const char *key) const
 {
     if (attrs)
@@ -4163,7 +4172,7 @@ public:
 
 ///////////////////
 
-PTStackIterator::PTStackIterator(IPropertyTreeIterator *_iter, const char *_xpath) : rootIter(_iter), xpath(_xpath)
+PTStackIterator::PTStackIterator(IPropertyTreeIterator *_iter, const char *_xpath, bool _ptreeElements) : rootIter(_iter), xpath(_xpath), ptreeElements(_ptreeElements)
 {
     iter = NULL;
     xxpath = "";
@@ -4284,7 +4293,7 @@ bool PTStackIterator::next()
                         qualifierText.clear().append(s, start);
 
                         bool mapped = false;
-                        if (!wild && !numeric)
+                        if (!wild && !numeric && ptreeElements)
                         {
                             ChildMap *children = ((PTree *)element)->checkChildren();
                             if (children)
@@ -4364,6 +4373,940 @@ IPropertyTreeIterator *PTStackIterator::popFromStack(StringAttr &path)
     return stack[--stacklen].get(path);
 }
 
+///////////////////
+// Frozen property trees
+//
+// A frozen tree is an immutable copy of a property tree, held in a single allocation.  The nodes are laid out
+// breadth first so the children of each node are contiguous.  A parallel array holds each node's children in
+// name order, and each node has a sorted list of the distinct names of its children, so that a child is found
+// with a binary search of the names rather than a per-node hash table.  Element
+// and attribute names are interned in the same atom tables as CAtomPTree, and values are pooled (and shared
+// between identical values) at the end of the block.  Nothing is created or cached on read, so a frozen tree
+// can be read concurrently without locking.
+
+class CFrozenPTree;
+
+struct FrozenAttr
+{
+    const char *name;
+    const char *value;
+    bool encoded;
+};
+
+struct FrozenNameGroup
+{
+    const char *name;
+    unsigned first;     // position of the first child with this name in the node's name ordered children
+    unsigned count;
+};
+
+class CFrozenPTreeArena : public CSimpleInterface
+{
+public:
+    CFrozenPTreeArena(bool _nocase) : nocase(_nocase) { }
+    ~CFrozenPTreeArena()
+    {
+        // NB: the nodes have no members that need destroying, so the block is just freed
+        free(block);
+        AtomRefTable *kT = nocase ? keyTableNC : keyTable;
+        for (HashKeyElement *name : names)
+            kT->releaseKey(name);
+        CriticalBlock b(hashcrit);
+        for (AttrStr *attrName : attrNames)
+            attrHT->removekey(attrName, nocase);
+    }
+    inline CFrozenPTree *queryNode(unsigned idx) const;
+    inline const unsigned *queryOrder(unsigned idx) const { return order + idx; }
+    inline const FrozenAttr *queryAttr(unsigned idx) const { return attrs + idx; }
+    inline const FrozenNameGroup *queryGroup(unsigned idx) const { return groups + idx; }
+    inline bool isnocase() const { return nocase; }
+    inline memsize_t querySize() const { return sizeof(*this) + blockSize; }
+
+    int compareNames(const char *l, const char *r) const
+    {
+        // Case insensitive first, so that iterating in name order matches the order of a sorted iterator
+        int c = stricmp(l, r);
+        if (c || nocase)
+            return c;
+        return strcmp(l, r);
+    }
+    int compareName(const char *name, const char *id, size32_t idLen) const
+    {
+        // As compareNames(name, id), where id is not null terminated
+        int c = strnicmp(name, id, idLen);
+        if (c)
+            return c;
+        if (name[idLen])
+            return 1;
+        if (nocase)
+            return 0;
+        return strncmp(name, id, idLen);
+    }
+
+private:
+    friend class CFrozenPTreeBuilder;
+
+    void *block = nullptr;
+    memsize_t blockSize = 0;
+    CFrozenPTree *nodes = nullptr;
+    FrozenAttr *attrs = nullptr;
+    FrozenNameGroup *groups = nullptr;
+    unsigned *order = nullptr;          // parallel to nodes, the children of each node in name order
+    std::vector<HashKeyElement *> names;
+    std::vector<AttrStr *> attrNames;
+    bool nocase;
+};
+
+class CFrozenPTreeIterator final : public CSimpleInterfaceOf<IPropertyTreeIterator>
+{
+public:
+    CFrozenPTreeIterator(const CFrozenPTreeArena *_arena, const CFrozenPTree *_elems, const unsigned *_order, unsigned _num, const char *_wild=nullptr)
+        : arena(_arena), elems(_elems), order(_order), num(_num), cur(_num), wild(_wild)
+    {
+    }
+
+// IPropertyTreeIterator
+    virtual bool first() override
+    {
+        cur = 0;
+        return matchNext();
+    }
+    virtual bool next() override
+    {
+        if (cur < num)
+            cur++;
+        return matchNext();
+    }
+    virtual bool isValid() override { return cur < num; }
+    virtual IPropertyTree & query() override;
+
+private:
+    bool matchNext();
+
+    Linked<const CFrozenPTreeArena> arena;
+    const CFrozenPTree *elems;
+    const unsigned *order;
+    unsigned num, cur;
+    StringAttr wild;
+};
+
+class CFrozenPTree final : public IPropertyTree
+{
+    friend class CFrozenPTreeBuilder;
+    friend class CFrozenPTreeIterator;
+public:
+    CFrozenPTree(CFrozenPTreeArena *_arena, const char *_name, const char *_value, size32_t _valueLen, unsigned _firstChild, unsigned _numChildren,
+                 unsigned _firstGroup, unsigned _numGroups, unsigned _firstAttr, unsigned short _numAttrs, byte _flags)
+        : arena(_arena), name(_name), value(_value), valueLen(_valueLen), firstChild(_firstChild), childCount(_numChildren),
+          firstGroup(_firstGroup), numGroups(_numGroups), firstAttr(_firstAttr), numAttrs(_numAttrs), flags(_flags)
+    {
+    }
+
+    enum : byte { fpt_binary=0x01, fpt_arrayItem=0x02, fpt_nameEncoded=0x04 };
+
+    inline const CFrozenPTreeArena *queryArena() const { return arena; }
+    virtual bool isNameEncoded() const override { return (flags & fpt_nameEncoded) != 0; }
+    virtual bool isAttributeNameEncoded(const char *key) const override
+    {
+        const FrozenAttr *attr = findAttribute(key);
+        return attr && attr->encoded;
+    }
+
+// IInterface - all nodes share the lifetime of the arena
+    virtual void Link() const override { arena->Link(); }
+    virtual bool Release() const override { return arena->Release(); }
+
+// IPropertyTree read impl.
+    virtual bool hasProp(const char *xpath) const override
+    {
+        const char *prop = splitXPathX(xpath);
+        if (!isAttribute(prop))
+            return nullptr != queryFirst(xpath);
+        if (prop == xpath)
+            return nullptr != findAttribute(prop);
+        // Any of the matching elements may have the attribute
+        MAKE_LSTRING(path, xpath, prop-xpath);
+        Owned<IPropertyTreeIterator> iter = getElements(path);
+        ForEach(*iter)
+        {
+            if (iter->query().hasProp(prop))
+                return true;
+        }
+        return false;
+    }
+    virtual bool isBinary(const char *xpath=NULL) const override
+    {
+        const char *prop;
+        const CFrozenPTree *node = queryProperty(xpath, prop);
+        return node && !prop && (node->flags & fpt_binary);
+    }
+    virtual bool isCompressed(const char *xpath=NULL) const override { return false; }
+    virtual bool getProp(const char *xpath, StringBuffer &ret) const override
+    {
+        const char *prop;
+        const CFrozenPTree *node = queryProperty(xpath, prop);
+        if (!node)
+            return false;
+        if (prop)
+        {
+            const FrozenAttr *attr = node->findAttribute(prop);
+            if (!attr)
+                return false;
+            ret.append(attr->value);
+        }
+        else if (node->value)
+            ret.append(node->valueLen, node->value);
+        else
+            return false;
+        return true;
+    }
+    virtual const char *queryProp(const char *xpath) const override
+    {
+        const char *prop;
+        const CFrozenPTree *node = queryProperty(xpath, prop);
+        return node ? node->queryLocal(prop) : nullptr;
+    }
+    virtual bool getPropBool(const char *xpath, bool dft=false) const override
+    {
+        const char *val = queryProp(xpath);
+        if (val && *val)
+            return strToBool(val);
+        return dft;
+    }
+    virtual int getPropInt(const char *xpath, int dft=0) const override
+    {
+        return (int) getPropInt64(xpath, dft);
+    }
+    virtual __int64 getPropInt64(const char *xpath, __int64 dft=0) const override
+    {
+        const char *val = queryProp(xpath);
+        if (!val || !*val)
+            return dft;
+        return _atoi64(val);
+    }
+    virtual double getPropReal(const char *xpath, double dft=0.0) const override
+    {
+        const char *val = queryProp(xpath);
+        return val ? atof(val) : dft;
+    }
+    virtual bool getPropBin(const char *xpath, MemoryBuffer &ret) const override
+    {
+        CHECK_ATTRIBUTE(xpath);
+        const char *prop;
+        const CFrozenPTree *node = queryProperty(xpath, prop);
+        if (!node)
+            return false;
+        CHECK_ATTRIBUTE(prop);
+        ret.append(node->valueLen, node->value);
+        return true;
+    }
+    virtual IPropertyTree *getPropTree(const char *xpath) const override { return LINK(queryPropTree(xpath)); }
+    virtual IPropertyTree *queryPropTree(const char *xpath) const override { return const_cast<CFrozenPTree *>(queryFirst(xpath)); }
+    virtual IPropertyTree *getBranch(const char *xpath) const override { return LINK(queryBranch(xpath)); }
+    virtual IPropertyTree *queryBranch(const char *xpath) const override { return queryPropTree(xpath); }
+    virtual aindex_t queryChildIndex(IPropertyTree *child) override
+    {
+        const char *id = child ? child->queryName() : nullptr;
+        const FrozenNameGroup *group = id ? findGroup(id, strlen(id)) : nullptr;
+        if (!group)
+            return NotFound;
+        const unsigned *order = arena->queryOrder(firstChild) + group->first;
+        for (unsigned i=0; i < group->count; i++)
+        {
+            if (queryChild(order[i]) == child)
+                return i;
+        }
+        return NotFound;
+    }
+    virtual StringBuffer &getName(StringBuffer &ret) const override { return ret.append(name); }
+    virtual const char *queryName() const override { return name; }
+    virtual IPropertyTreeIterator *getElements(const char *xpath, IPTIteratorCodes flags = iptiter_null) const override;
+    virtual IAttributeIterator *getAttributes(bool sorted=false) const override;
+    virtual bool hasChildren() const override { return childCount != 0; }
+    virtual unsigned numUniq() const override { return numGroups; }
+    virtual unsigned numChildren() const override { return childCount; }
+    virtual bool isCaseInsensitive() const override { return arena->isnocase(); }
+    virtual bool IsShared() const override { return arena->IsShared(); }
+    virtual void localizeElements(const char *xpath, bool allTail=false) override { }
+    virtual unsigned getCount(const char *xpath) const override
+    {
+        unsigned count = 0;
+        Owned<IPropertyTreeIterator> iter = getElements(xpath);
+        ForEach(*iter)
+            ++count;
+        return count;
+    }
+    virtual bool isArray(const char *xpath=NULL) const override
+    {
+        if (isEmptyString(xpath))
+            return (flags & fpt_arrayItem) != 0;
+        if (isAttribute(xpath))
+            return false;
+        const CFrozenPTree *node = queryFirst(xpath);
+        return node && node->isArray(nullptr);
+    }
+    virtual unsigned getAttributeCount() const override { return numAttrs; }
+
+// IPropertyTree write impl. - all unsupported
+    virtual bool renameProp(const char *xpath, const char *newName) override { throwReadOnly("renameProp"); }
+    virtual bool renameTree(IPropertyTree *tree, const char *newName) override { throwReadOnly("renameTree"); }
+    virtual void setProp(const char *xpath, const char *val) override { throwReadOnly("setProp"); }
+    virtual void addProp(const char *xpath, const char *val) override { throwReadOnly("addProp"); }
+    virtual void appendProp(const char *xpath, const char *val) override { throwReadOnly("appendProp"); }
+    virtual void setPropBool(const char *xpath, bool val) override { throwReadOnly("setPropBool"); }
+    virtual void addPropBool(const char *xpath, bool val) override { throwReadOnly("addPropBool"); }
+    virtual void setPropInt(const char *xpath, int val) override { throwReadOnly("setPropInt"); }
+    virtual void addPropInt(const char *xpath, int val) override { throwReadOnly("addPropInt"); }
+    virtual void setPropInt64(const char *xpath, __int64 val) override { throwReadOnly("setPropInt64"); }
+    virtual void addPropInt64(const char *xpath, __int64 val) override { throwReadOnly("addPropInt64"); }
+    virtual void setPropReal(const char *xpath, double val) override { throwReadOnly("setPropReal"); }
+    virtual void addPropReal(const char *xpath, double val) override { throwReadOnly("addPropReal"); }
+    virtual void setPropBin(const char *xpath, size32_t size, const void *data) override { throwReadOnly("setPropBin"); }
+    virtual void addPropBin(const char *xpath, size32_t size, const void *data) override { throwReadOnly("addPropBin"); }
+    virtual void appendPropBin(const char *xpath, size32_t size, const void *data) override { throwReadOnly("appendPropBin"); }
+    virtual IPropertyTree *setPropTree(const char *xpath, IPropertyTree *val) override { ::Release(val); throwReadOnly("setPropTree"); }
+    virtual IPropertyTree *addPropTree(const char *xpath, IPropertyTree *val) override { ::Release(val); throwReadOnly("addPropTree"); }
+    virtual IPropertyTree *setPropTree(const char *xpath) override { throwReadOnly("setPropTree"); }
+    virtual IPropertyTree *addPropTree(const char *xpath) override { throwReadOnly("addPropTree"); }
+    virtual bool removeProp(const char *xpath) override { throwReadOnly("removeProp"); }
+    virtual bool removeTree(IPropertyTree *child) override { throwReadOnly("removeTree"); }
+    virtual IPropertyTree *addPropTreeArrayItem(const char *xpath, IPropertyTree *val) override { ::Release(val); throwReadOnly("addPropTreeArrayItem"); }
+
+// serializable impl.
+    virtual void serialize(MemoryBuffer &tgt) override
+    {
+        // Rare, so serialize a conventional copy rather than duplicating the format here
+        Owned<IPropertyTree> copy = createPTreeFromIPT(this);
+        copy->serialize(tgt);
+    }
+    virtual void deserialize(MemoryBuffer &src) override { throwReadOnly("deserialize"); }
+
+private:
+    [[noreturn]] void throwReadOnly(const char *method) const
+    {
+        throw MakeIPTException(PTreeExcpt_Unsupported, "%s: frozen property tree <%s> is read-only", method, name ? name : "");
+    }
+    inline const CFrozenPTree *queryChild(unsigned idx) const { return arena->queryNode(firstChild+idx); }
+    inline const char *queryLocal(const char *prop) const
+    {
+        if (!prop)
+            return value;
+        const FrozenAttr *attr = findAttribute(prop);
+        return attr ? attr->value : nullptr;
+    }
+    const FrozenAttr *findAttribute(const char *key) const
+    {
+        const FrozenAttr *cur = arena->queryAttr(firstAttr);
+        const FrozenAttr *end = cur + numAttrs;
+        bool nocase = arena->isnocase();
+        for (; cur != end; cur++)
+        {
+            if (nocase ? strieq(cur->name, key) : streq(cur->name, key))
+                return cur;
+        }
+        return nullptr;
+    }
+    const FrozenNameGroup *findGroup(const char *id, size32_t idLen) const
+    {
+        // Binary search of the distinct child names
+        const FrozenNameGroup *lo = arena->queryGroup(firstGroup);
+        const FrozenNameGroup *hi = lo + numGroups;
+        while (lo < hi)
+        {
+            const FrozenNameGroup *mid = lo + (hi-lo)/2;
+            int c = arena->compareName(mid->name, id, idLen);
+            if (c < 0)
+                lo = mid+1;
+            else if (c > 0)
+                hi = mid;
+            else
+                return mid;
+        }
+        return nullptr;
+    }
+    const CFrozenPTree *findSimple(const char *xpath) const;
+    const CFrozenPTree *queryFirst(const char *xpath) const;
+    const CFrozenPTree *queryProperty(const char *xpath, const char *&prop) const;
+    IPropertyTreeIterator *getChildIterator(const char *id, bool wild, bool sort) const;
+    IPropertyTreeIterator *getSelfIterator() const { return new CFrozenPTreeIterator(arena, this, nullptr, 1); }
+
+private:
+    /* NB: as with PTree, the members are ordered to keep the nodes as small as possible */
+    CFrozenPTreeArena *arena;
+    const char *name;
+    const char *value;      // null terminated, or null if there is no value
+    size32_t valueLen;      // excluding the terminator
+    unsigned firstChild;
+    unsigned childCount;
+    unsigned firstGroup;
+    unsigned numGroups;
+    unsigned firstAttr;
+    unsigned short numAttrs;
+    byte flags;
+};
+
+inline CFrozenPTree *CFrozenPTreeArena::queryNode(unsigned idx) const
+{
+    return nodes + idx;
+}
+
+IPropertyTree & CFrozenPTreeIterator::query()
+{
+    return const_cast<CFrozenPTree &>(elems[order ? order[cur] : cur]);
+}
+
+bool CFrozenPTreeIterator::matchNext()
+{
+    if (wild)
+    {
+        bool nocase = arena->isnocase();
+        while (cur < num)
+        {
+            if (WildMatch(elems[order ? order[cur] : cur].name, wild, nocase))
+                break;
+            cur++;
+        }
+    }
+    return cur < num;
+}
+
+const CFrozenPTree *CFrozenPTree::findSimple(const char *xpath) const
+{
+    // xpath is a sequence of plain element names separated by '/'. The result is the first match in iteration order,
+    // which need not be below the first element that matches the first step.
+    const char *end = strchr(xpath, '/');
+    size32_t len = end ? end-xpath : strlen(xpath);
+    const FrozenNameGroup *group = findGroup(xpath, len);
+    if (!group)
+        return nullptr;
+    const unsigned *order = arena->queryOrder(firstChild) + group->first;
+    if (!end || !end[1])
+        return queryChild(order[0]);
+    for (unsigned i=0; i < group->count; i++)
+    {
+        const CFrozenPTree *match = queryChild(order[i])->findSimple(end+1);
+        if (match)
+            return match;
+    }
+    return nullptr;
+}
+
+const CFrozenPTree *CFrozenPTree::queryFirst(const char *xpath) const
+{
+    if (isEmptyString(xpath))
+        return this;
+    // The common case of a path of plain names is resolved directly, anything else uses the general xpath support
+    const char *cur = xpath;
+    for (;;)
+    {
+        if (!isValidXPathStartChr(*cur))
+            break;
+        do
+        {
+            cur++;
+        } while (isValidXPathChr(*cur));
+        if ('/' != *cur)
+            break;
+        if ('\0' == *++cur)
+            break;
+    }
+    if ('\0' == *cur)
+        return findSimple(xpath);
+    Owned<IPropertyTreeIterator> iter = getElements(xpath);
+    if (!iter->first())
+        return nullptr;
+    return static_cast<const CFrozenPTree *>(&iter->query());
+}
+
+const CFrozenPTree *CFrozenPTree::queryProperty(const char *xpath, const char *&prop) const
+{
+    prop = nullptr;
+    if (!xpath)
+        return this;
+    if (isAttribute(xpath))
+    {
+        prop = xpath;
+        return this;
+    }
+    const char *tail = splitXPathX(xpath);
+    if (isAttribute(tail))
+    {
+        prop = tail;
+        MAKE_LSTRING(path, xpath, tail-xpath);
+        return queryFirst(path);
+    }
+    return queryFirst(xpath);
+}
+
+IPropertyTreeIterator *CFrozenPTree::getChildIterator(const char *id, bool wild, bool sort) const
+{
+    if (!childCount)
+        return LINK(nullPTreeIterator);
+    const CFrozenPTree *kids = arena->queryNode(firstChild);
+    const unsigned *order = arena->queryOrder(firstChild);
+    if (wild)
+    {
+        if (streq(id, "*"))
+            id = nullptr;
+        return new CFrozenPTreeIterator(arena, kids, sort ? order : nullptr, childCount, id);
+    }
+    const FrozenNameGroup *group = findGroup(id, strlen(id));
+    if (!group)
+        return LINK(nullPTreeIterator);
+    return new CFrozenPTreeIterator(arena, kids, order+group->first, group->count);
+}
+
+IPropertyTreeIterator *CFrozenPTree::getElements(const char *xpath, IPTIteratorCodes flags) const
+{
+    // Follows the structure of PTree::getElements, but finds children in the name ordered child list
+    if (isEmptyString(xpath))
+        return getSelfIterator();
+    Owned<IPropertyTreeIterator> iter;
+    const char *_xpath = xpath;
+    bool root=true;
+restart:
+    switch (*xpath)
+    {
+        case '.':
+            root=false;
+            ++xpath;
+            if ('\0' == *xpath)
+                return getSelfIterator();
+            else if ('/' != *xpath)
+                throw MakeXPathException(xpath-1, PTreeExcpt_XPath_Unsupported, 0, "\"/\" expected");
+            goto restart;
+        case '/':
+            ++xpath;
+            if ('/' == *xpath)
+            {
+                iter.setown(getElements(xpath+1));
+                if (childCount)
+                {
+                    IPropertyTreeIterator *iter2 = getChildIterator("*", true, flags & iptiter_sort);
+                    iter2 = new PTStackIterator(iter2, xpath-1, false);
+
+                    SeriesPTIterator *series = new SeriesPTIterator();
+                    series->addIterator(iter.getClear());
+                    series->addIterator(iter2);
+                    return series;
+                }
+                return iter.getClear();
+            }
+            else if (root)
+                throw MakeXPathException(xpath, PTreeExcpt_XPath_Unsupported, 0, "Root specifier \"/\" specifier is not supported");
+            else if ('\0' == *xpath)
+                return getSelfIterator();
+            goto restart;
+        case '[':
+        {
+            ++xpath;
+            if (isdigit(*xpath))
+            {
+                StringAttr index;
+                xpath = readIndex(xpath, index);
+                if (1 == atoi(index.get()))
+                    iter.setown(getSelfIterator());
+            }
+            else
+            {
+                if (checkPTreePattern(*this, arena->isnocase(), xpath))
+                    iter.setown(getSelfIterator());
+            }
+            if (']' != *xpath)
+                throw MakeXPathException(_xpath, PTreeExcpt_XPath_ParseError, xpath-_xpath, "Qualifier brace unclosed");
+            ++xpath;
+            break;
+        }
+        default:
+        {
+            bool wild;
+            const char *start = xpath;
+            readWildId(xpath, wild);
+            size32_t s = xpath-start;
+            if (s && childCount)
+            {
+                MAKE_LSTRING(id, start, s);
+                bool sort = (flags & iptiter_sort) != 0;
+                iter.setown(getChildIterator(id, wild, sort));
+                if ('[' == *xpath && iter->first()) // check for local index not iterative qualifier.
+                {
+                    const char *xxpath = xpath+1;
+                    if (isdigit(*xxpath))
+                    {
+                        StringAttr idxstr;
+                        xxpath = readIndex(xxpath, idxstr);
+                        if (']' != *xxpath)
+                            throw MakeXPathException(_xpath, PTreeExcpt_XPath_ParseError, xpath-_xpath, "Qualifier brace unclosed");
+                        ++xxpath;
+                        unsigned index = atoi(idxstr.get());
+                        Owned<IPropertyTreeIterator> matches = iter.getClear();
+                        if (index)
+                        {
+                            do
+                            {
+                                if (0 == --index)
+                                {
+                                    iter.setown(static_cast<CFrozenPTree &>(matches->query()).getSelfIterator());
+                                    break;
+                                }
+                            }
+                            while (matches->next());
+                        }
+                        xpath = xxpath;
+                    }
+                    else
+                    {
+                        const char *start = xxpath-1;
+                        for (;;)
+                        {
+                            char quote = 0;
+                            while (']' != *(++xxpath) || quote)
+                            {
+                                switch (*xxpath) {
+                                case '\"':
+                                case '\'':
+                                {
+                                    if (quote)
+                                    {
+                                        if (*xxpath == quote)
+                                            quote = 0;
+                                    }
+                                    else
+                                        quote = *xxpath;
+                                    break;
+                                }
+                                case '\0':
+                                    throw MakeXPathException(start, PTreeExcpt_XPath_ParseError, xxpath-start, "Qualifier brace unclosed");
+                                }
+                            }
+                            ++xxpath;
+                            if ('[' == *xxpath)
+                            {
+                                ++xxpath;
+                                if (isdigit(*xxpath))
+                                {
+                                    StringAttr qualifier(start, (xxpath-1)-start);
+                                    Owned<IPropertyTreeIterator> siter = new PTStackIterator(iter.getClear(), qualifier.get(), false);
+                                    StringAttr index;
+                                    xxpath = readIndex(xxpath, index);
+                                    iter.setown(new CIndexIterator(siter.getClear(), atoi(index.get())));
+                                    ++xxpath;
+                                    break;
+                                }
+                            }
+                            else
+                            {
+                                StringAttr qualifier(start, xxpath-start);
+                                iter.setown(new PTStackIterator(iter.getClear(), qualifier.get(), false));
+                                break;
+                            }
+                        }
+                        xpath = xxpath;
+                    }
+                }
+            }
+            break;
+        }
+    }
+
+    if (!iter)
+        iter.setown(LINK(nullPTreeIterator));
+    if (*xpath == '\0' || (*xpath == '/' && '\0' == *(xpath+1)))
+        return iter.getClear();
+    else
+        return new PTStackIterator(iter.getClear(), xpath, false);
+}
+
+IAttributeIterator *CFrozenPTree::getAttributes(bool sorted) const
+{
+    class CFrozenAttributeIterator final : public CSimpleInterfaceOf<IAttributeIterator>
+    {
+        Linked<const CFrozenPTree> parent;
+        const FrozenAttr *attrs;
+        std::vector<unsigned short> order;  // only used if sorted
+        unsigned num, cur;
+    public:
+        CFrozenAttributeIterator(const CFrozenPTree *_parent, bool sorted) : parent(_parent)
+        {
+            attrs = parent->arena->queryAttr(parent->firstAttr);
+            num = parent->numAttrs;
+            cur = num;
+            if (sorted && num > 1)
+            {
+                order.resize(num);
+                for (unsigned i=0; i < num; i++)
+                    order[i] = i;
+                std::stable_sort(order.begin(), order.end(), [this](unsigned short l, unsigned short r) { return stricmp(attrs[l].name, attrs[r].name) < 0; });
+            }
+        }
+    // IAttributeIterator impl.
+        virtual bool first() override
+        {
+            cur = 0;
+            return cur < num;
+        }
+        virtual bool next() override
+        {
+            if (cur < num)
+                cur++;
+            return cur < num;
+        }
+        virtual bool isValid() override { return cur < num; }
+        virtual unsigned count() override { return num; }
+        virtual const char *queryName() const override { return queryAttr().name; }
+        virtual const char *queryValue() const override { return queryAttr().value; }
+        virtual StringBuffer &getValue(StringBuffer &out) override { return out.append(queryValue()); }
+    private:
+        const FrozenAttr &queryAttr() const { return attrs[order.empty() ? cur : order[cur]]; }
+    };
+    return new CFrozenAttributeIterator(this, sorted);
+}
+
+class CFrozenPTreeBuilder
+{
+    struct NodeInfo
+    {
+        const IPropertyTree *src;
+        const char *name;
+        unsigned value;     // offset in the pool, or NotFound
+        size32_t valueLen;
+        unsigned firstChild;
+        unsigned numChildren;
+        unsigned firstGroup;
+        unsigned numGroups;
+        unsigned firstAttr;
+        unsigned short numAttrs;
+        byte flags;
+    };
+    struct AttrInfo
+    {
+        const char *name;
+        unsigned value;
+        bool encoded;
+    };
+
+    Owned<CFrozenPTreeArena> arena;
+    std::vector<NodeInfo> nodes;
+    std::vector<AttrInfo> attrs;
+    std::vector<unsigned> order;
+    std::vector<FrozenNameGroup> groups;
+    MemoryBuffer pool;
+    std::unordered_map<std::string, unsigned> poolMap;
+    std::unordered_map<std::string, const char *> nameMap;
+    std::unordered_map<std::string, const char *> attrNameMap;
+
+    unsigned addToPool(size32_t len, const char *data)
+    {
+        // Identical values (typically attributes) are only stored once
+        std::string key(data, len);
+        auto it = poolMap.find(key);
+        if (it != poolMap.end())
+            return it->second;
+        size32_t offset = pool.length();
+        if (offset + (memsize_t)len + 1 > (size32_t)-1)
+            throw MakeIPTException(PTreeExcpt_Unsupported, "createFrozenPTree: tree values are too large to freeze");
+        pool.append(len, data).append('\0');
+        poolMap.emplace(std::move(key), offset);
+        return offset;
+    }
+    const char *internName(const char *name)
+    {
+        // Each distinct name holds a single reference to its atom, released with the arena
+        if (!name)
+            return nullptr;
+        auto it = nameMap.find(name);
+        if (it != nameMap.end())
+            return it->second;
+        AtomRefTable *kT = arena->nocase ? keyTableNC : keyTable;
+        HashKeyElement *atom = kT->queryCreate(name);
+        arena->names.push_back(atom);
+        const char *interned = atom->get();
+        nameMap.emplace(name, interned);
+        return interned;
+    }
+    const char *internAttrName(const char *name)
+    {
+        auto it = attrNameMap.find(name);
+        if (it != attrNameMap.end())
+            return it->second;
+        AttrStr *atom;
+        {
+            CriticalBlock block(hashcrit);
+            atom = attrHT->addkey(name, arena->nocase);
+        }
+        arena->attrNames.push_back(atom);
+        const char *interned = atom->get();
+        attrNameMap.emplace(name, interned);
+        return interned;
+    }
+    void addNode(const IPropertyTree &src)
+    {
+        NodeInfo info;
+        info.src = &src;
+        info.name = internName(src.queryName());
+        info.value = NotFound;
+        info.valueLen = 0;
+        info.flags = 0;
+        if (src.isBinary(nullptr))
+        {
+            info.flags |= CFrozenPTree::fpt_binary;
+            MemoryBuffer mb;
+            src.getPropBin(nullptr, mb);
+            if (mb.length())
+            {
+                info.value = addToPool(mb.length(), mb.toByteArray());
+                info.valueLen = mb.length();
+            }
+        }
+        else if (src.isCompressed(nullptr))
+        {
+            StringBuffer s;
+            if (src.getProp(nullptr, s) && s.length())
+            {
+                info.value = addToPool(s.length(), s.str());
+                info.valueLen = s.length();
+            }
+        }
+        else
+        {
+            const char *val = src.queryProp(nullptr);
+            if (!isEmptyString(val))
+            {
+                size32_t len = strlen(val);
+                info.value = addToPool(len, val);
+                info.valueLen = len;
+            }
+        }
+        if (src.isArray(nullptr))
+            info.flags |= CFrozenPTree::fpt_arrayItem;
+        if (isPTreeNameEncoded(&src))
+            info.flags |= CFrozenPTree::fpt_nameEncoded;
+
+        info.firstAttr = attrs.size();
+        Owned<IAttributeIterator> aiter = src.getAttributes();
+        ForEach(*aiter)
+        {
+            const char *attrName = aiter->queryName();
+            const char *attrValue = aiter->queryValue();
+            AttrInfo attr;
+            attr.name = internAttrName(attrName);
+            attr.value = addToPool(strlen(attrValue), attrValue);
+            attr.encoded = isPTreeAttributeNameEncoded(&src, attrName);
+            attrs.push_back(attr);
+        }
+        size_t numAttrs = attrs.size() - info.firstAttr;
+        assertex(numAttrs <= (unsigned short)-1);
+        info.numAttrs = (unsigned short)numAttrs;
+        info.firstChild = 0;
+        info.numChildren = 0;
+        info.firstGroup = 0;
+        info.numGroups = 0;
+        nodes.push_back(info);
+        order.push_back(0);
+    }
+
+public:
+    CFrozenPTreeBuilder(bool nocase) : arena(new CFrozenPTreeArena(nocase))
+    {
+    }
+
+    CFrozenPTree *build(const IPropertyTree &root)
+    {
+        // Breadth first, so that the children of each node are allocated contiguously
+        addNode(root);
+        for (unsigned cur=0; cur < nodes.size(); cur++)
+        {
+            unsigned firstChild = nodes.size();
+            Owned<IPropertyTreeIterator> iter = nodes[cur].src->getElements("*");
+            ForEach(*iter)
+                addNode(iter->query());
+            unsigned numChildren = nodes.size() - firstChild;
+            nodes[cur].firstChild = firstChild;
+            nodes[cur].numChildren = numChildren;
+            nodes[cur].firstGroup = groups.size();
+            if (numChildren)
+            {
+                unsigned *childOrder = order.data() + firstChild;
+                for (unsigned i=0; i < numChildren; i++)
+                    childOrder[i] = i;
+                const CFrozenPTreeArena &a = *arena;
+                const NodeInfo *kids = nodes.data() + firstChild;
+                std::stable_sort(childOrder, childOrder+numChildren, [&a, kids](unsigned l, unsigned r) { return a.compareNames(kids[l].name, kids[r].name) < 0; });
+                for (unsigned i=0; i < numChildren; i++)
+                {
+                    const char *childName = kids[childOrder[i]].name;
+                    if (i && (0 == a.compareNames(groups.back().name, childName)))
+                        groups.back().count++;
+                    else
+                        groups.push_back({ childName, i, 1 });
+                }
+            }
+            nodes[cur].numGroups = groups.size() - nodes[cur].firstGroup;
+        }
+
+        // Everything is known, so lay the tree out in a single block - nodes, attributes, name groups, child order, then the values
+        size_t numNodes = nodes.size();
+        memsize_t nodeSize = numNodes * sizeof(CFrozenPTree);
+        memsize_t attrSize = attrs.size() * sizeof(FrozenAttr);
+        memsize_t groupSize = groups.size() * sizeof(FrozenNameGroup);
+        memsize_t orderSize = numNodes * sizeof(unsigned);
+        memsize_t blockSize = nodeSize + attrSize + groupSize + orderSize + pool.length();
+        byte *block = (byte *)checked_malloc(blockSize, -600);
+        arena->block = block;
+        arena->blockSize = blockSize;
+        arena->nodes = (CFrozenPTree *)block;
+        arena->attrs = (FrozenAttr *)(block + nodeSize);
+        arena->groups = (FrozenNameGroup *)(block + nodeSize + attrSize);
+        arena->order = (unsigned *)(block + nodeSize + attrSize + groupSize);
+        char *values = (char *)(block + nodeSize + attrSize + groupSize + orderSize);
+        memcpy(values, pool.toByteArray(), pool.length());
+        memcpy(arena->groups, groups.data(), groupSize);
+        memcpy(arena->order, order.data(), orderSize);
+        for (unsigned i=0; i < attrs.size(); i++)
+        {
+            const AttrInfo &attr = attrs[i];
+            FrozenAttr *dst = arena->attrs + i;
+            dst->name = attr.name;
+            dst->value = values + attr.value;
+            dst->encoded = attr.encoded;
+        }
+        for (unsigned i=0; i < numNodes; i++)
+        {
+            const NodeInfo &info = nodes[i];
+            const char *value = (NotFound == info.value) ? nullptr : values + info.value;
+            new (arena->nodes + i) CFrozenPTree(arena, info.name, value, info.valueLen, info.firstChild, info.numChildren, info.firstGroup, info.numGroups, info.firstAttr, info.numAttrs, info.flags);
+        }
+        CFrozenPTreeArena *result = arena.getClear();   // the link is owned by the root
+        return result->queryNode(0);
+    }
+};
+
+static const CFrozenPTree *queryFrozenPTree(const IPropertyTree *tree)
+{
+    return dynamic_cast<const CFrozenPTree *>(tree);
+}
+
+IPropertyTree *createFrozenPTree(const IPropertyTree *srcTree)
+{
+    assertex(srcTree);
+    if (queryFrozenPTree(srcTree))
+        return LINK(const_cast<IPropertyTree *>(srcTree));
+    CFrozenPTreeBuilder builder(srcTree->isCaseInsensitive());
+    return builder.build(*srcTree);
+}
+
+bool isFrozenPTree(const IPropertyTree *tree)
+{
+    return queryFrozenPTree(tree) != nullptr;
+}
+
+memsize_t getFrozenPTreeSize(const IPropertyTree *tree)
+{
+    const CFrozenPTree *frozen = queryFrozenPTree(tree);
+    return frozen ? frozen->queryArena()->querySize() : 0;
+}
+
+
 #define DEFAULT_PTREE_TYPE LocalPTree
 
 // factory methods
@@ -4603,6 +5546,134 @@ IPTreeReadException *createPTreeReadException(int code, const char *msg, const c
     return new CPTreeReadException(code, msg, context, line, offset);
 }
 
+// A small set of characters that terminate a run of ordinary text - e.g. '<' for element content, or the closing quote
+// of an attribute value.  The readers use it to consume a whole run directly from their buffer, rather than reading
+// and appending one character at a time.  Where SSE2 is available the buffer is scanned 16 bytes at a time.
+// If stopAtNonText is set, control characters and non-ascii (utf8) bytes also end a run.
+class CDelimiterSet
+{
+    static constexpr unsigned maxDelims = 4;
+    byte delims[maxDelims];
+    unsigned numDelims = 0;
+    bool stopAtNonText;
+#ifdef PTREE_SIMD_SCAN
+    __m128i vdelims[maxDelims];
+
+    inline unsigned matchMask(__m128i block) const
+    {
+        __m128i match = _mm_cmpeq_epi8(block, vdelims[0]);
+        for (unsigned i=1; i<numDelims; i++)
+            match = _mm_or_si128(match, _mm_cmpeq_epi8(block, vdelims[i]));
+        if (stopAtNonText) // a signed comparison, so bytes >= 0x80 are also less than ' '
+            match = _mm_or_si128(match, _mm_cmplt_epi8(block, _mm_set1_epi8(' ')));
+        return (unsigned)_mm_movemask_epi8(match);
+    }
+    static inline unsigned newlineMask(__m128i block)
+    {
+        return (unsigned)_mm_movemask_epi8(_mm_cmpeq_epi8(block, _mm_set1_epi8('\n')));
+    }
+#endif
+public:
+    CDelimiterSet(std::initializer_list<char> chars, bool _stopAtNonText=false) : stopAtNonText(_stopAtNonText)
+    {
+        assertex(chars.size() && chars.size() <= maxDelims);
+        for (char c : chars)
+        {
+#ifdef PTREE_SIMD_SCAN
+            vdelims[numDelims] = _mm_set1_epi8(c);
+#endif
+            delims[numDelims++] = (byte)c;
+        }
+    }
+    inline bool isDelim(byte c) const
+    {
+        if (stopAtNonText && ((c < ' ') || (c >= 0x80)))
+            return true;
+        for (unsigned i=0; i<numDelims; i++)
+        {
+            if (c == delims[i])
+                return true;
+        }
+        return false;
+    }
+    // Returns the offset of the first delimiter in [s, s+len), or len if there is none.
+    // The number of newlines that precede it is added to newlines.
+    size32_t find(const byte *s, size32_t len, unsigned &newlines) const
+    {
+        size32_t pos = 0;
+#ifdef PTREE_SIMD_SCAN
+        while (len - pos >= 16)
+        {
+            __m128i block = _mm_loadu_si128((const __m128i *)(s + pos));
+            unsigned mask = matchMask(block);
+            unsigned nlMask = newlineMask(block);
+            if (mask)
+            {
+                unsigned idx = __builtin_ctz(mask);
+                newlines += __builtin_popcount(nlMask & ((1U << idx) - 1));
+                return pos + idx;
+            }
+            newlines += __builtin_popcount(nlMask);
+            pos += 16;
+        }
+#endif
+        for (; pos < len; pos++)
+        {
+            byte c = s[pos];
+            if (isDelim(c))
+                break;
+            if ('\n' == c)
+                newlines++;
+        }
+        return pos;
+    }
+    // As find(), but for a null terminated string - the terminator always ends the scan.
+    size32_t findTerminated(const byte *s, unsigned &newlines) const
+    {
+        size32_t pos = 0;
+#if defined(PTREE_SIMD_SCAN) && !defined(__SANITIZE_ADDRESS__)
+        // Aligned loads never cross a page boundary, so may safely read beyond the terminator
+        for (; ((memsize_t)(s + pos) & 15) != 0; pos++)
+        {
+            byte c = s[pos];
+            if (!c || isDelim(c))
+                return pos;
+            if ('\n' == c)
+                newlines++;
+        }
+        const __m128i zero = _mm_setzero_si128();
+        for (;;)
+        {
+            __m128i block = _mm_load_si128((const __m128i *)(s + pos));
+            unsigned mask = matchMask(block) | (unsigned)_mm_movemask_epi8(_mm_cmpeq_epi8(block, zero));
+            unsigned nlMask = newlineMask(block);
+            if (mask)
+            {
+                unsigned idx = __builtin_ctz(mask);
+                newlines += __builtin_popcount(nlMask & ((1U << idx) - 1));
+                return pos + idx;
+            }
+            newlines += __builtin_popcount(nlMask);
+            pos += 16;
+        }
+#else
+        for (;; pos++)
+        {
+            byte c = s[pos];
+            if (!c || isDelim(c))
+                return pos;
+            if ('\n' == c)
+                newlines++;
+        }
+#endif
+    }
+};
+
+static const CDelimiterSet xmlTextDelims({'<', '\0'});
+static const CDelimiterSet xmlQuotedDelims({'"', '\0'});
+static const CDelimiterSet xmlApostrophedDelims({'\''});
+static const CDelimiterSet jsonStringDelims({'"', '\\'}, true);
+
 template <typename T>
 class CommonReaderBase : public CInterface
 {
@@ -4807,6 +5878,24 @@ protected:
         return readNextToken();
     }
     inline bool readNextToken();
+    inline size32_t scanToken(const CDelimiterSet &delims);
+    // Equivalent to "while (!delims.isDelim(nextChar)) { out.append(nextChar); readNext(); }", except that the
+    // characters between delimiters are consumed from the buffer as a block.
+    void readUntil(StringBuffer &out, const CDelimiterSet &delims)
+    {
+        while (!delims.isDelim(nextChar))
+        {
+            out.append(nextChar);
+            size32_t len = scanToken(delims);
+            if (len)
+            {
+                out.append(len, (const char *)bufPtr);
+                bufPtr += len;
+                curOffset += len;
+            }
+            readNext(); // the delimiter, or refill the buffer
+        }
+    }
     inline bool checkSkipWS()
     {
         while (isspace(nextChar)) if (!checkReadNext()) return false;
@@ -4864,6 +5953,27 @@ template <> inline bool CommonReaderBase<CInstStringReader>::readNextToken()
     return true;
 }
 
+// Returns the number of characters that follow bufPtr before the next delimiter (or the end of the buffer), updating
+// the line count and bufRemaining as readNextToken() would have done.  The caller advances bufPtr and curOffset.
+template <> inline size32_t CommonReaderBase<CInstStreamReader>::scanToken(const CDelimiterSet &delims)
+{
+    size32_t len = delims.find(bufPtr, bufRemaining, line);
+    bufRemaining -= len;
+    return len;
+}
+
+template <> inline size32_t CommonReaderBase<CInstBufferReader>::scanToken(const CDelimiterSet &delims)
+{
+    size32_t len = delims.find(bufPtr, bufRemaining, line);
+    bufRemaining -= len;
+    return len;
+}
+
+template <> inline size32_t CommonReaderBase<CInstStringReader>::scanToken(const CDelimiterSet &delims)
+{
+    return delims.findTerminated(bufPtr, line);
+}
+
 template <typename X>
 class CXMLReaderBase : public CommonReaderBase<X>, implements IEntityHelper
 {
@@ -5251,6 +6361,7 @@ public:
     typedef CXMLReaderBase<X> PARENT;
     using PARENT::nextChar;
     using PARENT::readNext;
+    using PARENT::readUntil;
     using PARENT::expecting;
     using PARENT::match;
     using PARENT::error;
@@ -5403,22 +6514,14 @@ restart:
             if (nextChar == '"')
             {
                 readNext();
-                while (nextChar != '"')
-                {
-                    if (!nextChar)
-                        eos();
-                    attrval.append(nextChar);
-                    readNext();
-                }
+                readUntil(attrval, xmlQuotedDelims);
+                if (!nextChar)
+                    eos();
             }
             else if (nextChar == '\'')
             {
                 readNext();
-                while (nextChar != '\'')
-                {
-                    attrval.append(nextChar);
-                    readNext();
-                }
+                readUntil(attrval, xmlApostrophedDelims);
             }
             else 
                 error();
@@ -5450,7 +6553,7 @@ restart:
                         if ('\0' == nextChar)
                             eos();
                         StringBuffer mark;
-                        while (nextChar && nextChar !='<') { mark.append(nextChar); readNext(); }
+                        readUntil(mark, xmlTextDelims);
                         size32_t l = mark.length();
                         size32_t r = l+1;
                         if (l)
@@ -5520,6 +6623,7 @@ class CPullXMLReader : public CXMLReaderBase<X>, implements IPullPTreeReader
     typedef CXMLReaderBase<X> PARENT;
     using PARENT::nextChar;
     using PARENT::readNext;
+    using PARENT::readUntil;
     using PARENT::expecting;
     using PARENT::match;
     using PARENT::error;
@@ -5736,22 +6840,14 @@ public:
                     if (nextChar == '"')
                     {
                         readNext();
-                        while (nextChar != '"')
-                        {
-                            if (!nextChar)
-                                eos();
-                            attrval.append(nextChar);
-                            readNext();
-                        }
+                        readUntil(attrval, xmlQuotedDelims);
+                        if (!nextChar)
+                            eos();
                     }
                     else if (nextChar == '\'')
                     {
                         readNext();
-                        while (nextChar != '\'')
-                        {
-                            attrval.append(nextChar);
-                            readNext();
-                        }
+                        readUntil(attrval, xmlApostrophedDelims);
                     }
                     else 
                         error();
@@ -5798,7 +6894,7 @@ public:
                             eos();
                         mark.clear();
                         state = tagMarker;
-                        while (nextChar && nextChar !='<') { mark.append(nextChar); readNext(); }
+                        readUntil(mark, xmlTextDelims);
                         if (!nextChar)
                             break;
                         size32_t l = mark.length();
@@ -7229,6 +8325,7 @@ public:
     using PARENT::checkReadNext;
     using PARENT::checkStartReadNext;
     using PARENT::readNext;
+    using PARENT::readUntil;
     using PARENT::expecting;
     using PARENT::match;
     using PARENT::error;
@@ -7277,6 +8374,7 @@ protected:
                 decode=true;
             appendChar(s, nextChar);
             readNext();
+            readUntil(s, jsonStringDelims);
         }
         size32_t r = s.length();
         if (ignoreWhiteSpace)
@@ -9941,8 +11039,7 @@ bool isPTreeNameEncoded(const IPropertyTree *tree)
 {
     if (!tree)
         return false;
-    const PTree *pt = static_cast<const PTree*>(tree);
-    return pt->isNameEncoded();
+    return tree->isNameEncoded();
 }
 
 void setPTreeAttribute(IPropertyTree *tree, const char *name, const char *value, bool markEncoded)
@@ -9957,8 +11054,7 @@ bool isPTreeAttributeNameEncoded(const IPropertyTree *tree, const char *name)
 {
     if (!tree || isEmptyString(name))
         return false;
-    const PTree *pt = static_cast<const PTree*>(tree);
-    return pt->isAttributeNameEncoded(name);
+    return tree->isAttributeNameEncoded(name);
 }
 
 bool isNullPtreeName(const char * name, bool isEncoded)
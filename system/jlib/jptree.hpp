@@ -142,6 +142,8 @@ interface jlib_decl IPropertyTree : extends serializable
     virtual IPropertyTree *addPropTreeArrayItem(const char *xpath, IPropertyTree *val) = 0;
     virtual bool isArray(const char *xpath=NULL) const = 0;
     virtual unsigned getAttributeCount() const = 0;
+    virtual bool isNameEncoded() const = 0;        // use isPTreeNameEncoded()
+    virtual bool isAttributeNameEncoded(const char *key) const = 0;    // use isPTreeAttributeNameEncoded()
 
 private:
     void setProp(const char *, int); // dummy to catch accidental use of setProp when setPropInt() intended
@@ -246,6 +248,13 @@ jlib_decl IPropertyTree *createPTreeFromIPT(const IPropertyTree *srcTree, ipt_fl
 jlib_decl IPropertyTree *createPTreeFromJSONString(const char *json, byte flags=ipt_none, PTreeReaderOptions readFlags=ptr_ignoreWhiteSpace, IPTreeMaker *iMaker=NULL);
 jlib_decl IPropertyTree *createPTreeFromJSONString(unsigned len, const char *json, byte flags=ipt_none, PTreeReaderOptions readFlags=ptr_ignoreWhiteSpace, IPTreeMaker *iMaker=NULL);
 
+// A frozen tree is a compact, immutable copy of srcTree held in a single allocation, for large trees that are only read
+// (e.g. configuration and query metadata).  It supports the read side of IPropertyTree, and is safe to read from multiple
+// threads.  Any attempt to modify it throws an IPTreeException.  Freezing a frozen tree returns it linked.
+jlib_decl IPropertyTree *createFrozenPTree(const IPropertyTree *srcTree);
+jlib_decl bool isFrozenPTree(const IPropertyTree *tree);
+jlib_decl memsize_t getFrozenPTreeSize(const IPropertyTree *tree); // bytes used by the frozen tree that tree belongs to, 0 if not frozen
+
 //URL node nameWithAttrs is of the form: "TagName/attr1('abc')/attr2/attr3('')"
 jlib_decl IPropertyTree *createPTreeFromHttpPath(const char *nameWithAttrs, IPropertyTree *content, bool nestedRoot, ipt_flags flags);
 jlib_decl IPropertyTree *createPTreeFromHttpParameters(const char *nameWithAttrs, IProperties *parameters, bool skipLeadingDotParameters, bool nestedRoot, ipt_flags flags=ipt_none);
@@ -645,8 +645,8 @@ public:
     virtual void setName(const char *name) = 0;
     virtual void serializeSelf(MemoryBuffer &tgt);
     inline void markNameEncoded() { IptFlagSet(flags, ipt_escaped); }
-    inline bool isNameEncoded() const { return IptFlagTst(flags, ipt_escaped); }
-    inline bool isAttributeNameEncoded(const char *key) const
+    virtual bool isNameEncoded() const override { return IptFlagTst(flags, ipt_escaped); }
+    virtual bool isAttributeNameEncoded(const char *key) const override
     {
         AttrValue *a = findAttribute(key);
         if (!a)
@@ -919,7 +919,7 @@ class StackElement;
 class PTStackIterator : public CInterfaceOf<IPropertyTreeIterator>
 {
 public:
-    PTStackIterator(IPropertyTreeIterator *_iter, const char *_xpath);
+    PTStackIterator(IPropertyTreeIterator *_iter, const char *_xpath, bool _ptreeElements=true);
     ~PTStackIterator();
 
 // IPropertyTreeIterator
@@ -941,6 +941,7 @@ private: // data
     unsigned stacklen;
     unsigned stackmax;
     StackElement *stack;
+    bool ptreeElements;   // elements are PTree's, so their child maps can be used directly
 };
 
 class CPTreeMaker : public CInterfaceOf<IPTreeMaker>
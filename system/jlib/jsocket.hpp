@@ -667,6 +667,8 @@ interface IBufferedSocket : implements IInterface
 #define BSOCKET_CLIENT_READ_TIMEOUT 7200
 
 extern jlib_decl IBufferedSocket* createBufferedSocket(ISocket* socket);
+// preRead is data that has already been read from the socket - it is returned before any further data is read
+extern jlib_decl IBufferedSocket* createBufferedSocket(ISocket* socket, MemoryBuffer & preRead);
 
 #define MAX_NET_ADDRESS_SIZE (16)
 
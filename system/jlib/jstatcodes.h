@@ -295,6 +295,15 @@ enum StatisticKind
     StCycleIndexCacheBlockedCycles,
     StTimeAgentProcess,
     StCycleAgentProcessCycles,
+    StNumLeafPrefetches,
+    StNumLeafPrefetchHits,
+    StNumLeafPrefetchWasted,
+    StNumMergePasses,
+    StSizeSpillReread,
+    StNumCompileCacheHits,
+    StNumCompileCacheMisses,
+    StTimeCompileCacheSaved,
+    StCycleCompileCacheSavedCycles,
     StMax,
 
     //For any quantity there is potentially the following variants.
@@ -956,6 +956,15 @@ static const constexpr StatisticMeta statsMetaData[StMax] = {
     { CYCLESTAT(IndexCacheBlocked) },
     { TIMESTAT(AgentProcess) },
     { CYCLESTAT(AgentProcess) },
+    { NUMSTAT(LeafPrefetches) },
+    { NUMSTAT(LeafPrefetchHits) },
+    { NUMSTAT(LeafPrefetchWasted) },
+    { NUMSTAT(MergePasses) },
+    { SIZESTAT(SpillReread) },
+    { NUMSTAT(CompileCacheHits) },
+    { NUMSTAT(CompileCacheMisses) },
+    { TIMESTAT(CompileCacheSaved) },
+    { CYCLESTAT(CompileCacheSaved) },
 };
 
 static MapStringTo<StatisticKind, StatisticKind> statisticNameMap(true);
@@ -1322,7 +1331,7 @@ const StatisticsMapping noStatistics({});
 const StatisticsMapping jhtreeCacheStatistics({ StNumIndexSeeks, StNumIndexScans, StNumPostFiltered, StNumIndexWildSeeks,
                                                 StNumNodeCacheAdds, StNumLeafCacheAdds, StNumBlobCacheAdds, StNumNodeCacheHits, StNumLeafCacheHits, StNumBlobCacheHits, StCycleNodeLoadCycles, StCycleLeafLoadCycles,
                                                 StCycleBlobLoadCycles, StCycleNodeReadCycles, StCycleLeafReadCycles, StCycleBlobReadCycles, StNumNodeDiskFetches, StNumLeafDiskFetches, StNumBlobDiskFetches,
-                                                StCycleNodeFetchCycles, StCycleLeafFetchCycles, StCycleBlobFetchCycles});
+                                                StCycleNodeFetchCycles, StCycleLeafFetchCycles, StCycleBlobFetchCycles, StNumLeafPrefetches, StNumLeafPrefetchHits, StNumLeafPrefetchWasted});
 
 const StatisticsMapping allStatistics(StKindAll);
 const StatisticsMapping heapStatistics({StNumAllocations, StNumAllocationScans});
@@ -0,0 +1,789 @@
+/*##############################################################################
+
+    HPCC SYSTEMS software Copyright (C) 2024 HPCC Systems®.
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+############################################################################## */
+
+#include "platform.h"
+#include <algorithm>
+#include <vector>
+
+#include "jlib.hpp"
+#include "jmutex.hpp"
+#include "jthread.hpp"
+#include "jtask.hpp"
+#include "jptree.hpp"
+#include "jdebug.hpp"
+#include "jlog.hpp"
+#include "jfile.ipp"
+#include "juring.hpp"
+
+#if defined(__linux__) && __has_include(<linux/io_uring.h>)
+#define HAS_IO_URING
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+#include <linux/io_uring.h>
+
+#ifndef __NR_io_uring_setup
+#define __NR_io_uring_setup     425
+#define __NR_io_uring_enter     426
+#define __NR_io_uring_register  427
+#endif
+#endif
+
+static void * allocateAligned(memsize_t size)
+{
+    void * ret = nullptr;
+#ifdef _WIN32
+    ret = _aligned_malloc(size, directIOAlignment);
+#else
+    if (posix_memalign(&ret, directIOAlignment, size) != 0)
+        ret = nullptr;
+#endif
+    if (!ret)
+        throw makeStringExceptionV(0, "Failed to allocate %" I64F "u bytes of aligned memory", (unsigned __int64)size);
+    return ret;
+}
+
+static void freeAligned(void * ptr)
+{
+#ifdef _WIN32
+    _aligned_free(ptr);
+#else
+    free(ptr);
+#endif
+}
+
+static inline bool isDirectAligned(offset_t pos, size32_t len, const void * data)
+{
+    return ((pos | len | (memsize_t)data) & (directIOAlignment - 1)) == 0;
+}
+
+static bool enableDirectIO(HANDLE handle)
+{
+#ifdef __linux__
+    //O_DIRECT can be changed on an open file, which avoids passing the flag through CFile::openHandle()
+    int flags = fcntl(handle, F_GETFL);
+    if ((flags != -1) && (fcntl(handle, F_SETFL, flags | O_DIRECT) == 0))
+        return true;
+#endif
+    return false;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+class CQueuedFileIO;
+
+struct QueuedFileRequest
+{
+    CQueuedFileIO * owner;
+    IFileIOCompletion * completion;
+    HANDLE handle;
+    offset_t pos;
+    void * data;
+    size32_t len;
+    bool isWrite;
+    cycle_t startCycles;
+};
+
+class CFileIOQueueBase : public CInterfaceOf<IFileIOQueue>
+{
+public:
+    CFileIOQueueBase(unsigned _numBuffers, size32_t _bufferSize)
+    : numBuffers(_numBuffers)
+    {
+        bufferSize = ((_bufferSize + directIOAlignment - 1) / directIOAlignment) * directIOAlignment;
+        if (numBuffers && bufferSize)
+        {
+            buffers = (byte *)allocateAligned((memsize_t)numBuffers * bufferSize);
+            for (unsigned i=numBuffers; i--; )
+                freeBuffers.append(i);
+        }
+        else
+            numBuffers = 0;
+    }
+    ~CFileIOQueueBase()
+    {
+        if (buffers)
+            freeAligned(buffers);
+    }
+
+    virtual size32_t queryBufferSize() const override
+    {
+        return bufferSize;
+    }
+    virtual void * allocateBuffer() override
+    {
+        CriticalBlock block(bufferCrit);
+        if (!freeBuffers.ordinality())
+            return nullptr;
+        return buffers + (memsize_t)freeBuffers.popGet() * bufferSize;
+    }
+    virtual void releaseBuffer(void * buffer) override
+    {
+        unsigned idx = findBuffer(buffer, 0);
+        assertex(idx != NotFound);
+        CriticalBlock block(bufferCrit);
+        freeBuffers.append(idx);
+    }
+
+    virtual void submit(QueuedFileRequest * request) = 0;
+
+protected:
+    // Return the index of the buffer that contains all of [data, data+len), or NotFound
+    unsigned findBuffer(const void * data, size32_t len) const
+    {
+        if (!buffers || ((const byte *)data < buffers))
+            return NotFound;
+        memsize_t offset = (const byte *)data - buffers;
+        memsize_t idx = offset / bufferSize;
+        if ((idx >= numBuffers) || (offset + len > (idx + 1) * bufferSize))
+            return NotFound;
+        return (unsigned)idx;
+    }
+
+    void completeRequest(QueuedFileRequest * request, int result);
+    void queueTask(QueuedFileRequest * request);
+
+protected:
+    byte * buffers = nullptr;
+    unsigned numBuffers;
+    size32_t bufferSize;
+    CriticalSection bufferCrit;
+    UnsignedArray freeBuffers;
+};
+
+//---------------------------------------------------------------------------------------------------------------------
+
+class CQueuedFileIO final : public CInterfaceOf<IQueuedFileIO>
+{
+public:
+    CQueuedFileIO(HANDLE _handle, IFOmode mode, IFSHmode sharemode, IFEflags extraFlags, CFileIOQueueBase & _queue)
+    : queue(&_queue), handle(_handle)
+    {
+        base.setown(new CFileIO(handle, mode, sharemode, extraFlags));
+        //Writes would need a read-modify-write for unaligned blocks, so O_DIRECT is only supported for reading
+        if ((extraFlags & IFEdirect) && (mode == IFOread))
+            direct = enableDirectIO(handle);
+    }
+    ~CQueuedFileIO()
+    {
+        waitForOutstanding();
+    }
+
+    virtual size32_t read(offset_t pos, size32_t len, void * data) override
+    {
+        if (!direct || isDirectAligned(pos, len, data))
+            return base->read(pos, len, data);
+
+        //Read the aligned blocks that contain the request, and copy the part that was requested
+        offset_t alignedPos = pos & ~(offset_t)(directIOAlignment - 1);
+        size32_t skip = (size32_t)(pos - alignedPos);
+        size32_t alignedLen = ((skip + len + directIOAlignment - 1) / directIOAlignment) * directIOAlignment;
+        void * buffer = (alignedLen <= queue->queryBufferSize()) ? queue->allocateBuffer() : nullptr;
+        bool fromQueue = (buffer != nullptr);
+        if (!fromQueue)
+            buffer = allocateAligned(alignedLen);
+        size32_t ret = 0;
+        try
+        {
+            size32_t got = base->read(alignedPos, alignedLen, buffer);
+            if (got > skip)
+                ret = std::min(got - skip, len);
+            memcpy(data, (const byte *)buffer + skip, ret);
+        }
+        catch (...)
+        {
+            releaseBounceBuffer(buffer, fromQueue);
+            throw;
+        }
+        releaseBounceBuffer(buffer, fromQueue);
+        return ret;
+    }
+    virtual offset_t size() override
+    {
+        return base->size();
+    }
+    virtual size32_t write(offset_t pos, size32_t len, const void * data) override
+    {
+        return base->write(pos, len, data);
+    }
+    virtual offset_t appendFile(IFile *file, offset_t pos, offset_t len) override
+    {
+        return base->appendFile(file, pos, len);
+    }
+    virtual void setSize(offset_t size) override
+    {
+        waitForOutstanding();
+        base->setSize(size);
+    }
+    virtual void flush() override
+    {
+        waitForOutstanding();
+        base->flush();
+    }
+    virtual void close() override
+    {
+        waitForOutstanding();
+        base->close();
+    }
+    virtual unsigned __int64 getStatistic(StatisticKind kind) override
+    {
+        return base->getStatistic(kind) + queuedStats.getStatistic(kind);
+    }
+
+    virtual void queueRead(offset_t pos, size32_t len, void * data, IFileIOCompletion & completion) override
+    {
+        queueRequest(false, pos, len, data, completion);
+    }
+    virtual void queueWrite(offset_t pos, size32_t len, const void * data, IFileIOCompletion & completion) override
+    {
+        queueRequest(true, pos, len, const_cast<void *>(data), completion);
+    }
+    virtual IFileIOQueue & queryQueue() override
+    {
+        return *queue;
+    }
+
+    int doSyncRequest(bool isWrite, offset_t pos, size32_t len, void * data)
+    {
+        try
+        {
+            if (isWrite)
+                return (int)base->write(pos, len, data);
+            return (int)read(pos, len, data);
+        }
+        catch (IException * e)
+        {
+            int code = e->errorCode();
+            e->Release();
+            return (code > 0) ? -code : -EIO;
+        }
+    }
+
+    // Called by the queue once a request has been processed.  The request has already been counted if countStats is false.
+    void noteComplete(QueuedFileRequest * request, int result, bool countStats)
+    {
+        IFileIOCompletion * completion = request->completion;
+        if (countStats && (result > 0))
+        {
+            cycle_t elapsed = get_cycles_now() - request->startCycles;
+            if (request->isWrite)
+            {
+                queuedStats.ioWriteCycles.fetch_add(elapsed);
+                queuedStats.ioWriteBytes.fetch_add(result);
+                ++queuedStats.ioWrites;
+            }
+            else
+            {
+                queuedStats.ioReadCycles.fetch_add(elapsed);
+                queuedStats.ioReadBytes.fetch_add(result);
+                ++queuedStats.ioReads;
+            }
+        }
+        delete request;
+        //This object may be destroyed as soon as the request is no longer outstanding, so it must not be accessed after this call
+        noteFinished();
+        completion->onFileIOComplete(result);
+    }
+
+protected:
+    void queueRequest(bool isWrite, offset_t pos, size32_t len, void * data, IFileIOCompletion & completion)
+    {
+        if (direct && !isDirectAligned(pos, len, data))
+        {
+            completion.onFileIOComplete(doSyncRequest(isWrite, pos, len, data));
+            return;
+        }
+
+        QueuedFileRequest * request = new QueuedFileRequest{ this, &completion, handle, pos, data, len, isWrite, get_cycles_now() };
+        {
+            CriticalBlock block(outstandingCrit);
+            outstanding++;
+        }
+        try
+        {
+            queue->submit(request);
+        }
+        catch (...)
+        {
+            delete request;
+            noteFinished();
+            throw;
+        }
+    }
+
+    void noteFinished()
+    {
+        CriticalBlock block(outstandingCrit);
+        if ((--outstanding == 0) && waiting)
+        {
+            idleSem.signal(waiting);
+            waiting = 0;
+        }
+    }
+
+    void waitForOutstanding()
+    {
+        for (;;)
+        {
+            {
+                CriticalBlock block(outstandingCrit);
+                if (outstanding == 0)
+                    return;
+                waiting++;
+            }
+            idleSem.wait();
+            //Ensure the thread that signalled has left the critical section before continuing (and possibly destroying it)
+            CriticalBlock block(outstandingCrit);
+        }
+    }
+
+    void releaseBounceBuffer(void * buffer, bool fromQueue)
+    {
+        if (fromQueue)
+            queue->releaseBuffer(buffer);
+        else
+            freeAligned(buffer);
+    }
+
+protected:
+    Linked<CFileIOQueueBase> queue;
+    Owned<CFileIO> base;
+    HANDLE handle;
+    bool direct = false;
+    FileIOStats queuedStats;
+    CriticalSection outstandingCrit;
+    Semaphore idleSem;
+    unsigned outstanding = 0;
+    unsigned waiting = 0;
+};
+
+class CFileIOTask : public CTask
+{
+public:
+    CFileIOTask(QueuedFileRequest * _request) : CTask(0), request(_request) { }
+    virtual CTask * execute() override
+    {
+        CQueuedFileIO * owner = request->owner;
+        int result = owner->doSyncRequest(request->isWrite, request->pos, request->len, request->data);
+        owner->noteComplete(request, result, false);
+        return nullptr;
+    }
+protected:
+    QueuedFileRequest * request;
+};
+
+void CFileIOQueueBase::completeRequest(QueuedFileRequest * request, int result)
+{
+    request->owner->noteComplete(request, result, true);
+}
+
+// Execute the request synchronously on the io task scheduler
+void CFileIOQueueBase::queueTask(QueuedFileRequest * request)
+{
+    enqueueOwnedTask(queryIOTaskScheduler(), *new CFileIOTask(request));
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+// Used if io_uring is not available - each request is executed synchronously by the io task scheduler
+class CTaskFileIOQueue final : public CFileIOQueueBase
+{
+public:
+    CTaskFileIOQueue(unsigned _numBuffers, size32_t _bufferSize) : CFileIOQueueBase(_numBuffers, _bufferSize)
+    {
+    }
+
+    virtual bool isKernelQueue() const override
+    {
+        return false;
+    }
+    virtual void submit(QueuedFileRequest * request) override
+    {
+        queueTask(request);
+    }
+};
+
+//---------------------------------------------------------------------------------------------------------------------
+
+#ifdef HAS_IO_URING
+
+// The rings are accessed directly rather than via liburing, so that no extra dependency is required.  Requests are
+// submitted by the calling thread, and a single thread waits for the completions and notifies the owners.
+// If the kernel ever refuses a submission the queue is marked as broken, and all subsequent requests are passed to
+// the io task scheduler instead.
+class CUringFileIOQueue final : public CFileIOQueueBase, implements IThreaded
+{
+public:
+    CUringFileIOQueue(unsigned _numBuffers, size32_t _bufferSize)
+    : CFileIOQueueBase(_numBuffers, _bufferSize), completionThread("FileIOQueue", this)
+    {
+    }
+    ~CUringFileIOQueue()
+    {
+        if (started)
+        {
+            //A nop with no request tells the completion thread to stop.  If it cannot be submitted the thread notices
+            //that it is stopping the next time its wait times out.
+            stopping = true;
+            if (!broken)
+                submitEntry(IORING_OP_NOP, nullptr);
+            completionThread.join();
+        }
+        if (sqes)
+            munmap(sqes, sqesSize);
+        if (cqRing && (cqRing != sqRing))
+            munmap(cqRing, cqRingSize);
+        if (sqRing)
+            munmap(sqRing, sqRingSize);
+        if (ringFd != -1)
+            ::close(ringFd);
+    }
+
+    bool init(unsigned depth)
+    {
+        io_uring_params params;
+        memset(&params, 0, sizeof(params));
+        int fd = (int)syscall(__NR_io_uring_setup, depth, &params);
+        if (fd < 0)
+        {
+            DBGLOG("io_uring is not available (errno %d) - file io will be queued to the io task scheduler", errno);
+            return false;
+        }
+        ringFd = fd;
+        if (!checkSupported())
+            return false;
+
+        sqRingSize = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+        cqRingSize = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+        bool singleMap = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+        if (singleMap)
+            sqRingSize = cqRingSize = std::max(sqRingSize, cqRingSize);
+        sqRing = mapRing(sqRingSize, IORING_OFF_SQ_RING);
+        if (!sqRing)
+            return false;
+        if (singleMap)
+            cqRing = sqRing;
+        else
+        {
+            cqRing = mapRing(cqRingSize, IORING_OFF_CQ_RING);
+            if (!cqRing)
+                return false;
+        }
+        sqesSize = params.sq_entries * sizeof(io_uring_sqe);
+        sqes = (io_uring_sqe *)mapRing(sqesSize, IORING_OFF_SQES);
+        if (!sqes)
+            return false;
+
+        byte * sq = (byte *)sqRing;
+        sqHead = (unsigned *)(sq + params.sq_off.head);
+        sqTail = (unsigned *)(sq + params.sq_off.tail);
+        sqMask = *(unsigned *)(sq + params.sq_off.ring_mask);
+        sqArray = (unsigned *)(sq + params.sq_off.array);
+        byte * cq = (byte *)cqRing;
+        cqHead = (unsigned *)(cq + params.cq_off.head);
+        cqTail = (unsigned *)(cq + params.cq_off.tail);
+        cqMask = *(unsigned *)(cq + params.cq_off.ring_mask);
+        cqes = (io_uring_cqe *)(cq + params.cq_off.cqes);
+
+        //Never have more requests in flight than there is space for their completions
+        freeSlots.signal(std::min(params.sq_entries, params.cq_entries));
+
+        if (numBuffers)
+        {
+            std::vector<iovec> iovecs(numBuffers);
+            for (unsigned i=0; i < numBuffers; i++)
+            {
+                iovecs[i].iov_base = buffers + (memsize_t)i * bufferSize;
+                iovecs[i].iov_len = bufferSize;
+            }
+            //This can fail if the locked memory limit is too low, in which case the buffers are used unregistered
+            if (syscall(__NR_io_uring_register, ringFd, IORING_REGISTER_BUFFERS, iovecs.data(), numBuffers) == 0)
+                fixedBuffers = true;
+            else
+                DBGLOG("Failed to register io_uring buffers (errno %d)", errno);
+        }
+
+        completionThread.start();
+        started = true;
+        return true;
+    }
+
+    virtual bool isKernelQueue() const override
+    {
+        return true;
+    }
+    virtual void submit(QueuedFileRequest * request) override
+    {
+        if (broken)
+        {
+            queueTask(request);
+            return;
+        }
+        unsigned bufferIndex = fixedBuffers ? findBuffer(request->data, request->len) : NotFound;
+        byte opcode;
+        if (bufferIndex != NotFound)
+            opcode = request->isWrite ? IORING_OP_WRITE_FIXED : IORING_OP_READ_FIXED;
+        else
+            opcode = request->isWrite ? IORING_OP_WRITE : IORING_OP_READ;
+        submitEntry(opcode, request, bufferIndex);
+    }
+
+    virtual void threadmain() override
+    {
+        //The completions are read directly from the ring, so rather than io_uring_enter() (which never returns if the
+        //ring fails) wait for the ring to become readable, with a timeout so that a broken queue can still be stopped.
+        pollfd ringPoll;
+        ringPoll.fd = ringFd;
+        ringPoll.events = POLLIN;
+        for (;;)
+        {
+            ringPoll.revents = 0;
+            int ret = ::poll(&ringPoll, 1, 1000);
+            if ((ret < 0) && (errno != EINTR))
+            {
+                OERRLOG("poll failed waiting for io_uring completions (errno %d)", errno);
+                Sleep(10);
+            }
+
+            bool stop = false;
+            unsigned head = *cqHead;
+            unsigned tail = __atomic_load_n(cqTail, __ATOMIC_ACQUIRE);
+            unsigned numCompleted = tail - head;
+            for (; head != tail; head++)
+            {
+                const io_uring_cqe & cqe = cqes[head & cqMask];
+                QueuedFileRequest * request = (QueuedFileRequest *)(memsize_t)cqe.user_data;
+                int result = cqe.res;
+                if (!request)
+                {
+                    stop = true;
+                    continue;
+                }
+                //Requests can be split, e.g. by a signal.  It is rare, so complete the remainder synchronously.
+                if ((result > 0) && ((size32_t)result < request->len))
+                {
+                    int extra = request->owner->doSyncRequest(request->isWrite, request->pos + result, request->len - result, (byte *)request->data + result);
+                    if (extra > 0)
+                        result += extra;
+                }
+                completeRequest(request, result);
+            }
+            __atomic_store_n(cqHead, tail, __ATOMIC_RELEASE);
+            if (numCompleted)
+                freeSlots.signal(numCompleted);
+            if (stop || (stopping && broken))
+                break;
+        }
+    }
+
+protected:
+    bool checkSupported()
+    {
+        //IORING_OP_READ and IORING_OP_WRITE were added in 5.6 - older kernels only support the vectored versions
+        size_t probeSize = sizeof(io_uring_probe) + IORING_OP_LAST * sizeof(io_uring_probe_op);
+        MemoryAttr probeMemory;
+        io_uring_probe * probe = (io_uring_probe *)probeMemory.allocate(probeSize);
+        memset(probe, 0, probeSize);
+        if (syscall(__NR_io_uring_register, ringFd, IORING_REGISTER_PROBE, probe, IORING_OP_LAST) != 0)
+            return false;
+        for (unsigned op : { IORING_OP_READ, IORING_OP_WRITE, IORING_OP_READ_FIXED, IORING_OP_WRITE_FIXED })
+        {
+            if ((op > probe->last_op) || !(probe->ops[op].flags & IO_URING_OP_SUPPORTED))
+            {
+                DBGLOG("io_uring does not support the required operations - file io will be queued to the io task scheduler");
+                return false;
+            }
+        }
+        return true;
+    }
+
+    void * mapRing(size_t size, __u64 offset)
+    {
+        void * ret = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ringFd, offset);
+        if (ret == MAP_FAILED)
+        {
+            DBGLOG("Failed to map io_uring ring (errno %d)", errno);
+            return nullptr;
+        }
+        return ret;
+    }
+
+    void submitEntry(byte opcode, QueuedFileRequest * request, unsigned bufferIndex = NotFound)
+    {
+        freeSlots.wait();
+        std::vector<QueuedFileRequest *> withdrawn;
+        int error = 0;
+        {
+            CriticalBlock block(submitCrit);
+            if (!broken)
+                error = submitLocked(opcode, request, bufferIndex, withdrawn);
+            else
+                withdrawn.push_back(request);
+        }
+        if (withdrawn.empty())
+            return;
+
+        //None of these requests were started, so they can safely be executed by the task scheduler instead
+        if (error)
+            OERRLOG("io_uring_enter failed submitting requests (errno %d) - file io will be queued to the io task scheduler", error);
+        freeSlots.signal(withdrawn.size());
+        for (QueuedFileRequest * cur : withdrawn)
+        {
+            if (cur)
+                queueTask(cur);
+        }
+    }
+
+    // Must be called within submitCrit.  Returns the error if the ring has failed, in which case any entries that the
+    // kernel has not consumed (including this one) are removed from the ring and added to withdrawn.
+    int submitLocked(byte opcode, QueuedFileRequest * request, unsigned bufferIndex, std::vector<QueuedFileRequest *> & withdrawn)
+    {
+        unsigned tail = *sqTail;
+        unsigned index = tail & sqMask;
+        io_uring_sqe * sqe = &sqes[index];
+        memset(sqe, 0, sizeof(*sqe));
+        sqe->opcode = opcode;
+        sqe->user_data = (__u64)(memsize_t)request;
+        if (request)
+        {
+            sqe->fd = request->handle;
+            sqe->off = request->pos;
+            sqe->addr = (__u64)(memsize_t)request->data;
+            sqe->len = request->len;
+            if (bufferIndex != NotFound)
+                sqe->buf_index = bufferIndex;
+        }
+        sqArray[index] = index;
+        unsigned newTail = tail + 1;
+        __atomic_store_n(sqTail, newTail, __ATOMIC_RELEASE);
+
+        for (;;)
+        {
+            unsigned head = __atomic_load_n(sqHead, __ATOMIC_ACQUIRE);
+            unsigned pending = newTail - head;
+            if (pending == 0)
+                return 0;
+            int ret = (int)syscall(__NR_io_uring_enter, ringFd, pending, 0, 0, nullptr, 0);
+            if (ret > 0)
+                continue;
+            if ((ret == 0) || (errno == EAGAIN) || (errno == EBUSY))
+                Sleep(1);
+            else if (errno != EINTR)
+            {
+                //Without SQPOLL the kernel only consumes entries within io_uring_enter(), which is only called with
+                //submitCrit held, so the entries it has not consumed can be removed from the ring.
+                int error = errno;
+                for (unsigned i=head; i != newTail; i++)
+                    withdrawn.push_back((QueuedFileRequest *)(memsize_t)sqes[sqArray[i & sqMask]].user_data);
+                __atomic_store_n(sqTail, head, __ATOMIC_RELEASE);
+                broken = true;
+                return error;
+            }
+        }
+    }
+
+protected:
+    CThreaded completionThread;
+    CriticalSection submitCrit;
+    Semaphore freeSlots;
+    int ringFd = -1;
+    bool started = false;
+    std::atomic<bool> broken{false};
+    std::atomic<bool> stopping{false};
+    bool fixedBuffers = false;
+    void * sqRing = nullptr;
+    void * cqRing = nullptr;
+    size_t sqRingSize = 0;
+    size_t cqRingSize = 0;
+    io_uring_sqe * sqes = nullptr;
+    size_t sqesSize = 0;
+    unsigned * sqHead = nullptr;
+    unsigned * sqTail = nullptr;
+    unsigned * sqArray = nullptr;
+    unsigned sqMask = 0;
+    unsigned * cqHead = nullptr;
+    unsigned * cqTail = nullptr;
+    io_uring_cqe * cqes = nullptr;
+    unsigned cqMask = 0;
+};
+
+#endif
+
+//---------------------------------------------------------------------------------------------------------------------
+
+IFileIOQueue * createFileIOQueue(unsigned depth, unsigned numBuffers, size32_t bufferSize, bool allowKernelQueue)
+{
+#ifdef HAS_IO_URING
+    if (allowKernelQueue)
+    {
+        Owned<CUringFileIOQueue> queue = new CUringFileIOQueue(numBuffers, bufferSize);
+        if (queue->init(depth))
+            return queue.getClear();
+    }
+#endif
+    return new CTaskFileIOQueue(numBuffers, bufferSize);
+}
+
+static std::atomic<bool> queuedFileIOEnabled{false};
+static unsigned queuedFileIOCBId = 0;
+static CriticalSection defaultQueueCrit;
+static IFileIOQueue * defaultQueue = nullptr;
+
+MODULE_INIT(INIT_PRIORITY_STANDARD)
+{
+    auto updateFunc = [&](const IPropertyTree *oldComponentConfiguration, const IPropertyTree *oldGlobalConfiguration)
+    {
+        queuedFileIOEnabled = getExpertOptBool("useIoUring", false);
+    };
+    queuedFileIOCBId = installConfigUpdateHook(updateFunc, true);
+    return true;
+}
+
+MODULE_EXIT()
+{
+    removeConfigUpdateHook(queuedFileIOCBId);
+    ::Release(defaultQueue);
+}
+
+bool useQueuedFileIO()
+{
+    return queuedFileIOEnabled;
+}
+
+IFileIOQueue & queryFileIOQueue()
+{
+    CriticalBlock block(defaultQueueCrit);
+    if (!defaultQueue)
+    {
+        unsigned depth = (unsigned)getExpertOptInt64("ioUringQueueDepth", 128);
+        unsigned numBuffers = (unsigned)getExpertOptInt64("ioUringBuffers", 64);
+        size32_t bufferSize = (size32_t)getExpertOptInt64("ioUringBufferSize", 0x10000);
+        defaultQueue = createFileIOQueue(depth, numBuffers, bufferSize);
+    }
+    return *defaultQueue;
+}
+
+IQueuedFileIO * createQueuedFileIO(HANDLE handle, IFOmode mode, IFSHmode sharemode, IFEflags extraFlags, IFileIOQueue * queue)
+{
+    if (!queue)
+        queue = &queryFileIOQueue();
+    CFileIOQueueBase * queueBase = dynamic_cast<CFileIOQueueBase *>(queue);
+    assertex(queueBase);
+    return new CQueuedFileIO(handle, mode, sharemode, extraFlags, *queueBase);
+}
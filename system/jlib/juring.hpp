@@ -0,0 +1,70 @@
+/*##############################################################################
+
+    HPCC SYSTEMS software Copyright (C) 2024 HPCC Systems®.
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+############################################################################## */
+
+#ifndef JURING_INCL
+#define JURING_INCL
+
+#include "jfile.hpp"
+
+// Offsets, lengths and buffers used for reads from a file opened with IFEdirect must be multiples of this
+constexpr size32_t directIOAlignment = 4096;
+
+// Notified when a queued read or write completes.  It is called on a thread owned by the queue, so it should not
+// block.  result is the number of bytes transferred, or a negative errno value if the request failed.
+interface IFileIOCompletion
+{
+    virtual void onFileIOComplete(int result) = 0;
+};
+
+// A queue that local file requests are submitted to.  On linux this is an io_uring if the kernel supports it,
+// otherwise the requests are executed by the io task scheduler.
+//
+// The queue also owns a set of aligned buffers.  With io_uring they are registered with the kernel, which avoids
+// mapping the pages on each request.  Reads and writes that lie within one of these buffers use them automatically.
+interface IFileIOQueue : extends IInterface
+{
+    virtual bool isKernelQueue() const = 0;
+    virtual size32_t queryBufferSize() const = 0;
+    virtual void * allocateBuffer() = 0;                // returns nullptr if all the buffers are in use
+    virtual void releaseBuffer(void * buffer) = 0;
+};
+
+// An IFileIO for a local file that also allows reads and writes to be queued.  The data must remain valid, and the
+// file must not be closed, until the completion has been notified.  If the file was opened with IFEdirect then
+// queued requests must be aligned to directIOAlignment - unaligned requests are executed synchronously.
+interface IQueuedFileIO : extends IFileIO
+{
+    virtual void queueRead(offset_t pos, size32_t len, void * data, IFileIOCompletion & completion) = 0;
+    virtual void queueWrite(offset_t pos, size32_t len, const void * data, IFileIOCompletion & completion) = 0;
+    virtual IFileIOQueue & queryQueue() = 0;
+};
+
+// Controlled by the expert options useIoUring, ioUringQueueDepth, ioUringBuffers and ioUringBufferSize
+extern jlib_decl bool useQueuedFileIO();
+extern jlib_decl IFileIOQueue & queryFileIOQueue();
+extern jlib_decl IFileIOQueue * createFileIOQueue(unsigned depth, unsigned numBuffers, size32_t bufferSize, bool allowKernelQueue = true);
+
+// Takes ownership of the handle
+extern jlib_decl IQueuedFileIO * createQueuedFileIO(HANDLE handle, IFOmode mode, IFSHmode sharemode, IFEflags extraFlags, IFileIOQueue * queue = nullptr);
+
+// Open a local file using a particular queue.  Returns nullptr if the file is not local, or does not exist.
+extern jlib_decl IQueuedFileIO * openQueuedFileIO(IFile * file, IFOmode mode, IFEflags extraFlags = IFEnone, IFileIOQueue * queue = nullptr);
+
+// Read a file sequentially, keeping numAhead blocks queued in advance of the current position
+extern jlib_decl ISerialStream * createQueuedFileSerialStream(IQueuedFileIO * fileio, offset_t ofs, offset_t flen, size32_t bufsize, unsigned numAhead, IFileSerialStreamCallback * callback = nullptr);
+
+#endif
@@ -0,0 +1,391 @@
+/*##############################################################################
+
+    HPCC SYSTEMS software Copyright (C) 2024 HPCC Systems®.
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+############################################################################## */
+
+#include "platform.h"
+#include <map>
+#include <vector>
+#include "jmutex.hpp"
+#include "jfcmp.hpp"
+#include "jzstd.hpp"
+#include "zstd.h"
+#include "zdict.h"
+
+/* Format (the same as lz4):
+    size32_t totalexpsize;
+    { size32_t subcmpsize; bytes subcmpdata; }
+    size32_t trailsize; bytes traildata;    // unexpanded
+*/
+
+class CZStdDictionary final : public CSimpleInterfaceOf<IZStdDictionary>
+{
+public:
+    CZStdDictionary(size32_t len, const void * data)
+    {
+        dict.set(len, data);
+        dictId = ZDICT_getDictID(data, len);
+    }
+    ~CZStdDictionary()
+    {
+        for (auto & cur : cdicts)
+            ZSTD_freeCDict(cur.second);
+        ZSTD_freeDDict(ddict);
+    }
+
+    virtual unsigned queryId() const override { return dictId; }
+    virtual size32_t querySize() const override { return dict.length(); }
+    virtual const void * queryData() const override { return dict.get(); }
+
+    //Digesting the dictionary is relatively expensive, so it is done once for each compression level that is used.
+    //Negative (fast) levels are all distinct, so the digests are keyed by the actual level rather than a clamped index.
+    const ZSTD_CDict * queryCDict(int level)
+    {
+        if (level == 0)
+            level = ZSTD_CLEVEL_DEFAULT;
+        else if (level > ZSTD_maxCLevel())
+            level = ZSTD_maxCLevel();
+        CriticalBlock block(cs);
+        ZSTD_CDict * & cdict = cdicts[level];
+        if (!cdict)
+        {
+            cdict = ZSTD_createCDict(dict.get(), dict.length(), level);
+            if (!cdict)
+            {
+                cdicts.erase(level);
+                throw makeStringException(0, "ZStd - failed to load dictionary");
+            }
+        }
+        return cdict;
+    }
+    const ZSTD_DDict * queryDDict()
+    {
+        CriticalBlock block(cs);
+        if (!ddict)
+        {
+            ddict = ZSTD_createDDict(dict.get(), dict.length());
+            if (!ddict)
+                throw makeStringException(0, "ZStd - failed to load dictionary");
+        }
+        return ddict;
+    }
+
+protected:
+    CriticalSection cs;
+    MemoryAttr dict;
+    unsigned dictId = 0;
+    std::map<int, ZSTD_CDict *> cdicts;
+    ZSTD_DDict * ddict = nullptr;
+};
+
+//---------------------------------------------------------------------------------------------------------------------
+
+class CZStdCompressor final : public CFcmpCompressor
+{
+    int level = ZSTD_CLEVEL_DEFAULT;
+    ZSTD_CCtx * cctx = nullptr;
+    Linked<CZStdDictionary> dictionary;
+
+protected:
+    size32_t compressData(size32_t destSize, void * dest, size32_t srcSize, const void * src)
+    {
+        size_t compressedSize;
+        if (dictionary)
+            compressedSize = ZSTD_compress_usingCDict(cctx, dest, destSize, src, srcSize, dictionary->queryCDict(level));
+        else
+            compressedSize = ZSTD_compressCCtx(cctx, dest, destSize, src, srcSize, level);
+        if (ZSTD_isError(compressedSize))
+            return 0;
+        return (size32_t)compressedSize;
+    }
+
+    virtual void setinmax() override
+    {
+        inmax = blksz-outlen-sizeof(size32_t);
+        if (inmax<256)
+            trailing = true;    // too small to bother compressing
+        else
+        {
+            trailing = false;
+            size32_t slack = ZSTD_compressBound(inmax) - inmax;
+            int inmax2 = inmax - (slack + sizeof(size32_t));
+            if (inmax2<256)
+                trailing = true;
+            else
+                inmax = inmax2;
+        }
+    }
+
+    virtual bool adjustLimit(size32_t newLimit) override
+    {
+        assertex(bufalloc == 0 && !outBufMb);       // Only supported when a fixed size buffer is provided
+        assertex(inlenblk == COMMITTED);            // not inside a transaction
+        assertex(newLimit <= originalMax);
+
+        //Reject the limit change if it is too small for the data already committed.
+        if (newLimit < ZSTD_compressBound(inlen) + outlen + sizeof(size32_t))
+            return false;
+
+        blksz = newLimit;
+        setinmax();
+        return true;
+    }
+
+    virtual void flushcommitted() override
+    {
+        // only does non trailing
+        if (trailing)
+            return;
+        size32_t toflush = (inlenblk==COMMITTED)?inlen:inlenblk;
+        if (toflush == 0)
+            return;
+
+        if (toflush < 256)
+        {
+            trailing = true;
+            return;
+        }
+
+        size32_t maxCompressed = ZSTD_compressBound(toflush);
+        size32_t outSzRequired = outlen+sizeof(size32_t)*2+maxCompressed;
+        if (!dynamicOutSz)
+            assertex(outSzRequired<=blksz);
+        else
+        {
+            if (outSzRequired>dynamicOutSz)
+            {
+                verifyex(outBufMb->ensureCapacity(outBufStart+outSzRequired));
+                dynamicOutSz = outBufMb->capacity();
+                outbuf = ((byte *)outBufMb->bufferBase()+outBufStart);
+            }
+        }
+        size32_t *cmpsize = (size32_t *)(outbuf+outlen);
+        byte *out = (byte *)(cmpsize+1);
+
+        *cmpsize = compressData(maxCompressed, out, toflush, inbuf);
+        if (*cmpsize && *cmpsize<toflush)
+        {
+            *(size32_t *)outbuf += toflush;
+            outlen += *cmpsize+sizeof(size32_t);
+            if (inlenblk==COMMITTED)
+                inlen = 0;
+            else
+            {
+                inlen -= inlenblk;
+                memmove(inbuf,inbuf+toflush,inlen);
+            }
+            setinmax();
+            return;
+        }
+        trailing = true;
+    }
+
+    size32_t buflen() override
+    {
+        if (inbuf)
+        {
+            //calling flushcommitted() would mean everything is serialized as trailing
+            size32_t toflush = (inlenblk==COMMITTED)?inlen:inlenblk;
+            return outlen+sizeof(size32_t)*2+ZSTD_compressBound(toflush);
+        }
+        return outlen;
+    }
+
+    virtual bool supportsBlockCompression() const override { return true; }
+    virtual bool supportsIncrementalCompression() const override { return false; }
+
+    virtual size32_t compressBlock(size32_t destSize, void * dest, size32_t srcSize, const void * src) override
+    {
+        if (destSize <= 3 * sizeof(size32_t))
+            return 0;
+
+        //See the lz4 compressor - the trailing uncompressed size is always 0
+        size32_t * ptrUnSize = (size32_t *)dest;
+        size32_t * ptrCmpSize = ptrUnSize+1;
+        byte * remaining = (byte *)(ptrCmpSize+1);
+        size32_t remainingSize = destSize - 3 * sizeof(size32_t);
+        size32_t compressedSize = compressData(remainingSize, remaining, srcSize, src);
+        if ((compressedSize == 0) || (compressedSize + sizeof(size32_t) > remainingSize))
+            return 0;
+
+        *ptrUnSize = srcSize;
+        *ptrCmpSize = compressedSize;
+        *(size32_t *)(remaining + compressedSize) = 0;
+
+        return compressedSize + 3 * sizeof(size32_t);
+    }
+
+    virtual CompressionMethod getCompressionMethod() const override { return COMPRESS_METHOD_ZSTD; }
+
+public:
+    CZStdCompressor(const char * options, IZStdDictionary * _dictionary) : dictionary(static_cast<CZStdDictionary *>(_dictionary))
+    {
+        auto processOption = [this](const char * option, const char * value)
+        {
+            if (strieq(option, "level"))
+                level = atoi(value);
+        };
+        processOptionString(options, processOption);
+        cctx = ZSTD_createCCtx();
+        if (!cctx)
+            throw makeStringException(0, "ZStdCompressor - failed to create context");
+    }
+    ~CZStdCompressor()
+    {
+        ZSTD_freeCCtx(cctx);
+    }
+};
+
+
+class CZStdExpander final : public CFcmpExpander
+{
+    size32_t totalExpanded = 0;
+    ZSTD_DCtx * dctx = nullptr;
+    Linked<CZStdDictionary> dictionary;
+
+    size32_t expandData(size32_t destSize, void * dest, size32_t srcSize, const void * src)
+    {
+        size_t expandedSize;
+        if (dictionary)
+            expandedSize = ZSTD_decompress_usingDDict(dctx, dest, destSize, src, srcSize, dictionary->queryDDict());
+        else
+            expandedSize = ZSTD_decompressDCtx(dctx, dest, destSize, src, srcSize);
+        if (ZSTD_isError(expandedSize))
+            throw makeStringExceptionV(0, "ZStdExpander - corrupt data: %s", ZSTD_getErrorName(expandedSize));
+        return (size32_t)expandedSize;
+    }
+
+public:
+    CZStdExpander(IZStdDictionary * _dictionary) : dictionary(static_cast<CZStdDictionary *>(_dictionary))
+    {
+        dctx = ZSTD_createDCtx();
+        if (!dctx)
+            throw makeStringException(0, "ZStdExpander - failed to create context");
+    }
+    ~CZStdExpander()
+    {
+        ZSTD_freeDCtx(dctx);
+    }
+
+    virtual void expand(void *buf) override
+    {
+        if (!outlen)
+            return;
+        if (buf)
+        {
+            if (bufalloc)
+                free(outbuf);
+            bufalloc = 0;
+            outbuf = (unsigned char *)buf;
+        }
+        else if (outlen>bufalloc)
+        {
+            if (bufalloc)
+                free(outbuf);
+            bufalloc = outlen;
+            outbuf = (unsigned char *)malloc(bufalloc);
+            if (!outbuf)
+                throw MakeStringException(MSGAUD_operator,0, "Out of memory in ZStdExpander::expand, requesting %d bytes", bufalloc);
+        }
+        size32_t done = 0;
+        for (;;)
+        {
+            const size32_t szchunk = *in;
+            in++;
+            if (szchunk+done<outlen)
+            {
+                size32_t written = expandData(outlen-done, outbuf+done, szchunk, in);
+                done += written;
+                if (!written||(done>outlen))
+                    throw MakeStringException(0, "ZStdExpander - corrupt data(1) %d %d",written,szchunk);
+            }
+            else
+            {
+                if (szchunk+done!=outlen)
+                    throw MakeStringException(0, "ZStdExpander - corrupt data(2) %d %d",szchunk,outlen);
+                memcpy(outbuf+done,in,szchunk);
+                break;
+            }
+            in = (const size32_t *)(((const byte *)in)+szchunk);
+        }
+    }
+
+    virtual size32_t expandFirst(MemoryBuffer & target, const void * src) override
+    {
+        init(src);
+        totalExpanded = 0;
+        return expandNext(target);
+    }
+
+    virtual size32_t expandNext(MemoryBuffer & target) override
+    {
+        if (totalExpanded == outlen)
+            return 0;
+
+        const size32_t szchunk = *in;
+        in++;
+
+        target.clear();
+        size32_t written;
+        if (szchunk+totalExpanded<outlen)
+        {
+            //Unlike lz4 the expanded size of each compressed block is recorded in the frame header
+            unsigned long long expandedSize = ZSTD_getFrameContentSize(in, szchunk);
+            if ((expandedSize == ZSTD_CONTENTSIZE_UNKNOWN) || (expandedSize == ZSTD_CONTENTSIZE_ERROR) || (expandedSize > outlen - totalExpanded))
+                throw MakeStringException(0, "ZStdExpander - corrupt data(3) %d", szchunk);
+            written = expandData((size32_t)expandedSize, target.reserveTruncate((size32_t)expandedSize), szchunk, in);
+            target.setLength(written);
+        }
+        else
+        {
+            void * buf = target.reserve(szchunk);
+            written = szchunk;
+            memcpy(buf,in,szchunk);
+        }
+
+        in = (const size32_t *)(((const byte *)in)+szchunk);
+        totalExpanded += written;
+        if (totalExpanded > outlen)
+            throw MakeStringException(0, "ZStdExpander - corrupt data(4) %d %d",written,szchunk);
+        return written;
+    }
+};
+
+//---------------------------------------------------------------------------------------------------------------------
+
+IZStdDictionary *createZStdDictionary(size32_t len, const void * data)
+{
+    return new CZStdDictionary(len, data);
+}
+
+IZStdDictionary *trainZStdDictionary(size32_t maxDictSize, unsigned numSamples, const void * samples, const size32_t * sampleSizes)
+{
+    std::vector<size_t> sizes(sampleSizes, sampleSizes + numSamples);
+    MemoryAttr dict(maxDictSize);
+    size_t dictSize = ZDICT_trainFromBuffer(dict.bufferBase(), maxDictSize, samples, sizes.data(), numSamples);
+    if (ZDICT_isError(dictSize))
+        throw makeStringExceptionV(0, "ZStd - failed to train dictionary: %s", ZDICT_getErrorName(dictSize));
+    return new CZStdDictionary((size32_t)dictSize, dict.get());
+}
+
+ICompressor *createZStdCompressor(const char * options, IZStdDictionary * dictionary)
+{
+    return new CZStdCompressor(options, dictionary);
+}
+
+IExpander *createZStdExpander(IZStdDictionary * dictionary)
+{
+    return new CZStdExpander(dictionary);
+}
@@ -0,0 +1,43 @@
+/*##############################################################################
+
+    HPCC SYSTEMS software Copyright (C) 2024 HPCC Systems®.
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+############################################################################## */
+
+#ifndef JZSTD_INCL
+#define JZSTD_INCL
+
+#include "jlzw.hpp"
+
+#define ZSTDCOMPRESSEDFILEBLOCKSIZE (0x100000)
+
+// A dictionary trained on samples of the data being compressed.  It significantly improves the compression of small
+// blocks (e.g. index nodes and network packets).  The same dictionary must be supplied to the expander - the id of
+// the dictionary is recorded in the compressed data, and an expander with a different dictionary will throw an error.
+interface IZStdDictionary : extends IInterface
+{
+    virtual unsigned queryId() const = 0;
+    virtual size32_t querySize() const = 0;
+    virtual const void * queryData() const = 0;
+};
+
+extern jlib_decl IZStdDictionary *createZStdDictionary(size32_t len, const void * data);
+// samples is the concatenation of numSamples samples, whose lengths are given by sampleSizes.
+extern jlib_decl IZStdDictionary *trainZStdDictionary(size32_t maxDictSize, unsigned numSamples, const void * samples, const size32_t * sampleSizes);
+
+// options is a comma separated list of name=value pairs.  "level" sets the compression level (default 3).
+extern jlib_decl ICompressor *createZStdCompressor(const char * options, IZStdDictionary * dictionary = nullptr);
+extern jlib_decl IExpander   *createZStdExpander(IZStdDictionary * dictionary = nullptr);
+
+#endif
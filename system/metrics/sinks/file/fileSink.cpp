@@ -98,6 +98,11 @@ void FileMetricSink::writeMeasurementToFile(const std::shared_ptr<IMetric> &pMet
         // count - total of all bucket counts (same as inf)
         fprintf(fhandle, "name=%s, count=%" I64F "d\n", name.c_str(), cumulative);
 
+        // percentiles - only available for some histogram types
+        for (auto &percentile: pMetric->queryHistogramPercentiles())
+        {
+            fprintf(fhandle, "name=%s, p%g=%" I64F "d\n", name.c_str(), percentile.percentile, percentile.value);
+        }
     }
     fflush(fhandle);
 }
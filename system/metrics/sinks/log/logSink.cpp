@@ -85,5 +85,11 @@ void LogMetricSink::writeLogEntry(const std::shared_ptr<IMetric> &pMetric)
 
         // count - total of all bucket counts (same as inf)
         LOG(MCoperatorMetric, "name=%s, count=%" I64F "d", name.c_str(), cumulative);
+
+        // percentiles - only available for some histogram types
+        for (auto &percentile: pMetric->queryHistogramPercentiles())
+        {
+            LOG(MCoperatorMetric, "name=%s, p%g=%" I64F "d", name.c_str(), percentile.percentile, percentile.value);
+        }
     }
 }
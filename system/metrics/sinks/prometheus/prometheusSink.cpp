@@ -130,6 +130,7 @@ void PrometheusMetricSink::toPrometheusMetrics(const std::vector<std::shared_ptr
         if (metricType == hpccMetrics::METRICS_HISTOGRAM)
         {
             toPrometheusHistogram(metricName, pMetric, out);
+            toPrometheusQuantiles(metricName, pMetric, out, verbose);
         }
         else
         {
@@ -138,16 +139,7 @@ void PrometheusMetricSink::toPrometheusMetrics(const std::vector<std::shared_ptr
             if (!metaData.empty())
             {
                 out.append(" {");
-                bool firstEntry = true;
-                for (auto &metaDataIt: metaData)
-                {
-                    if (!firstEntry)
-                        out.append(",");
-                    else
-                        firstEntry = false;
-
-                    out.append(metaDataIt.key.c_str()).append("=\"").append(metaDataIt.value.c_str()).append("\"");
-                }
+                appendMetaDataLabels(metaData, out);
                 out.append("}");
             }
             out.append(" ").append(pMetric->queryValue()).append("\n");
@@ -155,6 +147,20 @@ void PrometheusMetricSink::toPrometheusMetrics(const std::vector<std::shared_ptr
     }
 }
 
+void PrometheusMetricSink::appendMetaDataLabels(const MetricMetaData &metaData, StringBuffer & out)
+{
+    bool firstEntry = true;
+    for (auto &metaDataIt: metaData)
+    {
+        if (!firstEntry)
+            out.append(",");
+        else
+            firstEntry = false;
+
+        out.append(metaDataIt.key.c_str()).append("=\"").append(metaDataIt.value.c_str()).append("\"");
+    }
+}
+
 void PrometheusMetricSink::toPrometheusHistogram(const std::string &name, const std::shared_ptr<IMetric> &pHistogram, StringBuffer & out)
 {
     auto labels = getHistogramLabels(name, pHistogram);
@@ -176,6 +182,42 @@ void PrometheusMetricSink::toPrometheusHistogram(const std::string &name, const
     out.append(labels[cumulativeCountLabelIndex].c_str()).append(" ").append(cumulativeBucketCount).append("\n");
 }
 
+// A histogram cannot also have quantiles, so the percentiles (if available) are reported as a separate gauge family,
+// with the histogram's labels, and time values in seconds to match its buckets.
+void PrometheusMetricSink::toPrometheusQuantiles(const std::string &name, const std::shared_ptr<IMetric> &pHistogram, StringBuffer & out, bool verbose)
+{
+    auto percentiles = pHistogram->queryHistogramPercentiles();
+    if (percentiles.empty())
+        return;
+
+    std::string quantileName(name);
+    quantileName.append("_quantile");
+    if (verbose)
+    {
+        if (!pHistogram->queryDescription().empty())
+            out.append("# HELP ").append(quantileName.c_str()).append(" ").append(pHistogram->queryDescription().c_str()).append(" (quantiles)\n");
+        out.append("# TYPE ").append(quantileName.c_str()).append(" gauge\n");
+    }
+
+    const auto &metaData = pHistogram->queryMetaData();
+    bool isTime = (pHistogram->queryUnits() == SMeasureTimeNs);
+    for (auto const &percentile: percentiles)
+    {
+        out.append(quantileName.c_str()).append("{");
+        if (!metaData.empty())
+        {
+            appendMetaDataLabels(metaData, out);
+            out.append(",");
+        }
+        out.appendf("quantile=\"%g\"} ", percentile.percentile / 100.0);
+        if (isTime)
+            out.append((double)percentile.value / 1000000000.0);
+        else
+            out.append(percentile.value);
+        out.append("\n");
+    }
+}
+
 
 std::string PrometheusMetricSink::getPrometheusMetricName(const std::shared_ptr<IMetric> &pMetric)
 {
@@ -105,6 +105,8 @@ protected:
     static std::string getPrometheusMetricUnits(const std::shared_ptr<IMetric> &pMetric);
 
     static void toPrometheusHistogram(const std::string &name, const std::shared_ptr<IMetric> &, StringBuffer & out);
+    static void toPrometheusQuantiles(const std::string &name, const std::shared_ptr<IMetric> &, StringBuffer & out, bool verbose);
+    static void appendMetaDataLabels(const MetricMetaData &metaData, StringBuffer & out);
     static const std::vector<std::string> &getHistogramLabels(const std::string &name, const std::shared_ptr<IMetric> &pHistogram);
 };
 
@@ -807,6 +807,7 @@ class CDaliSDSStressTests : public CppUnit::TestFixture
         CPPUNIT_TEST(testSDSSubs2);
         CPPUNIT_TEST(testSDSNodeSubs);
         CPPUNIT_TEST(testEphemeralLocks);
+        CPPUNIT_TEST(testBranchCommits);
         CPPUNIT_TEST(testSiblingPerfLocal);
         CPPUNIT_TEST(testSiblingPerfDali);
         CPPUNIT_TEST(testSiblingPerfContention);
@@ -1462,6 +1463,55 @@ public:
         for (auto &f: results)
             f.get();
     }
+    void testBranchCommits()
+    {
+        // Concurrent commits within branches that the server locks independently (and one that it does not),
+        // whilst other threads read the whole store.
+        const char *branches[] = { "/WorkUnits", "/Files", "/Queues", "/TestBranchCommits" };
+        unsigned numBranches = sizeof(branches)/sizeof(branches[0]);
+        unsigned writersPerBranch = 4;
+        unsigned numCommits = 20;
+        unsigned numReaders = 4;
+        std::atomic<unsigned> writersRunning{numBranches*writersPerBranch};
+
+        auto writeFunc = [&](const char *branch, unsigned w)
+        {
+            COnScopeExit decOnExit([&](){ writersRunning--; }); // even if failed, so that the readers finish
+            VStringBuffer xpath("%s/TestBranchCommits%u", branch, w);
+            VStringBuffer countXPath("%s/Commit", xpath.str());
+            Owned<IRemoteConnection> conn = querySDS().connect(xpath, myProcessSession(), RTM_CREATE|RTM_LOCK_WRITE|RTM_DELETE_ON_DISCONNECT, 10000);
+            for (unsigned c=0; c<numCommits; c++)
+            {
+                conn->queryRoot()->addPropTree("Commit")->setPropInt("@n", c);
+                conn->commit();
+                CPPUNIT_ASSERT_EQUAL(c+1, querySDS().queryCount(countXPath));
+            }
+            conn.clear();
+            CPPUNIT_ASSERT_EQUAL(0U, querySDS().queryCount(xpath));
+        };
+        auto readFunc = [&]()
+        {
+            while (writersRunning)
+            {
+                Owned<IRemoteConnection> conn = querySDS().connect("/", myProcessSession(), 0, 10000);
+                CPPUNIT_ASSERT(conn);
+                querySDS().queryCount("/*/TestBranchCommits*");
+            }
+        };
+
+        std::vector<std::future<void>> results;
+        for (unsigned r=0; r<numReaders; r++)
+            results.push_back(std::async(std::launch::async, readFunc));
+        for (unsigned b=0; b<numBranches; b++)
+        {
+            for (unsigned w=0; w<writersPerBranch; w++)
+                results.push_back(std::async(std::launch::async, writeFunc, branches[b], w));
+        }
+        for (auto &f: results)
+            f.get();
+
+        Owned<IRemoteConnection> conn = querySDS().connect("/TestBranchCommits", myProcessSession(), RTM_DELETE_ON_DISCONNECT, 10000);
+    }
     void createLevel(IPropertyTree *parent, unsigned nodeSiblings, unsigned leafSiblings, unsigned attributes, unsigned depth, unsigned level)
     {
         StringBuffer aname;
@@ -2732,8 +2782,62 @@ class CDaliUtils : public CppUnit::TestFixture
 {
     CPPUNIT_TEST_SUITE(CDaliUtils);
       CPPUNIT_TEST(testDFSLfn);
+      CPPUNIT_TEST(testBinaryStore);
     CPPUNIT_TEST_SUITE_END();
 public:
+    void testBinaryStore()
+    {
+        Owned<IPropertyTree> root = createPTree("SDS");
+        IPropertyTree *wus = root->addPropTree("WorkUnits");
+        for (unsigned i=0; i<5000; i++)
+        {
+            VStringBuffer wuid("W20240101-%06u", i);
+            IPropertyTree *wu = wus->addPropTree(wuid);
+            wu->setProp("@state", (i % 2) ? "completed" : "failed");
+            wu->setPropInt("Statistics/Statistic/@value", i);
+            wu->addProp("Results/Result", "a");
+            wu->addProp("Results/Result", "b");
+        }
+        root->addPropTree("Files")->setProp("Scope/@name", "scope1");
+        root->addPropTree("Empty");
+        root->setProp("Status/@value", "binary");
+
+        const char *filename = "dalitests_store.bin";
+        saveStoreFile(root, filename, true);
+        CPPUNIT_ASSERT(isBinaryStoreFile(filename));
+        Owned<IPropertyTree> loaded = loadStoreFile(filename);
+        CPPUNIT_ASSERT(areMatchingPTrees(root, loaded));
+
+        // corrupt a byte in the middle of the chunk data
+        OwnedIFile iFile = createIFile(filename);
+        {
+            OwnedIFileIO iFileIO = iFile->open(IFOreadwrite);
+            char c;
+            offset_t pos = iFileIO->size()/2;
+            iFileIO->read(pos, 1, &c);
+            c ^= 0xff;
+            iFileIO->write(pos, 1, &c);
+        }
+        bool failed = false;
+        try
+        {
+            loaded.setown(loadStoreFile(filename));
+        }
+        catch (IException *e)
+        {
+            e->Release();
+            failed = true;
+        }
+        CPPUNIT_ASSERT(failed);
+        iFile->remove();
+
+        const char *xmlFilename = "dalitests_store.xml";
+        saveStoreFile(root, xmlFilename, false);
+        CPPUNIT_ASSERT(!isBinaryStoreFile(xmlFilename));
+        loaded.setown(loadStoreFile(xmlFilename));
+        CPPUNIT_ASSERT(areMatchingPTrees(root, loaded));
+        removeFileTraceIfFail(xmlFilename);
+    }
     void testDFSLfn()
     {
         const char *lfns[] = { "~foreign::192.168.16.1::scope1::file1",
@@ -30,6 +30,9 @@
 #include "jset.hpp"
 #include "rmtfile.hpp"
 #include "jlzw.hpp"
+#include "jzstd.hpp"
+#include "juring.hpp"
+#include "jcomp.hpp"
 #include "jqueue.hpp"
 #include "jregexp.hpp"
 #include "jutil.hpp"
@@ -2755,6 +2758,414 @@ Nothing_toEncodeHere:
 CPPUNIT_TEST_SUITE_REGISTRATION(JlibIPTTest);
 CPPUNIT_TEST_SUITE_NAMED_REGISTRATION(JlibIPTTest, "JlibIPTTest");
 
+class JlibPTreeReaderBase : public CppUnit::TestFixture
+{
+protected:
+    // Returns data in small, irregular chunks so the reader has to refill its buffer in the middle of tokens
+    class CChunkedReadStream : public CSimpleInterfaceOf<ISimpleReadStream>
+    {
+        const char *data;
+        size32_t remaining;
+        unsigned next = 0;
+    public:
+        CChunkedReadStream(size32_t len, const char *_data) : data(_data), remaining(len) {}
+        virtual size32_t read(size32_t max_len, void * dst) override
+        {
+            size32_t len = 1 + (next++ % 37);
+            if (len > max_len)
+                len = max_len;
+            if (len > remaining)
+                len = remaining;
+            memcpy(dst, data, len);
+            data += len;
+            remaining -= len;
+            return len;
+        }
+    };
+
+    // Something that looks like a workunit - long ECL text with escaped markup, quoted attributes and results
+    static void generateWorkunitXML(StringBuffer &xml, unsigned numGraphs)
+    {
+        xml.append("<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n");
+        xml.append("<W20261017-120000 clusterName=\"thor\" state=\"completed\" jobName='a \"quoted\" job'>\n");
+        xml.append(" <Query fetchEntire=\"1\">\n  <Text>");
+        for (unsigned i=0; i < numGraphs; i++)
+            xml.appendf("r%u := RECORD\n  STRING20 name;\n  UNSIGNED4 id;\nEND;\nds%u := DATASET([{'x&amp;y', %u}], r%u)(id &lt; 10 AND name != &apos;&apos;);\nOUTPUT(ds%u);\n", i, i, i, i, i);
+        xml.append("</Text>\n </Query>\n <Graphs>\n");
+        for (unsigned i=0; i < numGraphs; i++)
+        {
+            xml.appendf("  <Graph name=\"graph%u\" type=\"activities\">\n   <xgmml>\n    <graph>\n", i+1);
+            for (unsigned n=0; n < 8; n++)
+            {
+                xml.appendf("     <node id=\"%u\" label='Disk Read&#10;&apos;~file::%u&apos;'>\n", n+1, n);
+                xml.appendf("      <att name=\"definition\" value=\"./stress.ecl(%u,%u)\"/>\n", i, n);
+                xml.appendf("      <att name=\"ecl\" value=\"DATASET(&apos;~file%u&apos;, r, THOR) &gt; 0;&#10;\"/>\n", n);
+                xml.append("     </node>\n");
+            }
+            xml.append("    </graph>\n   </xgmml>\n  </Graph>\n");
+        }
+        xml.append(" </Graphs>\n <Results>\n");
+        for (unsigned i=0; i < numGraphs; i++)
+            xml.appendf("  <Result name=\"Result %u\" sequence=\"%u\" status=\"calculated\"><Value>  value %u\twith  whitespace </Value><![CDATA[<raw & ]]></Result>\n", i+1, i, i);
+        xml.append(" </Results>\n <Statistics utf8=\"\xc3\xa9t\xc3\xa9\"/>\n</W20261017-120000>\n");
+    }
+
+    // Something that looks like the /Files branch of the dali store
+    static void generateStoreXML(StringBuffer &xml, unsigned numFiles)
+    {
+        xml.append("<Files>\n <Scope name=\"regress\">\n");
+        for (unsigned i=0; i < numFiles; i++)
+        {
+            xml.appendf("  <File group=\"mythor\" modified=\"2026-10-17T12:00:%02u\" name=\"file%u\" numparts=\"4\" partmask=\"file%u._$P$_of_4\">\n", i % 60, i, i);
+            xml.appendf("   <Attr job=\"W20261017-120000\" owner=\"regress\" recordCount=\"%u\" size=\"%u\"><ECL>RECORD&#10; string20 name;&#10;END;&#10;</ECL></Attr>\n", i*10, i*200);
+            for (unsigned p=0; p < 4; p++)
+                xml.appendf("   <Part node=\"10.0.0.%u\" num=\"%u\" size=\"%u\"/>\n", p+1, p+1, i*50);
+            xml.append("  </File>\n");
+        }
+        xml.append(" </Scope>\n</Files>\n");
+    }
+};
+
+class JlibPTreeReaderTest : public JlibPTreeReaderBase
+{
+    CPPUNIT_TEST_SUITE(JlibPTreeReaderTest);
+        CPPUNIT_TEST(testXMLReaders);
+        CPPUNIT_TEST(testJSONReaders);
+        CPPUNIT_TEST(testErrorContext);
+    CPPUNIT_TEST_SUITE_END();
+
+    void checkXMLReaders(const char *xml, PTreeReaderOptions readFlags)
+    {
+        // The string, buffer and stream readers share the tokenizer but scan their input differently
+        StringBuffer fromString, fromBuffer, fromStream;
+        Owned<IPropertyTree> stringTree = createPTreeFromXMLString(xml, ipt_none, readFlags);
+        toXML(stringTree, fromString);
+        Owned<IPropertyTree> bufferTree = createPTreeFromXMLString(strlen(xml), xml, ipt_none, readFlags);
+        toXML(bufferTree, fromBuffer);
+        CChunkedReadStream stream(strlen(xml), xml);
+        Owned<IPropertyTree> streamTree = createPTree(stream, ipt_none, readFlags);
+        toXML(streamTree, fromStream);
+        CPPUNIT_ASSERT(streq(fromString, fromBuffer));
+        CPPUNIT_ASSERT(streq(fromString, fromStream));
+        CPPUNIT_ASSERT(areMatchingPTrees(stringTree, bufferTree));
+        CPPUNIT_ASSERT(areMatchingPTrees(stringTree, streamTree));
+    }
+
+public:
+    void testXMLReaders()
+    {
+        StringBuffer wu;
+        generateWorkunitXML(wu, 20);
+        checkXMLReaders(wu, ptr_ignoreWhiteSpace);
+        checkXMLReaders(wu, ptr_none);
+
+        StringBuffer store;
+        generateStoreXML(store, 100);
+        checkXMLReaders(store, ptr_ignoreWhiteSpace);
+        checkXMLReaders(store, ptr_none);
+
+        Owned<IPropertyTree> tree = createPTreeFromXMLString(wu);
+        CPPUNIT_ASSERT(streq("a \"quoted\" job", tree->queryProp("@jobName")));
+        CPPUNIT_ASSERT(streq("Disk Read\n'~file::3'", tree->queryProp("Graphs/Graph[@name='graph2']/xgmml/graph/node[@id='4']/@label")));
+        CPPUNIT_ASSERT(streq("DATASET('~file7', r, THOR) > 0;\n", tree->queryProp("Graphs/Graph[1]/xgmml/graph/node[8]/att[@name='ecl']/@value")));
+        CPPUNIT_ASSERT(streq("value 4\twith  whitespace", tree->queryProp("Results/Result[5]/Value")));
+        CPPUNIT_ASSERT(strstr(tree->queryProp("Results/Result[5]"), "<raw & "));
+        CPPUNIT_ASSERT(streq("\xc3\xa9t\xc3\xa9", tree->queryProp("Statistics/@utf8")));
+        const char *text = tree->queryProp("Query/Text");
+        CPPUNIT_ASSERT(startsWith(text, "r0 := RECORD\n  STRING20 name;\n"));
+        CPPUNIT_ASSERT(strstr(text, "ds19 := DATASET([{'x&y', 19}], r19)(id < 10 AND name != '');\n"));
+
+        Owned<IPropertyTree> raw = createPTreeFromXMLString(wu, ipt_none, ptr_none);
+        CPPUNIT_ASSERT(streq("  value 4\twith  whitespace ", raw->queryProp("Results/Result[5]/Value")));
+
+        tree.setown(createPTreeFromXMLString(store));
+        CPPUNIT_ASSERT_EQUAL(100U, (unsigned)tree->getCount("Scope/File"));
+        CPPUNIT_ASSERT(streq("RECORD\n string20 name;\nEND;\n", tree->queryProp("Scope/File[@name='file42']/Attr/ECL")));
+    }
+
+    void testJSONReaders()
+    {
+        StringBuffer wu;
+        generateWorkunitXML(wu, 20);
+        Owned<IPropertyTree> tree = createPTreeFromXMLString(wu);
+        StringBuffer json;
+        toJSON(tree, json);
+
+        Owned<IPropertyTree> fromString = createPTreeFromJSONString(json);
+        Owned<IPropertyTree> fromBuffer = createPTreeFromJSONString(json.length(), json.str());
+        CPPUNIT_ASSERT(areMatchingPTrees(fromString, fromBuffer));
+        StringBuffer s, b;
+        CPPUNIT_ASSERT(streq(toJSON(fromString, s), toJSON(fromBuffer, b)));
+        IPropertyTree *root = fromString->queryPropTree("*[1]");
+        CPPUNIT_ASSERT(root);
+        CPPUNIT_ASSERT(streq(tree->queryProp("@jobName"), root->queryProp("@jobName")));
+        CPPUNIT_ASSERT(streq(tree->queryProp("Query/Text"), root->queryProp("Query/Text")));
+
+        Owned<IPropertyTree> escaped = createPTreeFromJSONString("{\"a\": {\"b\": \"plain text \\\"quoted\\\" tab\\t \\u00e9 \xc3\xa9 end\"}}");
+        CPPUNIT_ASSERT(streq("plain text \"quoted\" tab\t \xc3\xa9 \xc3\xa9 end", escaped->queryProp("a/b")));
+    }
+
+    void testErrorContext()
+    {
+        // Line numbers must still be counted when the newlines are consumed as part of a block of text
+        const char *xml = "<a x=\"1\n2\">some\ntext\nover lines<b y='3\n'>\n\n</c></a>";
+        unsigned lines[3] = { 0, 0, 0 };
+        for (unsigned i=0; i < 3; i++)
+        {
+            try
+            {
+                Owned<IPropertyTree> tree;
+                if (i == 0)
+                    tree.setown(createPTreeFromXMLString(xml));
+                else if (i == 1)
+                    tree.setown(createPTreeFromXMLString(strlen(xml), xml));
+                else
+                {
+                    CChunkedReadStream stream(strlen(xml), xml);
+                    tree.setown(createPTree(stream));
+                }
+                CPPUNIT_FAIL("Expected a parse error");
+            }
+            catch (IPTreeReadException *e)
+            {
+                lines[i] = e->queryLine();
+                e->Release();
+            }
+        }
+        CPPUNIT_ASSERT_EQUAL(7U, lines[0]);
+        CPPUNIT_ASSERT_EQUAL(lines[0], lines[1]);
+        CPPUNIT_ASSERT_EQUAL(lines[0], lines[2]);
+    }
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(JlibPTreeReaderTest);
+CPPUNIT_TEST_SUITE_NAMED_REGISTRATION(JlibPTreeReaderTest, "JlibPTreeReaderTest");
+
+class JlibPTreeReaderTiming : public JlibPTreeReaderBase
+{
+    CPPUNIT_TEST_SUITE(JlibPTreeReaderTiming);
+        CPPUNIT_TEST(testParse);
+    CPPUNIT_TEST_SUITE_END();
+
+    void timeParse(const char *title, const char *xml, size32_t len)
+    {
+        const unsigned numIter = 5;
+        CCycleTimer timer;
+        for (unsigned i=0; i < numIter; i++)
+            Owned<IPropertyTree> tree = createPTreeFromXMLString(xml);
+        reportRate(title, "string", len * numIter, timer.elapsedNs());
+
+        timer.reset();
+        for (unsigned i=0; i < numIter; i++)
+            Owned<IPropertyTree> tree = createPTreeFromXMLString(len, xml);
+        reportRate(title, "buffer", len * numIter, timer.elapsedNs());
+
+        Owned<IPropertyTree> tree = createPTreeFromXMLString(len, xml);
+        StringBuffer json;
+        toJSON(tree, json);
+        timer.reset();
+        for (unsigned i=0; i < numIter; i++)
+            Owned<IPropertyTree> tree = createPTreeFromJSONString(json.length(), json.str());
+        reportRate(title, "json", json.length() * numIter, timer.elapsedNs());
+    }
+
+    void reportRate(const char *title, const char *mode, unsigned __int64 bytes, unsigned __int64 elapsedNs)
+    {
+        double seconds = (double)elapsedNs / 1000000000.0;
+        DBGLOG("  %-10s %-7s: %6.3fs %8.1fMB/s", title, mode, seconds, (double)bytes / 0x100000 / seconds);
+    }
+
+public:
+    void testParse()
+    {
+        StringBuffer wu;
+        generateWorkunitXML(wu, 2000);
+        timeParse("workunit", wu.str(), wu.length());
+
+        StringBuffer store;
+        generateStoreXML(store, 50000);
+        timeParse("store", store.str(), store.length());
+    }
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(JlibPTreeReaderTiming);
+CPPUNIT_TEST_SUITE_NAMED_REGISTRATION(JlibPTreeReaderTiming, "JlibPTreeReaderTiming");
+
+class JlibFrozenPTreeTest : public JlibPTreeReaderBase
+{
+    CPPUNIT_TEST_SUITE(JlibFrozenPTreeTest);
+        CPPUNIT_TEST(testXPath);
+        CPPUNIT_TEST(testSerialization);
+        CPPUNIT_TEST(testReadOnly);
+        CPPUNIT_TEST(testValues);
+    CPPUNIT_TEST_SUITE_END();
+
+    void checkXPath(IPropertyTree *expected, IPropertyTree *frozen, const char *xpath)
+    {
+        const char *expectedValue = expected->queryProp(xpath);
+        const char *frozenValue = frozen->queryProp(xpath);
+        if ((expectedValue == nullptr) != (frozenValue == nullptr) || (expectedValue && !streq(expectedValue, frozenValue)))
+            CPPUNIT_FAIL(VStringBuffer("queryProp(%s) '%s' != '%s'", xpath, expectedValue ? expectedValue : "(null)", frozenValue ? frozenValue : "(null)").str());
+        CPPUNIT_ASSERT_EQUAL_MESSAGE(xpath, expected->hasProp(xpath), frozen->hasProp(xpath));
+        if (!strchr(xpath, '@'))
+            CPPUNIT_ASSERT_EQUAL_MESSAGE(xpath, expected->getCount(xpath), frozen->getCount(xpath));
+    }
+
+public:
+    void testXPath()
+    {
+        const char *xml = "<Root a='1' b='two'><Child name='x' v='1'>text1</Child><Child name='y' v='2'><Sub>s</Sub></Child><Other>o</Other>"
+                          "<A><B><C id='1'/></B></A><A><B><C id='2'>c2</C></B></A><Z/><M><N k='a'/><N k='b'/><N k='c'/></M></Root>";
+        Owned<IPropertyTree> tree = createPTreeFromXMLString(xml);
+        Owned<IPropertyTree> frozen = createFrozenPTree(tree);
+        CPPUNIT_ASSERT(isFrozenPTree(frozen));
+        CPPUNIT_ASSERT(!isFrozenPTree(tree));
+        CPPUNIT_ASSERT(getFrozenPTreeSize(frozen) != 0);
+
+        const char *xpaths[] = { "@a", "@c", "Child", "Child/@name", "Child[2]/@name", "Child[@name='y']/Sub", "Child[@v=\"2\"]/@name",
+                                 "child", "A/B/C/@id", "A[2]/B/C", "A/B/C[@id='2']", "//C/@id", "//C", "*", "*/@name", "M/N[3]/@k",
+                                 "M/N[@k='b']/@k", "M/N[4]", "Z/Q", "Missing", "./Child/@v", "M/*[2]/@k", "Oth*", "A/B[C]/C/@id",
+                                 "M/N[@k='c'][1]/@k", "Child[Sub]/@name", "Child[Sub='s']/@v" };
+        for (const char *xpath : xpaths)
+            checkXPath(tree, frozen, xpath);
+
+        CPPUNIT_ASSERT_EQUAL(tree->numChildren(), frozen->numChildren());
+        CPPUNIT_ASSERT_EQUAL(tree->numUniq(), frozen->numUniq());
+        CPPUNIT_ASSERT_EQUAL(2U, frozen->getAttributeCount());
+        CPPUNIT_ASSERT_EQUAL(2, frozen->getPropInt("Child[2]/@v"));
+        IPropertyTree *n2 = frozen->queryPropTree("M/N[2]");
+        CPPUNIT_ASSERT(n2);
+        CPPUNIT_ASSERT_EQUAL(1U, frozen->queryPropTree("M")->queryChildIndex(n2));
+
+        Owned<IPropertyTree> nocase = createPTreeFromXMLString("<R><Abc X='1'/><aBC x='2'/></R>", ipt_caseInsensitive);
+        Owned<IPropertyTree> frozenNocase = createFrozenPTree(nocase);
+        CPPUNIT_ASSERT(frozenNocase->isCaseInsensitive());
+        CPPUNIT_ASSERT_EQUAL(2U, (unsigned)frozenNocase->getCount("ABC"));
+        CPPUNIT_ASSERT(streq("2", frozenNocase->queryProp("abc[2]/@X")));
+    }
+
+    void testSerialization()
+    {
+        StringBuffer store;
+        generateStoreXML(store, 100);
+        Owned<IPropertyTree> tree = createPTreeFromXMLString(store);
+        Owned<IPropertyTree> frozen = createFrozenPTree(tree);
+        CPPUNIT_ASSERT(areMatchingPTrees(tree, frozen));
+        StringBuffer xml1, xml2, json1, json2;
+        CPPUNIT_ASSERT(streq(toXML(tree, xml1), toXML(frozen, xml2)));
+        CPPUNIT_ASSERT(streq(toJSON(tree, json1), toJSON(frozen, json2)));
+
+        Owned<IPropertyTree> copy = createPTreeFromIPT(frozen);
+        CPPUNIT_ASSERT(!isFrozenPTree(copy));
+        CPPUNIT_ASSERT(areMatchingPTrees(tree, copy));
+
+        Owned<IPropertyTree> json = createPTreeFromJSONString("{\"r\": {\"arr\": [1, 2, 3], \"one\": [4], \"s\": 5}}");
+        Owned<IPropertyTree> frozenJson = createFrozenPTree(json);
+        CPPUNIT_ASSERT_EQUAL(json->isArray("r/arr"), frozenJson->isArray("r/arr"));
+        CPPUNIT_ASSERT_EQUAL(json->isArray("r/one"), frozenJson->isArray("r/one"));
+        CPPUNIT_ASSERT_EQUAL(json->isArray("r/s"), frozenJson->isArray("r/s"));
+        CPPUNIT_ASSERT(streq(toJSON(json, json1.clear()), toJSON(frozenJson, json2.clear())));
+    }
+
+    void testReadOnly()
+    {
+        Owned<IPropertyTree> frozen = createFrozenPTree(createPTreeFromXMLString("<a><b><c>value</c></b></a>"));
+        CPPUNIT_ASSERT(frozen->isCaseInsensitive() == false);
+        // Child nodes keep the whole tree alive
+        Linked<IPropertyTree> child = frozen->queryPropTree("b/c");
+        frozen.clear();
+        CPPUNIT_ASSERT(streq("value", child->queryProp(nullptr)));
+        try
+        {
+            child->setProp("@x", "1");
+            CPPUNIT_FAIL("Expected a frozen tree to be read-only");
+        }
+        catch (IException *e)
+        {
+            e->Release();
+        }
+        try
+        {
+            child->addPropTree("d", createPTree("d"));
+            CPPUNIT_FAIL("Expected a frozen tree to be read-only");
+        }
+        catch (IException *e)
+        {
+            e->Release();
+        }
+    }
+
+    void testValues()
+    {
+        Owned<IPropertyTree> tree = createPTree("Bin");
+        tree->setPropBin("data", 5, "ab\0cd");
+        tree->setProp("@x", "y");
+        tree->setProp("text", "some text");
+        Owned<IPropertyTree> frozen = createFrozenPTree(tree);
+        CPPUNIT_ASSERT(frozen->isBinary("data"));
+        CPPUNIT_ASSERT(!frozen->isBinary("text"));
+        MemoryBuffer mb;
+        CPPUNIT_ASSERT(frozen->getPropBin("data", mb));
+        CPPUNIT_ASSERT_EQUAL(5U, mb.length());
+        CPPUNIT_ASSERT(memcmp(mb.toByteArray(), "ab\0cd", 5) == 0);
+        CPPUNIT_ASSERT(streq("some text", frozen->queryProp("text")));
+        CPPUNIT_ASSERT(streq("y", frozen->queryProp("@x")));
+    }
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(JlibFrozenPTreeTest);
+CPPUNIT_TEST_SUITE_NAMED_REGISTRATION(JlibFrozenPTreeTest, "JlibFrozenPTreeTest");
+
+class JlibFrozenPTreeTiming : public JlibPTreeReaderBase
+{
+    CPPUNIT_TEST_SUITE(JlibFrozenPTreeTiming);
+        CPPUNIT_TEST(testStore);
+    CPPUNIT_TEST_SUITE_END();
+
+    void timeLookups(const char *title, IPropertyTree *tree, unsigned numFiles)
+    {
+        const unsigned numIter = 1000000;
+        unsigned __int64 total = 0;
+        CCycleTimer timer;
+        for (unsigned i=0; i < 200; i++)
+        {
+            VStringBuffer xpath("Scope/File[@name='file%u']/Attr/@recordCount", (i * 7919) % numFiles);
+            total += tree->getPropInt64(xpath);
+        }
+        unsigned __int64 qualifiedNs = timer.elapsedNs();
+        timer.reset();
+        for (unsigned i=0; i < numIter; i++)
+            total += tree->getPropInt("Scope/File/Attr/@size");
+        unsigned __int64 pathNs = timer.elapsedNs();
+        timer.reset();
+        for (unsigned i=0; i < numIter; i++)
+            total += tree->hasProp("Scope/File/Part");
+        unsigned __int64 hasNs = timer.elapsedNs();
+        DBGLOG("  %-7s qualified %6.3fs path %6.3fs hasProp %6.3fs (%" I64F "u)", title, (double)qualifiedNs / 1000000000.0,
+               (double)pathNs / 1000000000.0, (double)hasNs / 1000000000.0, total);
+    }
+
+public:
+    void testStore()
+    {
+        const unsigned numFiles = 50000;
+        StringBuffer store;
+        generateStoreXML(store, numFiles);
+        memsize_t before = getMapInfo("heap");
+        Owned<IPropertyTree> tree = createPTreeFromXMLString(store);
+        memsize_t treeHeap = getMapInfo("heap") - before;
+        CCycleTimer timer;
+        Owned<IPropertyTree> frozen = createFrozenPTree(tree);
+        DBGLOG("  freeze  %6.3fs local heap %" I64F "u frozen %" I64F "u bytes", (double)timer.elapsedNs() / 1000000000.0,
+               (unsigned __int64)treeHeap, (unsigned __int64)getFrozenPTreeSize(frozen));
+        timeLookups("local", tree, numFiles);
+        timeLookups("frozen", frozen, numFiles);
+    }
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(JlibFrozenPTreeTiming);
+CPPUNIT_TEST_SUITE_NAMED_REGISTRATION(JlibFrozenPTreeTiming, "JlibFrozenPTreeTiming");
+
 
 
 #include "jdebug.hpp"
@@ -3103,12 +3514,340 @@ CPPUNIT_TEST_SUITE_REGISTRATION(JlibIOTest);
 CPPUNIT_TEST_SUITE_NAMED_REGISTRATION(JlibIOTest, "JlibIOTest");
 
 
+// Each 32bit word in the test files contains its offset/4, so the contents of any read can be checked
+static void createQueuedIOTestFile(const char * filename, offset_t size)
+{
+    OwnedIFile file = createIFile(filename);
+    OwnedIFileIO io = file->open(IFOcreate);
+    MemoryAttr ma;
+    const size32_t blockSize = 0x100000;
+    unsigned * block = (unsigned *)ma.allocate(blockSize);
+    for (offset_t pos=0; pos < size; pos += blockSize)
+    {
+        for (unsigned i=0; i < blockSize/sizeof(unsigned); i++)
+            block[i] = (unsigned)(pos/sizeof(unsigned)) + i;
+        io->write(pos, blockSize, block);
+    }
+    io->close();
+}
+
+static bool checkQueuedIOTestData(offset_t pos, size32_t len, const void * data)
+{
+    const unsigned * values = (const unsigned *)data;
+    for (unsigned i=0; i < len/sizeof(unsigned); i++)
+    {
+        if (values[i] != (unsigned)(pos/sizeof(unsigned)) + i)
+            return false;
+    }
+    return true;
+}
+
+class CQueuedIOTestCompletion : implements IFileIOCompletion
+{
+public:
+    virtual void onFileIOComplete(int _result) override
+    {
+        result = _result;
+        done.signal();
+    }
+public:
+    Semaphore done;
+    int result = 0;
+};
+
+class JlibQueuedFileIOTest : public CppUnit::TestFixture
+{
+    CPPUNIT_TEST_SUITE(JlibQueuedFileIOTest);
+        CPPUNIT_TEST(testQueuedReads);
+        CPPUNIT_TEST(testDirectReads);
+        CPPUNIT_TEST(testSerialStream);
+    CPPUNIT_TEST_SUITE_END();
+
+    const char * filename = "JlibQueuedFileIOTest.dat";
+    const offset_t fileSize = 0x800000;
+
+public:
+    void setUp()
+    {
+        createQueuedIOTestFile(filename, fileSize);
+    }
+    void tearDown()
+    {
+        removeFileTraceIfFail(filename);
+    }
+
+    void testQueuedReads()
+    {
+        for (unsigned kernel=0; kernel < 2; kernel++)
+        {
+            Owned<IFileIOQueue> queue = createFileIOQueue(16, 4, 0x10000, kernel != 0);
+            OwnedIFile file = createIFile(filename);
+            Owned<IQueuedFileIO> io = openQueuedFileIO(file, IFOread, IFEnone, queue);
+            CPPUNIT_ASSERT(io);
+
+            //Two requests use the registered buffers, the others use normal memory - including one that reads past the end
+            const unsigned numRequests = 4;
+            offset_t positions[numRequests] = { 0x10000, 0x3000, fileSize - 0x8000, 0x124 };
+            MemoryAttr ma[numRequests];
+            void * buffers[numRequests];
+            CQueuedIOTestCompletion completions[numRequests];
+            for (unsigned i=0; i < numRequests; i++)
+            {
+                buffers[i] = (i < 2) ? queue->allocateBuffer() : ma[i].allocate(0x10000);
+                CPPUNIT_ASSERT(buffers[i]);
+                io->queueRead(positions[i], 0x10000, buffers[i], completions[i]);
+            }
+            for (unsigned i=0; i < numRequests; i++)
+            {
+                completions[i].done.wait();
+                size32_t expected = (size32_t)std::min((offset_t)0x10000, fileSize - positions[i]);
+                CPPUNIT_ASSERT_EQUAL((int)expected, completions[i].result);
+                CPPUNIT_ASSERT(checkQueuedIOTestData(positions[i], expected & ~3, buffers[i]));
+            }
+            for (unsigned i=0; i < 2; i++)
+                queue->releaseBuffer(buffers[i]);
+
+            //Queued writes are visible to normal reads once they have completed
+            Owned<IQueuedFileIO> out = openQueuedFileIO(file, IFOreadwrite, IFEnone, queue);
+            unsigned value = 0x12345678;
+            CQueuedIOTestCompletion written;
+            out->queueWrite(0x100, sizeof(value), &value, written);
+            written.done.wait();
+            CPPUNIT_ASSERT_EQUAL((int)sizeof(value), written.result);
+            unsigned check = 0;
+            out->read(0x100, sizeof(check), &check);
+            CPPUNIT_ASSERT_EQUAL(value, check);
+            out->close();
+            createQueuedIOTestFile(filename, fileSize);
+        }
+    }
+
+    void testDirectReads()
+    {
+        //Unaligned reads from a file opened with IFEdirect are satisfied from aligned blocks.  Some file systems (e.g. tmpfs)
+        //do not support O_DIRECT, in which case the flag is ignored - the results should be the same either way.
+        OwnedIFile file = createIFile(filename);
+        OwnedIFileIO io = file->open(IFOread, IFEdirect);
+        CPPUNIT_ASSERT(io);
+        MemoryAttr ma;
+        byte * buffer = (byte *)ma.allocate(0x20000);
+        const offset_t positions[] = { 0, 0x1004, 0x7ffc, fileSize - 0x100 };
+        for (offset_t pos : positions)
+        {
+            size32_t expected = (size32_t)std::min((offset_t)0x10004, fileSize - pos);
+            CPPUNIT_ASSERT_EQUAL(expected, io->read(pos, 0x10004, buffer + 4));
+            CPPUNIT_ASSERT(checkQueuedIOTestData(pos, expected, buffer + 4));
+        }
+        CPPUNIT_ASSERT_EQUAL(0U, io->read(fileSize + 0x1000, 0x100, buffer));
+    }
+
+    void testSerialStream()
+    {
+        OwnedIFile file = createIFile(filename);
+        Owned<IQueuedFileIO> io = openQueuedFileIO(file, IFOread);
+        CPPUNIT_ASSERT(io);
+        Owned<ISerialStream> stream = createQueuedFileSerialStream(io, 0x400, (offset_t)-1, (size32_t)-1, 4);
+        offset_t pos = 0x400;
+        MemoryAttr ma;
+        void * buffer = ma.allocate(0x3004);
+        while (pos + 0x3004 <= fileSize)
+        {
+            stream->get(0x3004, buffer);
+            CPPUNIT_ASSERT(checkQueuedIOTestData(pos, 0x3004, buffer));
+            pos += 0x3004;
+        }
+        size32_t got;
+        stream->peek(0x3004, got);
+        CPPUNIT_ASSERT_EQUAL((size32_t)(fileSize - pos), got);
+
+        //Reset to a different position, and restrict the length
+        stream->reset(0x1000, 0x2000);
+        stream->get(0x2000, buffer);
+        CPPUNIT_ASSERT(checkQueuedIOTestData(0x1000, 0x2000, buffer));
+        CPPUNIT_ASSERT(stream->eos());
+    }
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(JlibQueuedFileIOTest);
+CPPUNIT_TEST_SUITE_NAMED_REGISTRATION(JlibQueuedFileIOTest, "JlibQueuedFileIOTest");
+
+
+// Compare the throughput of random 4K reads and sequential reads using pread, the io task scheduler and io_uring.
+// The file has just been written, so the cached timings mostly measure the cost of the io calls rather than the
+// device.  The direct timings read from the device if the file system supports O_DIRECT.
+class JlibQueuedFileIOTiming : public CppUnit::TestFixture
+{
+    CPPUNIT_TEST_SUITE(JlibQueuedFileIOTiming);
+        CPPUNIT_TEST(testRandom);
+        CPPUNIT_TEST(testSequential);
+    CPPUNIT_TEST_SUITE_END();
+
+    class CCountingCompletion : implements IFileIOCompletion
+    {
+    public:
+        virtual void onFileIOComplete(int result) override
+        {
+            if (result != 4096)
+                errors++;
+            done.signal();
+        }
+    public:
+        Semaphore done;
+        std::atomic<unsigned> errors{0};
+    };
+
+    const char * filename = "JlibQueuedFileIOTiming.dat";
+    const offset_t fileSize = 0x10000000;
+    const unsigned numRandomReads = 200000;
+    const unsigned queueDepth = 64;
+
+public:
+    void setUp()
+    {
+        createQueuedIOTestFile(filename, fileSize);
+    }
+    void tearDown()
+    {
+        removeFileTraceIfFail(filename);
+    }
+
+    void testRandom()
+    {
+        DBGLOG("Random 4K reads from %" I64F "uMB file", fileSize / 0x100000);
+        for (unsigned direct=0; direct < 2; direct++)
+        {
+            IFEflags flags = direct ? IFEdirect : IFEnone;
+            OwnedIFile file = createIFile(filename);
+            Owned<IFileIO> io = file->open(IFOread, flags);
+            MemoryAttr ma;
+            byte * buffer = (byte *)ma.allocate(4096 * 2);
+            buffer += (4096 - ((memsize_t)buffer & 4095)) & 4095;
+            Owned<IRandomNumberGenerator> random = createRandomNumberGenerator();
+            random->seed(1);
+            CCycleTimer timer;
+            for (unsigned i=0; i < numRandomReads; i++)
+                io->read((offset_t)(random->next() % (fileSize / 4096)) * 4096, 4096, buffer);
+            reportRate("pread", direct, numRandomReads * 4096ULL, timer.elapsedNs());
+
+            for (unsigned kernel=0; kernel < 2; kernel++)
+            {
+                Owned<IFileIOQueue> queue = createFileIOQueue(queueDepth, queueDepth, 4096, kernel != 0);
+                if ((kernel != 0) && !queue->isKernelQueue())
+                {
+                    DBGLOG("io_uring is not available");
+                    continue;
+                }
+                Owned<IQueuedFileIO> queuedIO = openQueuedFileIO(file, IFOread, flags, queue);
+                void * buffers[queueDepth];
+                for (unsigned j=0; j < queueDepth; j++)
+                    buffers[j] = queue->allocateBuffer();
+                CCountingCompletion completion;
+                random->seed(1);
+                CCycleTimer queueTimer;
+                for (unsigned i=0; i < numRandomReads; i++)
+                {
+                    if (i >= queueDepth)
+                        completion.done.wait();
+                    queuedIO->queueRead((offset_t)(random->next() % (fileSize / 4096)) * 4096, 4096, buffers[i % queueDepth], completion);
+                }
+                for (unsigned i=0; i < std::min(numRandomReads, queueDepth); i++)
+                    completion.done.wait();
+                reportRate(kernel ? "io_uring" : "task queue", direct, numRandomReads * 4096ULL, queueTimer.elapsedNs());
+                CPPUNIT_ASSERT_EQUAL(0U, completion.errors.load());
+                for (unsigned j=0; j < queueDepth; j++)
+                    queue->releaseBuffer(buffers[j]);
+            }
+        }
+    }
+
+    void testSequential()
+    {
+        DBGLOG("Sequential reads of %" I64F "uMB file", fileSize / 0x100000);
+        MemoryAttr ma;
+        const size32_t readSize = 0x1000;
+        void * buffer = ma.allocate(readSize);
+        for (unsigned direct=0; direct < 2; direct++)
+        {
+            IFEflags flags = direct ? IFEdirect : IFEnone;
+            OwnedIFile file = createIFile(filename);
+            for (unsigned mode=0; mode < 3; mode++)
+            {
+                Owned<IFileIOQueue> queue = createFileIOQueue(queueDepth, 16, 0x40000, mode == 2);
+                if ((mode == 2) && !queue->isKernelQueue())
+                    break;
+                Owned<IQueuedFileIO> io = openQueuedFileIO(file, IFOread, flags, queue);
+                Owned<ISerialStream> stream;
+                if (mode == 0)
+                    stream.setown(createFileSerialStream(io, 0, (offset_t)-1, 0x40000));
+                else
+                    stream.setown(createQueuedFileSerialStream(io, 0, (offset_t)-1, 0x40000, 8));
+                CCycleTimer timer;
+                for (offset_t pos=0; pos < fileSize; pos += readSize)
+                    stream->get(readSize, buffer);
+                const char * modeText[] = { "pread", "task queue", "io_uring" };
+                reportRate(modeText[mode], direct, fileSize, timer.elapsedNs());
+            }
+        }
+    }
+
+protected:
+    void reportRate(const char * mode, bool direct, unsigned __int64 bytes, unsigned __int64 elapsedNs)
+    {
+        double seconds = (double)elapsedNs / 1000000000.0;
+        DBGLOG("  %-10s %s: %6.3fs %8.1fMB/s", mode, direct ? "direct" : "cached", seconds, (double)bytes / 0x100000 / seconds);
+    }
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(JlibQueuedFileIOTiming);
+CPPUNIT_TEST_SUITE_NAMED_REGISTRATION(JlibQueuedFileIOTiming, "JlibQueuedFileIOTiming");
+
+
 class JlibCompressionTestsStress : public CppUnit::TestFixture
 {
     CPPUNIT_TEST_SUITE(JlibCompressionTestsStress);
         CPPUNIT_TEST(test);
+        CPPUNIT_TEST(testZStdLevels);
+        CPPUNIT_TEST(testZStdDictionary);
     CPPUNIT_TEST_SUITE_END();
 
+    size32_t rowSz = 0;
+
+    void createSource(MemoryBuffer & src, size32_t sz)
+    {
+        src.ensureCapacity(sz);
+        StringBuffer tmp;
+        unsigned card = 0;
+        rowSz = 0;
+        while (true)
+        {
+            size32_t cLen = src.length();
+            if (cLen > sz)
+                break;
+            src.append(cLen);
+            tmp.clear().appendf("%10u", cLen);
+            src.append(tmp.length(), tmp.str());
+            src.append(++card % 52);
+            src.append(crc32((const char *)&cLen, sizeof(cLen), 0));
+            unsigned ccrc = crc32((const char *)&card, sizeof(card), 0);
+            tmp.clear().appendf("%10u", ccrc);
+            src.append(tmp.length(), tmp.str());
+            tmp.clear().appendf("%20u", (++card % 10));
+            src.append(tmp.length(), tmp.str());
+            if (0 == rowSz)
+                rowSz = src.length();
+            else
+            {
+                dbgassertex(0 == (src.length() % rowSz));
+            }
+        }
+    }
+
+    static double throughput(size32_t len, cycle_t cycles)
+    {
+        __uint64 ns = cycle_to_nanosec(cycles);
+        return ns ? ((double)len / 0x100000) / ((double)ns / 1000000000) : 0.0;
+    }
+
 public:
     void test()
     {
@@ -3116,38 +3855,12 @@ public:
         {
             size32_t sz = 100*0x100000; // 100MB
             MemoryBuffer src;
-            src.ensureCapacity(sz);
+            createSource(src, sz);
             MemoryBuffer compressed;
             const char *aesKey = "012345678901234567890123";
             Owned<ICompressHandlerIterator> iter = getCompressHandlerIterator();
 
-            StringBuffer tmp;
-            unsigned card = 0;
-            size32_t rowSz = 0;
-            while (true)
-            {
-                size32_t cLen = src.length();
-                if (cLen > sz)
-                    break;
-                src.append(cLen);
-                tmp.clear().appendf("%10u", cLen);
-                src.append(tmp.length(), tmp.str());
-                src.append(++card % 52);
-                src.append(crc32((const char *)&cLen, sizeof(cLen), 0));
-                unsigned ccrc = crc32((const char *)&card, sizeof(card), 0);
-                tmp.clear().appendf("%10u", ccrc);
-                src.append(tmp.length(), tmp.str());
-                tmp.clear().appendf("%20u", (++card % 10));
-                src.append(tmp.length(), tmp.str());
-                if (0 == rowSz)
-                    rowSz = src.length();
-                else
-                {
-                    dbgassertex(0 == (src.length() % rowSz));
-                }
-            }
-
-            DBGLOG("Algorithm || Compression Time (ms) || Decompression Time (ms) || Compression Ratio");
+            DBGLOG("Algorithm || Compression Time (ms) || Decompression Time (ms) || Compression Ratio || Compress MB/s || Decompress MB/s");
 
             ForEach(*iter)
             {
@@ -3183,7 +3896,8 @@ public:
 
                 float ratio = (float)(src.length()) / compressed.length();
 
-                DBGLOG("%9s || %21u || %23u || %17.2f [ %u, %u ]", handler.queryType(), (unsigned)cycle_to_millisec(compressCycles), (unsigned)cycle_to_millisec(decompressCycles), ratio, src.length(), compressed.length());
+                DBGLOG("%9s || %21u || %23u || %17.2f || %13.0f || %15.0f [ %u, %u ]", handler.queryType(), (unsigned)cycle_to_millisec(compressCycles), (unsigned)cycle_to_millisec(decompressCycles), ratio,
+                       throughput(src.length(), compressCycles), throughput(src.length(), decompressCycles), src.length(), compressed.length());
 
                 CPPUNIT_ASSERT(tgt.length() >= sz);
                 CPPUNIT_ASSERT(0 == memcmp(src.bufferBase(), tgt.bufferBase(), sz));
@@ -3195,6 +3909,111 @@ public:
             throw;
         }
     }
+
+    void testZStdLevels()
+    {
+        try
+        {
+            size32_t sz = 20*0x100000; // 20MB - the higher levels are slow
+            MemoryBuffer src;
+            createSource(src, sz);
+
+            DBGLOG("ZSTD level || Compress MB/s || Decompress MB/s || Compression Ratio");
+            const int levels[] = { -5, 1, 3, 6, 9, 15, 19 };
+            for (int level : levels)
+            {
+                VStringBuffer options("level=%d", level);
+                Owned<ICompressor> compressor = createZStdCompressor(options);
+                MemoryBuffer compressed;
+                CCycleTimer timer;
+                compressor->open(compressed, sz);
+                compressor->startblock();
+                for (size32_t offset = 0; offset + rowSz <= src.length(); offset += rowSz)
+                    compressor->write(src.bytes() + offset, rowSz);
+                compressor->commitblock();
+                compressor->close();
+                cycle_t compressCycles = timer.elapsedCycles();
+
+                Owned<IExpander> expander = createZStdExpander();
+                timer.reset();
+                size32_t required = expander->init(compressed.bytes());
+                MemoryBuffer tgt(required);
+                expander->expand(tgt.bufferBase());
+                tgt.setWritePos(required);
+                cycle_t decompressCycles = timer.elapsedCycles();
+
+                DBGLOG("%10d || %13.0f || %15.0f || %17.2f", level, throughput(src.length(), compressCycles), throughput(src.length(), decompressCycles), (float)src.length() / compressed.length());
+                CPPUNIT_ASSERT(tgt.length() >= sz);
+                CPPUNIT_ASSERT(0 == memcmp(src.bufferBase(), tgt.bufferBase(), sz));
+            }
+        }
+        catch (IException *e)
+        {
+            EXCLOG(e, nullptr);
+            throw;
+        }
+    }
+
+    //Small blocks (e.g. index nodes) compress poorly on their own - a dictionary trained on similar blocks helps
+    void testZStdDictionary()
+    {
+        try
+        {
+            const size32_t blockSize = 0x2000;
+            size32_t sz = 8*0x100000;
+            MemoryBuffer src;
+            createSource(src, sz);
+            unsigned numBlocks = sz / blockSize;
+
+            //Train on every 8th block, and compress all of them
+            UnsignedArray sampleSizes;
+            MemoryBuffer samples;
+            for (unsigned block = 0; block < numBlocks; block += 8)
+            {
+                samples.append(blockSize, src.bytes() + block * blockSize);
+                sampleSizes.append(blockSize);
+            }
+            Owned<IZStdDictionary> dictionary = trainZStdDictionary(0x10000, sampleSizes.ordinality(), samples.bytes(), sampleSizes.getArray());
+
+            DBGLOG("ZSTD %u byte blocks || Compress MB/s || Decompress MB/s || Compression Ratio", blockSize);
+            for (unsigned pass = 0; pass < 2; pass++)
+            {
+                IZStdDictionary * dict = pass ? dictionary.get() : nullptr;
+                Owned<ICompressor> compressor = createZStdCompressor(nullptr, dict);
+                Owned<IExpander> expander = createZStdExpander(dict);
+                MemoryBuffer compressed;
+                MemoryBuffer expanded;
+                size32_t totalCompressed = 0;
+                cycle_t compressCycles = 0;
+                cycle_t decompressCycles = 0;
+                for (unsigned block = 0; block < numBlocks; block++)
+                {
+                    const byte * data = src.bytes() + block * blockSize;
+                    CCycleTimer timer;
+                    compressed.clear();
+                    compressor->open(compressed, blockSize * 2);
+                    compressor->write(data, blockSize);
+                    compressor->close();
+                    compressCycles += timer.elapsedCycles();
+                    totalCompressed += compressed.length();
+
+                    timer.reset();
+                    size32_t required = expander->init(compressed.bytes());
+                    expanded.clear();
+                    expander->expand(expanded.reserveTruncate(required));
+                    decompressCycles += timer.elapsedCycles();
+                    CPPUNIT_ASSERT_EQUAL(blockSize, required);
+                    CPPUNIT_ASSERT(0 == memcmp(data, expanded.bytes(), blockSize));
+                }
+                DBGLOG("%22s || %13.0f || %15.0f || %17.2f", pass ? "dictionary" : "no dictionary", throughput(numBlocks * blockSize, compressCycles), throughput(numBlocks * blockSize, decompressCycles), (float)(numBlocks * blockSize) / totalCompressed);
+            }
+        }
+        catch (IException *e)
+        {
+            EXCLOG(e, nullptr);
+            throw;
+        }
+    }
 };
 
 CPPUNIT_TEST_SUITE_REGISTRATION( JlibCompressionTestsStress );
@@ -3317,6 +4136,158 @@ class HashTableTests : public CppUnit::TestFixture
 CPPUNIT_TEST_SUITE_REGISTRATION( HashTableTests );
 CPPUNIT_TEST_SUITE_NAMED_REGISTRATION( HashTableTests, "HashTableTests" );
 
+#ifndef _WIN32
+class JlibCompiledObjectCacheTest : public CppUnit::TestFixture
+{
+    CPPUNIT_TEST_SUITE(JlibCompiledObjectCacheTest);
+        CPPUNIT_TEST(testExtractFilenames);
+        CPPUNIT_TEST(testRestoreAdd);
+        CPPUNIT_TEST(testPurge);
+    CPPUNIT_TEST_SUITE_END();
+
+    const char * testDir = "JlibCompiledObjectCacheTest";
+
+    StringBuffer & getPath(StringBuffer & out, const char * name)
+    {
+        return out.append(testDir).append(PATHSEPCHAR).append(name);
+    }
+    std::string makePath(const char * name)
+    {
+        StringBuffer path;
+        return getPath(path, name).str();
+    }
+    void writeFile(const char * name, const char * text)
+    {
+        StringBuffer path;
+        Owned<IFile> file = createIFile(getPath(path, name));
+        Owned<IFileIO> io = file->open(IFOcreate);
+        io->write(0, strlen(text), text);
+    }
+    bool fileExists(const char * name)
+    {
+        StringBuffer path;
+        return checkFileExists(getPath(path, name));
+    }
+    StringBuffer & readFile(StringBuffer & out, const char * name)
+    {
+        StringBuffer path;
+        return out.loadFile(getPath(path, name));
+    }
+    void setModified(const char * name, unsigned age)
+    {
+        StringBuffer path;
+        Owned<IFile> file = createIFile(getPath(path, name));
+        CDateTime when;
+        when.setNow();
+        when.adjustTimeSecs(-(int)age);
+        file->setTime(nullptr, &when, nullptr);
+    }
+
+public:
+    void setUp()
+    {
+        recursiveRemoveDirectory(testDir);
+        recursiveCreateDirectory(testDir);
+        StringBuffer path;
+        recursiveCreateDirectory(getPath(path, "include"));
+    }
+    void tearDown()
+    {
+        recursiveRemoveDirectory(testDir);
+    }
+
+    void testExtractFilenames()
+    {
+        StringBuffer source, object;
+        CPPUNIT_ASSERT(extractCompileFilenames("\"g++\" \"/tmp/W1.cpp\" -fPIC -c -O0 -o \"/tmp/W1.o\" -fvisibility=hidden", source, object));
+        CPPUNIT_ASSERT_EQUAL(std::string("/tmp/W1.cpp"), std::string(source.str()));
+        CPPUNIT_ASSERT_EQUAL(std::string("/tmp/W1.o"), std::string(object.str()));
+        CPPUNIT_ASSERT(extractCompileFilenames("\"g++\" \"W1_2.cpp\" \"-Iinc\" -c -o \"W1_2.o\"", source, object));
+        CPPUNIT_ASSERT_EQUAL(std::string("W1_2.cpp"), std::string(source.str()));
+        CPPUNIT_ASSERT_EQUAL(std::string("W1_2.o"), std::string(object.str()));
+        CPPUNIT_ASSERT(!extractCompileFilenames("\"g++\" \"W1.cpp\" -shared -o \"libW1.so\"", source, object));  // a link
+        CPPUNIT_ASSERT(!extractCompileFilenames("\"g++\" \"W1.hpp\" -c -o \"W1.hpp.gch\"", source, object));    // a precompiled header
+        CPPUNIT_ASSERT(!extractCompileFilenames("\"g++\" \"W1.cpp\" -c", source, object));                       // no object
+    }
+
+    //The key must change whenever anything the source includes changes, including headers found via -I
+    void testRestoreAdd()
+    {
+        writeFile("W1.cpp", "#include \"W1.hpp\"\n#include \"user.hpp\"\nint f() { return LOCAL + USER; }\n");
+        writeFile("W1.hpp", "#define LOCAL 1\n");
+        writeFile("include/user.hpp", "#define USER 1\n");
+        writeFile("W2.cpp", "#include \"W2.hpp\"\n#include \"user.hpp\"\nint f() { return LOCAL + USER; }\n");
+        writeFile("W2.hpp", "#define LOCAL 1\n");
+
+        Owned<ICompiledObjectCache> cache = createCompiledObjectCache(makePath("cache").c_str());
+        auto restore = [&](const char * core, StringBuffer & key, unsigned __int64 & savedNs)
+        {
+            StringBuffer source, object, include;
+            getPath(source, core).append(".cpp");
+            getPath(object, core).append(".o");
+            getPath(include, "include");
+            VStringBuffer cmdline("\"g++\" \"%s\" \"-I%s\" -c -o \"%s\"", source.str(), include.str(), object.str());
+            return cache->restore(cmdline, source, object, key, savedNs);
+        };
+
+        StringBuffer key, key2, text;
+        unsigned __int64 savedNs = 0;
+        CPPUNIT_ASSERT(!restore("W1", key, savedNs));
+        CPPUNIT_ASSERT(key.length() != 0);
+        writeFile("W1.o", "object1");
+        cache->add(key, makePath("W1.o").c_str(), 1234);
+
+        //The same code in a different workunit finds the object
+        CPPUNIT_ASSERT(restore("W2", key2, savedNs));
+        CPPUNIT_ASSERT_EQUAL(std::string("object1"), std::string(readFile(text, "W2.o").str()));
+        CPPUNIT_ASSERT_EQUAL((unsigned __int64)1234, savedNs);
+
+        //A change to a header in the same directory, or in an include path, is a different key
+        writeFile("W2.hpp", "#define LOCAL 2\n");
+        CPPUNIT_ASSERT(!restore("W2", key2, savedNs));
+        CPPUNIT_ASSERT(!streq(key, key2));
+        writeFile("include/user.hpp", "#define USER 2\n");
+        CPPUNIT_ASSERT(!restore("W1", key2, savedNs));
+        CPPUNIT_ASSERT(!streq(key, key2));
+        writeFile("include/user.hpp", "#define USER 1\n");
+        CPPUNIT_ASSERT(restore("W1", key2, savedNs));
+
+        //A source that does not compile is never cached
+        writeFile("W1.cpp", "#include \"missing.hpp\"\n");
+        CPPUNIT_ASSERT(!restore("W1", key2, savedNs));
+        CPPUNIT_ASSERT_EQUAL(0U, key2.length());
+    }
+
+    void testPurge()
+    {
+        Owned<ICompiledObjectCache> cache = createCompiledObjectCache(makePath("cache").c_str());
+        writeFile("object", "0123456789");
+        for (const char * key : { "k1", "k2", "k3" })
+            cache->add(key, makePath("object").c_str(), 1);
+        setModified("cache/k1.o", 300);
+        setModified("cache/k2.o", 200);
+        setModified("cache/k3.o", 100);
+
+        cache->purge(30);
+        CPPUNIT_ASSERT(fileExists("cache/k1.o") && fileExists("cache/k2.o") && fileExists("cache/k3.o"));
+
+        //The least recently used objects are removed first, along with their compile times
+        cache->purge(25);
+        CPPUNIT_ASSERT(!fileExists("cache/k1.o") && !fileExists("cache/k1.time"));
+        CPPUNIT_ASSERT(fileExists("cache/k2.o") && fileExists("cache/k3.o"));
+
+        //restore() updates the time of the object it uses, so k3 is now the least recently used
+        setModified("cache/k2.o", 0);
+        cache->purge(10);
+        CPPUNIT_ASSERT(fileExists("cache/k2.o") && fileExists("cache/k2.time"));
+        CPPUNIT_ASSERT(!fileExists("cache/k3.o"));
+    }
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION( JlibCompiledObjectCacheTest );
+CPPUNIT_TEST_SUITE_NAMED_REGISTRATION( JlibCompiledObjectCacheTest, "JlibCompiledObjectCacheTest" );
+#endif
+
 class BlockedTimingTests : public CppUnit::TestFixture
 {
     static constexpr bool trace = false;
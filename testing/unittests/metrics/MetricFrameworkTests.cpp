@@ -76,6 +76,7 @@ public:
         CPPUNIT_TEST(Test_metric_meta_data);
         CPPUNIT_TEST(Test_gauge_by_counters_metric);
         CPPUNIT_TEST(Test_histogram_metric);
+        CPPUNIT_TEST(Test_log_linear_histogram_metric);
     CPPUNIT_TEST_SUITE_END();
 
 protected:
@@ -446,6 +447,68 @@ protected:
     }
 
 
+    void Test_log_linear_histogram_metric()
+    {
+        //
+        // Verify every value falls within the bounds of its bucket, and that buckets are contiguous
+        for (unsigned i=0; i < 4096; ++i)
+        {
+            unsigned bucket = LogLinearHistogramMetric::getBucketIndex(i);
+            CPPUNIT_ASSERT(LogLinearHistogramMetric::getBucketLowerBound(bucket) <= i);
+            CPPUNIT_ASSERT(LogLinearHistogramMetric::getBucketUpperBound(bucket) >= i);
+            if (bucket)
+                CPPUNIT_ASSERT_EQUAL(LogLinearHistogramMetric::getBucketUpperBound(bucket-1)+1, LogLinearHistogramMetric::getBucketLowerBound(bucket));
+        }
+        unsigned lastBucket = LogLinearHistogramMetric::getBucketIndex(UINT64_MAX);
+        CPPUNIT_ASSERT_EQUAL(LogLinearHistogramMetric::numBuckets-1, lastBucket);
+        CPPUNIT_ASSERT_EQUAL((__uint64)UINT64_MAX, LogLinearHistogramMetric::getBucketUpperBound(lastBucket));
+
+        //
+        // Same measurements as the histogram test should produce the same buckets
+        std::vector<__uint64> bucketDefs = {2, 4, 8};
+        std::shared_ptr<LogLinearHistogramMetric> pHistogram = std::make_shared<LogLinearHistogramMetric>("requests.dist", "description", SMeasureCount, bucketDefs);
+        CPPUNIT_ASSERT_EQUAL(bucketDefs.size()+1, pHistogram->queryHistogramValues().size());
+        pHistogram->recordMeasurement(4);
+        pHistogram->recordMeasurement(4);
+        pHistogram->recordMeasurement(20);
+        pHistogram->recordMeasurement(8);
+        checkHistogramBucketResult(pHistogram, 36, {0,2,1,1});
+
+        //
+        // Percentiles are the upper bound of the bucket containing the percentile (20 is in the bucket 20..21)
+        std::vector<MetricPercentile> percentiles = pHistogram->queryHistogramPercentiles();
+        CPPUNIT_ASSERT_EQUAL((size_t)4, percentiles.size());
+        CPPUNIT_ASSERT_EQUAL(50.0, percentiles[0].percentile);
+        CPPUNIT_ASSERT_EQUAL((__uint64)4, percentiles[0].value);
+        CPPUNIT_ASSERT_EQUAL((__uint64)21, percentiles[1].value);
+        CPPUNIT_ASSERT_EQUAL((__uint64)21, percentiles[3].value);
+
+        //
+        // Measurements from multiple threads are all counted
+        std::shared_ptr<LogLinearHistogramMetric> pThreaded = std::make_shared<LogLinearHistogramMetric>("requests.threaded", "description", SMeasureCount, bucketDefs);
+        constexpr unsigned numThreads = 8;
+        constexpr unsigned numMeasurements = 10000;
+        std::vector<std::thread> threads;
+        for (unsigned t=0; t < numThreads; ++t)
+        {
+            threads.emplace_back([&pThreaded, t]()
+            {
+                for (unsigned i=0; i < numMeasurements; ++i)
+                    pThreaded->recordMeasurement(t+1);
+            });
+        }
+        for (auto &thread: threads)
+            thread.join();
+        std::vector<__uint64> values = pThreaded->queryHistogramValues();
+        CPPUNIT_ASSERT_EQUAL((__uint64)(2*numMeasurements), values[0]);
+        CPPUNIT_ASSERT_EQUAL((__uint64)(2*numMeasurements), values[1]);
+        CPPUNIT_ASSERT_EQUAL((__uint64)(4*numMeasurements), values[2]);
+        CPPUNIT_ASSERT_EQUAL((__uint64)0, values[3]);
+        CPPUNIT_ASSERT_EQUAL((__uint64)(36*numMeasurements), pThreaded->queryValue());
+        CPPUNIT_ASSERT_EQUAL((__uint64)4, pThreaded->queryHistogramPercentiles()[0].value);
+    }
+
+
     void checkHistogramBucketResult(std::shared_ptr<IMetric> pHistogram, int expectedSum, const std::vector<int> &expectedValues)
     {
         std::vector<__uint64> values = pHistogram->queryHistogramValues();
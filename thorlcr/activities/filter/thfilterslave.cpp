@@ -17,6 +17,45 @@
 
 #include "thfilterslave.ipp"
 
+// Filters a block of rows returned by nextRows() in place, dropping the end of group markers of any groups that are now empty.
+// Returns the new size of the block, and the number of (non NULL) rows that matched.
+static unsigned filterRowBlock(IHThorFilterArg &helper, const void * * rows, unsigned numIn, bool &anyThisGroup, unsigned &numMatched)
+{
+    unsigned numOut = 0;
+    unsigned i = 0;
+    numMatched = 0;
+    try
+    {
+        for (; i < numIn; i++)
+        {
+            const void *row = rows[i];
+            if (!row)
+            {
+                if (anyThisGroup)
+                {
+                    rows[numOut++] = nullptr;
+                    anyThisGroup = false;
+                }
+            }
+            else if (helper.isValid(row))
+            {
+                rows[numOut++] = row;
+                anyThisGroup = true;
+                numMatched++;
+            }
+            else
+                ReleaseThorRow(row);
+        }
+    }
+    catch (...)
+    {
+        roxiemem::ReleaseRoxieRowRange(rows, 0, numOut);
+        roxiemem::ReleaseRoxieRowRange(rows, i, numIn);
+        throw;
+    }
+    return numOut;
+}
+
 class CFilterSlaveActivityBase : public CSlaveActivity
 {
     typedef CSlaveActivity PARENT;
@@ -55,6 +94,7 @@ class CFilterSlaveActivity : public CFilterSlaveActivityBase, public CThorSteppa
 
     IHThorFilterArg *helper;
     unsigned matched;
+    bool eof = false;   // the input has reported the end of the stream to nextRows()
 
 public:
     CFilterSlaveActivity(CGraphElementBase *container)
@@ -66,6 +106,7 @@ public:
     {   
         ActivityTimer s(slaveTimerStats, timeActivities);
         matched = 0;
+        eof = false;
         if (helper->canMatchAny())
             PARENT::start();
         else
@@ -102,6 +143,30 @@ public:
         }
         return nullptr;
     }
+    virtual unsigned nextRows(const void * * rows, unsigned maxRows, bool & eos) override
+    {
+        try { return nextRowsNoCatch(rows, maxRows, eos); }
+        CATCH_NEXTROWX_CATCH
+    }
+    unsigned nextRowsNoCatch(const void * * rows, unsigned maxRows, bool & eos)
+    {
+        ActivityTimer t(slaveTimerStats, timeActivities);
+        while (!abortSoon && !eof)
+        {
+            unsigned numIn = inputStream->nextRows(rows, maxRows, eof);
+            unsigned numMatched;
+            unsigned numOut = filterRowBlock(*helper, rows, numIn, anyThisGroup, numMatched);
+            if (numOut)
+            {
+                matched += numMatched;
+                dataLinkIncrement(numMatched);
+                eos = eof;
+                return numOut;
+            }
+        }
+        eos = true;
+        return 0;
+    }
     virtual const void *nextRowGE(const void *seek, unsigned numFields, bool &wasCompleteMatch, const SmartStepExtra &stepExtra) override
     {
         try { return nextRowGENoCatch(seek, numFields, wasCompleteMatch, stepExtra); }
@@ -148,6 +213,7 @@ public:
     { 
         abortSoon = !helper->canMatchAny();
         anyThisGroup = false;
+        eof = false;
         inputStream->resetEOF();
     }
 // steppable
@@ -159,6 +225,109 @@ public:
     virtual IInputSteppingMeta *querySteppingMeta() { return CThorSteppable::inputStepping; }
 };
 
+class CFilterStrandProcessor : public CThorStrandProcessor
+{
+    IHThorFilterArg *helper;
+    bool matchAny = true;
+    bool eof = false;   // the input has reported the end of the stream to nextRows()
+
+public:
+    explicit CFilterStrandProcessor(CThorStrandedActivity &parent, IEngineRowStream *inputStream, unsigned outputId)
+        : CThorStrandProcessor(parent, inputStream, outputId)
+    {
+        helper = static_cast <IHThorFilterArg *> (queryHelper());
+    }
+    virtual void start() override
+    {
+        CThorStrandProcessor::start();
+        matchAny = helper->canMatchAny();
+        eof = false;
+    }
+    STRAND_CATCH_NEXTROW()
+    {
+        ActivityTimer t(slaveTimerStats, timeActivities);
+        if (!matchAny)
+            return nullptr;
+        for (;;)
+        {
+            if (parent.queryAbortSoon())
+                return nullptr;
+            OwnedConstThorRow in = inputStream->nextRow();
+            if (!in)
+            {
+                if (numProcessedLastGroup == rowsProcessed)
+                    in.setown(inputStream->nextRow());
+                if (!in)
+                {
+                    numProcessedLastGroup = rowsProcessed;
+                    return nullptr;
+                }
+            }
+            if (helper->isValid(in))
+            {
+                rowsProcessed++;
+                return in.getClear();
+            }
+        }
+    }
+    virtual unsigned nextRows(const void * * rows, unsigned maxRows, bool & eos) override
+    {
+        try { return nextRowsNoCatch(rows, maxRows, eos); }
+        CATCH_NEXTROWX_CATCH
+    }
+    unsigned nextRowsNoCatch(const void * * rows, unsigned maxRows, bool & eos)
+    {
+        ActivityTimer t(slaveTimerStats, timeActivities);
+        eos = true;
+        if (!matchAny)
+            return 0;
+        while (!eof)
+        {
+            if (parent.queryAbortSoon())
+                return 0;
+            unsigned numIn = inputStream->nextRows(rows, maxRows, eof);
+            bool anyThisGroup = (numProcessedLastGroup != rowsProcessed);
+            unsigned numMatched;
+            unsigned numOut = filterRowBlock(*helper, rows, numIn, anyThisGroup, numMatched);
+            rowsProcessed += numMatched;
+            if (!anyThisGroup)
+                numProcessedLastGroup = rowsProcessed;
+            if (numOut)
+            {
+                eos = eof;
+                return numOut;
+            }
+        }
+        return 0;
+    }
+};
+
+// Used in place of CFilterSlaveActivity when the filter has been asked to run in parallel.
+// NB: it is not steppable, and unlike the single stream version the input is started even if canMatchAny() is false.
+class CStrandedFilterSlaveActivity : public CThorStrandedActivity
+{
+public:
+    explicit CStrandedFilterSlaveActivity(CGraphElementBase *_container) : CThorStrandedActivity(_container)
+    {
+        setRequireInitData(false);
+        appendOutputLinked(this);
+    }
+    virtual CThorStrandProcessor *createStrandProcessor(IEngineRowStream *instream) override
+    {
+        return new CFilterStrandProcessor(*this, instream, 0);
+    }
+    virtual CThorStrandProcessor *createStrandSourceProcessor(bool inputOrdered) override { throwUnexpected(); }
+
+// IThorDataLink
+    virtual void getMetaInfo(ThorDataLinkMetaInfo &info) const override
+    {
+        initMetaInfo(info);
+        info.canReduceNumRows = true;
+        calcMetaInfoSize(info, queryInput(0));
+    }
+    virtual bool isGrouped() const override { return queryInput(0)->isGrouped(); }
+};
+
 class CFilterProjectSlaveActivity : public CFilterSlaveActivityBase
 {
     typedef CFilterSlaveActivityBase PARENT;
@@ -412,6 +581,9 @@ public:
 
 CActivityBase *createFilterSlave(CGraphElementBase *container)
 {
+    // Only split into strands if a PARALLEL hint (or forceNumStrands) asks for it, otherwise keep the steppable version
+    if (CThorStrandOptions(*container).numStrands > 1)
+        return new CStrandedFilterSlaveActivity(container);
     return new CFilterSlaveActivity(container);
 }
 
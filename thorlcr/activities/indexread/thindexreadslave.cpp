@@ -75,6 +75,7 @@ protected:
     rowcount_t keyedProcessed = 0;
     rowcount_t rowLimit = RCMAX;
     bool useRemoteStreaming = false;
+    unsigned indexReadAhead = 0;
     Owned<IFileIO> lazyIFileIO;
     mutable CriticalSection ioStatsCS;
     unsigned fileTableStart = NotFound;
@@ -305,6 +306,8 @@ public:
 
                 Owned<IKeyIndex> keyIndex = createKeyIndex(path, crc, *lazyIFileIO, (unsigned) -1, false);
                 Owned<IKeyManager> klManager = createLocalKeyManager(helper->queryDiskRecordSize()->queryRecordAccessor(true), keyIndex, &contextLogger, helper->hasNewSegmentMonitors(), false);
+                if (indexReadAhead)
+                    klManager->setReadAhead(indexReadAhead);
                 if (localMerge)
                 {
                     if (!keyIndexSet)
@@ -332,6 +335,8 @@ public:
                 }
             }
             keyMergerManager.setown(createKeyMerger(helper->queryDiskRecordSize()->queryRecordAccessor(true), keyIndexSet, seekGEOffset, &contextLogger, helper->hasNewSegmentMonitors(), false));
+            if (indexReadAhead)
+                keyMergerManager->setReadAhead(indexReadAhead);
             const ITranslator *translator = translators.item(0);
             if (translator)
                 keyMergerManager->setLayoutTranslator(&translator->queryTranslator());
@@ -601,6 +606,7 @@ public:
             deserializePartFileDescriptors(data, partDescs);
         localKey = partDescs.ordinality() ? partDescs.item(0).queryOwner().queryProperties().getPropBool("@local", false) : false;
         localMerge = (localKey && partDescs.ordinality()>1) || seekGEOffset;
+        indexReadAhead = getOptInt(THOROPT_INDEX_READAHEAD);
 
         if (parts)
         {
@@ -217,7 +217,8 @@ public:
         if (!needsSeek)
             out.setown(createNoSeekIOStream(out));
         maxRecordSizeSeen = 0;
-        builder.setown(createKeyBuilder(out, flags, maxDiskRecordSize, nodeSize, helper->getKeyedSize(), isTlk ? 0 : totalCount, helper, defaultIndexCompression, !isTlk, isTlk));
+        unsigned buildThreads = isTlk ? 0 : getOptUInt(THOROPT_INDEX_BUILD_THREADS);
+        builder.setown(createKeyBuilder(out, flags, maxDiskRecordSize, nodeSize, helper->getKeyedSize(), isTlk ? 0 : totalCount, helper, defaultIndexCompression, !isTlk, isTlk, buildThreads));
     }
     void buildLayoutMetadata(Owned<IPropertyTree> & metadata)
     {
@@ -1255,6 +1255,68 @@ class CKeyedJoinSlave : public CSlaveActivity, implements IJoinProcessor, implem
         typedef CLookupHandler PARENT;
     protected:
         std::vector<Owned<const ITranslator>> translators;
+        // The bloom pre-filter means the segment monitors are created twice for rows that are not rejected, so stop
+        // using it if too few rows are being rejected.
+        static constexpr unsigned bloomPrefilterSampleRows = 10000;
+        static constexpr unsigned bloomPrefilterMinRejectPct = 10;
+        bool bloomPrefilter = false;
+        unsigned bloomProbed = 0;
+        unsigned bloomRejected = 0;
+        std::vector<hash64_t> bloomHashes;
+        std::vector<unsigned> bloomRows;
+        std::unique_ptr<bool[]> bloomResults;
+        std::vector<bool> rejected;
+
+        // Test all the rows in the batch against the bloom filter that applies to the first of them, and mark those that cannot match
+        bool prefilterRows(CThorExpandingRowArray &processing, IKeyManager *keyManager)
+        {
+            unsigned numRows = processing.ordinality();
+            bloomHashes.clear();
+            bloomRows.clear();
+            unsigned batchFilter = NotFound;
+            for (unsigned r=0; r<numRows && !stopped; r++)
+            {
+                const void *keyedFieldsRow = (const byte *)processing.query(r) + sizeof(KeyLookupHeader);
+                helper->createSegmentMonitors(keyManager, keyedFieldsRow);
+                keyManager->finishSegmentMonitors();
+                unsigned whichFilter;
+                hash64_t hash;
+                bool probed = keyManager->getBloomProbe(whichFilter, hash);
+                keyManager->releaseSegmentMonitors();
+                if (probed)
+                {
+                    if (NotFound == batchFilter)
+                        batchFilter = whichFilter;
+                    if (whichFilter == batchFilter)
+                    {
+                        bloomHashes.push_back(hash);
+                        bloomRows.push_back(r);
+                    }
+                }
+            }
+            if (bloomHashes.empty())
+            {
+                // The index has no bloom filters that can be used with this join condition
+                bloomPrefilter = false;
+                return false;
+            }
+
+            unsigned numProbes = bloomHashes.size();
+            bloomResults.reset(new bool[numProbes]);
+            unsigned numRejected = keyManager->bloomFilterTestMany(batchFilter, numProbes, bloomHashes.data(), bloomResults.get());
+            rejected.assign(numRows, false);
+            for (unsigned i=0; i<numProbes; i++)
+            {
+                if (!bloomResults[i])
+                    rejected[bloomRows[i]] = true;
+            }
+
+            bloomProbed += numRows;
+            bloomRejected += numRejected;
+            if ((bloomProbed >= bloomPrefilterSampleRows) && (bloomRejected * 100 < bloomProbed * bloomPrefilterMinRejectPct))
+                bloomPrefilter = false;
+            return numRejected != 0;
+        }
 
         void setupTranslation(unsigned partNo, unsigned selected, IKeyManager &keyManager)
         {
@@ -1280,14 +1342,23 @@ class CKeyedJoinSlave : public CSlaveActivity, implements IJoinProcessor, implem
         {
             limiter = &activity.lookupThreadLimiter;
             allParts = &activity.allIndexParts;
+            bloomPrefilter = activity.keyLookupBloomPrefilter;
         }
         void processRows(CThorExpandingRowArray &processing, unsigned partNo, IKeyManager *keyManager)
         {
             CStatsScopedThresholdDeltaUpdater scoped(activity.statsUpdater);
+            bool checkRejected = false;
+            if (bloomPrefilter && (processing.ordinality() > 1))
+                checkRejected = prefilterRows(processing, keyManager);
             for (unsigned r=0; r<processing.ordinality() && !stopped; r++)
             {
                 OwnedConstThorRow row = processing.getClear(r);
                 CJoinGroup *joinGroup = *(CJoinGroup **)row.get();
+                if (checkRejected && rejected[r])
+                {
+                    joinGroup->decPending();
+                    continue;
+                }
 
                 const void *keyedFieldsRow = (byte *)row.get() + sizeof(KeyLookupHeader);
                 helper->createSegmentMonitors(keyManager, keyedFieldsRow);
@@ -2252,6 +2323,7 @@ class CKeyedJoinSlave : public CSlaveActivity, implements IJoinProcessor, implem
     unsigned fetchLookupQueuedBatchSize = defaultKeyLookupFetchQueuedBatchSize;
     unsigned keyLookupProcessBatchLimit = defaultKeyLookupProcessBatchLimit;
     unsigned fetchLookupProcessBatchLimit = defaultFetchLookupProcessBatchLimit;
+    bool keyLookupBloomPrefilter = true;
     bool remoteKeyedLookup = false;
     bool remoteKeyedFetch = false;
     bool forceRemoteKeyedLookup = false;
@@ -2957,6 +3029,7 @@ public:
         forceRemoteKeyedFetch = getOptBool(THOROPT_FORCE_REMOTE_KEYED_FETCH);
         keyLookupProcessBatchLimit = getOptInt(THOROPT_KEYLOOKUP_PROCESS_BATCHLIMIT, defaultKeyLookupProcessBatchLimit);
         fetchLookupProcessBatchLimit = getOptInt(THOROPT_FETCHLOOKUP_PROCESS_BATCHLIMIT, defaultFetchLookupProcessBatchLimit);
+        keyLookupBloomPrefilter = getOptBool(THOROPT_KEYLOOKUP_BLOOM_PREFILTER, true);
         messageCompression = getOptBool(THOROPT_KEYLOOKUP_COMPRESS_MESSAGES, true);
 
         fetchLookupQueuedBatchSize = getOptInt(THOROPT_KEYLOOKUP_FETCH_QUEUED_BATCHSIZE, defaultKeyLookupFetchQueuedBatchSize);
@@ -786,6 +786,33 @@ public:
 
 struct HtEntry { rowidx_t index, count; };
 
+#ifdef __64BIT__
+/* The top 16 bits of a user space row pointer are always zero, so the LOOKUP hash table stores the top 16 bits of the
+ * row's hash there.  Most probes that reach an entry for a different key are rejected without reading the rhs row.
+ * LOOKUP MANY entries hold a row index and count rather than a pointer, so there are no spare bits to tag them with,
+ * and adding a hash field would make the table 50% larger.
+ */
+static constexpr unsigned htTagShift = 48;
+static constexpr memsize_t htRowMask = ((memsize_t)1 << htTagShift) - 1;
+static inline const void *makeTaggedHtRow(const void *row, unsigned hash)
+{
+    dbgassertex(((memsize_t)row & ~htRowMask) == 0);
+    return (const void *)((memsize_t)row | ((memsize_t)(hash >> 16) << htTagShift));
+}
+static inline bool htTagMatches(const void *entry, unsigned hash)
+{
+    return ((memsize_t)entry >> htTagShift) == (hash >> 16);
+}
+static inline const void *getTaggedHtRow(const void *entry)
+{
+    return (const void *)((memsize_t)entry & htRowMask);
+}
+#else
+static inline const void *makeTaggedHtRow(const void *row, unsigned hash) { return row; }
+static inline bool htTagMatches(const void *entry, unsigned hash) { return true; }
+static inline const void *getTaggedHtRow(const void *entry) { return entry; }
+#endif
+
 /* 
     These activities load the RHS into a table, therefore
     the right hand stream -should- contain the fewer records
@@ -919,6 +946,17 @@ protected:
     HtEntry currentHashEntry; // Used for lookup,many only
     OwnedConstThorRow leftRow;
 
+    /* LHS rows are read in batches when probing a hash table.  The hashes of the whole batch are calculated and their
+     * table entries prefetched, and then the rhs rows they reference, before any rows in the batch are compared.
+     * A batch ends early at the end of a group, so rows are never read beyond the end of the input.
+     */
+    static constexpr unsigned maxLhsProbeBatch = 64;
+    unsigned lhsProbeBatch = 0;
+    unsigned lhsBatchPos = 0;
+    unsigned lhsBatchCount = 0;
+    OwnedConstThorRow lhsBatchRows[maxLhsProbeBatch];
+    unsigned lhsBatchHashes[maxLhsProbeBatch];
+
     IThorDataLink *leftITDL, *rightITDL;
     Owned<IRowStream> left;
     IRowStream *right = nullptr;
@@ -1161,6 +1199,35 @@ protected:
         joined = 0;
         leftMatch = false;
     }
+    void readLeftBatch()
+    {
+        lhsBatchPos = 0;
+        lhsBatchCount = 0;
+        while (lhsBatchCount < lhsProbeBatch)
+        {
+            const void *row = left->nextRow();
+            lhsBatchRows[lhsBatchCount].setown(row);
+            if (!row)
+            {
+                lhsBatchCount++;
+                break;
+            }
+            unsigned hash = tableProxy->getLeftHash(row);
+            lhsBatchHashes[lhsBatchCount++] = hash;
+            tableProxy->prefetchEntry(hash);
+        }
+        for (unsigned i=0; i<lhsBatchCount; i++)
+        {
+            if (lhsBatchRows[i])
+                tableProxy->prefetchCandidate(lhsBatchHashes[i]);
+        }
+    }
+    void clearLeftBatch()
+    {
+        while (lhsBatchPos < lhsBatchCount)
+            lhsBatchRows[lhsBatchPos++].clear();
+        lhsBatchPos = lhsBatchCount = 0;
+    }
     inline const void *denormalizeNextRow()
     {
         ConstPointerArray filteredRhs;
@@ -1235,7 +1302,17 @@ protected:
             {
                 if (NULL == rhsNext)
                 {
-                    leftRow.setown(left->nextRow());
+                    bool batched = lhsProbeBatch && rhsTableLen;
+                    unsigned leftRowHash = 0;
+                    if (batched)
+                    {
+                        if (lhsBatchPos == lhsBatchCount)
+                            readLeftBatch();
+                        leftRowHash = lhsBatchHashes[lhsBatchPos];
+                        leftRow.setown(lhsBatchRows[lhsBatchPos++].getClear());
+                    }
+                    else
+                        leftRow.setown(left->nextRow());
                     joinCounter = 0;
                     if (leftRow)
                     {
@@ -1245,7 +1322,10 @@ protected:
                             resetRhsNext();
                             const void *failRow = NULL;
                             // NB: currentHashEntry used for Lookup,Many or All cases
-                            rhsNext = tableProxy->getFirstRHSMatch(leftRow, failRow, currentHashEntry); // also checks abortLimit/atMost
+                            if (batched)
+                                rhsNext = tableProxy->getFirstRHSMatch(leftRow, leftRowHash, failRow, currentHashEntry); // also checks abortLimit/atMost
+                            else
+                                rhsNext = tableProxy->getFirstRHSMatch(leftRow, failRow, currentHashEntry); // also checks abortLimit/atMost
                             if (failRow)
                                 return failRow;
                         }
@@ -1361,6 +1441,8 @@ public:
         if (!isGlobal())
             setRequireInitData(false);
         rhsConstant = getOptBool("lookupRhsConstant", false); // for testing purposes only
+        if (HTHELPER::isHashTable)
+            lhsProbeBatch = std::min(getOptUInt(THOROPT_LKJOIN_PROBE_BATCH, 16), maxLhsProbeBatch);
         appendOutputLinked(this);
     }
     ~CInMemJoinBase()
@@ -1545,6 +1627,7 @@ public:
             stopInput(1, "(R)");
         if (broadcaster)
             broadcaster->reset();
+        clearLeftBatch();
         stopInput(0, "(L)");
         left.clear();
         if (isGlobal() && (queryJob().queryJobChannels()>1) && (0 == queryJobChannelNumber()))
@@ -2968,6 +3051,8 @@ class CTableCommon : public CInterfaceOf<IInterface>
 protected:
     rowidx_t tableSize;
 public:
+    static constexpr bool isHashTable = false;
+
     rowidx_t queryTableSize() const { return tableSize; }
     void reset()
     {
@@ -2983,13 +3068,15 @@ protected:
     ICompare *compareLeftRight;
 
 public:
+    static constexpr bool isHashTable = true;
+
     CHTBase()
     {
         reset();
     }
-    void setup(CSlaveActivity *activity, roxiemem::IRowManager *rowManager, rowidx_t size, IHash *_leftHash, IHash *_rightHash, ICompare *_compareLeftRight)
+    void setup(CSlaveActivity *activity, roxiemem::IRowManager *rowManager, rowidx_t size, size32_t entrySize, IHash *_leftHash, IHash *_rightHash, ICompare *_compareLeftRight)
     {
-        unsigned __int64 _sz = sizeof(const void *) * ((unsigned __int64)size);
+        unsigned __int64 _sz = entrySize * ((unsigned __int64)size);
         memsize_t sz = (memsize_t)_sz;
         if (sz != _sz) // treat as OOM exception for handling purposes.
             throw MakeStringException(ROXIEMM_MEMORY_LIMIT_EXCEEDED, "Unsigned overflow, trying to allocate hash table of size: %" I64F "d ", _sz);
@@ -3008,6 +3095,10 @@ public:
         leftHash = rightHash = NULL;
         compareLeftRight = NULL;
     }
+    inline unsigned getLeftHash(const void *leftRow) const
+    {
+        return leftHash->hash(leftRow);
+    }
 };
 
 class CLookupHT : public CHTBase
@@ -3015,16 +3106,20 @@ class CLookupHT : public CHTBase
     CLookupJoinActivityBase<CLookupHT> *activity;
     const void **ht;
 
-    const void *findFirst(const void *left)
+    const void *findFirst(const void *left, unsigned hash)
     {
-        unsigned h = leftHash->hash(left)%tableSize;
+        unsigned h = hash%tableSize;
         for (;;)
         {
-            const void *right = ht[h];
-            if (!right)
+            const void *entry = ht[h];
+            if (!entry)
                 break;
-            if (0 == compareLeftRight->docompare(left, right))
-                return right;
+            if (htTagMatches(entry, hash))
+            {
+                const void *right = getTaggedHtRow(entry);
+                if (0 == compareLeftRight->docompare(left, right))
+                    return right;
+            }
             h++;
             if (h>=tableSize)
                 h = 0;
@@ -3033,6 +3128,8 @@ class CLookupHT : public CHTBase
     }
     void releaseHTRows()
     {
+        for (rowidx_t i=0; i<tableSize; i++)
+            ht[i] = getTaggedHtRow(ht[i]);
         roxiemem::ReleaseRoxieRowArray(tableSize, ht);
     }
 public:
@@ -3047,7 +3144,7 @@ public:
     void setup(CLookupJoinActivityBase<CLookupHT> *_activity, roxiemem::IRowManager *rowManager, rowidx_t size, IHash *leftHash, IHash *rightHash, ICompare *compareLeftRight)
     {
         activity = _activity;
-        CHTBase::setup(activity, rowManager, size, leftHash, rightHash, compareLeftRight);
+        CHTBase::setup(activity, rowManager, size, sizeof(const void *), leftHash, rightHash, compareLeftRight);
         ht = (const void **)htMemory.get();
     }
     void reset()
@@ -3058,28 +3155,43 @@ public:
     }
     inline void addEntry(const void *row, unsigned hash)
     {
+        unsigned h = hash%tableSize;
         for (;;)
         {
-            const void *&htRow = ht[hash];
+            const void *&htRow = ht[h];
             if (!htRow)
             {
                 LinkThorRow(row);
-                htRow = row;
+                htRow = makeTaggedHtRow(row, hash);
                 break;
             }
-            hash++;
-            if (hash>=tableSize)
-                hash = 0;
+            h++;
+            if (h>=tableSize)
+                h = 0;
         }
     }
+    inline void prefetchEntry(unsigned hash) const
+    {
+        __builtin_prefetch(ht + hash%tableSize);
+    }
+    inline void prefetchCandidate(unsigned hash) const
+    {
+        const void *entry = ht[hash%tableSize];
+        if (entry && htTagMatches(entry, hash))
+            __builtin_prefetch(getTaggedHtRow(entry));
+    }
     inline const void *getNextRHS(HtEntry &currentHashEntry __attribute__((unused)))
     {
         return NULL; // no next in LOOKUP without MANY
     }
-    inline const void *getFirstRHSMatch(const void *leftRow, const void *&failRow, HtEntry &currentHashEntry __attribute__((unused)))
+    inline const void *getFirstRHSMatch(const void *leftRow, unsigned hash, const void *&failRow, HtEntry &currentHashEntry __attribute__((unused)))
     {
         failRow = NULL;
-        return findFirst(leftRow);
+        return findFirst(leftRow, hash);
+    }
+    inline const void *getFirstRHSMatch(const void *leftRow, const void *&failRow, HtEntry &currentHashEntry)
+    {
+        return getFirstRHSMatch(leftRow, getLeftHash(leftRow), failRow, currentHashEntry);
     }
     virtual void addRows(CThorExpandingRowArray &_rows, CMarker &marker)
     {
@@ -3091,8 +3203,7 @@ public:
             if (0 == nextPos)
                 break;
             const void *row = rows[pos];
-            unsigned h = rightHash->hash(row)%tableSize;
-            addEntry(row, h);
+            addEntry(row, rightHash->hash(row));
             pos = nextPos;
         }
         // Rows now in hash table, rhs arrays no longer needed
@@ -3107,16 +3218,16 @@ class CLookupManyHT : public CHTBase
     HtEntry *ht;
     const void **rows;
 
-    inline HtEntry *lookup(unsigned hash)
+    inline HtEntry *lookup(unsigned h)
     {
-        HtEntry *e = ht+hash;
+        HtEntry *e = ht+h;
         if (0 == e->count)
             return NULL;
         return e;
     }
-    const void *findFirst(const void *left, HtEntry &currentHashEntry)
+    const void *findFirst(const void *left, unsigned hash, HtEntry &currentHashEntry)
     {
-        unsigned h = leftHash->hash(left)%tableSize;
+        unsigned h = hash%tableSize;
         for (;;)
         {
             HtEntry *e = lookup(h);
@@ -3142,25 +3253,38 @@ public:
     void setup(CLookupJoinActivityBase<CLookupManyHT> *_activity, roxiemem::IRowManager *rowManager, rowidx_t size, IHash *leftHash, IHash *rightHash, ICompare *compareLeftRight)
     {
         activity = _activity;
-        CHTBase::setup(activity, rowManager, size, leftHash, rightHash, compareLeftRight);
+        CHTBase::setup(activity, rowManager, size, sizeof(HtEntry), leftHash, rightHash, compareLeftRight);
         ht = (HtEntry *)htMemory.get();
     }
     inline void addEntry(const void *row, unsigned hash, rowidx_t index, rowidx_t count)
     {
+        unsigned h = hash%tableSize;
         for (;;)
         {
-            HtEntry &e = ht[hash];
+            HtEntry &e = ht[h];
             if (!e.count)
             {
                 e.index = index;
                 e.count = count;
                 break;
             }
-            hash++;
-            if (hash>=tableSize)
-                hash = 0;
+            h++;
+            if (h>=tableSize)
+                h = 0;
         }
     }
+    inline void prefetchEntry(unsigned hash) const
+    {
+        __builtin_prefetch(ht + hash%tableSize);
+    }
+    inline void prefetchCandidate(unsigned hash) const
+    {
+        //The entry has no hash to filter on, so only fetch the slot holding the candidate row pointer, rather than
+        //stalling to read it and fetching a row that often belongs to a different key.
+        const HtEntry &e = ht[hash%tableSize];
+        if (e.count)
+            __builtin_prefetch(rows + e.index);
+    }
     void reset()
     {
         CHTBase::reset();
@@ -3174,9 +3298,9 @@ public:
         --currentHashEntry.count;
         return rows[++currentHashEntry.index];
     }
-    inline const void *getFirstRHSMatch(const void *leftRow, const void *&failRow, HtEntry &currentHashEntry)
+    inline const void *getFirstRHSMatch(const void *leftRow, unsigned hash, const void *&failRow, HtEntry &currentHashEntry)
     {
-        const void *right = findFirst(leftRow, currentHashEntry);
+        const void *right = findFirst(leftRow, hash, currentHashEntry);
         if (right)
         {
             if (activity->exceedsLimit(currentHashEntry.count, leftRow, right, failRow))
@@ -3184,6 +3308,10 @@ public:
         }
         return right;
     }
+    inline const void *getFirstRHSMatch(const void *leftRow, const void *&failRow, HtEntry &currentHashEntry)
+    {
+        return getFirstRHSMatch(leftRow, getLeftHash(leftRow), failRow, currentHashEntry);
+    }
     virtual void addRows(CThorExpandingRowArray &_rows, CMarker &marker)
     {
         rows = _rows.getRowArray();
@@ -3200,9 +3328,8 @@ public:
              * i.e. feels like LOOKUP without MANY should be deprecated..
             */
             const void *row = rows[pos];
-            unsigned h = rightHash->hash(row)%tableSize;
             // NB: 'pos' and 'count' won't be used if dedup variety
-            addEntry(row, h, pos, count);
+            addEntry(row, rightHash->hash(row), pos, count);
             pos = pos2;
         }
     }
@@ -3252,6 +3379,14 @@ public:
         failRow = NULL;
         return rows[0]; // guaranteed to be at least one row
     }
+    // The ALL join does not hash the lhs rows (see isHashTable), these are only provided so the common code compiles
+    inline unsigned getLeftHash(const void *leftRow) const { return 0; }
+    inline void prefetchEntry(unsigned hash) const {}
+    inline void prefetchCandidate(unsigned hash) const {}
+    inline const void *getFirstRHSMatch(const void *leftRow, unsigned hash, const void *&failRow, HtEntry &currentEntry)
+    {
+        return getFirstRHSMatch(leftRow, failRow, currentEntry);
+    }
     void addRows(CThorExpandingRowArray &_rows)
     {
         tableSize = _rows.ordinality();
@@ -50,6 +50,7 @@ public:
         unstable = helper->getAlgorithmFlags()&TAFunstable;
         unsigned spillPriority = container.queryGrouped() ? SPILL_PRIORITY_GROUPSORT : SPILL_PRIORITY_LARGESORT;
         iLoader.setown(createThorRowLoader(*this, iCompare, unstable ? stableSort_none : stableSort_earlyAlloc, rc_mixed, spillPriority));
+        iLoader->setSortKeyPrefix(helper->queryOptSortKeyPrefix());
         setRequireInitData(false);
         appendOutputLinked(this);
     }
@@ -116,7 +116,8 @@ public:
                 false,
                 isUnstable(),
                 abortSoon,
-                auxrowif);
+                auxrowif,
+                helper->queryOptSortKeyPrefix());
 
             PARENT::stopInput(0);
             if (abortSoon)
@@ -24,6 +24,7 @@ class CProjecStrandProcessor : public CThorStrandProcessor
 {
     IHThorProjectArg *helper;
     Owned<IEngineRowAllocator> allocator;
+    bool eof = false;   // the input has reported the end of the stream to nextRows()
 
 public:
     explicit CProjecStrandProcessor(CThorStrandedActivity &parent, IEngineRowStream *inputStream, unsigned outputId)
@@ -33,6 +34,11 @@ public:
         Owned<IRowInterfaces> rowIf = parent.getRowInterfaces();
         allocator.setown(parent.getRowAllocator(rowIf->queryRowMetaData(), (parent.queryHeapFlags()|roxiemem::RHFpacked|roxiemem::RHFunique)));
     }
+    virtual void start() override
+    {
+        CThorStrandProcessor::start();
+        eof = false;
+    }
     STRAND_CATCH_NEXTROW()
     {
         ActivityTimer t(slaveTimerStats, timeActivities);
@@ -70,6 +76,61 @@ public:
             }
         }
     }
+    virtual unsigned nextRows(const void * * rows, unsigned maxRows, bool & eos) override
+    {
+        try { return nextRowsNoCatch(rows, maxRows, eos); }
+        CATCH_NEXTROWX_CATCH
+    }
+    unsigned nextRowsNoCatch(const void * * rows, unsigned maxRows, bool & eos)
+    {
+        ActivityTimer t(slaveTimerStats, timeActivities);
+        eos = true;
+        while (!eof)
+        {
+            if (parent.queryAbortSoon())
+                return 0;
+            unsigned numIn = inputStream->nextRows(rows, maxRows, eof);
+            // Each output row replaces an input row at the same or an earlier position in the block
+            unsigned numOut = 0;
+            unsigned i = 0;
+            try
+            {
+                for (; i < numIn; i++)
+                {
+                    OwnedConstThorRow in = rows[i];
+                    if (!in)
+                    {
+                        if (numProcessedLastGroup != rowsProcessed)
+                        {
+                            rows[numOut++] = nullptr;
+                            numProcessedLastGroup = rowsProcessed;
+                        }
+                        continue;
+                    }
+                    RtlDynamicRowBuilder rowBuilder(allocator);
+                    size32_t outSize = helper->transform(rowBuilder, in);
+                    if (outSize)
+                    {
+                        rowsProcessed++;
+                        rows[numOut++] = rowBuilder.finalizeRowClear(outSize);
+                    }
+                }
+            }
+            catch (IException *e)
+            {
+                roxiemem::ReleaseRoxieRowRange(rows, 0, numOut);
+                roxiemem::ReleaseRoxieRowRange(rows, i+1, numIn);
+                parent.ActPrintLog(e, "In helper->transform()");
+                throw;
+            }
+            if (numOut)
+            {
+                eos = eof;
+                return numOut;
+            }
+        }
+        return 0;
+    }
 };
 
 
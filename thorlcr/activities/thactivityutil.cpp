@@ -106,7 +106,43 @@ public:
             IRowWriter *writer = smartbuf->queryWriter();
 
             rowcount_t requiredLeft = required;
-            if (preserveGrouping)
+            if (RCUNBOUND == requiredLeft)
+            {
+                // No limit on how far ahead to read, so pull blocks of rows from the input
+                const void * rows[defaultNextRowsBlockSize];
+                bool pendingEog = false;
+                bool eos = false;
+                while (running && !eos)
+                {
+                    unsigned numRows = inputStream->nextRows(rows, defaultNextRowsBlockSize, eos);
+                    unsigned i = 0;
+                    try
+                    {
+                        for (; i<numRows; i++)
+                        {
+                            const void *row = rows[i];
+                            if (!row)
+                                pendingEog = preserveGrouping;
+                            else
+                            {
+                                if (pendingEog)
+                                {
+                                    writer->putRow(NULL); // eog
+                                    pendingEog = false;
+                                }
+                                ++count;
+                                writer->putRow(row);
+                            }
+                        }
+                    }
+                    catch (IException *)
+                    {
+                        roxiemem::ReleaseRoxieRowRange(rows, i+1, numRows);
+                        throw;
+                    }
+                }
+            }
+            else if (preserveGrouping)
             {
                 while (requiredLeft&&running)
                 {
@@ -789,6 +825,8 @@ IFileIO *createMultipleWrite(CActivityBase *activity, IPartDescriptor &partDesc,
                 compMethod = COMPRESS_METHOD_LZ4;
             else if (activity->getOptBool(THOROPT_COMP_FORCELZ4HC, false))
                 compMethod = COMPRESS_METHOD_LZ4HC;
+            else if (activity->getOptBool(THOROPT_COMP_FORCEZSTD, false))
+                compMethod = COMPRESS_METHOD_ZSTD;
         }
         fileio.setown(createCompressedFileWriter(file, recordSize, 0 != (twFlags & TW_Extend), true, ecomp, compMethod));
         if (!fileio)
@@ -313,6 +313,8 @@ void CWriteMasterBase::publish()
                 compMethod = COMPRESS_METHOD_LZ4;
             else if (getOptBool(THOROPT_COMP_FORCELZ4HC, false))
                 compMethod = COMPRESS_METHOD_LZ4HC;
+            else if (getOptBool(THOROPT_COMP_FORCEZSTD, false))
+                compMethod = COMPRESS_METHOD_ZSTD;
             bool blockCompressed;
             bool compressed = fileDesc->isCompressed(&blockCompressed);
             for (unsigned clusterIdx=0; clusterIdx<fileDesc->numClusters(); clusterIdx++)
@@ -22,137 +22,135 @@
 #include "thactivityutil.ipp"
 #include "eclrtl.hpp"
 
-class CXmlParseSlaveActivity : public CSlaveActivity, implements IXMLSelect
+class CXmlParseStrandProcessor : public CThorStrandProcessor, implements IXMLSelect
 {
-    typedef CSlaveActivity PARENT;
-
     IHThorXmlParseArg *helper;
-    bool eogNext;
-    bool anyThisGroup;
     Linked<IColumnProvider> lastMatch;
-    char *searchStr;
+    char *searchStr = nullptr;
     Owned<IXMLParse> xmlParser;
     OwnedConstThorRow nxt;
     Owned<IEngineRowAllocator> allocator;
 
-public:
-    IMPLEMENT_IINTERFACE_USING(CSlaveActivity);
-
-    CXmlParseSlaveActivity(CGraphElementBase *_container) : CSlaveActivity(_container)
-    {
-        helper = static_cast <IHThorXmlParseArg *> (queryHelper());
-        searchStr = NULL;
-        appendOutputLinked(this);
-    }
-
-// IXMLSelect
-    virtual void match(IColumnProvider &entry, offset_t startOffset, offset_t endOffset)
-    {
-        lastMatch.set(&entry);
-    }
-
-// IThorSlaveActivity overloaded methods
-    virtual void init(MemoryBuffer &data, MemoryBuffer &slaveData)
-    {
-        allocator.set(queryRowAllocator());
-    }
-    virtual void kill()
+    void clearParser()
     {
-        CSlaveActivity::kill();
         xmlParser.clear();
-        if (searchStr && helper->searchTextNeedsFree())
+        lastMatch.clear();
+        if (helper->searchTextNeedsFree())
             rtlFree(searchStr);
+        searchStr = nullptr;
     }
-// IThorDataLink methods
-    virtual void start() override
-    {
-        ActivityTimer s(slaveTimerStats, timeActivities);
-        PARENT::start();
-        anyThisGroup = false;
-        eogNext = false;
-    }
-    CATCH_NEXTROW()
+    const void *nextParsedRow()
     {
-        ActivityTimer t(slaveTimerStats, timeActivities);
-        if (abortSoon)
-            return NULL;
-        if (eogNext)
-        {
-            eogNext = false;
-            anyThisGroup = false;
-            return NULL;
-        }
-        try
+        for (;;)
         {
-            for (;;)
+            if (xmlParser)
             {
-                if (xmlParser)
+                for (;;)
                 {
-                    for (;;)
+                    if (!xmlParser->next())
                     {
-                        if (!xmlParser->next())
-                        {
-                            if (helper->searchTextNeedsFree())
-                            {
-                                rtlFree(searchStr);
-                                searchStr = NULL;
-                            }
-                            xmlParser.clear();
-                            break;
-                        }
-                        if (lastMatch)
+                        clearParser();
+                        break;
+                    }
+                    if (lastMatch)
+                    {
+                        RtlDynamicRowBuilder row(allocator);
+                        size32_t sizeGot;
+                        try { sizeGot = helper->transform(row, nxt, lastMatch); }
+                        catch (IException *e)
                         {
-                            RtlDynamicRowBuilder row(allocator);
-                            size32_t sizeGot;
-                            try { sizeGot = helper->transform(row, nxt, lastMatch); }
-                            catch (IException *e) 
-                            { 
-                                ActPrintLog(e, "In helper->transform()");
-                                throw;
-                            }
-                            lastMatch.clear();
-                            if (sizeGot == 0)
-                                continue; // not sure if this will ever be possible in this context.
-                            dataLinkIncrement();
-                            anyThisGroup = true;
-                            OwnedConstThorRow ret = row.finalizeRowClear(sizeGot);
-                            return ret.getClear();
+                            parent.ActPrintLog(e, "In helper->transform()");
+                            throw;
                         }
+                        lastMatch.clear();
+                        if (sizeGot == 0)
+                            continue; // not sure if this will ever be possible in this context.
+                        rowsProcessed++;
+                        return row.finalizeRowClear(sizeGot);
                     }
                 }
+            }
+            if (parent.queryAbortSoon())
+                return nullptr;
+            nxt.setown(inputStream->nextRow());
+            if (!nxt && (numProcessedLastGroup == rowsProcessed))
                 nxt.setown(inputStream->nextRow());
-                if (!nxt && !anyThisGroup)
-                    nxt.setown(inputStream->nextRow());
-                if (!nxt)
-                    break;
-                unsigned len;
-                helper->getSearchText(len, searchStr, nxt);
-                OwnedRoxieString xmlIteratorPath(helper->getXmlIteratorPath());
-                xmlParser.setown(createXMLParse(searchStr, len, xmlIteratorPath, *this, ptr_noRoot, helper->requiresContents()));
+            if (!nxt)
+            {
+                numProcessedLastGroup = rowsProcessed;
+                return nullptr;
             }
+            unsigned len;
+            helper->getSearchText(len, searchStr, nxt);
+            OwnedRoxieString xmlIteratorPath(helper->getXmlIteratorPath());
+            xmlParser.setown(createXMLParse(searchStr, len, xmlIteratorPath, *this, ptr_noRoot, helper->requiresContents()));
+        }
+    }
+public:
+    IMPLEMENT_IINTERFACE_USING(CThorStrandProcessor);
+
+    explicit CXmlParseStrandProcessor(CThorStrandedActivity &parent, IEngineRowStream *inputStream, unsigned outputId)
+        : CThorStrandProcessor(parent, inputStream, outputId)
+    {
+        helper = static_cast <IHThorXmlParseArg *> (queryHelper());
+        Owned<IRowInterfaces> rowIf = parent.getRowInterfaces();
+        allocator.setown(parent.getRowAllocator(rowIf->queryRowMetaData(), (parent.queryHeapFlags()|roxiemem::RHFpacked|roxiemem::RHFunique)));
+    }
+    ~CXmlParseStrandProcessor()
+    {
+        clearParser();
+    }
+    virtual void reset() override
+    {
+        clearParser();
+        nxt.clear();
+        CThorStrandProcessor::reset();
+    }
+// IXMLSelect
+    virtual void match(IColumnProvider &entry, offset_t startOffset, offset_t endOffset) override
+    {
+        lastMatch.set(&entry);
+    }
+    STRAND_CATCH_NEXTROW()
+    {
+        ActivityTimer t(slaveTimerStats, timeActivities);
+        try
+        {
+            return nextParsedRow();
         }
         catch (IOutOfMemException *e)
         {
             StringBuffer s("XMLParse actId(");
-            s.append(container.queryId()).append(") out of memory.").newline();
+            s.append(parent.queryId()).append(") out of memory.").newline();
             s.append("INTERNAL ERROR ").append(e->errorCode()).append(": ");
             e->errorMessage(s);
             e->Release();
-            throw MakeActivityException(this, 0, "%s", s.str());
+            throw MakeActivityException(&parent, 0, "%s", s.str());
         }
         catch (IException *e)
         {
             StringBuffer s("XMLParse actId(");
-            s.append(container.queryId());
+            s.append(parent.queryId());
             s.append(") INTERNAL ERROR ").append(e->errorCode()).append(": ");
             e->errorMessage(s);
             e->Release();
-            throw MakeActivityException(this, 0, "%s", s.str());
+            throw MakeActivityException(&parent, 0, "%s", s.str());
         }
-        eogNext = false;
-        anyThisGroup = false;
-        return NULL;
     }
+};
+
+class CXmlParseSlaveActivity : public CThorStrandedActivity
+{
+public:
+    CXmlParseSlaveActivity(CGraphElementBase *_container) : CThorStrandedActivity(_container)
+    {
+        appendOutputLinked(this);
+    }
+    virtual CThorStrandProcessor *createStrandProcessor(IEngineRowStream *instream) override
+    {
+        return new CXmlParseStrandProcessor(*this, instream, 0);
+    }
+    virtual CThorStrandProcessor *createStrandSourceProcessor(bool inputOrdered) override { throwUnexpected(); }
     virtual bool isGrouped() const override { return queryInput(0)->isGrouped(); }
     virtual void getMetaInfo(ThorDataLinkMetaInfo &info) const override
     {
@@ -20,6 +20,7 @@
 #include "commonext.hpp"
 #include "dasess.hpp"
 #include "jhtree.hpp"
+#include "ctfile.hpp"
 #include "thcodectx.hpp"
 #include "thbuf.hpp"
 #include "thormisc.hpp"
@@ -2699,6 +2700,7 @@ void CJobBase::applyMemorySettings(const char *context)
     bool gmemRetainMemory = getBoolSetting("heapRetainMemory", false);
     bool gmemLockMemory = getBoolSetting("heapLockMemory", false);
     roxiemem::setTotalMemoryLimit(gmemAllowHugePages, gmemAllowTransparentHugePages, gmemRetainMemory, gmemLockMemory, ((memsize_t)queryMemoryMB) * 0x100000, 0, thorAllocSizes, NULL);
+    roxiemem::setHeapNumaPartitions(getBoolSetting("heapNumaPartitions", false));
 
     PROGLOG("Total memory = %u MB, query memory = %u MB, memory spill at = %u", totalMemoryMB, queryMemoryMB, memorySpillAtPercentage);
 }
@@ -2793,6 +2795,11 @@ void CJobBase::startJob()
     setLeafCacheMem(keyLeafCacheBytes);
     setBlobCacheMem(keyBlobCacheBytes);
     PROGLOG("Key node caching setting: node=%u MB, leaf=%u MB, blob=%u MB", keyNodeCacheMB, keyLeafCacheMB, keyBlobCacheMB);
+    StringBuffer keyLeafCachePolicy, keyBlobCachePolicy;
+    getWorkUnitValue("keyLeafCachePolicy", keyLeafCachePolicy);
+    getWorkUnitValue("keyBlobCachePolicy", keyBlobCachePolicy);
+    setNodeCachePolicy(NodeLeaf, getNodeCachePolicy(keyLeafCachePolicy.str()));
+    setNodeCachePolicy(NodeBlob, getNodeCachePolicy(keyBlobCachePolicy.str()));
 
     unsigned keyFileCacheLimit = (unsigned)getWorkUnitValueInt("keyFileCacheLimit", 0);
     if (!keyFileCacheLimit)
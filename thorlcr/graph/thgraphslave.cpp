@@ -682,7 +682,22 @@ void CThorStrandedActivity::strandedStop()
     if (active)
         --active;
     if (!active)
+    {
+        if (strands.ordinality() > 1)
+            logStrandStats();
         stop();
+    }
+}
+
+void CThorStrandedActivity::logStrandStats() const
+{
+    StringBuffer msg;
+    ForEachItemIn(i, strands)
+    {
+        const CThorStrandProcessor &strand = strands.item(i);
+        msg.appendf(" [%u: rows=%" RCPF "u, time=%" I64F "uns]", i, strand.getCount(), cycle_to_nanosec(strand.queryTotalCycles()));
+    }
+    ::ActPrintLog(this, thorDetailedLogLevel, "Strands(%u):%s", strands.ordinality(), msg.str());
 }
 
 //This function is pure (But also implemented out of line) to force the derived classes to implement it.
@@ -841,6 +856,13 @@ rowcount_t CThorStrandedActivity::getProgressCount() const
     return totalCount;
 }
 
+void CThorStrandedActivity::gatherActiveStats(CRuntimeStatisticCollection &activeStats) const
+{
+    CSlaveActivity::gatherActiveStats(activeStats);
+    if (strands.ordinality())
+        activeStats.setStatistic(StNumStrands, strands.ordinality());
+}
+
 // CSlaveLateStartActivity
 
 void CSlaveLateStartActivity::lateStart(bool any)
@@ -471,6 +471,7 @@ protected:
     std::atomic<unsigned> active;
 protected:
     void onStartStrands();
+    void logStrandStats() const;
 public:
     CThorStrandedActivity(CGraphElementBase *container, const StatisticsMapping &statsMapping = basicActivityStatistics)
         : CSlaveActivity(container, statsMapping), strandOptions(*container), active(0)
@@ -493,6 +494,8 @@ public:
     virtual unsigned __int64 queryTotalCycles() const override;
     virtual void dataLinkSerialize(MemoryBuffer &mb) const override;
     virtual rowcount_t getProgressCount() const override;
+// CSlaveActivity
+    virtual void gatherActiveStats(CRuntimeStatisticCollection &activeStats) const override;
 };
 
 
@@ -1254,7 +1254,8 @@ public:
         bool _nosort,
         bool _unstable,
         bool &abort,
-        IThorRowInterfaces *_auxrowif
+        IThorRowInterfaces *_auxrowif,
+        ISortKeyPrefix *sortKeyPrefix
         )
     {
         ActPrintLog(activity, "Gather in");
@@ -1317,6 +1318,8 @@ public:
             primarySecondaryUpperCompare = primarySecondaryCompare;
 
         Owned<IThorRowLoader> sortedloader = createThorRowLoader(*activity, rowif, nosort?NULL:rowCompare, isstable ? stableSort_earlyAlloc : stableSort_none, rc_allDiskOrAllMem, SPILL_PRIORITY_SELFJOIN);
+        if (!nosort)
+            sortedloader->setSortKeyPrefix(sortKeyPrefix);
         Owned<IRowStream> overflowstream;
         memsize_t inMemUsage = 0;
         try
@@ -38,6 +38,7 @@
 #define CONNECTTIMEOUT 300  // seconds
 
 interface ISortKeySerializer;
+interface ISortKeyPrefix;
 interface IThorRowInterfaces;
 interface IThorDataLink;
 
@@ -57,7 +58,8 @@ public:
         bool nosort, 
         bool unstable, 
         bool &abort,
-        IThorRowInterfaces *_auxrowif
+        IThorRowInterfaces *_auxrowif,
+        ISortKeyPrefix *sortKeyPrefix=nullptr
         )=0;
     virtual IRowStream * startMerge(rowcount_t &totalrows)=0;
     virtual void stopMerge()=0;
@@ -55,6 +55,8 @@
 #define LOOP_SMART_BUFFER_SIZE                  (0x100000*12)           // 12MB
 #define LOCALRESULT_BUFFER_SIZE                 (0x100000*10)           // 10MB
 #define DEFAULT_SORT_COMPBLKSZ                  (0x10000)               // 64K
+#define DEFAULT_SORT_MAX_MERGE_FANIN            64
+#define DEFAULT_SORT_MERGE_READAHEAD            256                     // rows
 
 #define DEFAULT_KEYNODECACHEMB                  10
 #define DEFAULT_KEYLEAFCACHEMB                  50
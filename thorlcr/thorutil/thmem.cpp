@@ -22,6 +22,7 @@
 #include "jsort.hpp"
 #include "jsorta.hpp"
 #include "jflz.hpp"
+#include "jtask.hpp"
 
 #include "thbufdef.hpp"
 #include "thor.hpp"
@@ -578,9 +579,30 @@ bool CThorExpandingRowArray::resizeRowTable(void **&_rows, rowidx_t requiredRows
     return true;
 }
 
-void CThorExpandingRowArray::doSort(rowidx_t n, void **const rows, ICompare &compare, unsigned maxCores)
+void CThorExpandingRowArray::doSort(rowidx_t n, void **const rows, ICompare &compare, unsigned maxCores, ISortKeyPrefix *prefix)
 {
     // NB: will only be called if numRows>1
+    if (prefix)
+    {
+        // The prefix sort is stable, but needs more temporary space than the other sorts - use them if it isn't available
+        OwnedConstThorRow prefixTemp;
+        try
+        {
+            prefixTemp.setown(rowManager->allocate(getPrefixSortTempSize(n), activity.queryContainer().queryId(), defaultMaxSpillCost));
+        }
+        catch (IException * e)
+        {
+            unsigned code = e->errorCode();
+            if ((code != ROXIEMM_MEMORY_LIMIT_EXCEEDED) && (code != ROXIEMM_MEMORY_POOL_EXHAUSTED))
+                throw;
+            e->Release();
+        }
+        if (prefixTemp)
+        {
+            prefixsortvecinplace(rows, n, compare, *prefix, (void *)prefixTemp.get(), maxCores);
+            return;
+        }
+    }
     if (stableSort_none != stableSort)
     {
         OwnedConstThorRow tmpStableTable;
@@ -964,10 +986,10 @@ bool CThorExpandingRowArray::resize(rowidx_t requiredRows, unsigned maxSpillCost
     return _resize(requiredRows, maxSpillCost);
 }
 
-void CThorExpandingRowArray::sort(ICompare &compare, unsigned maxCores)
+void CThorExpandingRowArray::sort(ICompare &compare, unsigned maxCores, ISortKeyPrefix *prefix)
 {
     if (numRows>1)
-        doSort(numRows, (void **)rows, compare, maxCores);
+        doSort(numRows, (void **)rows, compare, maxCores, prefix);
 }
 
 void CThorExpandingRowArray::reorder(rowidx_t start, rowidx_t num, rowidx_t *neworder)
@@ -1356,14 +1378,14 @@ void CThorSpillableRowArray::kill()
     CThorExpandingRowArray::kill();
 }
 
-void CThorSpillableRowArray::sort(ICompare &compare, unsigned maxCores)
+void CThorSpillableRowArray::sort(ICompare &compare, unsigned maxCores, ISortKeyPrefix *prefix)
 {
     // NB: only to be called inside lock
     rowidx_t n = numCommitted();
     if (n>1)
     {
         void ** rows = (void **)getBlock(n);
-        doSort(n, rows, compare, maxCores);
+        doSort(n, rows, compare, maxCores, prefix);
     }
 }
 
@@ -1614,6 +1636,169 @@ IRowStream *CThorSpillableRowArray::createRowStream(unsigned spillPriority, unsi
 
 
 
+/* Reads rows from an ungrouped input stream into one buffer on the io task scheduler, while the rows in the other
+ * buffer are being consumed.  Used for the inputs of a spill merge, so that the merge does not stall on the
+ * read and decompression of each input in turn.
+ */
+class CReadAheadRowStream : public CSimpleInterfaceOf<IRowStream>
+{
+    class CFillTask : public CTask
+    {
+        Linked<CReadAheadRowStream> owner;
+    public:
+        CFillTask(CReadAheadRowStream &_owner) : CTask(0), owner(&_owner) { }
+        virtual CTask *execute() override
+        {
+            owner->fill();
+            return nullptr;
+        }
+    };
+
+    Owned<IRowStream> input;
+    ConstPointerArray buffers[2];
+    unsigned current = 0;       // the buffer being consumed, the other is filled asynchronously
+    unsigned pos = 0;
+    unsigned rowsPerBuffer;
+    bool eos = false;           // only updated by fill(), and only read once the fill has been waited for
+    bool pending = false;
+    Semaphore filled;
+    Owned<IException> exception;
+
+    void fill()
+    {
+        ConstPointerArray &target = buffers[current^1];
+        try
+        {
+            while (target.ordinality() < rowsPerBuffer)
+            {
+                const void *row = input->nextRow();
+                if (!row)
+                {
+                    eos = true;
+                    break;
+                }
+                target.append(row);
+            }
+        }
+        catch (IException *e)
+        {
+            exception.setown(e);
+        }
+        filled.signal();
+    }
+    void startFill()
+    {
+        if (eos)
+            return;
+        pending = true;
+        enqueueOwnedTask(queryIOTaskScheduler(), *new CFillTask(*this));
+    }
+    bool waitFill()
+    {
+        if (!pending)
+            return false;
+        filled.wait();
+        pending = false;
+        if (exception)
+            throw exception.getClear();
+        return true;
+    }
+    void releaseRows(ConstPointerArray &rows, unsigned from)
+    {
+        for (unsigned r=from; r<rows.ordinality(); r++)
+            ReleaseThorRow(rows.item(r));
+        rows.kill();
+    }
+public:
+    CReadAheadRowStream(IRowStream *_input, unsigned _rowsPerBuffer) : input(_input), rowsPerBuffer(_rowsPerBuffer)
+    {
+        startFill();
+    }
+    ~CReadAheadRowStream()
+    {
+        // Cannot be pending, since the fill task links this object
+        releaseRows(buffers[current], pos);
+        releaseRows(buffers[current^1], 0);
+    }
+// IRowStream
+    virtual const void *nextRow() override
+    {
+        for (;;)
+        {
+            ConstPointerArray &rows = buffers[current];
+            if (pos < rows.ordinality())
+                return rows.item(pos++);
+            rows.kill();
+            pos = 0;
+            if (!waitFill())
+                return nullptr;
+            current ^= 1;
+            startFill();
+        }
+    }
+    virtual void stop() override
+    {
+        try
+        {
+            waitFill();
+        }
+        catch (IException *e)
+        {
+            e->Release(); // stopping, so of no further interest
+        }
+        releaseRows(buffers[current], pos);
+        releaseRows(buffers[current^1], 0);
+        pos = 0;
+        eos = true;
+        input->stop();
+    }
+};
+
+
+// Returns the start of the window of numMerge adjacent inputs with the smallest total size
+unsigned findSmallestMergeWindow(unsigned numInputs, const offset_t *sizes, unsigned numMerge)
+{
+    assertex(numMerge && (numMerge <= numInputs));
+    offset_t windowSize = 0;
+    for (unsigned i=0; i < numMerge; i++)
+        windowSize += sizes[i];
+    offset_t bestSize = windowSize;
+    unsigned bestStart = 0;
+    for (unsigned start=1; start + numMerge <= numInputs; start++)
+    {
+        windowSize += sizes[start + numMerge - 1] - sizes[start - 1];
+        if (windowSize < bestSize)
+        {
+            bestSize = windowSize;
+            bestStart = start;
+        }
+    }
+    return bestStart;
+}
+
+unsigned mergeRunsToFanIn(std::vector<offset_t> &runSizes, unsigned numOtherInputs, unsigned maxFanIn, const MergeRunsFunction &mergeRuns)
+{
+    assertex(maxFanIn >= 2);
+    unsigned numInputs = runSizes.size() + numOtherInputs;
+    if (numInputs <= maxFanIn)
+        return 0;
+
+    unsigned numPasses = 0;
+    unsigned numMerges = ((numInputs - 2) % (maxFanIn - 1)) + 2;
+    while (numInputs > maxFanIn)
+    {
+        unsigned first = findSmallestMergeWindow(runSizes.size(), runSizes.data(), numMerges);
+        offset_t mergedSize = mergeRuns(first, numMerges);
+        runSizes.erase(runSizes.begin() + first, runSizes.begin() + first + numMerges);
+        runSizes.insert(runSizes.begin() + first, mergedSize);
+        numInputs -= (numMerges - 1);
+        numMerges = maxFanIn;
+        numPasses++;
+    }
+    return numPasses;
+}
+
+
 class CThorRowCollectorBase : public CSpillable
 {
 protected:
@@ -1626,6 +1811,7 @@ protected:
     unsigned maxCores = 0;
     unsigned outStreams = 0;
     ICompare *iCompare;
+    ISortKeyPrefix *sortKeyPrefix = nullptr;
     StableSortFlag stableSort;
     EmptyRowSemantics emptyRowSemantics = ers_forbidden;
     Owned<CSharedSpillableRowSet> spillableRowSet;
@@ -1635,6 +1821,12 @@ protected:
     RelaxedAtomic<offset_t> statSizeSpill{0};
     RelaxedAtomic<__uint64> statSpillCycles{0};
     RelaxedAtomic<__uint64> statSortCycles{0};
+    RelaxedAtomic<unsigned> statMergePasses{0};
+    RelaxedAtomic<offset_t> statSizeReread{0};
+    size32_t spillCompBlkSz = 0;
+    CriticalSection spillFilesCrit;
+    unsigned maxMergeFanIn = DEFAULT_SORT_MAX_MERGE_FANIN;
+    unsigned mergeReadAhead = DEFAULT_SORT_MERGE_READAHEAD;
 
     bool spillRows(bool critical)
     {
@@ -1649,7 +1841,7 @@ protected:
         if (iCompare)
         {
             CCycleTimer timer;
-            spillableRows.sort(*iCompare, maxCores); // sorts committed rows
+            spillableRows.sort(*iCompare, maxCores, sortKeyPrefix); // sorts committed rows
             statSortCycles.fastAdd(timer.elapsedCycles());
             ActPrintLog(&activity, "%sSorting %" RIPF "u rows took: %f", tracingPrefix.str(), spillableRows.numCommitted(), ((float)timer.elapsedMs())/1000);
             tempPrefix.append("srt");
@@ -1666,6 +1858,83 @@ protected:
         statSpillCycles.fastAdd(spillTimer.elapsedCycles());
         return true;
     }
+    unsigned getSpillReadFlags() const
+    {
+        unsigned rwFlags = DEFAULT_RWFLAGS;
+        if (spillCompInfo)
+        {
+            rwFlags |= rw_compress;
+            rwFlags |= spillCompInfo;
+        }
+        rwFlags |= mapESRToRWFlags(emptyRowSemantics);
+        return rwFlags;
+    }
+    IRowStream *createSpillStream(CFileOwner *fileOwner, unsigned rwFlags, bool readAhead)
+    {
+        // NB: CStreamFileOwner links CFileOwner - last usage will auto delete file
+        Owned<IExtRowStream> strm = createRowStream(&fileOwner->queryIFile(), rowIf, rwFlags);
+        Owned<IRowStream> fileStream = new CStreamFileOwner(fileOwner, strm);
+        // The read ahead relies on a null row marking the end of the stream, so it cannot be used if grouped
+        if (readAhead && mergeReadAhead && (ers_forbidden == emptyRowSemantics))
+            return new CReadAheadRowStream(fileStream.getClear(), mergeReadAhead);
+        return fileStream.getClear();
+    }
+    // Merge runs of adjacent spill files into new spill files until the final merge is within maxMergeFanIn inputs
+    void mergeSpillFiles(unsigned numOtherInputs)
+    {
+        if (!iCompare || (maxMergeFanIn < 2))
+            return;
+        if (spillFiles.ordinality() + numOtherInputs <= maxMergeFanIn)
+            return;
+
+        unsigned rwFlags = getSpillReadFlags();
+        Owned<IRowLinkCounter> linkcounter = new CThorRowLinkCounter;
+        std::vector<offset_t> sizes;
+        ForEachItemIn(f, spillFiles)
+            sizes.push_back(spillFiles.item(f)->queryIFile().size());
+        auto mergeFiles = [&](unsigned first, unsigned numMerges) -> offset_t
+        {
+            CCycleTimer mergeTimer;
+            IArrayOf<IRowStream> instrms;
+            offset_t sizeReread = 0;
+            for (unsigned f=first; f<first+numMerges; f++)
+            {
+                sizeReread += sizes[f];
+                instrms.append(*createSpillStream(spillFiles.item(f), rwFlags, true));
+            }
+            spillFiles.removen(first, numMerges); // the streams now own the files
+
+            StringBuffer tempName;
+            VStringBuffer tempPrefix("srtmrg_spill_%d", activity.queryId());
+            GetTempFilePath(tempName, tempPrefix.str());
+            Owned<IFile> iFile = createIFile(tempName.str());
+            Owned<CFileOwner> mergedOwner = new CFileOwner(iFile.getLink());
+            {
+                Owned<IRowStream> merged = createRowStreamMerger(instrms.ordinality(), instrms.getArray(), iCompare, false, linkcounter);
+                instrms.kill();
+                Owned<IExtRowWriter> writer = createRowWriter(iFile, rowIf, rwFlags, nullptr, spillCompBlkSz);
+                for (;;)
+                {
+                    const void *row = merged->nextRow();
+                    if (!row)
+                        break;
+                    writer->putRow(row);
+                }
+                merged->stop();
+                writer->flush(nullptr);
+            }
+            offset_t mergedSize = iFile->size();
+            ActPrintLog(&activity, thorDetailedLogLevel, "%sMerged %u spill files (%" I64F "u bytes) into one of %" I64F "u bytes", tracingPrefix.str(), numMerges, sizeReread, mergedSize);
+            spillFiles.add(mergedOwner.getClear(), first);
+
+            statMergePasses.fastAdd(1);
+            statSizeReread.fastAdd(sizeReread);
+            statSizeSpill.fastAdd(mergedSize);
+            statSpillCycles.fastAdd(mergeTimer.elapsedCycles());
+            return mergedSize;
+        };
+        mergeRunsToFanIn(sizes, numOtherInputs, maxMergeFanIn, mergeFiles);
+    }
     void setEmptyRowSemantics(EmptyRowSemantics _emptyRowSemantics)
     {
         emptyRowSemantics = _emptyRowSemantics;
@@ -1719,11 +1988,14 @@ protected:
     IRowStream *getStream(CThorExpandingRowArray *allMemRows, memsize_t *memUsage, bool shared)
     {
         bool activateSharedCallback = false;
+        bool firstStream = false;
+        unsigned numMemInputs = 0;
 
         {
             CThorArrayLockBlock block(spillableRows); // ensure locked until deactivated
             if (0 == outStreams++)
             {
+                firstStream = true;
                 flush();
                 if (spillingEnabled())
                 {
@@ -1746,11 +2018,12 @@ protected:
 
                 if (spillableRows.numCommitted())
                 {
+                    numMemInputs = 1;
                     totalRows += spillableRows.numCommitted();
                     if (iCompare)
                     {
                         CCycleTimer timer;
-                        spillableRows.sort(*iCompare, maxCores);
+                        spillableRows.sort(*iCompare, maxCores, sortKeyPrefix);
                         statSortCycles.fastAdd(timer.elapsedCycles());
                     }
 
@@ -1787,23 +2060,19 @@ protected:
         if (activateSharedCallback)
             spillableRowSet->activateSpillingCallback();
 
+        /* Any intermediate merges are performed outside of the spillableRows lock, since the read ahead allocates rows
+         * on other threads, and a spilling callback on those threads would block on the lock.
+         */
+        CriticalBlock block(spillFilesCrit);
+        if (firstStream && overflowCount)
+            mergeSpillFiles(numMemInputs);
 
-        // NB: CStreamFileOwner links CFileOwner - last usage will auto delete file
-        // which may be one of these streams or CThorRowCollectorBase itself
-        unsigned rwFlags = DEFAULT_RWFLAGS;
-        if (spillCompInfo)
-        {
-            rwFlags |= rw_compress;
-            rwFlags |= spillCompInfo;
-        }
-        rwFlags |= mapESRToRWFlags(emptyRowSemantics);
+        // NB: the last usage of a CFileOwner will auto delete file, which may be one of these streams or CThorRowCollectorBase itself
+        unsigned rwFlags = getSpillReadFlags();
+        bool merging = (nullptr != iCompare) && (spillFiles.ordinality() > 1);
         IArrayOf<IRowStream> instrms;
         ForEachItemIn(f, spillFiles)
-        {
-            CFileOwner *fileOwner = spillFiles.item(f);
-            Owned<IExtRowStream> strm = createRowStream(&fileOwner->queryIFile(), rowIf, rwFlags);
-            instrms.append(* new CStreamFileOwner(fileOwner, strm));
-        }
+            instrms.append(*createSpillStream(spillFiles.item(f), rwFlags, merging));
 
         if (shared)
         {
@@ -1862,9 +2131,11 @@ public:
              * if there are a lot of spill files, the merge opens them all and causes excessive
              * memory usage.
              */
-            size32_t compBlkSz = activity.getOptUInt(THOROPT_SORT_COMPBLKSZ, DEFAULT_SORT_COMPBLKSZ);
-            ActPrintLog(&activity, thorDetailedLogLevel, "%sSpilling will use compressed block size = %u", tracingPrefix.str(), compBlkSz);
-            spillableRows.setCompBlockSize(compBlkSz);
+            spillCompBlkSz = activity.getOptUInt(THOROPT_SORT_COMPBLKSZ, DEFAULT_SORT_COMPBLKSZ);
+            ActPrintLog(&activity, thorDetailedLogLevel, "%sSpilling will use compressed block size = %u", tracingPrefix.str(), spillCompBlkSz);
+            spillableRows.setCompBlockSize(spillCompBlkSz);
+            maxMergeFanIn = activity.getOptUInt(THOROPT_SORT_MAX_MERGE_FANIN, DEFAULT_SORT_MAX_MERGE_FANIN);
+            mergeReadAhead = activity.getOptUInt(THOROPT_SORT_MERGE_READAHEAD, DEFAULT_SORT_MERGE_READAHEAD);
         }
     }
     ~CThorRowCollectorBase()
@@ -1895,7 +2166,7 @@ public:
         if (sort && iCompare)
         {
             CCycleTimer timer;
-            spillableRows.sort(*iCompare, maxCores);
+            spillableRows.sort(*iCompare, maxCores, sortKeyPrefix);
             statSortCycles.fastAdd(timer.elapsedCycles());
         }
         out.transferFrom(spillableRows);
@@ -1933,6 +2204,10 @@ public:
         }
         spillableRows.setup(rowIf, ers_forbidden, stableSort);
     }
+    void setSortKeyPrefix(ISortKeyPrefix *_sortKeyPrefix)
+    {
+        sortKeyPrefix = _sortKeyPrefix;
+    }
     void resize(rowidx_t max)
     {
         spillableRows.resize(max);
@@ -1957,6 +2232,10 @@ public:
             return statOverflowCount;
         case StSizeSpillFile:
             return statSizeSpill;
+        case StNumMergePasses:
+            return statMergePasses;
+        case StSizeSpillReread:
+            return statSizeReread;
         default:
             break;
         }
@@ -2027,6 +2306,7 @@ public:
     {
         CThorRowCollectorBase::setup(iCompare, stableSort, diskMemMix, spillPriority);
     }
+    virtual void setSortKeyPrefix(ISortKeyPrefix *prefix) override { CThorRowCollectorBase::setSortKeyPrefix(prefix); }
     virtual void resize(rowidx_t max) override { CThorRowCollectorBase::resize(max); }
     virtual void setOptions(unsigned options) override { CThorRowCollectorBase::setOptions(options); }
     virtual unsigned __int64 getStatistic(StatisticKind kind) override { return CThorRowCollectorBase::getStatistic(kind); }
@@ -2082,6 +2362,7 @@ public:
     {
         CThorRowCollectorBase::setup(iCompare, stableSort, diskMemMix, spillPriority);
     }
+    virtual void setSortKeyPrefix(ISortKeyPrefix *prefix) override { CThorRowCollectorBase::setSortKeyPrefix(prefix); }
     virtual void resize(rowidx_t max) override { CThorRowCollectorBase::resize(max); }
     virtual void setOptions(unsigned options) override { CThorRowCollectorBase::setOptions(options); }
     virtual unsigned __int64 getStatistic(StatisticKind kind) override { return CThorRowCollectorBase::getStatistic(kind); }
@@ -2645,4 +2926,129 @@ IOutputMetaData *createOutputMetaDataWithChildRow(IEngineRowAllocator *childAllo
     return new COutputMetaWithChildRow(childAllocator, extraSz);
 }
 
+#ifdef _USE_CPPUNIT
+#include "unittests.hpp"
+
+class ThorSpillMergeTest : public CppUnit::TestFixture
+{
+    CPPUNIT_TEST_SUITE( ThorSpillMergeTest );
+        CPPUNIT_TEST(testSmallestMergeWindow);
+        CPPUNIT_TEST(testMultiPassMergeStable);
+    CPPUNIT_TEST_SUITE_END();
 
+    struct TestRow
+    {
+        unsigned key;
+        unsigned seq;   // position in the original input
+    };
+
+    class RowCompare : implements ICompare
+    {
+    public:
+        virtual int docompare(const void * l, const void * r) const override
+        {
+            unsigned lKey = ((const TestRow *)l)->key;
+            unsigned rKey = ((const TestRow *)r)->key;
+            return (lKey < rKey) ? -1 : (lKey > rKey) ? 1 : 0;
+        }
+    };
+
+    class NullLinkCounter : public CSimpleInterfaceOf<IRowLinkCounter>
+    {
+    public:
+        virtual void linkRow(const void *row) override {}
+        virtual void releaseRow(const void *row) override {}
+    };
+
+    class RunStream : public CSimpleInterfaceOf<IRowStream>
+    {
+        const std::vector<const TestRow *> &rows;
+        unsigned next = 0;
+    public:
+        RunStream(const std::vector<const TestRow *> &_rows) : rows(_rows) {}
+        virtual const void *nextRow() override { return (next < rows.size()) ? rows[next++] : nullptr; }
+        virtual void stop() override {}
+    };
+
+    using Run = std::vector<const TestRow *>;
+
+    Run mergeRuns(const std::vector<Run> &runs, unsigned first, unsigned num)
+    {
+        RowCompare compare;
+        Owned<IRowLinkCounter> linkCounter = new NullLinkCounter;
+        IArrayOf<IRowStream> streams;
+        for (unsigned i=first; i < first+num; i++)
+            streams.append(*new RunStream(runs[i]));
+        Owned<IRowStream> merged = createRowStreamMerger(num, streams.getArray(), &compare, false, linkCounter);
+        Run result;
+        for (;;)
+        {
+            const void *row = merged->nextRow();
+            if (!row)
+                break;
+            result.push_back((const TestRow *)row);
+        }
+        return result;
+    }
+
+    void testSmallestMergeWindow()
+    {
+        offset_t sizes[] = { 5, 1, 1, 9, 1, 1, 1 };
+        CPPUNIT_ASSERT_EQUAL(4U, findSmallestMergeWindow(7, sizes, 3));
+        CPPUNIT_ASSERT_EQUAL(1U, findSmallestMergeWindow(7, sizes, 2));
+        CPPUNIT_ASSERT_EQUAL(0U, findSmallestMergeWindow(7, sizes, 7));
+    }
+
+    //Runs of unequal size containing duplicate keys are merged over several passes, in the same way as the spill files,
+    //and rows with equal keys must end up in their original order.
+    void testMultiPassMergeStable()
+    {
+        constexpr unsigned numRuns = 23;
+        constexpr unsigned maxFanIn = 4;
+        std::vector<TestRow> rows;
+        rows.reserve(numRuns * 20);
+        std::vector<Run> runs(numRuns);
+        unsigned seq = 0;
+        for (unsigned r=0; r < numRuns; r++)
+        {
+            unsigned runLength = ((r * 37) % 17) + 1;
+            unsigned start = rows.size();
+            for (unsigned i=0; i < runLength; i++)
+                rows.push_back(TestRow{ (i * 7 + r) % 5, seq++ });
+            std::stable_sort(rows.begin() + start, rows.end(), [](const TestRow &l, const TestRow &r) { return l.key < r.key; });
+            for (unsigned i=start; i < rows.size(); i++)
+                runs[r].push_back(&rows[i]);
+        }
+
+        std::vector<offset_t> sizes;
+        for (auto &run : runs)
+            sizes.push_back(run.size());
+        auto mergeAdjacentRuns = [&](unsigned first, unsigned num) -> offset_t
+        {
+            Run merged = mergeRuns(runs, first, num);
+            runs.erase(runs.begin() + first, runs.begin() + first + num);
+            runs.insert(runs.begin() + first, merged);
+            return merged.size();
+        };
+        unsigned numPasses = mergeRunsToFanIn(sizes, 0, maxFanIn, mergeAdjacentRuns);
+        CPPUNIT_ASSERT(runs.size() <= maxFanIn);
+        CPPUNIT_ASSERT_EQUAL(runs.size(), sizes.size());
+        CPPUNIT_ASSERT(numPasses > 1);
+
+        Run result = mergeRuns(runs, 0, runs.size());
+        CPPUNIT_ASSERT_EQUAL(rows.size(), result.size());
+        for (unsigned i=1; i < result.size(); i++)
+        {
+            const TestRow *prev = result[i-1];
+            const TestRow *cur = result[i];
+            CPPUNIT_ASSERT(prev->key <= cur->key);
+            if (prev->key == cur->key)
+                CPPUNIT_ASSERT(prev->seq < cur->seq);
+        }
+    }
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION( ThorSpillMergeTest );
+CPPUNIT_TEST_SUITE_NAMED_REGISTRATION( ThorSpillMergeTest, "ThorSpillMergeTest" );
+
+#endif
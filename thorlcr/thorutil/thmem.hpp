@@ -24,6 +24,8 @@
     #define graph_decl DECL_IMPORT
 #endif
 
+#include <functional>
+#include <vector>
 #include "jexcept.hpp"
 #include "jbuff.hpp"
 #include "jsort.hpp"
@@ -292,7 +294,7 @@ protected:
     const void **allocateRowTable(rowidx_t num, unsigned maxSpillCost);
     rowidx_t getNewSize(rowidx_t requiredRows);
     void serialize(IRowSerializerTarget &out);
-    void doSort(rowidx_t n, void **const rows, ICompare &compare, unsigned maxCores);
+    void doSort(rowidx_t n, void **const rows, ICompare &compare, unsigned maxCores, ISortKeyPrefix *prefix);
     inline rowidx_t getRowsCapacity() const { return rows ? RoxieRowCapacity(rows) / sizeof(void *) : 0; }
 public:
     CThorExpandingRowArray(CActivityBase &activity);
@@ -373,7 +375,7 @@ public:
     bool appendRows(CThorExpandingRowArray &inRows, bool takeOwnership);
     bool appendRows(CThorSpillableRowArray &inRows, bool takeOwnership);
     void clearUnused();
-    void sort(ICompare &compare, unsigned maxCores);
+    void sort(ICompare &compare, unsigned maxCores, ISortKeyPrefix *prefix=nullptr);
     void reorder(rowidx_t start, rowidx_t num, rowidx_t *neworder);
 
     bool equal(ICompare *icmp, CThorExpandingRowArray &other);
@@ -479,7 +481,7 @@ public:
     }
 
     //A thread calling the following functions must own the lock, or guarantee no other thread will access
-    void sort(ICompare & compare, unsigned maxcores);
+    void sort(ICompare & compare, unsigned maxcores, ISortKeyPrefix *prefix=nullptr);
     rowidx_t save(IFile &file, unsigned _spillCompInfo, bool skipNulls, const char *tracingPrefix);
 
     inline rowidx_t numCommitted() const { return commitRows - firstRow; } //MORE::Not convinced this is very safe!
@@ -540,6 +542,7 @@ interface IThorRowCollectorCommon : extends IInterface, extends IThorArrayLock
     virtual void transferRowsIn(CThorSpillableRowArray &src) = 0;
     virtual const void *probeRow(unsigned r) = 0;
     virtual void setup(ICompare *iCompare, StableSortFlag stableSort=stableSort_none, RowCollectorSpillFlags diskMemMix=rc_mixed, unsigned spillPriority=50) = 0;
+    virtual void setSortKeyPrefix(ISortKeyPrefix *prefix) = 0; // optional, used to speed up sorting with iCompare
     virtual void resize(rowidx_t max) = 0;
     virtual void setOptions(unsigned options) = 0;
     virtual unsigned __int64 getStatistic(StatisticKind kind) = 0;
@@ -568,6 +571,16 @@ extern graph_decl IThorRowLoader *createThorRowLoader(CActivityBase &activity, I
 extern graph_decl IThorRowLoader *createThorRowLoader(CActivityBase &activity, ICompare *iCompare=NULL, StableSortFlag stableSort=stableSort_none, RowCollectorSpillFlags diskMemMix=rc_mixed, unsigned spillPriority=SPILL_PRIORITY_DEFAULT);
 extern graph_decl IThorRowCollector *createThorRowCollector(CActivityBase &activity, IThorRowInterfaces *rowIf, ICompare *iCompare=NULL, StableSortFlag stableSort=stableSort_none, RowCollectorSpillFlags diskMemMix=rc_mixed, unsigned spillPriority=SPILL_PRIORITY_DEFAULT, EmptyRowSemantics emptyRowSemantics=ers_forbidden);
 
+/* Merging too many sorted runs at once needs a read buffer per run, so while there are more than maxFanIn inputs
+ * (runs plus numOtherInputs that are only available to the final merge), mergeRuns is called to merge the window of
+ * adjacent runs with the smallest total size.  It returns the size of the merged run, which replaces the window in
+ * runSizes.  Only merging adjacent runs keeps the merge stable, because the merger breaks ties by input index.
+ * The first merge is sized so that every subsequent merge has the full fan-in.  Returns the number of merges.
+ */
+typedef std::function<offset_t(unsigned first, unsigned num)> MergeRunsFunction;
+extern graph_decl unsigned findSmallestMergeWindow(unsigned numInputs, const offset_t *sizes, unsigned numMerge);
+extern graph_decl unsigned mergeRunsToFanIn(std::vector<offset_t> &runSizes, unsigned numOtherInputs, unsigned maxFanIn, const MergeRunsFunction &mergeRuns);
+
 
 
 
@@ -65,11 +65,13 @@
 #define THOROPT_JOINHELPER_THREADS    "joinHelperThreads"       // Number of threads to use in threaded variety of join helper
 #define THOROPT_LKJOIN_LOCALFAILOVER  "lkjoin_localfailover"    // Force SMART to failover to distributed local lookup join (for testing only)   (default = false)
 #define THOROPT_LKJOIN_HASHJOINFAILOVER "lkjoin_hashjoinfailover" // Force SMART to failover to hash join (for testing only)                     (default = false)
+#define THOROPT_LKJOIN_PROBE_BATCH    "lkjoin_probebatch"       // Number of LHS rows hashed and prefetched together when probing the RHS table (0=off) (default = 16)
 #define THOROPT_MAX_KERNLOG           "max_kern_level"          // Max kernel logging level, to push to workunit, -1 to disable                  (default = 3)
 #define THOROPT_COMP_FORCELZW         "forceLZW"                // Forces file compression to use LZW                                            (default = false)
 #define THOROPT_COMP_FORCEFLZ         "forceFLZ"                // Forces file compression to use FLZ                                            (default = false)
 #define THOROPT_COMP_FORCELZ4         "forceLZ4"                // Forces file compression to use LZ4                                            (default = false)
 #define THOROPT_COMP_FORCELZ4HC       "forceLZ4HC"              // Forces file compression to use LZ4HC                                          (default = false)
+#define THOROPT_COMP_FORCEZSTD        "forceZSTD"               // Forces file compression to use ZSTD                                           (default = false)
 #define THOROPT_TRACE_ENABLED         "traceEnabled"            // Output from TRACE activity enabled                                            (default = false)
 #define THOROPT_TRACE_LIMIT           "traceLimit"              // Number of rows from TRACE activity                                            (default = 10)
 #define THOROPT_READ_CRC              "crcReadEnabled"          // Enabled CRC validation on disk reads if file CRC are available                (default = true)
@@ -78,6 +80,8 @@
 #define THOROPT_WRITECOMPRESSED_CRC   "crcWriteCompressedEnabled" // Calculate CRC's for compressed disk outputs and store in file meta data     (default = false)
 #define THOROPT_CHILD_GRAPH_INIT_TIMEOUT "childGraphInitTimeout" // Time to wait for child graphs to respond to initialization                  (default = 5*60 seconds)
 #define THOROPT_SORT_COMPBLKSZ        "sortCompBlkSz"           // Block size used by compressed spill in a spilling sort                        (default = 0, uses row writer default)
+#define THOROPT_SORT_MAX_MERGE_FANIN  "sortMaxMergeFanIn"       // Max. number of spill files merged at once, more cause intermediate merges     (default = 64)
+#define THOROPT_SORT_MERGE_READAHEAD  "sortMergeReadAhead"      // Number of rows read ahead asynchronously from each merged spill file (0=off) (default = 256)
 #define THOROPT_KEYLOOKUP_QUEUED_BATCHSIZE "keyLookupQueuedBatchSize" // Number of rows candidates to gather before performing lookup against part (default = 1000)
 #define THOROPT_KEYLOOKUP_FETCH_QUEUED_BATCHSIZE "fetchLookupQueuedBatchSize" // Number of rows candidates to gather before performing lookup against part (default = 1000)
 #define THOROPT_KEYLOOKUP_MAX_LOOKUP_BATCHSIZE "keyLookupMaxLookupBatchSize"  // Maximum chunk of rows to process per cycle in lookup handler    (default = 1000)
@@ -89,6 +93,7 @@
 #define THOROPT_KEYLOOKUP_MAX_DONE    "keyLookupMaxDone"        // Maximum number of done items pending to be ready by next activity             (default = 10000)
 #define THOROPT_KEYLOOKUP_PROCESS_BATCHLIMIT "keyLookupProcessBatchLimit" // Maximum number of key lookups on queue before passing to a processor (default = 1000)
 #define THOROPT_FETCHLOOKUP_PROCESS_BATCHLIMIT "fetchLookupProcessBatchLimit" // Maximum number of fetch lookups on queue before passing to a processor (default = 10000)
+#define THOROPT_KEYLOOKUP_BLOOM_PREFILTER "keyLookupBloomPrefilter" // Check each batch of local key lookups against the index bloom filters first (default = true)
 #define THOROPT_REMOTE_KEYED_LOOKUP   "remoteKeyedLookup"       // Send key request to remote node unless part is local                          (default = true)
 #define THOROPT_REMOTE_KEYED_FETCH    "remoteKeyedFetch"        // Send fetch request to remote node unless part is local                        (default = true)
 #define THOROPT_FORCE_REMOTE_KEYED_LOOKUP "forceRemoteKeyedLookup" // force all keyed lookups, even where part local to be sent as if remote     (default = false)
@@ -105,6 +110,8 @@
 #define THOROPT_VALIDATE_FILE_TYPE    "validateFileType"        // validate file type compatibility, e.g. if on fire error if XML reading CSV    (default = true)
 #define THOROPT_MIN_REMOTE_CQ_INDEX_SIZE_MB "minRemoteCQIndexSizeMb" // minimum size of index file to enable server side handling                (default = 0, meaning use heuristic to determin)
 #define THOROPT_KJ_ASSUME_PRIMARY "keyedJoinAssumePrimary"      // assume primary part exists (don't check when mapping, which can be slow)
+#define THOROPT_INDEX_READAHEAD "indexReadAhead"              // Number of index leaf nodes to read asynchronously ahead of an index read  (default = 0, disabled)
+#define THOROPT_INDEX_BUILD_THREADS "indexBuildThreads"      // Number of threads used to fill the leaf nodes when building an index part (default = 0, serial)
 #define THOROPT_COMPRESS_SORTOVERFLOW "compressSortOverflow"    // If global sort spills, compress the merged overflow file                      (default = true)
 #define THOROPT_TIME_ACTIVITIES "timeActivities"                // Time activities (default=true)
 #define THOROPT_MAX_ACTIVITY_CORES "maxActivityCores"           // controls number of default threads to use for very parallel phases (like sort/parallel join helper). (default = # of h/w cores)
@@ -81,6 +81,7 @@ inline void SwapBigEndian(KeyHdr &hdr)
     _WINREV(hdr.bloomHead);
     _WINREV(hdr.partitionFieldMask);
     _WINREV(hdr.firstLeaf);
+    _WINREV(hdr.blockedBloomHead);
 }
 
 